@@ -0,0 +1,1004 @@
+/**
+ * tiny-sql 负载生成器
+ * MySQL-protocol load generator for end-to-end throughput and latency
+ *
+ * 单线程 epoll 驱动任意数量的非阻塞连接，握手和认证复用服务器的
+ * HandshakeV10Packet / HandshakeResponse41Packet / Authenticator::computeAuthResponse。
+ * 负载仿照 sysbench 的 oltp 系列：point / range / insert / oltp（混合读写）。
+ *
+ * 两种节奏：
+ * - 闭环（--rate=0）：每个连接收到响应后立即发下一条，测最大吞吐
+ * - 开环（--rate=N）：按泊松过程每秒到达 N 个请求，空闲连接取走到达的请求，
+ *   没有空闲连接时请求排队；延迟从请求的计划到达时间算起，排队时间也计入，
+ *   避免 coordinated omission
+ *
+ * 用法：
+ *   tiny-sql-loadgen --port=3306 --prepare --table-size=100000
+ *   tiny-sql-loadgen --port=3306 --workload=oltp --connections=2000 --rate=20000 --duration=30
+ *   tiny-sql-loadgen --socket=/tmp/tiny-sql.sock --workload=point
+ */
+
+#include "tiny_sql/auth/authenticator.h"
+#include "tiny_sql/common/buffer.h"
+#include "tiny_sql/protocol/handshake.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace tiny_sql;
+
+namespace {
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+enum class Workload { POINT_SELECT, RANGE_SELECT, INSERT, OLTP };
+
+struct Options {
+    std::string host = "127.0.0.1";
+    uint16_t port = 3306;
+    std::string socket;             // Unix 域 socket 路径，非空时忽略 host/port
+    std::string user = "root";
+    std::string password;
+    std::string database = "sbtest";
+    Workload workload = Workload::POINT_SELECT;
+    size_t connections = 64;
+    double rate = 0;                // 每秒到达的请求数，0 为闭环
+    double duration = 10;           // 测量时长（秒）
+    double warmup = 0;              // 预热时长（秒），期间的请求不计入统计
+    double report_interval = 1;     // 中间报告间隔（秒），0 表示只输出最终结果
+    size_t table_size = 10000;
+    size_t range_size = 100;
+    bool prepare = false;           // 建表并装载 table_size 行后退出
+    uint64_t seed = 1;
+};
+
+void printUsage() {
+    std::cerr <<
+        "Usage: tiny-sql-loadgen [options]\n"
+        "  --host=ADDR              server address (default 127.0.0.1)\n"
+        "  --port=N                 server port (default 3306)\n"
+        "  --socket=PATH            connect through a unix socket instead of TCP\n"
+        "  --user=NAME              user (default root)\n"
+        "  --password=PASS          password (default empty)\n"
+        "  --database=NAME          database (default sbtest)\n"
+        "  --prepare                create and load sbtest1, then exit\n"
+        "  --table-size=N           rows in sbtest1 (default 10000)\n"
+        "  --workload=KIND          point | range | insert | oltp (default point)\n"
+        "  --connections=N          concurrent connections (default 64)\n"
+        "  --rate=N                 open-loop arrivals per second, 0 = closed loop (default 0)\n"
+        "  --duration=SECONDS       measured duration (default 10)\n"
+        "  --warmup=SECONDS         unmeasured warmup before the run (default 0)\n"
+        "  --range-size=N           rows per range select (default 100)\n"
+        "  --report-interval=SEC    interim report interval, 0 = off (default 1)\n"
+        "  --seed=N                 random seed (default 1)\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            return false;
+        }
+        size_t eq = arg.find('=');
+        std::string name = arg.substr(2, eq == std::string::npos ? std::string::npos : eq - 2);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+        if (name == "host") {
+            options.host = value;
+        } else if (name == "port") {
+            options.port = static_cast<uint16_t>(std::atoi(value.c_str()));
+        } else if (name == "socket") {
+            options.socket = value;
+        } else if (name == "user") {
+            options.user = value;
+        } else if (name == "password") {
+            options.password = value;
+        } else if (name == "database") {
+            options.database = value;
+        } else if (name == "prepare") {
+            options.prepare = true;
+        } else if (name == "table-size") {
+            options.table_size = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (name == "workload") {
+            if (value == "point") {
+                options.workload = Workload::POINT_SELECT;
+            } else if (value == "range") {
+                options.workload = Workload::RANGE_SELECT;
+            } else if (value == "insert") {
+                options.workload = Workload::INSERT;
+            } else if (value == "oltp") {
+                options.workload = Workload::OLTP;
+            } else {
+                return false;
+            }
+        } else if (name == "connections") {
+            options.connections = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (name == "rate") {
+            options.rate = std::strtod(value.c_str(), nullptr);
+        } else if (name == "duration") {
+            options.duration = std::strtod(value.c_str(), nullptr);
+        } else if (name == "warmup") {
+            options.warmup = std::strtod(value.c_str(), nullptr);
+        } else if (name == "range-size") {
+            options.range_size = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (name == "report-interval") {
+            options.report_interval = std::strtod(value.c_str(), nullptr);
+        } else if (name == "seed") {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    return options.port != 0 && options.connections > 0 && options.table_size > 0 &&
+           options.range_size > 0 && options.duration > 0 && options.rate >= 0;
+}
+
+// ==================== 语句生成 ====================
+
+/**
+ * sysbench 风格的语句生成器
+ * 表结构：sbtest1 (id INT PRIMARY KEY, k INT, c VARCHAR(120), pad VARCHAR(60))，k 上有索引
+ */
+class QueryGenerator {
+public:
+    explicit QueryGenerator(const Options& options)
+        : options_(options), rng_(options.seed), next_insert_id_(options.table_size + 1) {}
+
+    std::string next() {
+        switch (options_.workload) {
+            case Workload::POINT_SELECT:
+                return pointSelect();
+            case Workload::RANGE_SELECT:
+                return rangeSelect("SELECT c FROM sbtest1", "");
+            case Workload::INSERT:
+                return insert();
+            case Workload::OLTP:
+                return oltp();
+        }
+        return pointSelect();
+    }
+
+    // 装载数据的多行 INSERT（行号 [first, last]）
+    std::string loadBatch(size_t first, size_t last) {
+        std::string sql = "INSERT INTO sbtest1 (id, k, c, pad) VALUES ";
+        for (size_t id = first; id <= last; ++id) {
+            if (id != first) {
+                sql += ", ";
+            }
+            sql += row(id);
+        }
+        return sql;
+    }
+
+private:
+    // oltp_read_write 的语句比例（不含 BEGIN/COMMIT 和 DISTINCT 范围查询）：
+    // 10 点查 + 3 范围（简单/SUM/ORDER BY）+ 2 更新（索引列/非索引列）+ 1 插入
+    std::string oltp() {
+        uint64_t pick = rng_() % 16;
+        if (pick < 10) {
+            return pointSelect();
+        }
+        switch (pick) {
+            case 10: return rangeSelect("SELECT c FROM sbtest1", "");
+            case 11: return rangeSelect("SELECT SUM(k) FROM sbtest1", "");
+            case 12: return rangeSelect("SELECT c FROM sbtest1", " ORDER BY c");
+            case 13: return "UPDATE sbtest1 SET k = k + 1 WHERE id = " + std::to_string(randomId());
+            case 14: return "UPDATE sbtest1 SET c = '" + randomString(119) + "' WHERE id = " +
+                            std::to_string(randomId());
+            default: return insert();
+        }
+    }
+
+    std::string pointSelect() {
+        return "SELECT c FROM sbtest1 WHERE id = " + std::to_string(randomId());
+    }
+
+    std::string rangeSelect(const char* head, const char* tail) {
+        size_t begin = randomId();
+        return std::string(head) + " WHERE id >= " + std::to_string(begin) +
+               " AND id < " + std::to_string(begin + options_.range_size) + tail;
+    }
+
+    std::string insert() {
+        return "INSERT INTO sbtest1 (id, k, c, pad) VALUES " + row(next_insert_id_++);
+    }
+
+    std::string row(size_t id) {
+        return "(" + std::to_string(id) + ", " + std::to_string(randomId()) + ", '" +
+               randomString(119) + "', '" + randomString(59) + "')";
+    }
+
+    size_t randomId() {
+        return 1 + rng_() % options_.table_size;
+    }
+
+    // sysbench 的 c/pad 列：以 '-' 分隔的11位数字组
+    std::string randomString(size_t length) {
+        std::string s(length, '-');
+        for (size_t i = 0; i < length; ++i) {
+            if ((i + 1) % 12 != 0) {
+                s[i] = static_cast<char>('0' + rng_() % 10);
+            }
+        }
+        return s;
+    }
+
+    const Options& options_;
+    std::mt19937_64 rng_;
+    size_t next_insert_id_;
+};
+
+// ==================== 延迟统计 ====================
+
+class LatencyRecorder {
+public:
+    void record(uint64_t ns) { samples_.push_back(ns); }
+
+    size_t count() const { return samples_.size(); }
+
+    // 百分位（毫秒），会对样本重新排列
+    double percentileMs(double p) {
+        if (samples_.empty()) {
+            return 0;
+        }
+        size_t rank = std::min(samples_.size() - 1, static_cast<size_t>(p * samples_.size()));
+        std::nth_element(samples_.begin(), samples_.begin() + rank, samples_.end());
+        return static_cast<double>(samples_[rank]) / 1e6;
+    }
+
+    double maxMs() const {
+        return samples_.empty() ? 0 :
+            static_cast<double>(*std::max_element(samples_.begin(), samples_.end())) / 1e6;
+    }
+
+    double avgMs() const {
+        if (samples_.empty()) {
+            return 0;
+        }
+        long double total = 0;
+        for (uint64_t s : samples_) {
+            total += s;
+        }
+        return static_cast<double>(total / samples_.size() / 1e6);
+    }
+
+    void clear() { samples_.clear(); }
+
+private:
+    std::vector<uint64_t> samples_;
+};
+
+// ==================== 连接 ====================
+
+struct Connection {
+    enum class State {
+        CONNECTING,     // 等待非阻塞 connect 完成
+        HANDSHAKE,      // 等待服务器握手包
+        AUTH,           // 已发送认证响应，等待 OK
+        IDLE,
+        QUERY,          // 等待查询结果
+        CLOSED,
+    };
+
+    // 结果集解析阶段
+    enum class Phase { FIRST, COLUMNS, ROWS };
+
+    int fd = -1;
+    State state = State::CONNECTING;
+    Phase phase = Phase::FIRST;
+    uint64_t columns_left = 0;
+    uint64_t start_ns = 0;          // 延迟的起点（开环为计划到达时间）
+    Buffer input;
+    Buffer output;
+    bool want_write = false;
+};
+
+// 读取 payload 中的 lenenc 整数
+uint64_t readLenenc(const uint8_t* p, size_t len) {
+    if (len == 0) {
+        return 0;
+    }
+    if (p[0] < 0xfb) {
+        return p[0];
+    }
+    uint64_t value = 0;
+    size_t bytes = p[0] == 0xfc ? 2 : p[0] == 0xfd ? 3 : 8;
+    for (size_t i = 0; i < bytes && i + 1 < len; ++i) {
+        value |= static_cast<uint64_t>(p[i + 1]) << (8 * i);
+    }
+    return value;
+}
+
+// 结果集结束包：EOF，或 CLIENT_DEPRECATE_EOF 下代替它的 0xFE 开头的 OK 包
+bool isEof(const uint8_t* payload, size_t len) {
+    return len > 0 && len < 9 && payload[0] == 0xfe;
+}
+
+std::string errMessage(const uint8_t* payload, size_t len) {
+    // 0xff + 2字节错误码 + '#' + 5字节 SQLSTATE + 消息
+    uint16_t code = len >= 3 ? static_cast<uint16_t>(payload[1] | (payload[2] << 8)) : 0;
+    std::string message = len > 9 ? std::string(reinterpret_cast<const char*>(payload) + 9, len - 9) : "";
+    return "ERROR " + std::to_string(code) + ": " + message;
+}
+
+// ==================== 负载驱动 ====================
+
+class LoadGenerator {
+public:
+    explicit LoadGenerator(const Options& options)
+        : options_(options), generator_(options), arrival_rng_(options.seed ^ 0x9e3779b97f4a7c15ULL) {}
+
+    ~LoadGenerator() {
+        for (auto& conn : connections_) {
+            if (conn->fd >= 0) {
+                ::close(conn->fd);
+            }
+        }
+        if (timer_fd_ >= 0) {
+            ::close(timer_fd_);
+        }
+        if (epoll_fd_ >= 0) {
+            ::close(epoll_fd_);
+        }
+    }
+
+    bool init() {
+        epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        timer_fd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (epoll_fd_ < 0 || timer_fd_ < 0) {
+            std::perror("epoll/timerfd");
+            return false;
+        }
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr;      // nullptr 表示定时器
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, timer_fd_, &ev);
+
+        if (!options_.socket.empty()) {
+            struct sockaddr_un addr = {};
+            addr.sun_family = AF_UNIX;
+            if (options_.socket.size() >= sizeof(addr.sun_path)) {
+                std::cerr << "Socket path too long: " << options_.socket << std::endl;
+                return false;
+            }
+            std::memcpy(addr.sun_path, options_.socket.c_str(), options_.socket.size());
+            std::memcpy(&addr_, &addr, sizeof(addr));
+            addr_len_ = sizeof(addr);
+            return true;
+        }
+
+        struct addrinfo hints = {};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        struct addrinfo* result = nullptr;
+        if (::getaddrinfo(options_.host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+            std::cerr << "Cannot resolve host: " << options_.host << std::endl;
+            return false;
+        }
+        struct sockaddr_in addr = {};
+        std::memcpy(&addr, result->ai_addr, sizeof(addr));
+        addr.sin_port = htons(options_.port);
+        std::memcpy(&addr_, &addr, sizeof(addr));
+        addr_len_ = sizeof(addr);
+        ::freeaddrinfo(result);
+        return true;
+    }
+
+    /**
+     * 建立 count 个连接并完成认证
+     * @return 认证成功的连接数
+     */
+    size_t connectAll(size_t count) {
+        // 同时进行的握手数，避免一次性发起上千个 SYN 撑满服务器的 accept 队列
+        constexpr size_t kMaxPendingConnects = 128;
+
+        size_t started = 0;
+        while (true) {
+            while (started < count && pending_connects_ < kMaxPendingConnects) {
+                startConnect();
+                started++;
+            }
+            if (pending_connects_ == 0) {
+                break;
+            }
+            poll(1000);
+        }
+
+        size_t ready = 0;
+        for (auto& conn : connections_) {
+            if (conn->state == Connection::State::IDLE) {
+                ready++;
+            }
+        }
+        return ready;
+    }
+
+    /**
+     * 在一个连接上依次执行语句（装载数据用）
+     * @return 全部成功时返回true；ignore_first_error 为 true 时第一条的错误被忽略
+     */
+    bool runScript(const std::vector<std::string>& statements, bool ignore_first_error) {
+        Connection* conn = idleConnection();
+        if (!conn) {
+            return false;
+        }
+        for (size_t i = 0; i < statements.size(); ++i) {
+            script_error_.clear();
+            sendQuery(*conn, statements[i], nowNs());
+            while (conn->state == Connection::State::QUERY) {
+                poll(1000);
+            }
+            if (conn->state == Connection::State::CLOSED) {
+                std::cerr << "Connection lost while running: " << statements[i].substr(0, 80) << std::endl;
+                return false;
+            }
+            if (!script_error_.empty() && !(i == 0 && ignore_first_error)) {
+                std::cerr << script_error_ << "\n  in: " << statements[i].substr(0, 80) << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 施加负载并输出报告
+    void run() {
+        uint64_t start = nowNs();
+        measure_start_ns_ = start + static_cast<uint64_t>(options_.warmup * 1e9);
+        uint64_t end = measure_start_ns_ + static_cast<uint64_t>(options_.duration * 1e9);
+        uint64_t report_ns = static_cast<uint64_t>(options_.report_interval * 1e9);
+        uint64_t next_report = report_ns > 0 ? start + report_ns : UINT64_MAX;
+        open_loop_ = options_.rate > 0;
+        running_ = true;
+
+        if (open_loop_) {
+            next_arrival_ns_ = start;
+            idle_.clear();
+            for (auto& conn : connections_) {
+                if (conn->state == Connection::State::IDLE) {
+                    idle_.push_back(conn.get());
+                }
+            }
+        } else {
+            for (auto& conn : connections_) {
+                if (conn->state == Connection::State::IDLE) {
+                    sendQuery(*conn, generator_.next(), start);
+                }
+            }
+        }
+
+        uint64_t interval_start = start;
+        while (true) {
+            uint64_t now = nowNs();
+            if (now >= end) {
+                break;
+            }
+            if (open_loop_) {
+                releaseArrivals(now, end);
+            }
+            if (now >= next_report) {
+                reportInterval(now - start, now - interval_start);
+                interval_start = now;
+                next_report += report_ns;
+            }
+            poll(10);
+        }
+        running_ = false;
+        elapsed_ns_ = end - std::max(measure_start_ns_, start);
+        report();
+    }
+
+private:
+    void startConnect() {
+        connections_.push_back(std::make_unique<Connection>());
+        Connection& conn = *connections_.back();
+        pending_connects_++;
+
+        conn.fd = ::socket(addr_.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (conn.fd < 0) {
+            std::perror("socket");
+            closeConnection(conn);
+            return;
+        }
+        if (addr_.ss_family == AF_INET) {
+            int one = 1;
+            ::setsockopt(conn.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+
+        int rc = ::connect(conn.fd, reinterpret_cast<struct sockaddr*>(&addr_), addr_len_);
+        if (rc < 0 && errno != EINPROGRESS) {
+            std::perror("connect");
+            closeConnection(conn);
+            return;
+        }
+
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN | EPOLLOUT;
+        ev.data.ptr = &conn;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, conn.fd, &ev);
+        conn.want_write = true;
+    }
+
+    Connection* idleConnection() {
+        for (auto& conn : connections_) {
+            if (conn->state == Connection::State::IDLE) {
+                return conn.get();
+            }
+        }
+        return nullptr;
+    }
+
+    void poll(int timeout_ms) {
+        struct epoll_event events[256];
+        int n = ::epoll_wait(epoll_fd_, events, 256, timeout_ms);
+        for (int i = 0; i < n; ++i) {
+            auto* conn = static_cast<Connection*>(events[i].data.ptr);
+            if (!conn) {
+                uint64_t expirations;
+                while (::read(timer_fd_, &expirations, sizeof(expirations)) > 0) {
+                }
+                continue;
+            }
+            if (conn->state == Connection::State::CONNECTING) {
+                onConnected(*conn);
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                onReadable(*conn);
+            }
+            if (conn->state != Connection::State::CLOSED && (events[i].events & EPOLLOUT)) {
+                flush(*conn);
+            }
+        }
+    }
+
+    void onConnected(Connection& conn) {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        ::getsockopt(conn.fd, SOL_SOCKET, SO_ERROR, &error, &len);
+        if (error != 0) {
+            std::cerr << "connect: " << std::strerror(error) << std::endl;
+            closeConnection(conn);
+            return;
+        }
+        conn.state = Connection::State::HANDSHAKE;
+        setWantWrite(conn, false);
+    }
+
+    void setWantWrite(Connection& conn, bool want) {
+        if (conn.want_write == want) {
+            return;
+        }
+        conn.want_write = want;
+        struct epoll_event ev = {};
+        ev.events = want ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        ev.data.ptr = &conn;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn.fd, &ev);
+    }
+
+    void flush(Connection& conn) {
+        while (conn.output.readableBytes() > 0) {
+            ssize_t n = ::send(conn.fd, conn.output.peek(), conn.output.readableBytes(), MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    setWantWrite(conn, true);
+                    return;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                closeConnection(conn);
+                return;
+            }
+            conn.output.skip(static_cast<size_t>(n));
+        }
+        conn.output.reset();
+        setWantWrite(conn, false);
+    }
+
+    void onReadable(Connection& conn) {
+        uint8_t buf[65536];
+        while (true) {
+            ssize_t n = ::recv(conn.fd, buf, sizeof(buf), 0);
+            if (n > 0) {
+                conn.input.append(buf, static_cast<size_t>(n));
+                if (static_cast<size_t>(n) < sizeof(buf)) {
+                    break;
+                }
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            closeConnection(conn);
+            return;
+        }
+
+        // 按包处理
+        while (conn.state != Connection::State::CLOSED && conn.input.readableBytes() >= 4) {
+            const uint8_t* data = conn.input.peek();
+            size_t payload_len = data[0] | (data[1] << 8) | (data[2] << 16);
+            if (conn.input.readableBytes() < 4 + payload_len) {
+                break;
+            }
+            onPacket(conn, data, payload_len);
+            if (conn.state != Connection::State::CLOSED) {
+                conn.input.skip(4 + payload_len);
+            }
+        }
+        if (conn.state != Connection::State::CLOSED && conn.input.readableBytes() == 0) {
+            conn.input.reset();
+        }
+    }
+
+    void onPacket(Connection& conn, const uint8_t* packet, size_t len) {
+        const uint8_t* payload = packet + 4;
+        switch (conn.state) {
+            case Connection::State::HANDSHAKE:
+                onHandshake(conn, packet, len);
+                break;
+
+            case Connection::State::AUTH:
+                if (len > 0 && payload[0] == 0x00) {
+                    pending_connects_--;
+                    conn.state = Connection::State::IDLE;
+                } else {
+                    std::cerr << "Authentication failed: "
+                              << (len > 0 && payload[0] == 0xff ? errMessage(payload, len) : "unsupported auth method")
+                              << std::endl;
+                    closeConnection(conn);
+                }
+                break;
+
+            case Connection::State::QUERY:
+                onQueryPacket(conn, payload, len);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    void onHandshake(Connection& conn, const uint8_t* packet, size_t len) {
+        if (len > 0 && packet[4] == 0xff) {
+            std::cerr << "Connection refused: " << errMessage(packet + 4, len) << std::endl;
+            closeConnection(conn);
+            return;
+        }
+
+        Buffer buffer;
+        buffer.append(packet, 4 + len);
+        HandshakeV10Packet handshake;
+        if (!handshake.decode(buffer)) {
+            std::cerr << "Malformed handshake" << std::endl;
+            closeConnection(conn);
+            return;
+        }
+
+        HandshakeResponse41Packet response;
+        uint32_t flags = CapabilityFlags::CLIENT_LONG_PASSWORD | CapabilityFlags::CLIENT_LONG_FLAG |
+                         CapabilityFlags::CLIENT_PROTOCOL_41 | CapabilityFlags::CLIENT_TRANSACTIONS |
+                         CapabilityFlags::CLIENT_SECURE_CONNECTION | CapabilityFlags::CLIENT_PLUGIN_AUTH |
+                         CapabilityFlags::CLIENT_DEPRECATE_EOF;
+        if (!options_.database.empty()) {
+            flags |= CapabilityFlags::CLIENT_CONNECT_WITH_DB;
+            response.setDatabase(options_.database);
+        }
+        response.setCapabilityFlags(flags);
+        response.setMaxPacketSize(16 * 1024 * 1024);
+        response.setCharacterSet(Charset::UTF8MB4_GENERAL_CI);
+        response.setUsername(options_.user);
+        response.setAuthResponse(
+            Authenticator::computeAuthResponse(options_.password, handshake.getAuthPluginData()));
+        response.setAuthPluginName("mysql_native_password");
+        response.encode(conn.output, static_cast<uint8_t>(packet[3] + 1));
+
+        conn.state = Connection::State::AUTH;
+        flush(conn);
+    }
+
+    void onQueryPacket(Connection& conn, const uint8_t* payload, size_t len) {
+        switch (conn.phase) {
+            case Connection::Phase::FIRST:
+                if (len > 0 && payload[0] == 0x00) {
+                    complete(conn, true, nullptr, 0);
+                } else if (len > 0 && payload[0] == 0xff) {
+                    complete(conn, false, payload, len);
+                } else {
+                    conn.columns_left = readLenenc(payload, len);
+                    conn.phase = Connection::Phase::COLUMNS;
+                }
+                break;
+
+            case Connection::Phase::COLUMNS:
+                // 协商了 CLIENT_DEPRECATE_EOF：列定义之后直接是行数据，没有 EOF 包
+                if (conn.columns_left == 0 || --conn.columns_left == 0) {
+                    conn.phase = Connection::Phase::ROWS;
+                }
+                break;
+
+            case Connection::Phase::ROWS:
+                if (isEof(payload, len)) {
+                    complete(conn, true, nullptr, 0);
+                } else if (len > 0 && payload[0] == 0xff) {
+                    complete(conn, false, payload, len);
+                }
+                break;
+        }
+    }
+
+    void sendQuery(Connection& conn, const std::string& sql, uint64_t start_ns) {
+        uint32_t payload_len = static_cast<uint32_t>(sql.size() + 1);
+        conn.output.writeUint8(static_cast<uint8_t>(payload_len & 0xff));
+        conn.output.writeUint8(static_cast<uint8_t>((payload_len >> 8) & 0xff));
+        conn.output.writeUint8(static_cast<uint8_t>((payload_len >> 16) & 0xff));
+        conn.output.writeUint8(0);
+        conn.output.writeUint8(0x03);      // COM_QUERY
+        conn.output.writeString(sql);
+
+        conn.state = Connection::State::QUERY;
+        conn.phase = Connection::Phase::FIRST;
+        conn.start_ns = start_ns;
+        flush(conn);
+    }
+
+    void complete(Connection& conn, bool ok, const uint8_t* err, size_t err_len) {
+        uint64_t now = nowNs();
+        conn.state = Connection::State::IDLE;
+
+        if (!ok) {
+            std::string message = errMessage(err, err_len);
+            if (!running_) {
+                script_error_ = message;
+            } else if (errors_ < 5) {
+                std::cerr << message << std::endl;
+            }
+        }
+        if (running_ && conn.start_ns >= measure_start_ns_) {
+            if (ok) {
+                latencies_.record(now - conn.start_ns);
+                interval_latencies_.record(now - conn.start_ns);
+            } else {
+                errors_++;
+                interval_errors_++;
+            }
+        }
+
+        if (!running_) {
+            return;
+        }
+        if (!open_loop_) {
+            sendQuery(conn, generator_.next(), now);
+        } else if (!backlog_.empty()) {
+            uint64_t arrival = backlog_.front();
+            backlog_.pop_front();
+            sendQuery(conn, generator_.next(), arrival);
+        } else {
+            idle_.push_back(&conn);
+        }
+    }
+
+    // 开环：放出所有已到达的请求，并把定时器设到下一次到达
+    void releaseArrivals(uint64_t now, uint64_t end) {
+        std::exponential_distribution<double> gap(options_.rate / 1e9);
+        while (next_arrival_ns_ <= now && next_arrival_ns_ < end) {
+            Connection* conn = nullptr;
+            while (!idle_.empty() && !conn) {
+                conn = idle_.back();
+                idle_.pop_back();
+                if (conn->state != Connection::State::IDLE) {
+                    conn = nullptr;
+                }
+            }
+            if (conn) {
+                sendQuery(*conn, generator_.next(), next_arrival_ns_);
+            } else {
+                backlog_.push_back(next_arrival_ns_);
+            }
+            next_arrival_ns_ += static_cast<uint64_t>(gap(arrival_rng_)) + 1;
+        }
+
+        struct itimerspec spec = {};
+        spec.it_value.tv_sec = static_cast<time_t>(next_arrival_ns_ / 1000000000);
+        spec.it_value.tv_nsec = static_cast<long>(next_arrival_ns_ % 1000000000);
+        ::timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+    }
+
+    void closeConnection(Connection& conn) {
+        switch (conn.state) {
+            case Connection::State::CONNECTING:
+            case Connection::State::HANDSHAKE:
+            case Connection::State::AUTH:
+                pending_connects_--;
+                break;
+            case Connection::State::QUERY:
+                if (running_) {
+                    errors_++;
+                    interval_errors_++;
+                }
+                break;
+            default:
+                break;
+        }
+        if (conn.fd >= 0) {
+            ::close(conn.fd);      // 关闭 fd 会自动从 epoll 中移除
+            conn.fd = -1;
+        }
+        conn.state = Connection::State::CLOSED;
+    }
+
+    size_t activeConnections() const {
+        size_t active = 0;
+        for (const auto& conn : connections_) {
+            active += conn->state != Connection::State::CLOSED;
+        }
+        return active;
+    }
+
+    void reportInterval(uint64_t since_start_ns, uint64_t interval_ns) {
+        double seconds = static_cast<double>(interval_ns) / 1e9;
+        std::printf("[ %5.1fs ] conns: %zu  qps: %.1f  lat(ms) p50: %.3f  p99: %.3f  err/s: %.1f  backlog: %zu\n",
+                    static_cast<double>(since_start_ns) / 1e9, activeConnections(),
+                    static_cast<double>(interval_latencies_.count()) / seconds,
+                    interval_latencies_.percentileMs(0.50), interval_latencies_.percentileMs(0.99),
+                    static_cast<double>(interval_errors_) / seconds, backlog_.size());
+        std::fflush(stdout);
+        interval_latencies_.clear();
+        interval_errors_ = 0;
+    }
+
+    void report() {
+        static const char* kWorkloadNames[] = {"point", "range", "insert", "oltp"};
+        double seconds = static_cast<double>(elapsed_ns_) / 1e9;
+        size_t in_flight = 0;
+        for (const auto& conn : connections_) {
+            in_flight += conn->state == Connection::State::QUERY;
+        }
+
+        std::printf("\nworkload:        %s (%s)\n", kWorkloadNames[static_cast<int>(options_.workload)],
+                    open_loop_ ? "open loop" : "closed loop");
+        std::printf("connections:     %zu\n", activeConnections());
+        if (open_loop_) {
+            std::printf("target rate:     %.1f/s\n", options_.rate);
+        }
+        std::printf("duration:        %.2fs\n", seconds);
+        std::printf("queries:         %zu\n", latencies_.count());
+        std::printf("errors:          %" PRIu64 "\n", errors_);
+        std::printf("qps:             %.1f\n", static_cast<double>(latencies_.count()) / seconds);
+        std::printf("latency (ms):\n");
+        std::printf("  avg:           %.3f\n", latencies_.avgMs());
+        std::printf("  p50:           %.3f\n", latencies_.percentileMs(0.50));
+        std::printf("  p99:           %.3f\n", latencies_.percentileMs(0.99));
+        std::printf("  p999:          %.3f\n", latencies_.percentileMs(0.999));
+        std::printf("  max:           %.3f\n", latencies_.maxMs());
+        std::printf("unfinished:      %zu in flight, %zu queued\n", in_flight, backlog_.size());
+    }
+
+    const Options& options_;
+    QueryGenerator generator_;
+    std::mt19937_64 arrival_rng_;
+
+    int epoll_fd_ = -1;
+    int timer_fd_ = -1;
+    struct sockaddr_storage addr_ = {};
+    socklen_t addr_len_ = 0;
+    std::vector<std::unique_ptr<Connection>> connections_;
+    size_t pending_connects_ = 0;
+
+    bool running_ = false;
+    bool open_loop_ = false;
+    uint64_t measure_start_ns_ = 0;
+    uint64_t elapsed_ns_ = 0;
+    uint64_t next_arrival_ns_ = 0;
+    std::vector<Connection*> idle_;         // 开环：等待请求的空闲连接
+    std::deque<uint64_t> backlog_;          // 开环：没有空闲连接时排队的请求（计划到达时间）
+
+    LatencyRecorder latencies_;
+    LatencyRecorder interval_latencies_;
+    uint64_t errors_ = 0;
+    uint64_t interval_errors_ = 0;
+    std::string script_error_;
+};
+
+// 上千个连接需要提高文件描述符上限
+void raiseFdLimit(size_t connections) {
+    struct rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return;
+    }
+    if (limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    if (limit.rlim_cur != RLIM_INFINITY && connections + 16 > limit.rlim_cur) {
+        std::cerr << "Warning: open file limit " << limit.rlim_cur << " is below "
+                  << connections << " connections" << std::endl;
+    }
+}
+
+// 建表并装载数据
+int prepare(const Options& options) {
+    LoadGenerator loader(options);
+    if (!loader.init() || loader.connectAll(1) != 1) {
+        return 1;
+    }
+
+    constexpr size_t kBatchRows = 500;
+    QueryGenerator generator(options);
+    std::vector<std::string> statements = {
+        "DROP TABLE sbtest1",
+        "CREATE TABLE sbtest1 (id INT PRIMARY KEY, k INT NOT NULL, c VARCHAR(120) NOT NULL, "
+        "pad VARCHAR(60) NOT NULL)",
+    };
+    for (size_t first = 1; first <= options.table_size; first += kBatchRows) {
+        statements.push_back(generator.loadBatch(first, std::min(options.table_size, first + kBatchRows - 1)));
+    }
+    statements.push_back("CREATE INDEX k_1 ON sbtest1 (k)");
+    statements.push_back("ANALYZE TABLE sbtest1");
+
+    uint64_t start = nowNs();
+    if (!loader.runScript(statements, true)) {
+        return 1;
+    }
+    std::printf("Loaded %zu rows into %s.sbtest1 in %.2fs\n", options.table_size,
+                options.database.c_str(), static_cast<double>(nowNs() - start) / 1e9);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    if (options.prepare) {
+        return prepare(options);
+    }
+
+    raiseFdLimit(options.connections);
+    LoadGenerator generator(options);
+    if (!generator.init()) {
+        return 1;
+    }
+
+    uint64_t start = nowNs();
+    size_t ready = generator.connectAll(options.connections);
+    std::printf("Connected %zu/%zu in %.2fs\n", ready, options.connections,
+                static_cast<double>(nowNs() - start) / 1e9);
+    if (ready == 0) {
+        return 1;
+    }
+
+    generator.run();
+    return 0;
+}
@@ -0,0 +1,324 @@
+/**
+ * tiny-sql 微基准测试
+ * Microbenchmarks for the hot paths of tiny-sql
+ *
+ * 覆盖协议缓冲区、词法/语法分析、WHERE 求值、值比较、插入和结果集编码。
+ * 用 `cmake --build <dir> --target bench-json` 运行并把结果写成 JSON，
+ * 便于在版本之间对比；也可以直接运行 tiny-sql-bench 并传入 google-benchmark 的参数。
+ */
+
+#include "tiny_sql/common/buffer.h"
+#include "tiny_sql/protocol/response.h"
+#include "tiny_sql/sql/lexer.h"
+#include "tiny_sql/sql/parser.h"
+#include "tiny_sql/storage/expression_evaluator.h"
+#include "tiny_sql/storage/table.h"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace tiny_sql;
+
+namespace {
+
+// 有代表性的语句：点查、范围+排序、连接、聚合、多行插入、更新
+const std::vector<std::string> kQueries = {
+    "SELECT * FROM users WHERE id = 42",
+    "SELECT id, name, age FROM users WHERE age > 18 AND age < 65 ORDER BY name LIMIT 100",
+    "SELECT u.name, o.amount FROM users u JOIN orders o ON u.id = o.user_id WHERE o.amount >= 100",
+    "SELECT dept, COUNT(*), AVG(salary) FROM employees GROUP BY dept HAVING COUNT(*) > 5",
+    "INSERT INTO users (id, name, age) VALUES (1, 'alice', 30), (2, 'bob', 25), (3, 'carol', 41)",
+    "UPDATE users SET age = age + 1 WHERE name = 'alice' OR id IN (1, 2, 3)",
+};
+
+std::vector<ColumnDef> userColumns() {
+    ColumnDef id("id", DataType::INT);
+    id.primary_key = true;
+    return {id, ColumnDef("name", DataType::VARCHAR), ColumnDef("age", DataType::INT),
+            ColumnDef("score", DataType::DOUBLE)};
+}
+
+Row userRow(int32_t id) {
+    std::vector<Value> values;
+    values.reserve(4);
+    values.emplace_back(id);
+    values.emplace_back("user_" + std::to_string(id));
+    values.emplace_back(static_cast<int32_t>(18 + id % 50));
+    values.emplace_back(id * 0.5);
+    return Row(std::move(values));
+}
+
+// 从 SELECT 语句中取出 WHERE 表达式
+std::unique_ptr<Statement> parseWhere(const std::string& where, const Expression*& expr) {
+    Parser parser("SELECT * FROM users WHERE " + where);
+    auto stmt = parser.parse();
+    expr = static_cast<const SelectStatement*>(stmt.get())->getWhereClause();
+    return stmt;
+}
+
+} // namespace
+
+// ==================== Buffer ====================
+
+static void BM_BufferWriteRead(benchmark::State& state) {
+    Buffer buffer;
+    for (auto _ : state) {
+        for (uint32_t i = 0; i < 64; ++i) {
+            buffer.writeUint8(static_cast<uint8_t>(i));
+            buffer.writeUint16(static_cast<uint16_t>(i));
+            buffer.writeUint32(i);
+            buffer.writeUint64(i);
+        }
+        for (uint32_t i = 0; i < 64; ++i) {
+            benchmark::DoNotOptimize(buffer.readUint8());
+            benchmark::DoNotOptimize(buffer.readUint16());
+            benchmark::DoNotOptimize(buffer.readUint32());
+            benchmark::DoNotOptimize(buffer.readUint64());
+        }
+        buffer.reset();
+    }
+    state.SetBytesProcessed(state.iterations() * 64 * 15);
+}
+BENCHMARK(BM_BufferWriteRead);
+
+// lenenc 整数：参数为取值，覆盖 1/3/4/9 字节四种编码
+static void BM_LenencInt(benchmark::State& state) {
+    const uint64_t value = static_cast<uint64_t>(state.range(0));
+    Buffer buffer;
+    for (auto _ : state) {
+        for (int i = 0; i < 64; ++i) {
+            buffer.writeLenencInt(value);
+        }
+        for (int i = 0; i < 64; ++i) {
+            benchmark::DoNotOptimize(buffer.readLenencInt());
+        }
+        buffer.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_LenencInt)->Arg(200)->Arg(60000)->Arg(1 << 20)->Arg(int64_t(1) << 32);
+
+static void BM_LenencString(benchmark::State& state) {
+    const std::string value(static_cast<size_t>(state.range(0)), 'x');
+    Buffer buffer;
+    for (auto _ : state) {
+        for (int i = 0; i < 16; ++i) {
+            buffer.writeLenencString(value);
+        }
+        for (int i = 0; i < 16; ++i) {
+            benchmark::DoNotOptimize(buffer.readLenencString());
+        }
+        buffer.reset();
+    }
+    state.SetBytesProcessed(state.iterations() * 16 * state.range(0));
+}
+BENCHMARK(BM_LenencString)->Arg(8)->Arg(256)->Arg(4096);
+
+// 每条命令临时构造的响应缓冲区：构造、写一个 OK 包、析构（存储来自线程局部池）
+static void BM_BufferPerCommand(benchmark::State& state) {
+    for (auto _ : state) {
+        Buffer response;
+        OkPacket packet(1, 42, 0x0002, 0);
+        packet.encode(response, 1);
+        benchmark::DoNotOptimize(response.peek());
+    }
+}
+BENCHMARK(BM_BufferPerCommand);
+
+// ==================== Lexer / Parser ====================
+
+static void BM_Lexer(benchmark::State& state) {
+    const std::string& sql = kQueries[static_cast<size_t>(state.range(0))];
+    for (auto _ : state) {
+        Lexer lexer(sql);
+        benchmark::DoNotOptimize(lexer.tokenize());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(sql.size()));
+}
+BENCHMARK(BM_Lexer)->DenseRange(0, static_cast<int>(kQueries.size()) - 1);
+
+static void BM_Parser(benchmark::State& state) {
+    const std::string& sql = kQueries[static_cast<size_t>(state.range(0))];
+    for (auto _ : state) {
+        Parser parser(sql);
+        auto stmt = parser.parse();
+        if (!stmt) {
+            state.SkipWithError("parse failed");
+            break;
+        }
+        benchmark::DoNotOptimize(stmt);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(sql.size()));
+}
+BENCHMARK(BM_Parser)->DenseRange(0, static_cast<int>(kQueries.size()) - 1);
+
+// ==================== ExpressionEvaluator ====================
+
+static void BM_EvaluateWhere(benchmark::State& state) {
+    static const std::vector<std::string> kWheres = {
+        "id = 42",
+        "age > 18 AND age < 65",
+        "name = 'user_7' OR score >= 100.5",
+        "id IN (1, 2, 3, 5, 8, 13, 21)",
+        "name LIKE 'user_1%' AND NOT age = 30",
+    };
+    const Expression* where = nullptr;
+    auto stmt = parseWhere(kWheres[static_cast<size_t>(state.range(0))], where);
+    if (!where) {
+        state.SkipWithError("parse failed");
+        return;
+    }
+
+    auto columns = userColumns();
+    std::vector<Row> rows;
+    for (int32_t i = 0; i < 1024; ++i) {
+        rows.push_back(userRow(i));
+    }
+
+    for (auto _ : state) {
+        size_t matched = 0;
+        for (const auto& row : rows) {
+            matched += ExpressionEvaluator::evaluate(where, row, columns);
+        }
+        benchmark::DoNotOptimize(matched);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(rows.size()));
+}
+BENCHMARK(BM_EvaluateWhere)->DenseRange(0, 4);
+
+// ==================== Value ====================
+
+static void BM_ValueCompareInt(benchmark::State& state) {
+    std::vector<Value> values;
+    for (int32_t i = 0; i < 1024; ++i) {
+        values.emplace_back(static_cast<int32_t>((i * 7919) % 1024));
+    }
+    for (auto _ : state) {
+        int sum = 0;
+        for (size_t i = 1; i < values.size(); ++i) {
+            sum += values[i - 1].compare(values[i]);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 1023);
+}
+BENCHMARK(BM_ValueCompareInt);
+
+static void BM_ValueCompareMixedNumeric(benchmark::State& state) {
+    std::vector<Value> values;
+    for (int32_t i = 0; i < 1024; ++i) {
+        if (i % 2 == 0) {
+            values.emplace_back(static_cast<int64_t>(i));
+        } else {
+            values.emplace_back(i + 0.5);
+        }
+    }
+    for (auto _ : state) {
+        int sum = 0;
+        for (size_t i = 1; i < values.size(); ++i) {
+            sum += values[i - 1] < values[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 1023);
+}
+BENCHMARK(BM_ValueCompareMixedNumeric);
+
+static void BM_ValueCompareString(benchmark::State& state) {
+    std::vector<Value> values;
+    for (int32_t i = 0; i < 1024; ++i) {
+        values.emplace_back(std::string("customer_") + std::to_string((i * 7919) % 1024));
+    }
+    for (auto _ : state) {
+        int sum = 0;
+        for (size_t i = 1; i < values.size(); ++i) {
+            sum += values[i - 1] == values[i];
+            sum += values[i - 1] < values[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 1023);
+}
+BENCHMARK(BM_ValueCompareString);
+
+// ==================== Table ====================
+
+// 每次迭代向新表插入 range(0) 行（带主键，走唯一约束的哈希索引）
+static void BM_TableInsertRow(benchmark::State& state) {
+    const int32_t count = static_cast<int32_t>(state.range(0));
+    auto columns = userColumns();
+    std::vector<Row> rows;
+    for (int32_t i = 0; i < count; ++i) {
+        rows.push_back(userRow(i));
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto table = std::make_unique<Table>("users");
+        for (const auto& column : columns) {
+            table->addColumn(column);
+        }
+        state.ResumeTiming();
+
+        for (const auto& row : rows) {
+            table->insertRow(row, 1);
+        }
+
+        state.PauseTiming();
+        table.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_TableInsertRow)->Arg(1024)->Arg(16384);
+
+// ==================== 包编码 ====================
+
+static void BM_EncodeOkPacket(benchmark::State& state) {
+    Buffer buffer;
+    for (auto _ : state) {
+        OkPacket packet(1, 42, 0x0002, 0);
+        packet.encode(buffer, 1);
+        buffer.reset();
+    }
+}
+BENCHMARK(BM_EncodeOkPacket);
+
+static void BM_EncodeColumnDefinitions(benchmark::State& state) {
+    auto columns = userColumns();
+    Buffer buffer;
+    for (auto _ : state) {
+        uint8_t sequence_id = 1;
+        for (const auto& column : columns) {
+            ColumnDefinitionPacket::fromColumnDef(column, "users", "test").encode(buffer, sequence_id++);
+        }
+        buffer.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(columns.size()));
+}
+BENCHMARK(BM_EncodeColumnDefinitions);
+
+// 结果集行：每次迭代编码 range(0) 行
+static void BM_EncodeResultRows(benchmark::State& state) {
+    std::vector<Row> rows;
+    for (int32_t i = 0; i < state.range(0); ++i) {
+        rows.push_back(userRow(i));
+    }
+    Buffer buffer;
+    for (auto _ : state) {
+        uint8_t sequence_id = 3;
+        for (const auto& row : rows) {
+            TextResultRowPacket(row).encode(buffer, sequence_id++);
+        }
+        state.counters["bytes_per_row"] =
+            static_cast<double>(buffer.readableBytes()) / static_cast<double>(rows.size());
+        buffer.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_EncodeResultRows)->Arg(1)->Arg(1000);
+
+BENCHMARK_MAIN();
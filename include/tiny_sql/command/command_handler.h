@@ -5,6 +5,7 @@
 #include "tiny_sql/common/types.h"
 #include <memory>
 #include <functional>
+#include <vector>
 
 namespace tiny_sql {
 
@@ -12,18 +13,35 @@ namespace tiny_sql {
 class TcpConnection;
 class SelectStatement;
 class InsertStatement;
+class UpdateStatement;
+class DeleteStatement;
 class CreateTableStatement;
 class DropTableStatement;
 class ShowTablesStatement;
 class ShowDatabasesStatement;
+class ShowStatusStatement;
+class ShowQueryDigestsStatement;
+class ShowProcesslistStatement;
+class KillStatement;
 class UseDatabaseStatement;
+class TransactionStatement;
+class CreateIndexStatement;
+class AnalyzeTableStatement;
+class ExplainStatement;
+class QueryProfile;
+class Table;
+class Row;
+struct ColumnDef;
 
 /**
  * 命令处理器基类
  */
 class CommandHandler {
 public:
+    // 响应回调：传入的 Buffer 被移入输出队列，返回后为空
     using ResponseCallback = std::function<void(Buffer&)>;
+    // 写出已排队的响应
+    using FlushCallback = std::function<void()>;
 
     virtual ~CommandHandler() = default;
 
@@ -73,16 +91,50 @@ public:
                       Session& session,
                       ResponseCallback response_callback) override;
 
+    // SHOW [FULL] PROCESSLIST（COM_PROCESS_INFO 也走这里）
+    bool executeShowProcesslist(const ShowProcesslistStatement* stmt,
+                               Session& session,
+                               ResponseCallback response_callback);
+
+    // KILL [QUERY | CONNECTION] id（COM_PROCESS_KILL 也走这里）
+    bool executeKill(const KillStatement* stmt,
+                    Session& session,
+                    ResponseCallback response_callback);
+
 private:
     // SQL执行方法
+    // profile 非空时为 EXPLAIN [ANALYZE]：返回计划树（及各算子统计）而不是结果行
     bool executeSelect(const SelectStatement* stmt,
                       Session& session,
-                      ResponseCallback response_callback);
+                      ResponseCallback response_callback,
+                      QueryProfile* profile);
+
+    // 带聚合函数或GROUP BY的SELECT（rows/columns 为单表或连接结果）
+    bool executeAggregateSelect(const SelectStatement* stmt,
+                               const std::vector<Row>& rows,
+                               const std::vector<ColumnDef>& columns,
+                               const std::string& table_name,
+                               const std::string& db_name,
+                               Session& session,
+                               ResponseCallback response_callback,
+                               QueryProfile* profile);
+
+    bool executeExplain(const ExplainStatement* stmt,
+                       Session& session,
+                       ResponseCallback response_callback);
 
     bool executeInsert(const InsertStatement* stmt,
                       Session& session,
                       ResponseCallback response_callback);
 
+    bool executeUpdate(const UpdateStatement* stmt,
+                      Session& session,
+                      ResponseCallback response_callback);
+
+    bool executeDelete(const DeleteStatement* stmt,
+                      Session& session,
+                      ResponseCallback response_callback);
+
     bool executeCreateTable(const CreateTableStatement* stmt,
                            Session& session,
                            ResponseCallback response_callback);
@@ -91,15 +143,38 @@ private:
                          Session& session,
                          ResponseCallback response_callback);
 
+    bool executeCreateIndex(const CreateIndexStatement* stmt,
+                           Session& session,
+                           ResponseCallback response_callback);
+
+    bool executeAnalyzeTable(const AnalyzeTableStatement* stmt,
+                            Session& session,
+                            ResponseCallback response_callback);
+
     bool executeShowTables(Session& session,
                           ResponseCallback response_callback);
 
     bool executeShowDatabases(Session& session,
                              ResponseCallback response_callback);
 
+    // SHOW [GLOBAL] STATUS [LIKE 'pattern']：指标注册表中的状态变量
+    bool executeShowStatus(const ShowStatusStatement* stmt,
+                          Session& session,
+                          ResponseCallback response_callback);
+
+    // SHOW QUERY DIGESTS [LIMIT n]：按总耗时排序的语句摘要
+    bool executeShowQueryDigests(const ShowQueryDigestsStatement* stmt,
+                                Session& session,
+                                ResponseCallback response_callback);
+
     bool executeUseDatabase(const UseDatabaseStatement* stmt,
                            Session& session,
                            ResponseCallback response_callback);
+
+    // BEGIN / START TRANSACTION / COMMIT / ROLLBACK
+    bool executeTransaction(const TransactionStatement* stmt,
+                           Session& session,
+                           ResponseCallback response_callback);
 };
 
 /**
@@ -127,11 +202,13 @@ public:
      * @param buffer 包含完整MySQL包的缓冲区
      * @param session 会话对象
      * @param response_callback 响应回调
+     * @param flush_callback 写出已排队响应的回调（COM_QUERY 在语句统计结束前调用）
      * @return 是否成功处理
      */
     bool dispatch(Buffer& buffer,
                  Session& session,
-                 CommandHandler::ResponseCallback response_callback);
+                 CommandHandler::ResponseCallback response_callback,
+                 CommandHandler::FlushCallback flush_callback = nullptr);
 
 private:
     std::unique_ptr<PingCommandHandler> ping_handler_;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "tiny_sql/common/buffer_pool.h"
+
 #include <vector>
 #include <string>
 #include <cstring>
@@ -8,24 +10,72 @@
 
 namespace tiny_sql {
 
+/**
+ * 协议缓冲区
+ * 存储从线程局部的 BufferPool 按级别取用，析构时归还；默认构造不分配，
+ * 第一次写入时才取存储，因此每条命令临时构造的 Buffer 不再各自 malloc 4KB。
+ * Storage comes from the thread-local BufferPool and goes back on destruction;
+ * a default-constructed Buffer allocates nothing until the first write.
+ */
 class Buffer {
 public:
-    Buffer() : read_index_(0), write_index_(0) {
-        data_.reserve(4096);  // 预分配4KB
-    }
+    Buffer() : read_index_(0), write_index_(0) {}
 
-    explicit Buffer(size_t initial_size) : read_index_(0), write_index_(0) {
-        data_.reserve(initial_size);
-    }
+    explicit Buffer(size_t initial_size)
+        : data_(BufferPool::acquire(initial_size)), read_index_(0), write_index_(0) {}
 
     explicit Buffer(const std::vector<uint8_t>& data)
-        : data_(data), read_index_(0), write_index_(data.size()) {}
+        : data_(BufferPool::acquire(data.size())), read_index_(0), write_index_(data.size()) {
+        data_.assign(data.begin(), data.end());
+    }
 
     explicit Buffer(const std::string& str)
-        : read_index_(0), write_index_(str.size()) {
+        : data_(BufferPool::acquire(str.size())), read_index_(0), write_index_(str.size()) {
         data_.assign(str.begin(), str.end());
     }
 
+    Buffer(const Buffer& other)
+        : data_(BufferPool::acquire(other.data_.size()))
+        , read_index_(other.read_index_)
+        , write_index_(other.write_index_) {
+        data_.assign(other.data_.begin(), other.data_.end());
+    }
+
+    Buffer(Buffer&& other) noexcept
+        : data_(std::move(other.data_))
+        , read_index_(other.read_index_)
+        , write_index_(other.write_index_) {
+        other.data_.clear();
+        other.read_index_ = 0;
+        other.write_index_ = 0;
+    }
+
+    Buffer& operator=(const Buffer& other) {
+        if (this != &other) {
+            data_.assign(other.data_.begin(), other.data_.end());
+            read_index_ = other.read_index_;
+            write_index_ = other.write_index_;
+        }
+        return *this;
+    }
+
+    Buffer& operator=(Buffer&& other) noexcept {
+        if (this != &other) {
+            BufferPool::release(std::move(data_));
+            data_ = std::move(other.data_);
+            read_index_ = other.read_index_;
+            write_index_ = other.write_index_;
+            other.data_.clear();
+            other.read_index_ = 0;
+            other.write_index_ = 0;
+        }
+        return *this;
+    }
+
+    ~Buffer() {
+        BufferPool::release(std::move(data_));
+    }
+
     // 可读字节数
     size_t readableBytes() const {
         return write_index_ - read_index_;
@@ -262,13 +312,24 @@ public:
         read_index_ += n;
     }
 
-    // 重置缓冲区
+    // 重置缓冲区（保留存储）
     void reset() {
         read_index_ = 0;
         write_index_ = 0;
         data_.clear();
     }
 
+    /**
+     * 丢弃已读数据并按未读数据量收缩存储（用于空闲连接的输入/输出缓冲区）
+     * 没有未读数据时把存储整块还给池，空闲连接不再占用缓冲区内存
+     */
+    void shrink();
+
+    // 当前占用的存储容量
+    size_t capacity() const {
+        return data_.capacity();
+    }
+
     // 获取所有数据
     const std::vector<uint8_t>& data() const {
         return data_;
@@ -303,6 +364,27 @@ public:
         append(data.data(), data.size());
     }
 
+    /**
+     * 在尾部扩出 len 字节并返回其起始位置，供解压等直接写入（内容未定义）
+     * 实际写入不足 len 时用 retract 退回多扩的部分
+     */
+    uint8_t* extend(size_t len) {
+        ensureWritable(len);
+        data_.resize(write_index_ + len);
+        uint8_t* start = data_.data() + write_index_;
+        write_index_ += len;
+        return start;
+    }
+
+    // 退回尾部 n 个未读字节
+    void retract(size_t n) {
+        if (readableBytes() < n) {
+            throw std::runtime_error("Buffer: not enough data to retract");
+        }
+        write_index_ -= n;
+        data_.resize(write_index_);
+    }
+
     // 获取读指针位置
     size_t readerIndex() const {
         return read_index_;
@@ -321,6 +403,16 @@ public:
         return write_index_;
     }
 
+    // 回填已写入位置的3字节小端整数（先占位后补包长度）
+    void writeUint24At(size_t index, uint32_t val) {
+        if (index + 3 > write_index_) {
+            throw std::runtime_error("Buffer: invalid index for uint24");
+        }
+        data_[index] = static_cast<uint8_t>(val & 0xFF);
+        data_[index + 1] = static_cast<uint8_t>((val >> 8) & 0xFF);
+        data_[index + 2] = static_cast<uint8_t>((val >> 16) & 0xFF);
+    }
+
     // 获取lenenc int的编码长度（用于计算大小）
     static size_t getLenencIntSize(uint64_t val) {
         if (val < 0xFB) return 1;
@@ -338,10 +430,13 @@ public:
 private:
     void ensureWritable(size_t len) {
         if (writableBytes() < len) {
-            data_.reserve(data_.capacity() + len);
+            grow(len);
         }
     }
 
+    // 换一块至少能再写 len 字节的存储（按倍数增长），旧存储还给池
+    void grow(size_t len);
+
     std::vector<uint8_t> data_;
     size_t read_index_;
     size_t write_index_;
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "tiny_sql/common/buffer.h"
+
+#include <deque>
+#include <sys/types.h>
+
+namespace tiny_sql {
+
+/**
+ * 待发送数据的缓冲区链
+ * Chain of encoded buffer segments waiting to be written
+ *
+ * 每段是一个独立的 Buffer（列定义、若干行、EOF ...），追加时移入而不拼接；
+ * writeToFd 用一次 writev 把多段一起写出，写完的段析构后存储回到 BufferPool。
+ * Each segment is a Buffer moved in as-is instead of being concatenated; writeToFd
+ * gathers several segments into one writev, and fully written segments return their
+ * storage to the BufferPool.
+ */
+class BufferChain {
+public:
+    // 一次 writev 最多携带的段数
+    static constexpr size_t kMaxIovecs = 64;
+
+    // 移入一段（空段忽略）
+    void append(Buffer&& segment);
+
+    // 复制一段数据：尾段还有空间时写入尾段，否则新开一段
+    void append(const uint8_t* data, size_t len);
+
+    // 待发送的总字节数
+    size_t readableBytes() const { return bytes_; }
+
+    size_t segmentCount() const { return segments_.size(); }
+
+    bool empty() const { return bytes_ == 0; }
+
+    // 丢弃所有数据
+    void clear();
+
+    /**
+     * 用 writev 写出尽可能多的数据，并丢弃已写出的部分
+     * @return writev 的返回值（-1 时 errno 有效）
+     */
+    ssize_t writeToFd(int fd);
+
+private:
+    // 丢弃链头 n 个字节
+    void consume(size_t n);
+
+    std::deque<Buffer> segments_;
+    size_t bytes_ = 0;
+};
+
+} // namespace tiny_sql
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tiny_sql {
+
+/**
+ * 线程局部的缓冲区存储池（按大小分级）
+ * Thread-local pool of recycled buffer storage in size classes
+ *
+ * 级别为 256B、512B ... 64KB 九级，每级一个空闲链表。取用时按请求大小向上取整到
+ * 级别，归还时按容量向下取整到级别，因此池中每块存储的容量都不小于所在级别。
+ * 每个线程缓存的总字节数有上限，超过上限或大于最大级别的存储直接释放。
+ * 只在本线程内使用，不加锁；在其他线程释放的存储归还到那个线程的池。
+ * Nine classes from 256B to 64KB, one free list each. Requests round up to a class
+ * and returned storage rounds down by capacity, so every cached block is at least
+ * its class size. Each thread caches a bounded number of bytes; anything above the
+ * cap or larger than the biggest class is freed. No locking: storage released on
+ * another thread simply joins that thread's pool.
+ */
+class BufferPool {
+public:
+    static constexpr size_t kMinClassSize = 256;
+    static constexpr size_t kNumClasses = 9;
+    static constexpr size_t kMaxClassSize = kMinClassSize << (kNumClasses - 1);     // 64KB
+    static constexpr size_t kMaxCachedBytes = 4 * 1024 * 1024;                      // 每线程
+
+    /**
+     * 取一块空的存储（size 为 0），容量不小于 min_capacity
+     * 不超过最大级别时容量取整到级别大小
+     */
+    static std::vector<uint8_t> acquire(size_t min_capacity);
+
+    /**
+     * 归还存储（内容被丢弃）；没有容量的 vector 直接忽略
+     */
+    static void release(std::vector<uint8_t>&& storage);
+
+    // 请求大小对应的级别容量（大于最大级别时原样返回）
+    static size_t classSize(size_t min_capacity);
+
+    // 本线程池中缓存的字节数
+    static size_t cachedBytes();
+
+    /**
+     * 释放上次 trim 以来一直没被取用的缓存存储（每级空闲链表的最低水位部分），
+     * 由事件循环定期调用，负载下降后把峰值时积攒的存储还给系统
+     * @return 释放的字节数
+     */
+    static size_t trim();
+};
+
+} // namespace tiny_sql
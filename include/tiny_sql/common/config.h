@@ -0,0 +1,99 @@
+#pragma once
+
+#include "tiny_sql/common/logger.h"
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace tiny_sql {
+
+/**
+ * 服务器配置（全局单例）
+ *
+ * 通过命令行参数设置：./tiny-sql [端口号] [--选项=值 ...]
+ */
+class Config {
+public:
+    static Config& instance() {
+        static Config config;
+        return config;
+    }
+
+    /**
+     * 解析命令行参数
+     * @return 参数是否全部合法
+     */
+    bool parseArgs(int argc, char* argv[]);
+
+    // 监听端口
+    uint16_t port = 3306;
+
+    // Unix 域 socket 路径，本机客户端可以不经过 TCP 连接（空串表示不监听）
+    std::string socket;
+
+    // 排序内存预算（字节），超过后将有序段溢出到临时文件
+    size_t sort_buffer_size = 8 * 1024 * 1024;
+
+    // 哈希连接建表侧内存预算（字节），超过后对建表侧分区
+    size_t join_buffer_size = 256 * 1024;
+
+    // 临时文件目录（外部排序等）
+    std::string tmpdir = "/tmp";
+
+    // 已删除行占比超过该值时由后台线程压缩表
+    double compaction_dead_ratio = 0.25;
+
+    // 后台压缩线程的检查间隔（毫秒）
+    uint32_t compaction_interval_ms = 1000;
+
+    // 运行期日志级别（编译期低于 TINY_SQL_MIN_LOG_LEVEL 的日志已被移除）
+    LogLevel log_level = LogLevel::INFO;
+
+    // 日志文件（空串表示标准输出）
+    std::string log_file;
+
+    // 慢查询日志文件（空串表示不写慢查询日志）
+    std::string slow_query_log_file;
+
+    // 慢查询阈值（秒），耗时超过该值的语句写入慢查询日志
+    double long_query_time = 10.0;
+
+    // 单条语句的最长执行时间（毫秒），超时的语句在下一个检查点中断，0 表示不限制
+    uint32_t max_execution_time = 0;
+
+    // 握手超时（秒）：连接建立后在这段时间内没有完成认证则断开，0 表示不限制
+    uint32_t connect_timeout = 10;
+
+    // 非交互式连接的空闲超时（秒），两条命令之间超过该时间则断开，0 表示不限制
+    uint32_t wait_timeout = 28800;
+
+    // 交互式客户端（握手时带 CLIENT_INTERACTIVE）的空闲超时（秒），0 表示不限制
+    uint32_t interactive_timeout = 28800;
+
+    // 单个连接待发送数据的高水位（字节），超过后暂停读取该连接的新命令，0 表示不限制
+    size_t net_output_high_water = 4 * 1024 * 1024;
+
+    // 所有连接待发送数据的总上限（字节），超过后从积压最久的连接开始断开，0 表示不限制
+    size_t max_output_memory = 256 * 1024 * 1024;
+
+    // 握手时声明支持的压缩算法（逗号分隔的 zlib、zstd，空串表示不支持压缩协议）
+    // 编译时没有对应的库的算法不会声明
+    std::string protocol_compression_algorithms = "zlib,zstd";
+
+    // 压缩协议下短于该长度（字节）的帧不压缩，直接原样发送
+    size_t compression_min_length = 50;
+
+    // Prometheus 指标导出端口（只监听 127.0.0.1，0 表示不开启）
+    uint16_t admin_port = 0;
+
+private:
+    Config() = default;
+
+    /**
+     * 设置单个选项
+     * @return 选项名和值是否合法
+     */
+    bool setOption(const std::string& name, const std::string& value);
+};
+
+} // namespace tiny_sql
@@ -1,11 +1,24 @@
 #pragma once
 
 #include <string>
-#include <iostream>
 #include <sstream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <ctime>
-#include <iomanip>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 编译期最低日志级别：低于该级别的日志宏被整体移除（消息表达式不求值、不生成代码）
+ * 0=DEBUG 1=INFO 2=WARN 3=ERROR 4=FATAL，由 CMake 选项 TINY_SQL_MIN_LOG_LEVEL 设置
+ * Compile-time minimum log level: log macros below it compile to nothing
+ */
+#ifndef TINY_SQL_MIN_LOG_LEVEL
+#define TINY_SQL_MIN_LOG_LEVEL 0
+#endif
 
 namespace tiny_sql {
 
@@ -17,101 +30,131 @@ enum class LogLevel {
     FATAL
 };
 
+/**
+ * 解析日志级别名（debug/info/warn/error/fatal，不区分大小写）
+ * @return 名字是否合法
+ */
+bool parseLogLevel(const std::string& name, LogLevel& level);
+
+class LogRing;
+
+/**
+ * 日志记录：调用线程只保存原始字段，时间戳等由后台写线程格式化
+ */
+struct LogRecord {
+    std::chrono::system_clock::time_point time;
+    LogLevel level = LogLevel::INFO;
+    const char* file = "";
+    int line = 0;
+    std::string message;
+};
+
+/**
+ * 异步日志（全局单例）
+ * Asynchronous logger (singleton)
+ *
+ * 日志宏先检查级别再格式化消息；记录写入调用线程自己的无锁环形缓冲区（单生产者
+ * 单消费者），由后台写线程定期批量取出、格式化并一次 write 写入输出文件。
+ * 缓冲区满时丢弃新记录并计数，不阻塞调用线程；FATAL 同步刷出。
+ * Log macros check the level before formatting; records go into a lock-free
+ * single-producer ring owned by the calling thread, drained by a background writer
+ * that formats them and writes each batch with a single write(). A full ring drops
+ * the record (counted) instead of blocking the caller; FATAL flushes synchronously.
+ */
 class Logger {
 public:
-    static Logger& instance() {
-        static Logger logger;
-        return logger;
-    }
+    static Logger& instance();
+
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
 
     void setLevel(LogLevel level) {
-        level_ = level;
+        level_.store(level, std::memory_order_relaxed);
     }
 
     LogLevel getLevel() const {
-        return level_;
+        return level_.load(std::memory_order_relaxed);
     }
 
-    void log(LogLevel level, const std::string& file, int line,
-             const std::string& message) {
-        if (level < level_) {
-            return;
-        }
+    // 该级别的日志是否输出（日志宏在格式化消息前调用）
+    bool isEnabled(LogLevel level) const {
+        return level >= level_.load(std::memory_order_relaxed);
+    }
 
-        std::lock_guard<std::mutex> lock(mutex_);
+    /**
+     * 设置输出文件（追加写入），空串表示标准输出
+     * @return 文件能否打开
+     */
+    bool setOutput(const std::string& path);
 
-        std::ostringstream oss;
+    /**
+     * 提交一条日志（不做级别检查，由日志宏负责）
+     */
+    void log(LogLevel level, const char* file, int line, std::string message);
 
-        // 时间戳
-        auto now = std::time(nullptr);
-        auto tm = *std::localtime(&now);
-        oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+    /**
+     * 同步写出所有已提交的日志
+     */
+    void flush();
 
-        // 日志级别
-        oss << " [" << levelToString(level) << "] ";
+    // 因缓冲区满被丢弃的日志条数
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
 
-        // 文件和行号
-        oss << "[" << file << ":" << line << "] ";
+private:
+    Logger();
 
-        // 消息
-        oss << message << std::endl;
+    // 当前线程的环形缓冲区（首次使用时创建并登记）
+    LogRing& localRing();
 
-        std::cout << oss.str();
-        std::cout.flush();
-    }
+    // 后台写线程主循环
+    void run();
 
-private:
-    Logger() : level_(LogLevel::INFO) {}
-
-    std::string levelToString(LogLevel level) const {
-        switch (level) {
-            case LogLevel::DEBUG: return "DEBUG";
-            case LogLevel::INFO:  return "INFO ";
-            case LogLevel::WARN:  return "WARN ";
-            case LogLevel::ERROR: return "ERROR";
-            case LogLevel::FATAL: return "FATAL";
-            default: return "UNKNOWN";
-        }
-    }
+    // 取出所有缓冲区中的记录，按时间排序后格式化写出
+    void drain();
+    void drainLocked();         // 调用方持有 drain_mutex_
 
-    LogLevel level_;
-    std::mutex mutex_;
-};
+    // 格式化一条记录追加到 out
+    void format(const LogRecord& record, std::string& out);
 
-// 便捷宏
-#define LOG_DEBUG(msg) \
-    do { \
-        std::ostringstream oss; \
-        oss << msg; \
-        tiny_sql::Logger::instance().log(tiny_sql::LogLevel::DEBUG, __FILE__, __LINE__, oss.str()); \
-    } while (0)
+    std::atomic<LogLevel> level_{LogLevel::INFO};
+    std::atomic<uint64_t> dropped_{0};
+    uint64_t reported_dropped_ = 0;
 
-#define LOG_INFO(msg) \
-    do { \
-        std::ostringstream oss; \
-        oss << msg; \
-        tiny_sql::Logger::instance().log(tiny_sql::LogLevel::INFO, __FILE__, __LINE__, oss.str()); \
-    } while (0)
+    std::mutex mutex_;                              // 保护 rings_ 和 running_
+    std::condition_variable cv_;
+    std::vector<std::shared_ptr<LogRing>> rings_;
+    bool running_ = true;
+    std::thread thread_;
 
-#define LOG_WARN(msg) \
-    do { \
-        std::ostringstream oss; \
-        oss << msg; \
-        tiny_sql::Logger::instance().log(tiny_sql::LogLevel::WARN, __FILE__, __LINE__, oss.str()); \
-    } while (0)
+    std::mutex drain_mutex_;                        // 串行化消费者（写线程和 flush）及输出文件
+    int fd_;
+    bool owns_fd_ = false;
+    std::vector<LogRecord> batch_;
+    std::string buffer_;
 
-#define LOG_ERROR(msg) \
-    do { \
-        std::ostringstream oss; \
-        oss << msg; \
-        tiny_sql::Logger::instance().log(tiny_sql::LogLevel::ERROR, __FILE__, __LINE__, oss.str()); \
-    } while (0)
+    // 时间戳前缀缓存（同一秒内只格式化一次）
+    time_t cached_second_ = 0;
+    char cached_time_[32] = {};
+};
 
-#define LOG_FATAL(msg) \
+} // namespace tiny_sql
+
+// 便捷宏：编译期级别过滤 + 运行期级别检查，通过后才格式化消息
+#define TINY_SQL_LOG(level, msg) \
     do { \
-        std::ostringstream oss; \
-        oss << msg; \
-        tiny_sql::Logger::instance().log(tiny_sql::LogLevel::FATAL, __FILE__, __LINE__, oss.str()); \
+        if constexpr (static_cast<int>(level) >= TINY_SQL_MIN_LOG_LEVEL) { \
+            if (tiny_sql::Logger::instance().isEnabled(level)) { \
+                std::ostringstream tiny_sql_log_stream; \
+                tiny_sql_log_stream << msg; \
+                tiny_sql::Logger::instance().log(level, __FILE__, __LINE__, tiny_sql_log_stream.str()); \
+            } \
+        } \
     } while (0)
 
-} // namespace tiny_sql
+#define LOG_DEBUG(msg) TINY_SQL_LOG(tiny_sql::LogLevel::DEBUG, msg)
+#define LOG_INFO(msg)  TINY_SQL_LOG(tiny_sql::LogLevel::INFO, msg)
+#define LOG_WARN(msg)  TINY_SQL_LOG(tiny_sql::LogLevel::WARN, msg)
+#define LOG_ERROR(msg) TINY_SQL_LOG(tiny_sql::LogLevel::ERROR, msg)
+#define LOG_FATAL(msg) TINY_SQL_LOG(tiny_sql::LogLevel::FATAL, msg)
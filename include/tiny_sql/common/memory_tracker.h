@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace tiny_sql {
+
+/**
+ * 一条语句的执行器内存用量
+ * Per-statement executor memory accounting
+ *
+ * 执行器在持有内存的地方显式记账（TrackedMemory）：语句内存池向上游申请的块、物化的
+ * 结果行、排序缓冲区和聚合哈希表。计数是原子的，WorkerPool 的任务继承调用者的
+ * MemoryTracker，并行聚合时各工作线程的部分哈希表累加到同一条语句上。
+ * Operators charge the memory they own explicitly (TrackedMemory): arena blocks,
+ * materialized rows, sort buffers and aggregate hash tables. Counters are atomic and
+ * WorkerPool tasks inherit the caller's tracker, so per-worker partials add up.
+ */
+class MemoryTracker {
+public:
+    MemoryTracker() = default;
+
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    // 记入（bytes 为负时扣除）用量，并更新峰值
+    void consume(int64_t bytes);
+
+    void release(int64_t bytes) { consume(-bytes); }
+
+    // 当前用量（字节）
+    int64_t usage() const { return usage_.load(std::memory_order_relaxed); }
+
+    // 最高用量（字节）
+    uint64_t peak() const { return static_cast<uint64_t>(peak_.load(std::memory_order_relaxed)); }
+
+private:
+    std::atomic<int64_t> usage_{0};
+    std::atomic<int64_t> peak_{0};
+};
+
+namespace memory_tracker {
+
+    // 当前线程正在执行的语句的内存记账（没有时为nullptr，不记账）
+    MemoryTracker*& current();
+
+} // namespace memory_tracker
+
+/**
+ * RAII：作用域内设置当前线程的内存记账（并行算子的工作线程用它继承调用者的记账）
+ */
+class MemoryTrackerScope {
+public:
+    explicit MemoryTrackerScope(MemoryTracker* tracker) : previous_(memory_tracker::current()) {
+        memory_tracker::current() = tracker;
+    }
+    ~MemoryTrackerScope() { memory_tracker::current() = previous_; }
+
+    MemoryTrackerScope(const MemoryTrackerScope&) = delete;
+    MemoryTrackerScope& operator=(const MemoryTrackerScope&) = delete;
+
+private:
+    MemoryTracker* previous_;
+};
+
+/**
+ * RAII：算子持有的一块内存，记在构造时线程的当前语句上，析构时扣除
+ *
+ * 可以在其他线程上调整（如工作线程更新部分聚合表的用量），但同一时刻只能有一个线程使用。
+ */
+class TrackedMemory {
+public:
+    TrackedMemory() : tracker_(memory_tracker::current()) {}
+    ~TrackedMemory() { set(0); }
+
+    TrackedMemory(const TrackedMemory&) = delete;
+    TrackedMemory& operator=(const TrackedMemory&) = delete;
+
+    // 增加持有的字节数
+    void add(size_t bytes) { set(bytes_ + bytes); }
+
+    // 设置持有的字节数
+    void set(size_t bytes) {
+        if (tracker_ && bytes != bytes_) {
+            tracker_->consume(static_cast<int64_t>(bytes) - static_cast<int64_t>(bytes_));
+        }
+        bytes_ = bytes;
+    }
+
+    size_t bytes() const { return bytes_; }
+
+private:
+    MemoryTracker* tracker_;
+    size_t bytes_ = 0;
+};
+
+} // namespace tiny_sql
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tiny_sql {
+
+namespace metrics {
+    // 分片数：每个线程固定落在一个分片上，分片之间不共享缓存行
+    constexpr size_t kShards = 8;
+
+    // 当前线程的分片号（首次调用时轮流分配）
+    size_t shardIndex();
+
+    // 单调时钟（纳秒）
+    inline uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
+
+/**
+ * 计数器：按线程分片的原子累加，读取时求和
+ * Counter: per-thread sharded relaxed atomics, summed on read
+ */
+class Counter {
+public:
+    void add(uint64_t n = 1) {
+        shards_[metrics::shardIndex()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, metrics::kShards> shards_;
+};
+
+/**
+ * 瞬时值（如当前连接数）
+ */
+class Gauge {
+public:
+    void add(int64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    void sub(int64_t n = 1) { value_.fetch_sub(n, std::memory_order_relaxed); }
+    void set(int64_t n) { value_.store(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+/**
+ * HDR 风格的延迟直方图（纳秒）
+ * HDR-style latency histogram (nanoseconds)
+ *
+ * 对数-线性分桶：每个2的幂区间再均分为16个子桶，相对误差不超过 1/16，
+ * 覆盖 0 到 2^64 纳秒。记录是一次分片内的原子自增，不加锁。
+ * Log-linear buckets: every power-of-two range is split into 16 sub-buckets (at most
+ * 1/16 relative error) covering the full uint64 range; recording is one relaxed
+ * atomic increment on the caller's shard.
+ */
+class Histogram {
+public:
+    static constexpr size_t kLinearBuckets = 32;        // 小于32的值每个值一个桶
+    static constexpr size_t kSubBuckets = 16;           // 每个2的幂区间的子桶数
+    static constexpr size_t kBuckets = kLinearBuckets + 59 * kSubBuckets;
+
+    void record(uint64_t value);
+
+    /**
+     * 合并各分片后的快照
+     */
+    struct Snapshot {
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+        std::vector<uint64_t> buckets;
+
+        // 分位数（q 取 0~1），返回所在桶的上界，没有数据时为0
+        uint64_t percentile(double q) const;
+
+        double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+    };
+
+    Snapshot snapshot() const;
+
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(size_t index);
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, kBuckets> buckets{};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sum{0};
+    };
+    std::array<Shard, metrics::kShards> shards_;
+    std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * 指标注册表（全局单例）
+ * Metrics registry (singleton)
+ *
+ * 指标按名字注册一次，之后调用方持有引用直接更新。名字使用 SHOW STATUS 的
+ * 风格（如 Bytes_received），Prometheus 输出时转换为 tiny_sql_bytes_received_total。
+ * Metrics are registered once by name and updated through the returned reference.
+ * Names follow SHOW STATUS (e.g. Bytes_received) and are converted for Prometheus
+ * (tiny_sql_bytes_received_total).
+ */
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance();
+
+    // 注册（或取得已注册的）指标
+    Counter& counter(const std::string& name, const std::string& help);
+    Gauge& gauge(const std::string& name, const std::string& help);
+    Histogram& histogram(const std::string& name, const std::string& help);
+
+    /**
+     * SHOW GLOBAL STATUS 的 (Variable_name, Value) 列表
+     * 直方图展开为 _count/_avg_us/_p50_us/_p95_us/_p99_us/_max_us
+     */
+    std::vector<std::pair<std::string, std::string>> statusVariables() const;
+
+    /**
+     * Prometheus 文本格式（直方图输出为以秒为单位的 summary）
+     */
+    std::string renderPrometheus() const;
+
+private:
+    MetricsRegistry();
+
+    enum class Kind { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Entry {
+        Kind kind;
+        std::string name;
+        std::string help;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    Entry& findOrAdd(Kind kind, const std::string& name, const std::string& help);
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Entry>> entries_;
+    std::chrono::steady_clock::time_point start_time_;
+};
+
+/**
+ * 服务器内置指标：首次使用时注册，热路径直接持有引用
+ * Built-in server metrics, registered on first use
+ */
+struct ServerMetrics {
+    static ServerMetrics& instance();
+
+    // 连接
+    Counter& connections;           // 累计接受的连接
+    Counter& aborted_connects;      // 超过连接上限被拒绝的连接
+    Gauge& threads_connected;       // 当前连接数
+
+    // 网络流量
+    Counter& bytes_received;
+    Counter& bytes_sent;
+    Gauge& output_buffer_bytes;     // 所有连接积压未发出的字节数
+    Counter& aborted_slow_clients;  // 因积压超过全局上限被断开的连接
+
+    // 命令和行数
+    Counter& questions;             // 客户端发来的命令数
+    Counter& rows_scanned;          // 访问路径读取的可见行数
+    Counter& rows_returned;         // 结果集返回的行数
+    Counter& slow_queries;          // 超过 long_query_time 的语句数
+
+    // 语句各阶段耗时
+    Histogram& parse_time;
+    Histogram& plan_time;
+    Histogram& execute_time;
+    Histogram& encode_time;
+    Histogram& network_write_time;
+
+private:
+    ServerMetrics();
+};
+
+/**
+ * 一条语句的资源统计：各阶段累计耗时（纳秒）和读写的行数、字节数、内存峰值，
+ * 由 CommandDispatcher 在语句结束时记入直方图和慢查询日志
+ * Per-statement resource accounting, recorded by CommandDispatcher when the command ends
+ */
+struct StatementStats {
+    uint64_t parse_ns = 0;
+    uint64_t plan_ns = 0;
+    uint64_t encode_ns = 0;
+    uint64_t network_ns = 0;
+
+    uint64_t rows_scanned = 0;      // 访问路径读取的可见行数
+    uint64_t rows_returned = 0;     // 结果集返回的行数
+    uint64_t bytes_sent = 0;        // 发送给客户端的字节数
+    uint64_t peak_memory = 0;       // 执行器显式记账的内存峰值（字节），见 MemoryTracker
+};
+
+namespace metrics {
+    /**
+     * 当前线程正在执行的语句（没有时为nullptr）
+     * 供拿不到 Session 的底层代码（如访问路径）累加行数
+     */
+    StatementStats*& currentStatement();
+}
+
+namespace metrics {
+    // 累加读取的行数：计入 Rows_scanned 和当前语句的统计
+    void addRowsScanned(uint64_t rows);
+}
+
+/**
+ * RAII：作用域内把 stats 设为当前线程正在执行的语句，退出时恢复
+ */
+class CurrentStatementScope {
+public:
+    explicit CurrentStatementScope(StatementStats& stats)
+        : previous_(metrics::currentStatement()) {
+        metrics::currentStatement() = &stats;
+    }
+    ~CurrentStatementScope() { metrics::currentStatement() = previous_; }
+
+    CurrentStatementScope(const CurrentStatementScope&) = delete;
+    CurrentStatementScope& operator=(const CurrentStatementScope&) = delete;
+
+private:
+    StatementStats* previous_;
+};
+
+/**
+ * RAII计时器：将作用域内的耗时累加到 target
+ */
+class PhaseTimer {
+public:
+    explicit PhaseTimer(uint64_t& target) : target_(target), start_(metrics::nowNs()) {}
+    ~PhaseTimer() { target_ += metrics::nowNs() - start_; }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    uint64_t& target_;
+    uint64_t start_;
+};
+
+} // namespace tiny_sql
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace tiny_sql {
+
+/**
+ * 会话的终止标记（KILL 设置，执行线程在检查点读取）
+ */
+enum class KillState : uint8_t {
+    NONE,
+    QUERY,          // KILL QUERY：中断当前语句
+    CONNECTION,     // KILL [CONNECTION]：中断当前语句并关闭连接
+};
+
+/**
+ * 语句被中断：KILL 或超过 max_execution_time
+ *
+ * 故意不继承 std::exception：执行器里把 std::exception 转成求值错误的 catch 不会拦截它，
+ * 异常一路传到 CommandDispatcher，沿途的表锁和自动提交事务由 RAII 释放/回滚。
+ * Deliberately not a std::exception, so the executor's evaluation-error handlers let it
+ * through to CommandDispatcher; locks and autocommit transactions unwind via RAII.
+ */
+class QueryInterrupted {
+public:
+    enum class Reason { KILLED, TIMEOUT };
+
+    explicit QueryInterrupted(Reason reason) : reason_(reason) {}
+
+    Reason getReason() const { return reason_; }
+
+private:
+    Reason reason_;
+};
+
+/**
+ * 一条语句的中断条件
+ */
+struct InterruptContext {
+    const std::atomic<KillState>* kill_state = nullptr;
+    uint64_t deadline_ns = 0;       // metrics::nowNs() 时间，0 表示不限时
+};
+
+/**
+ * 协作式取消：扫描、排序、连接、聚合每处理一个 morsel（kMorselRows 行）调用一次 check，
+ * 发现会话被 KILL 或语句超时就抛出 QueryInterrupted。
+ * Cooperative cancellation: scans, sorts, joins and aggregations call check() once per
+ * morsel; it throws QueryInterrupted when the session was killed or the statement timed out.
+ */
+namespace interrupt {
+
+    constexpr size_t kMorselRows = 1024;
+
+    // 当前线程正在执行的语句的中断条件（没有时为nullptr，check 不做任何事）
+    InterruptContext*& current();
+
+    // 检查当前语句是否应中断
+    void check();
+
+} // namespace interrupt
+
+/**
+ * RAII：作用域内设置当前线程的中断条件（并行算子的工作线程用它继承调用者的条件）
+ */
+class InterruptScope {
+public:
+    explicit InterruptScope(InterruptContext* context) : previous_(interrupt::current()) {
+        interrupt::current() = context;
+    }
+    ~InterruptScope() { interrupt::current() = previous_; }
+
+    InterruptScope(const InterruptScope&) = delete;
+    InterruptScope& operator=(const InterruptScope&) = delete;
+
+private:
+    InterruptContext* previous_;
+};
+
+/**
+ * 按行计数，每 kMorselRows 行检查一次中断
+ */
+class MorselCheck {
+public:
+    void tick() {
+        if (++rows_ == interrupt::kMorselRows) {
+            rows_ = 0;
+            interrupt::check();
+        }
+    }
+
+private:
+    size_t rows_ = 0;
+};
+
+} // namespace tiny_sql
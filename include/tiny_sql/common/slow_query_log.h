@@ -0,0 +1,105 @@
+#pragma once
+
+#include "tiny_sql/common/metrics.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tiny_sql {
+
+/**
+ * 一条执行完毕的语句及其资源统计
+ */
+struct QueryRecord {
+    uint32_t connection_id = 0;
+    std::string user;
+    std::string database;
+    std::string query;
+    std::string fingerprint;            // 规范化后的语句（见 fingerprintQuery）
+    uint64_t digest = 0;                // 指纹的哈希
+    uint64_t total_ns = 0;              // 墙钟耗时
+    StatementStats stats;
+    std::chrono::system_clock::time_point start_time;
+};
+
+/**
+ * 按指纹聚合的语句统计
+ */
+struct QueryDigest {
+    uint64_t digest = 0;
+    std::string fingerprint;
+    std::string sample_query;           // 最近一次执行的原始语句
+    uint64_t count = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t rows_scanned = 0;
+    uint64_t rows_returned = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t max_peak_memory = 0;
+};
+
+/**
+ * 慢查询日志和语句摘要（全局单例）
+ * Slow query log and statement digests (singleton)
+ *
+ * 每条语句结束后按指纹累计到摘要表，摘要表最多保留 kMaxDigests 个指纹，满了以后
+ * 淘汰总耗时最少的一个，总耗时高的语句不会被挤出。耗时超过 long_query_time
+ * 的语句以 MySQL 慢查询日志格式（# Query_time: ... 注释行 + 语句）追加到日志文件，
+ * 可直接用 mysqldumpslow / pt-query-digest 分析（未统计锁等待，Lock_time 恒为0）；
+ * 慢查询很少，写文件同步进行。
+ * Every statement is folded into a per-fingerprint digest table (bounded, evicting the
+ * entry with the least total time so heavy statements are kept). Statements
+ * slower than long_query_time are appended to the log file in the MySQL slow log format.
+ */
+class SlowQueryLog {
+public:
+    static constexpr size_t kMaxDigests = 1024;
+
+    static SlowQueryLog& instance();
+
+    ~SlowQueryLog();
+
+    SlowQueryLog(const SlowQueryLog&) = delete;
+    SlowQueryLog& operator=(const SlowQueryLog&) = delete;
+
+    /**
+     * 设置慢查询日志文件（追加写入），空串表示不写文件
+     * @return 文件能否打开
+     */
+    bool setOutput(const std::string& path);
+
+    // 慢查询阈值（秒）
+    void setLongQueryTime(double seconds);
+    double getLongQueryTime() const;
+
+    /**
+     * 记录一条执行完毕的语句
+     * @return 是否为慢查询
+     */
+    bool record(const QueryRecord& record);
+
+    /**
+     * 按总耗时降序返回前 k 个摘要
+     */
+    std::vector<QueryDigest> topDigests(size_t k) const;
+
+    // 清空摘要表
+    void resetDigests();
+
+private:
+    SlowQueryLog() = default;
+
+    // 把一条慢查询格式化为日志条目追加到 out
+    static void format(const QueryRecord& record, std::string& out);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, QueryDigest> digests_;
+    int fd_ = -1;
+    std::atomic<uint64_t> long_query_time_ns_{10ULL * 1000 * 1000 * 1000};
+};
+
+} // namespace tiny_sql
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "tiny_sql/common/memory_tracker.h"
+#include "tiny_sql/common/query_interrupt.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tiny_sql {
+
+/**
+ * 并行算子共用的工作线程池（全局单例）
+ * Long-lived worker pool shared by the parallel operators (global singleton)
+ *
+ * 第一次使用时创建 min(CPU 数, kMaxThreads) - 1 个线程，之后一直复用，语句执行时
+ * 不再创建线程。run 把一批任务放进队列，调用线程自己也领取任务执行，因此线程创建
+ * 失败或池已停止时照样能完成（退化为串行）。任务在工作线程上继承调用者的中断条件和
+ * 内存记账，抛出的异常在整批任务结束后在调用线程重新抛出。
+ * Threads are created once, on first use; run() queues a batch and the caller claims
+ * tasks too, so a pool with no threads simply runs serially. Tasks inherit the caller's
+ * interrupt context and memory tracker, and the first exception is rethrown on the caller once the batch ends.
+ */
+class WorkerPool {
+public:
+    static constexpr size_t kMaxThreads = 8;       // 包括调用线程
+
+    static WorkerPool& instance();
+
+    /**
+     * 执行 task(0) ... task(count - 1)，全部结束后返回
+     * @throws 任一任务抛出的第一个异常
+     */
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+    // 一批任务最多同时执行的线程数（工作线程加调用线程）
+    size_t concurrency();
+
+    // 停止并等待所有工作线程退出，之后的 run 在调用线程串行执行
+    void stop();
+
+private:
+    // 一批任务
+    struct Batch {
+        const std::function<void(size_t)>* task = nullptr;
+        size_t count = 0;
+        InterruptContext* interrupt = nullptr;
+        MemoryTracker* memory = nullptr;
+        std::atomic<size_t> next{0};            // 下一个未领取的任务
+        size_t finished = 0;                    // 受 WorkerPool::mutex_ 保护
+        std::exception_ptr error;               // 同上
+    };
+
+    WorkerPool() = default;
+    ~WorkerPool();
+
+    // 创建工作线程（只在第一次使用时执行）
+    void start();
+
+    void workerLoop();
+
+    // 领取并执行 batch 中的任务，直到没有未领取的任务
+    void drain(Batch& batch);
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;           // 有新的批次或停止
+    std::condition_variable done_cv_;           // 有批次完成
+    std::deque<std::shared_ptr<Batch>> queue_;  // 还有未领取任务的批次
+    bool started_ = false;
+    bool stopping_ = false;
+};
+
+} // namespace tiny_sql
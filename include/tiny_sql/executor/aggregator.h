@@ -0,0 +1,158 @@
+#pragma once
+
+#include "tiny_sql/common/memory_tracker.h"
+#include "tiny_sql/sql/ast.h"
+#include "tiny_sql/storage/table.h"
+#include "tiny_sql/storage/value.h"
+#include <vector>
+#include <cstdint>
+
+namespace tiny_sql {
+
+/**
+ * 聚合函数类型
+ */
+enum class AggregateKind {
+    COUNT_STAR,     // COUNT(*)
+    COUNT,          // COUNT(expr)，只统计非NULL
+    SUM,
+    AVG,
+    MIN,
+    MAX
+};
+
+/**
+ * 聚合描述 - SELECT列表中的一个聚合函数
+ */
+struct AggregateSpec {
+    AggregateKind kind;
+    const Expression* argument = nullptr;  // COUNT(*) 时为nullptr
+
+    /**
+     * 从函数调用构造聚合描述
+     * @throws std::runtime_error 如果不是受支持的聚合函数
+     */
+    static AggregateSpec fromFunctionCall(const FunctionCall* func);
+};
+
+/**
+ * 单个聚合函数的中间状态（可合并，用于线程局部的部分聚合）
+ */
+struct AggregateState {
+    int64_t count = 0;          // 参与聚合的非NULL值个数（COUNT(*)时为行数）
+    int64_t int_sum = 0;        // 整数部分的累加和
+    double double_sum = 0.0;    // 浮点部分的累加和
+    bool is_floating = false;   // 是否出现过浮点输入
+    Value extreme;              // MIN/MAX 的当前值
+
+    void update(AggregateKind kind, const Value& value);
+    void merge(AggregateKind kind, const AggregateState& other);
+    Value finalize(AggregateKind kind) const;
+};
+
+/**
+ * 分组哈希表 - 开放寻址（线性探测）
+ *
+ * 槽位数组只保存分组编号和哈希值，分组键和聚合状态按分组编号连续存放，
+ * 探测时先比较哈希值，命中后才比较分组键，减少Value比较次数。
+ */
+class GroupHashTable {
+public:
+    explicit GroupHashTable(size_t aggregate_count, size_t initial_capacity = 64);
+
+    /**
+     * 查找分组，不存在时插入新分组
+     * @return 分组编号
+     */
+    size_t findOrInsert(const std::vector<Value>& key, size_t hash);
+
+    // 分组数量
+    size_t size() const { return keys_.size(); }
+
+    // 分组键
+    const std::vector<Value>& getKey(size_t group) const { return keys_[group]; }
+
+    // 分组的聚合状态（aggregate_count个连续状态）
+    AggregateState* getStates(size_t group) { return &states_[group * aggregate_count_]; }
+    const AggregateState* getStates(size_t group) const { return &states_[group * aggregate_count_]; }
+
+    // 预计算的分组哈希值
+    size_t getHash(size_t group) const { return hashes_[group]; }
+
+    // 哈希表占用内存的估算（字节），O(1)
+    size_t memoryBytes() const;
+
+    /**
+     * 计算分组键的哈希值
+     */
+    static size_t hashKey(const std::vector<Value>& key);
+
+private:
+    static constexpr uint32_t kEmptySlot = UINT32_MAX;
+
+    void grow();
+
+    size_t aggregate_count_;
+    size_t mask_;                           // 容量-1（容量为2的幂）
+    std::vector<uint32_t> slots_;           // 槽位 -> 分组编号
+    std::vector<size_t> hashes_;            // 分组编号 -> 哈希值
+    std::vector<std::vector<Value>> keys_;  // 分组编号 -> 分组键
+    std::vector<AggregateState> states_;    // 分组编号 * aggregate_count -> 状态
+    size_t key_bytes_ = 0;                  // 各分组键的 Value 数组大小之和
+};
+
+/**
+ * 哈希聚合执行器
+ *
+ * 对输入行执行 WHERE 过滤、按 GROUP BY 分组并累加聚合函数。
+ * 大表按行区间切分，在 WorkerPool 的常驻线程上并行执行，每个分片维护自己的
+ * 部分聚合哈希表，最后合并到一张表中，避免线程间共享可变状态。
+ * 结果表和各部分表的大小每个 morsel 记入一次语句内存用量。
+ */
+class HashAggregator {
+public:
+    HashAggregator(std::vector<AggregateSpec> aggregates,
+                   std::vector<const Expression*> group_by,
+                   const std::vector<ColumnDef>& columns);
+
+    /**
+     * 执行聚合
+     * @param rows 输入行
+     * @param where WHERE子句（可以为nullptr）
+     * @throws std::runtime_error 表达式求值失败
+     */
+    void run(const std::vector<Row>& rows, const Expression* where);
+
+    /**
+     * 获取聚合结果，每个分组一行，布局为 [分组键..., 聚合值...]
+     * 没有GROUP BY时总是返回一行（空输入时COUNT为0，其余为NULL）
+     */
+    std::vector<Row> getResults() const;
+
+    // 满足WHERE条件、参与聚合的行数
+    size_t getMatchedRows() const { return matched_rows_; }
+
+    // 聚合哈希表占用内存的估算（字节）
+    size_t getMemoryBytes() const { return result_table_.memoryBytes(); }
+
+    // 并行聚合的行数阈值
+    static constexpr size_t kParallelThreshold = 64 * 1024;
+
+private:
+    // 返回满足WHERE条件的行数
+    size_t consumeRange(GroupHashTable& table, TrackedMemory& memory,
+                        const std::vector<Row>& rows,
+                        size_t begin, size_t end,
+                        const Expression* where) const;
+
+    void mergeInto(GroupHashTable& target, const GroupHashTable& source) const;
+
+    std::vector<AggregateSpec> aggregates_;
+    std::vector<const Expression*> group_by_;
+    const std::vector<ColumnDef>& columns_;
+    GroupHashTable result_table_;
+    TrackedMemory result_memory_;
+    size_t matched_rows_ = 0;
+};
+
+} // namespace tiny_sql
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "tiny_sql/sql/ast.h"
+#include "tiny_sql/storage/table.h"
+#include "tiny_sql/executor/join.h"
+#include <vector>
+#include <string>
+#include <functional>
+
+namespace tiny_sql {
+
+/**
+ * 单表访问路径类型
+ */
+enum class AccessPathType {
+    FULL_SCAN,          // 全表扫描
+    PK_LOOKUP,          // 主键等值查找
+    INDEX_LOOKUP,       // 二级索引等值查找
+    INDEX_RANGE,        // 索引范围扫描
+    INDEX_SCAN          // 按索引顺序全扫描（用于免排序的 ORDER BY）
+};
+
+const char* accessPathTypeToString(AccessPathType type);
+
+/**
+ * 单表访问路径
+ */
+struct AccessPath {
+    AccessPathType type = AccessPathType::FULL_SCAN;
+    int column = -1;                        // 索引列（FULL_SCAN 时为-1）
+    const OrderedIndex* index = nullptr;
+    std::string index_name;
+
+    // 索引扫描范围（已转换为索引列类型）
+    bool has_lower = false;
+    bool lower_inclusive = true;
+    Value lower;
+    bool has_upper = false;
+    bool upper_inclusive = true;
+    Value upper;
+
+    double estimated_rows = 0;              // 估算需要读取的行数
+    double cost = 0;                        // 估算代价
+
+    bool usesIndex() const { return index != nullptr; }
+
+    /**
+     * 按访问路径逐行读取表中对读视图可见的行
+     * @param ascending 索引路径的遍历方向（全表扫描时忽略）
+     * @param fn 回调，返回false时停止
+     */
+    void forEachRow(const Table& table, const ReadView& view, bool ascending,
+                    const std::function<bool(const Row&)>& fn) const;
+
+    /**
+     * 按访问路径逐个读取可见行的行号（UPDATE/DELETE 用）
+     * @param fn 回调 bool(size_t row_id)，返回false时停止
+     */
+    void forEachRowId(const Table& table, const ReadView& view, bool ascending,
+                      const std::function<bool(size_t)>& fn) const;
+
+    /**
+     * 访问路径的文字描述（EXPLAIN 输出），如 "Index range scan on t using idx (age < 5)"
+     * @param alias 表的引用名（别名或表名）
+     */
+    std::string describe(const Table& table, const std::string& alias, bool ascending) const;
+};
+
+/**
+ * 连接一侧的代价估计输入
+ */
+struct JoinSideEstimate {
+    double rows = 0;                // 经本表条件过滤后的（估算）行数
+    double table_rows = 0;          // 表总行数
+    double key_ndv = 0;             // 连接键不同值个数
+    bool has_index = false;         // 连接键上有可用索引（输入未被预过滤）
+};
+
+/**
+ * 代价模型 - 选择单表访问路径和连接算法/顺序
+ *
+ * 代价单位为“顺序读取并过滤一行”。有 ANALYZE TABLE 生成的统计信息时
+ * 用直方图和NDV估算选择率，否则使用默认选择率。
+ */
+class CostModel {
+public:
+    // 代价常量
+    static constexpr double kSeqRowCost = 1.0;          // 顺序扫描一行（含条件求值）
+    static constexpr double kIndexSeekCost = 1.0;       // 索引树下降每层的代价
+    static constexpr double kIndexRowCost = 2.0;        // 通过索引回表读取一行（随机访问）
+    static constexpr double kHashBuildCost = 2.0;       // 哈希表插入一行
+    static constexpr double kHashProbeCost = 1.0;       // 哈希表探测一行
+
+    // 无统计信息时的默认选择率
+    static constexpr double kDefaultEqSelectivity = 0.1;
+    static constexpr double kDefaultRangeSelectivity = 1.0 / 3.0;
+
+    /**
+     * 将条件按顶层AND拆分为合取项
+     */
+    static std::vector<const Expression*> splitConjuncts(const Expression* expr);
+
+    /**
+     * 为单表选择访问路径
+     * @param conjuncts 只引用该表列的WHERE合取项
+     */
+    static AccessPath chooseAccessPath(const Table& table,
+                                       const std::vector<const Expression*>& conjuncts);
+
+    /**
+     * 按索引顺序全扫描的访问路径（ORDER BY 索引列时免排序）
+     */
+    static AccessPath indexScan(const Table& table, size_t column);
+
+    /**
+     * 估算合取条件的选择率（各项独立假设）
+     */
+    static double estimateSelectivity(const Table& table,
+                                      const std::vector<const Expression*>& conjuncts);
+
+    /**
+     * 估算连接键的不同值个数
+     */
+    static double estimateKeyNdv(const Table& table, size_t column);
+
+    /**
+     * 选择连接算法和连接顺序（建表侧/内表）
+     * @param has_equi_key ON 条件中是否有等值连接键
+     */
+    static JoinPlan planJoin(JoinType type, bool has_equi_key,
+                             const JoinSideEstimate& left,
+                             const JoinSideEstimate& right);
+};
+
+} // namespace tiny_sql
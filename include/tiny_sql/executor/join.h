@@ -0,0 +1,165 @@
+#pragma once
+
+#include "tiny_sql/sql/ast.h"
+#include "tiny_sql/storage/table.h"
+#include "tiny_sql/storage/index.h"
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+namespace tiny_sql {
+
+/**
+ * 连接算法
+ */
+enum class JoinAlgorithm {
+    HASH,                   // 哈希连接（在较小的一侧建表）
+    INDEX_NESTED_LOOP,      // 索引嵌套循环（内表连接键上有索引）
+    NESTED_LOOP             // 嵌套循环（没有等值连接键时）
+};
+
+const char* joinAlgorithmToString(JoinAlgorithm algorithm);
+
+/**
+ * 连接计划（由 CostModel::planJoin 生成）
+ */
+struct JoinPlan {
+    JoinAlgorithm algorithm = JoinAlgorithm::HASH;
+    bool build_left = false;        // 哈希连接在左表建表
+    bool index_on_left = false;     // 索引嵌套循环的内表为左表
+    double cost = 0;
+    double estimated_rows = 0;      // 估算输出行数
+};
+
+/**
+ * 连接的一侧输入
+ */
+struct JoinInput {
+    const std::vector<Row>* rows = nullptr;
+    size_t width = 0;                       // 列数
+    int key_column = -1;                    // 等值连接键所在列（-1表示无等值键）
+    DataType key_type = DataType::NULL_TYPE;
+    const OrderedIndex* index = nullptr;    // 连接键上的索引（可选）
+    const Table* table = nullptr;           // 非空时 rows 为该表的行，跳过对 view 不可见的版本
+    const ReadView* view = nullptr;
+
+    bool isLive(size_t row_id) const { return !table || table->isVisible(row_id, *view); }
+};
+
+/**
+ * 二元连接执行器
+ *
+ * 输出行布局为 [左表各列..., 右表各列...]，LEFT JOIN 未匹配时右侧补NULL。
+ * 算法和建表侧由 CostModel::planJoin 选择，前提不满足时退回哈希连接/嵌套循环。
+ * - 哈希连接：在较小一侧建哈希表，用较大一侧探测；建表侧超过
+ *   join_buffer_size 时按哈希高位分区，逐个分区建表/探测，保证哈希表常驻缓存。
+ * - 索引嵌套循环：外表很小而内表连接键有索引时，逐行查索引，免去建表。
+ * - 嵌套循环：ON 条件中没有等值键时的兜底算法。
+ */
+class JoinExecutor {
+public:
+    using RowCallback = std::function<bool(Row&&)>;
+
+    /**
+     * @param type 连接类型
+     * @param left 左表输入
+     * @param right 右表输入
+     * @param residual 除等值键外还需满足的ON条件（可为nullptr），在合并行上求值
+     * @param columns 合并行的列定义（用于求值residual）
+     * @param plan 连接计划（算法、建表侧、内表）
+     */
+    JoinExecutor(JoinType type,
+                 const JoinInput& left,
+                 const JoinInput& right,
+                 const Expression* residual,
+                 const std::vector<ColumnDef>& columns,
+                 const JoinPlan& plan);
+
+    // 连接算法
+    JoinAlgorithm getAlgorithm() const { return algorithm_; }
+
+    // 哈希连接是否在左表上建表
+    bool buildsOnLeft() const { return build_left_; }
+
+    // 索引嵌套循环的内表是否为左表
+    bool indexOnLeft() const { return index_on_left_; }
+
+    // 哈希连接分区数（1表示未分区）
+    size_t getPartitionCount() const { return partitions_; }
+
+    // 哈希表占用内存的估算（字节，非哈希连接为0）
+    size_t getBuildBytes() const { return build_bytes_; }
+
+    /**
+     * 执行连接
+     * @param emit 输出回调，返回false时提前结束
+     * @throws std::runtime_error residual 求值失败
+     */
+    void run(const RowCallback& emit);
+
+    /**
+     * 合并两表的列定义，列名改为 "表名或别名.列名"
+     */
+    static std::vector<ColumnDef> combineColumns(const std::string& left_name,
+                                                 const std::vector<ColumnDef>& left_columns,
+                                                 const std::string& right_name,
+                                                 const std::vector<ColumnDef>& right_columns);
+
+    /**
+     * 从ON条件中提取等值连接键（第一个 左表列 = 右表列 形式的AND合取项）
+     * @param columns 合并后的列定义
+     * @param left_width 左表列数
+     * @param left_key 输出：左表连接键列下标
+     * @param right_key 输出：右表连接键列下标（相对右表）
+     * @param needs_residual 输出：是否还需在合并行上检查整个ON条件
+     * @return 是否找到等值连接键
+     */
+    static bool extractEquiKey(const Expression* condition,
+                               const std::vector<ColumnDef>& columns,
+                               size_t left_width,
+                               int& left_key,
+                               int& right_key,
+                               bool& needs_residual);
+
+    /**
+     * 连接键哈希（INT/BIGINT/整数值的浮点数哈希一致，与 keysEqual 对应）
+     */
+    static uint64_t hashKey(const Value& key);
+
+    /**
+     * 连接键相等比较（数值类型跨类型比较，NULL 不等于任何值）
+     */
+    static bool keysEqual(const Value& a, const Value& b);
+
+    // 哈希表每项的估算内存（字节），用于决定分区数
+    static constexpr size_t kEntryBytes = sizeof(uint64_t) + 3 * sizeof(uint32_t);
+
+private:
+
+    void runHash(const RowCallback& emit);
+    void runIndexNestedLoop(const RowCallback& emit);
+    void runNestedLoop(const RowCallback& emit);
+
+    // 合并左右两行（right 为nullptr时补NULL）
+    Row combine(const Row& left, const Row* right) const;
+
+    // 检查 residual 条件
+    bool residualMatches(const Row& combined) const;
+
+    // LEFT JOIN：输出未匹配的左表行
+    bool emitUnmatchedLeft(const std::vector<bool>& matched, const RowCallback& emit) const;
+
+    JoinType type_;
+    JoinInput left_;
+    JoinInput right_;
+    const Expression* residual_;
+    const std::vector<ColumnDef>& columns_;
+
+    JoinAlgorithm algorithm_ = JoinAlgorithm::HASH;
+    bool build_left_ = false;
+    bool index_on_left_ = false;
+    size_t partitions_ = 1;
+    size_t build_bytes_ = 0;
+};
+
+} // namespace tiny_sql
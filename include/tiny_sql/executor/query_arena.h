@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace tiny_sql {
+
+/**
+ * 单条语句的内存池（每个线程一个）
+ * Per-statement memory arena (one per thread)
+ *
+ * 执行器的中间结果（结果行的指针列表、投影等）从单调分配器分配，逐个释放是空操作；
+ * 语句结束时由 QueryArenaScope 整体回收。首块内存跨语句保留，普通查询不再调用 malloc。
+ * Executor intermediates come from a monotonic resource whose deallocate is a no-op;
+ * QueryArenaScope releases everything at statement end. The first block is kept
+ * across statements, so typical queries never reach malloc.
+ *
+ * 从内存池分配的对象不能活过语句（结果在编码进响应缓冲区后才回收）。
+ * Nothing allocated here may outlive the statement.
+ */
+class QueryArena {
+public:
+    // 跨语句保留的首块大小
+    static constexpr size_t kInitialBlockSize = 64 * 1024;
+
+    // 当前线程的内存池
+    static std::pmr::memory_resource* resource();
+
+    // 回收当前线程内存池中的所有分配（只保留首块）
+    static void reset();
+};
+
+/**
+ * RAII：作用域结束时回收当前线程的内存池
+ */
+class QueryArenaScope {
+public:
+    QueryArenaScope() = default;
+    ~QueryArenaScope() { QueryArena::reset(); }
+
+    QueryArenaScope(const QueryArenaScope&) = delete;
+    QueryArenaScope& operator=(const QueryArenaScope&) = delete;
+};
+
+} // namespace tiny_sql
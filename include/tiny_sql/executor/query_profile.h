@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace tiny_sql {
+
+/**
+ * 计划树中一个算子的描述和执行统计（EXPLAIN / EXPLAIN ANALYZE）
+ */
+struct OperatorProfile {
+    std::string name;                       // 算子描述，如 "Table scan on t"
+    double estimated_rows = -1;             // 优化器估算的输出行数（<0 表示无估算）
+    std::vector<OperatorProfile*> children;
+
+    // 以下仅在 EXPLAIN ANALYZE 时统计
+    uint64_t rows_in = 0;                   // 输入行数
+    uint64_t rows_out = 0;                  // 输出行数
+    uint64_t rows_filtered = 0;             // 被条件过滤掉的行数
+    uint64_t bytes = 0;                     // 算子物化的数据量（估算字节）
+    uint64_t time_ns = 0;                   // 自身耗时（不含子算子和下游算子）
+    bool filters = false;                   // 是否为过滤算子（输出 filtered 统计）
+};
+
+/**
+ * 查询计划/执行剖析
+ *
+ * 执行器按自底向上的顺序创建算子：先创建数据源，再用 wrap 逐层包上
+ * 过滤、排序、聚合、LIMIT 等算子，最终的根算子通过 getRoot 获取。
+ * 剖析对象为nullptr时执行器不做任何统计。
+ */
+class QueryProfile {
+public:
+    explicit QueryProfile(bool analyze) : analyze_(analyze) {}
+
+    // 是否为 EXPLAIN ANALYZE（实际执行查询并统计）
+    bool isAnalyze() const { return analyze_; }
+
+    /**
+     * 创建算子并将其设为根
+     */
+    OperatorProfile* add(const std::string& name, double estimated_rows = -1);
+
+    /**
+     * 创建以 child 为唯一子节点的算子并将其设为根
+     */
+    OperatorProfile* wrap(const std::string& name, OperatorProfile* child,
+                          double estimated_rows = -1);
+
+    OperatorProfile* getRoot() const { return root_; }
+    void setRoot(OperatorProfile* root) { root_ = root; }
+
+    /**
+     * 渲染为缩进的树形文本，每个算子一行
+     */
+    std::vector<std::string> render() const;
+
+    /**
+     * 单调时钟（纳秒）
+     */
+    static uint64_t nowNs();
+
+private:
+    void renderOperator(const OperatorProfile* op, int depth,
+                        std::vector<std::string>& lines) const;
+
+    bool analyze_;
+    std::deque<OperatorProfile> operators_;     // deque 保证算子地址稳定
+    OperatorProfile* root_ = nullptr;
+};
+
+/**
+ * RAII计时器：将作用域内的耗时累加到算子（op 为nullptr时不计时）
+ */
+class OperatorTimer {
+public:
+    explicit OperatorTimer(OperatorProfile* op)
+        : op_(op), start_(op ? QueryProfile::nowNs() : 0) {}
+
+    ~OperatorTimer() { stop(); }
+
+    // 提前结束计时（之后的耗时不再计入）
+    void stop() {
+        if (op_) {
+            op_->time_ns += QueryProfile::nowNs() - start_;
+            op_ = nullptr;
+        }
+    }
+
+    OperatorTimer(const OperatorTimer&) = delete;
+    OperatorTimer& operator=(const OperatorTimer&) = delete;
+
+private:
+    OperatorProfile* op_;
+    uint64_t start_;
+};
+
+} // namespace tiny_sql
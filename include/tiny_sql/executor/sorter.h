@@ -0,0 +1,147 @@
+#pragma once
+
+#include "tiny_sql/common/memory_tracker.h"
+#include "tiny_sql/storage/table.h"
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+namespace tiny_sql {
+
+/**
+ * 排序键 - 行中的列下标及排序方向
+ */
+struct SortKey {
+    size_t column;
+    bool ascending = true;
+};
+
+/**
+ * 行比较器（NULL 视为最小值，与 MySQL 一致）
+ */
+class RowComparator {
+public:
+    explicit RowComparator(std::vector<SortKey> keys) : keys_(std::move(keys)) {}
+
+    // a 是否应排在 b 之前
+    bool operator()(const Row& a, const Row& b) const {
+        return compare(a, b) < 0;
+    }
+
+    // 三路比较：<0 表示 a 在前，>0 表示 b 在前
+    int compare(const Row& a, const Row& b) const;
+
+private:
+    std::vector<SortKey> keys_;
+};
+
+/**
+ * Top-N 堆 - 用于 ORDER BY ... LIMIT k
+ *
+ * 维护一个大小不超过 k 的最大堆（堆顶为当前第 k 名），
+ * 时间复杂度 O(n log k)，内存只保存 k 行。
+ */
+class TopNHeap {
+public:
+    TopNHeap(std::vector<SortKey> keys, size_t limit);
+
+    // 加入一行
+    void push(const Row& row);
+
+    // 取出排好序的结果（调用后堆被清空）
+    std::vector<Row> finish();
+
+private:
+    RowComparator comparator_;
+    size_t limit_;
+    std::vector<Row> heap_;
+};
+
+/**
+ * 排序临时文件读写失败
+ */
+class SortError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * 外部排序器 - 用于无 LIMIT 的 ORDER BY
+ *
+ * 行先累积在内存中，超过内存预算时并行排序并作为有序段溢出到临时文件；
+ * 结束时对所有有序段做 k 路归并。数据量未超过预算时完全在内存中完成。
+ * 有序段多于 kMaxMergeWidth 时，先把最小的若干段归并成新的段（删除输入段），
+ * 直到段数不超过上限再做最后一趟流式归并，同时打开的文件数因此有上限。
+ */
+class ExternalSorter {
+public:
+    using RowCallback = std::function<bool(Row&&)>;
+
+    /**
+     * @param keys 排序键
+     * @param memory_budget 内存预算（字节）
+     * @param tmpdir 临时文件目录
+     */
+    ExternalSorter(std::vector<SortKey> keys, size_t memory_budget, const std::string& tmpdir);
+    ~ExternalSorter();
+
+    ExternalSorter(const ExternalSorter&) = delete;
+    ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+    // 加入一行
+    void add(const Row& row);
+
+    /**
+     * 按顺序输出所有行
+     * @param callback 回调，返回false时提前结束
+     * @throws SortError 临时文件读写失败
+     */
+    void finish(const RowCallback& callback);
+
+    // 溢出到磁盘的有序段数量（不含中间归并产生的段）
+    size_t getRunCount() const { return spilled_runs_; }
+
+    // 一趟归并最多同时打开的有序段数
+    static constexpr size_t kMaxMergeWidth = 64;
+
+    // 并行排序的行数阈值
+    static constexpr size_t kParallelSortThreshold = 64 * 1024;
+
+    /**
+     * 原地并行排序：切分后在 WorkerPool 上各自排序，再两两归并
+     */
+    static void parallelSort(std::vector<Row>& rows, const RowComparator& comparator);
+
+    /**
+     * 估算一行占用的内存（字节）
+     */
+    static size_t estimateRowSize(const Row& row);
+
+private:
+    // 将当前内存中的行排序后写成一个有序段
+    void spill();
+
+    // 新建一个有序段临时文件（路径加入 runs_，析构时删除）
+    FILE* createRun();
+
+    // 对 paths 中的有序段做 k 路归并，按顺序交给 callback
+    void mergeRuns(const std::vector<std::string>& paths, const RowCallback& callback);
+
+    // 把 runs_ 开头的 width 个段归并成一个新段，并删除这些输入段
+    void mergeFront(size_t width);
+
+    RowComparator comparator_;
+    size_t memory_budget_;
+    std::string tmpdir_;
+
+    std::vector<Row> buffer_;
+    size_t buffer_bytes_ = 0;
+    TrackedMemory buffer_memory_;       // buffer_bytes_ 记入语句内存用量
+    std::vector<std::string> runs_;     // 有序段临时文件路径（按生成顺序）
+    size_t spilled_runs_ = 0;
+};
+
+} // namespace tiny_sql
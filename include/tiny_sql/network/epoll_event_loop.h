@@ -15,12 +15,15 @@ public:
     explicit EpollEventLoop(int max_events = 1024);
     ~EpollEventLoop() override;
 
+    using EventLoop::addFd;
+    using EventLoop::modifyFd;
+
     bool init() override;
-    bool addFd(int fd, uint32_t events) override;
-    bool modifyFd(int fd, uint32_t events) override;
+    bool addFd(int fd, uint32_t events, uint64_t token) override;
+    bool modifyFd(int fd, uint32_t events, uint64_t token) override;
     bool removeFd(int fd) override;
     int wait(int timeout = -1) override;
-    int getReadyFd(int index) const override;
+    uint64_t getReadyToken(int index) const override;
     uint32_t getReadyEvents(int index) const override;
     void close() override;
 
@@ -11,7 +11,7 @@ namespace tiny_sql {
 class EpollServer {
 public:
     using ConnectionCallback = std::function<void(std::shared_ptr<TcpConnection>)>;
-    using MessageCallback = std::function<void(std::shared_ptr<TcpConnection>, Buffer&)>;
+    using MessageCallback = TcpConnection::MessageCallback;
     using CloseCallback = std::function<void(std::shared_ptr<TcpConnection>)>;
 
     EpollServer(uint16_t port, int max_connections = 10000);
@@ -18,16 +18,21 @@ class EventLoop {
 public:
     using EventCallback = std::function<void(int fd, uint32_t events)>;
 
+    static constexpr uint64_t kInvalidToken = UINT64_MAX;
+
     virtual ~EventLoop() = default;
 
     // 初始化事件循环
     virtual bool init() = 0;
 
     // 添加文件描述符到事件循环
-    virtual bool addFd(int fd, uint32_t events) = 0;
+    // token: 随就绪事件原样返回（getReadyToken），低 32 位必须是 fd，高 32 位由调用者使用
+    virtual bool addFd(int fd, uint32_t events, uint64_t token) = 0;
+    bool addFd(int fd, uint32_t events) { return addFd(fd, events, static_cast<uint32_t>(fd)); }
 
-    // 修改文件描述符的事件
-    virtual bool modifyFd(int fd, uint32_t events) = 0;
+    // 修改文件描述符的事件（token 同 addFd）
+    virtual bool modifyFd(int fd, uint32_t events, uint64_t token) = 0;
+    bool modifyFd(int fd, uint32_t events) { return modifyFd(fd, events, static_cast<uint32_t>(fd)); }
 
     // 从事件循环移除文件描述符
     virtual bool removeFd(int fd) = 0;
@@ -37,8 +42,13 @@ public:
     // 返回就绪的事件数量
     virtual int wait(int timeout = -1) = 0;
 
-    // 获取就绪事件的文件描述符
-    virtual int getReadyFd(int index) const = 0;
+    // 获取就绪事件登记时的 token（index 无效时为 kInvalidToken）
+    virtual uint64_t getReadyToken(int index) const = 0;
+
+    // 获取就绪事件的文件描述符（token 的低 32 位，index 无效时为 -1）
+    int getReadyFd(int index) const {
+        return static_cast<int>(static_cast<uint32_t>(getReadyToken(index)));
+    }
 
     // 获取就绪事件的事件类型
     virtual uint32_t getReadyEvents(int index) const = 0;
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace tiny_sql {
+
+/**
+ * 指标导出端口（只监听 127.0.0.1）
+ * Metrics admin endpoint, loopback only
+ *
+ * 独立线程上的极简 HTTP/1.0 服务：GET /metrics（或 /）返回 Prometheus 文本格式，
+ * 每个请求处理完即关闭连接。与主事件循环无关，抓取不会占用查询线程。
+ * GET /processlist 返回进程列表，GET /kill?id=N[&query=1] 设置连接的终止标记，
+ * 用于事件循环被长查询占住、SQL 的 KILL 无法送达的情况。
+ * A minimal HTTP/1.0 server on its own thread: GET /metrics (or /) returns the
+ * Prometheus text format and closes the connection, keeping scrapes off the reactor.
+ * GET /processlist and GET /kill?id=N[&query=1] reach sessions even while the
+ * reactor is busy running a long statement.
+ */
+class MetricsServer {
+public:
+    explicit MetricsServer(uint16_t port) : port_(port) {}
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * 监听端口并启动线程
+     * @return 端口能否监听
+     */
+    bool start();
+
+    // 停止线程并关闭端口
+    void stop();
+
+private:
+    void run();
+
+    // 处理一个抓取请求
+    void handleClient(int fd);
+
+    uint16_t port_;
+    int listen_fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+} // namespace tiny_sql
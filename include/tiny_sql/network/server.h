@@ -2,18 +2,33 @@
 
 #include "tiny_sql/network/tcp_connection.h"
 #include "tiny_sql/network/event_loop.h"
-#include <unordered_map>
+#include "tiny_sql/network/timer_wheel.h"
+#include <atomic>
+#include <vector>
 #include <memory>
 #include <functional>
 #include <cstdint>
+#include <string>
 
 namespace tiny_sql {
 
-// 跨平台服务器（自动选择epoll/kqueue）
+/**
+ * 跨平台服务器（自动选择epoll/kqueue）
+ * Cross-platform server (epoll or kqueue)
+ *
+ * 连接表是按 fd 下标的数组，每个槽放连接和上层附加对象（协议处理器）。事件登记的
+ * token 是 (槽代号 << 32) | fd，分发事件时直接定位到槽，不做查找；代号不一致说明
+ * fd 已被新连接复用，丢弃旧连接的事件。本轮关闭的连接在事件处理完后才释放，
+ * 处理过程中可以直接使用裸指针。
+ * The connection table is an fd-indexed array of slots holding the connection and
+ * the upper layer's context. Events carry (generation << 32) | fd, so dispatch is an
+ * index plus a generation check; connections closed during a round are released
+ * after the round, so handlers can work with raw pointers.
+ */
 class Server {
 public:
     using ConnectionCallback = std::function<void(std::shared_ptr<TcpConnection>)>;
-    using MessageCallback = std::function<void(std::shared_ptr<TcpConnection>, Buffer&)>;
+    using MessageCallback = TcpConnection::MessageCallback;
     using CloseCallback = std::function<void(std::shared_ptr<TcpConnection>)>;
 
     Server(uint16_t port, int max_connections = 10000);
@@ -26,8 +41,18 @@ public:
     // 启动服务器
     void start();
 
-    // 停止服务器
-    void stop();
+    /**
+     * 停止服务器（事件循环在本轮结束后退出）
+     * 只写原子变量和唤醒管道，可在信号处理函数中调用；日志由事件循环醒来后输出
+     * @param signum 触发停止的信号，0 表示不是信号
+     */
+    void stop(int signum = 0);
+
+    /**
+     * 另外在 Unix 域 socket 上监听，由同一个事件循环服务，需在 start 之前设置
+     * @param path socket 文件路径，空串表示不监听
+     */
+    void setUnixSocketPath(const std::string& path) { unix_socket_path_ = path; }
 
     // 设置回调
     void setConnectionCallback(const ConnectionCallback& cb) {
@@ -42,29 +67,73 @@ public:
         close_callback_ = cb;
     }
 
+    /**
+     * 把上层对象（如协议处理器）放进连接所在的槽，连接关闭时一起释放；
+     * 连接通过 getContext() 取得它（不增加引用计数）
+     */
+    void setContext(TcpConnection& conn, std::shared_ptr<void> context);
+
+    /**
+     * 事件循环的时间轮：每次等待的超时取自最近的定时器，回调在事件循环线程执行
+     * 可在 start 之前添加周期任务（如后台维护）
+     */
+    TimerWheel& timers() { return timers_; }
+
+    /**
+     * 设置输出背压限制
+     * @param high_water_mark 单个连接待发送数据的高水位（字节），超过后暂停读取该连接，0 表示不限制
+     * @param max_output_memory 所有连接待发送数据的总上限（字节），超过后从积压最久的连接开始断开，0 表示不限制
+     */
+    void setOutputLimits(size_t high_water_mark, size_t max_output_memory) {
+        high_water_mark_ = high_water_mark;
+        max_output_memory_ = max_output_memory;
+    }
+
 private:
+    // 连接槽
+    struct ConnectionSlot {
+        std::shared_ptr<TcpConnection> conn;
+        std::shared_ptr<void> context;          // 上层附加对象
+        uint32_t generation = 0;                // 每次有新连接占用这个槽时加一
+    };
+
     // 事件循环
     void eventLoop();
 
-    // 处理新连接
-    void handleAccept();
+    // 事件循环退出后关闭所有连接、事件循环和监听 socket
+    void shutdown();
+
+    // 创建唤醒管道并加入事件循环
+    bool initWakeup();
 
-    // 处理读事件
-    void handleRead(int fd);
+    // 接受监听 socket 上的新连接
+    void handleAccept(int listen_fd);
 
-    // 处理写事件
-    void handleWrite(int fd);
+    // 处理一个连接的就绪事件
+    void handleEvents(uint64_t token, uint32_t events);
 
-    // 处理关闭
+    // 处理关闭（从事件循环和连接表中移除，本轮结束后释放）
     void handleClose(int fd);
 
+    // 积压总量超过上限时，按积压开始时间从早到晚断开连接，直到回到上限以内
+    void shedSlowConsumers();
+
     uint16_t port_;
     int max_connections_;
     int listen_fd_;
-    bool running_;
+    std::string unix_socket_path_;
+    int unix_listen_fd_ = -1;
+    std::atomic<bool> running_;
+    std::atomic<int> stop_signal_{0};
+    int wakeup_fds_[2] = {-1, -1};              // stop 写入一个字节，唤醒阻塞中的 wait
+    size_t high_water_mark_ = 0;
+    size_t max_output_memory_ = 0;
 
     std::unique_ptr<EventLoop> event_loop_;
-    std::unordered_map<int, std::shared_ptr<TcpConnection>> connections_;
+    TimerWheel timers_;
+    std::vector<ConnectionSlot> slots_;         // 按 fd 下标
+    size_t connection_count_ = 0;
+    std::vector<ConnectionSlot> closed_;        // 本轮关闭、等待释放的连接
 
     ConnectionCallback connection_callback_;
     MessageCallback message_callback_;
@@ -7,8 +7,11 @@ namespace tiny_sql {
 
 class SocketUtils {
 public:
-    // 创建TCP监听socket
-    static int createListenSocket(uint16_t port, int backlog = 1024);
+    // 创建TCP监听socket（loopback_only 时只绑定 127.0.0.1）
+    static int createListenSocket(uint16_t port, int backlog = 1024, bool loopback_only = false);
+
+    // 创建 Unix 域监听socket（path 上残留的、没有服务器在监听的 socket 文件会被删除）
+    static int createUnixListenSocket(const std::string& path, int backlog = 1024);
 
     // 设置非阻塞模式
     static bool setNonBlocking(int fd);
@@ -34,7 +37,7 @@ public:
     // 获取本地地址
     static std::string getLocalAddress(int fd);
 
-    // 接受新连接
+    // 接受新连接（Unix 域连接的对端地址为 localhost）
     static int acceptConnection(int listen_fd, std::string& peer_addr);
 };
 
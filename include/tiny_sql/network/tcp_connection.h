@@ -1,15 +1,31 @@
 #pragma once
 
 #include "tiny_sql/common/buffer.h"
+#include "tiny_sql/common/buffer_chain.h"
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <functional>
 
 namespace tiny_sql {
 
+class EventLoop;
+class TimerWheel;
+
+/**
+ * TCP 连接
+ *
+ * 输出背压：有待发送数据时在事件循环中登记可写事件，写完后取消；待发送数据超过
+ * 高水位时暂停读取新命令（取消可读事件），降到高水位一半以下再恢复。所有连接的
+ * 积压字节数计入 Output_buffer_bytes，由 Server 按全局上限断开积压最久的连接。
+ * Output backpressure: write interest is registered while output is pending and
+ * dropped once drained. Above the high-water mark the connection stops reading new
+ * commands until the backlog falls below half of it. Backlogs are summed into
+ * Output_buffer_bytes so the Server can enforce a global cap.
+ */
 class TcpConnection : public std::enable_shared_from_this<TcpConnection> {
 public:
-    using MessageCallback = std::function<void(std::shared_ptr<TcpConnection>, Buffer&)>;
+    using MessageCallback = std::function<void(TcpConnection&, Buffer&)>;
     using CloseCallback = std::function<void(std::shared_ptr<TcpConnection>)>;
     using WriteCompleteCallback = std::function<void(std::shared_ptr<TcpConnection>)>;
 
@@ -32,22 +48,64 @@ public:
     // 读取数据
     ssize_t read();
 
-    // 发送数据
+    // 发送数据（输出队列非空时追加到队尾，保证顺序）
     ssize_t send(const void* data, size_t len);
     ssize_t send(const std::string& data);
     ssize_t send(const Buffer& buffer);
 
+    /**
+     * 把一段已编码的数据移入输出队列，不立即写出
+     * 一次命令的所有响应段排队后由 flush 用一次 writev 写出
+     */
+    void queue(Buffer&& buffer);
+
+    /**
+     * 用 writev 写出输出队列，直到写完或遇到 EAGAIN（剩余部分留在队列中）
+     * @return 写出的字节数，出错时为 -1
+     */
+    ssize_t flush();
+
     // 关闭连接
     void close();
 
     // 强制关闭连接
     void forceClose();
 
+    /**
+     * 登记到事件循环（用于根据输出积压切换关注的事件），当前关注的事件为 events，
+     * token 为登记时使用的事件 token，修改关注的事件时原样带上
+     */
+    void setEventLoop(EventLoop* loop, uint32_t events, uint64_t token) {
+        loop_ = loop;
+        interest_ = events;
+        token_ = token;
+    }
+
+    /**
+     * 上层附加在连接上的对象（如协议处理器），不持有所有权
+     * 由 Server 的连接槽持有，与连接一起释放
+     */
+    void setContext(void* context) { context_ = context; }
+    void* getContext() const { return context_; }
+
+    // 所在事件循环的时间轮（握手和空闲超时用），未设置时为 nullptr
+    void setTimerWheel(TimerWheel* timers) { timers_ = timers; }
+    TimerWheel* getTimerWheel() const { return timers_; }
+
+    // 待发送数据的高水位（字节），0 表示不限制
+    void setHighWaterMark(size_t bytes) { high_water_mark_ = bytes; }
+
+    // 是否因输出积压暂停读取
+    bool isReadingPaused() const { return reading_paused_; }
+
+    // 待发送数据开始积压的时间（纳秒，没有积压时为0）
+    uint64_t pendingSinceNs() const { return pending_since_ns_; }
+
     // 获取输入缓冲区
     Buffer& getInputBuffer() { return input_buffer_; }
 
-    // 获取输出缓冲区
-    Buffer& getOutputBuffer() { return output_buffer_; }
+    // 获取输出队列
+    BufferChain& getOutputBuffer() { return output_buffer_; }
 
     // 设置回调
     void setMessageCallback(const MessageCallback& cb) { message_callback_ = cb; }
@@ -61,12 +119,28 @@ public:
     void handleError();
 
 private:
+    /**
+     * 输出积压变化后更新全局统计、读暂停状态和事件循环中关注的事件
+     * @return 是否刚刚从读暂停中恢复
+     */
+    bool updateOutputState();
+
     int fd_;
     std::string peer_addr_;
     bool connected_;
 
+    EventLoop* loop_ = nullptr;
+    TimerWheel* timers_ = nullptr;
+    uint32_t interest_ = 0;
+    uint64_t token_ = 0;
+    void* context_ = nullptr;
+    size_t high_water_mark_ = 0;
+    bool reading_paused_ = false;
+    size_t accounted_output_ = 0;       // 已计入 Output_buffer_bytes 的字节数
+    uint64_t pending_since_ns_ = 0;
+
     Buffer input_buffer_;
-    Buffer output_buffer_;
+    BufferChain output_buffer_;
 
     MessageCallback message_callback_;
     CloseCallback close_callback_;
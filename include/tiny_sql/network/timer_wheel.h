@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace tiny_sql {
+
+/**
+ * 分层时间轮（事件循环线程专用，不加锁）
+ * Hierarchical timer wheel (event loop thread only, no locking)
+ *
+ * 4 层、每层 64 个槽，第 0 层每槽一个 tick（默认 10ms），上层每槽覆盖下层一整圈，
+ * 共覆盖 64^4 个 tick（10ms 时约 46 小时），更远的定时器先放在最高层。
+ * 添加、取消都是 O(1)（槽内为侵入式双向链表）；第 0 层转完一圈时把上层对应槽的
+ * 定时器重新分配到下层。每层一个 64 位占用位图，nextTimeoutMs 用它算出下一次
+ * 需要醒来的时间，作为 epoll_wait 的超时。
+ * Four levels of 64 slots; level 0 has one tick per slot and each higher slot spans a
+ * full turn of the level below (64^4 ticks, ~46 hours at 10ms). Add and cancel are
+ * O(1) via intrusive lists; higher slots cascade down when level 0 wraps. Per-level
+ * occupancy bitmaps give the next wakeup for the event loop's wait timeout.
+ */
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+    using TimerId = uint64_t;      // 0 表示无效
+
+    static constexpr uint32_t kLevels = 4;
+    static constexpr uint32_t kSlotBits = 6;
+    static constexpr uint32_t kSlots = 1u << kSlotBits;
+
+    explicit TimerWheel(uint32_t tick_ms = 10);
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * delay_ms 毫秒后调用一次 callback（按 tick 向上取整）
+     */
+    TimerId schedule(uint64_t delay_ms, Callback callback);
+
+    /**
+     * 每隔 interval_ms 毫秒调用一次 callback，直到被取消
+     */
+    TimerId scheduleEvery(uint64_t interval_ms, Callback callback);
+
+    /**
+     * 取消定时器；回调执行期间取消自身也是安全的
+     * @return 定时器是否存在
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * 推进到当前时间，执行所有到期的回调
+     * @return 执行的回调数
+     */
+    size_t advance();
+
+    /**
+     * 距下一次需要 advance 的毫秒数（没有定时器时为 -1），用作事件循环等待的超时
+     */
+    int nextTimeoutMs() const;
+
+    // 等待中的定时器数
+    size_t size() const { return size_; }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    enum class State : uint8_t { FREE, PENDING, FIRING };
+
+    struct Node {
+        uint64_t expire = 0;            // 到期 tick
+        uint64_t interval = 0;          // 周期（tick），0 表示一次性
+        Callback callback;
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t generation = 1;
+        uint8_t level = 0;
+        uint8_t slot = 0;
+        State state = State::FREE;
+        bool cancelled = false;         // 回调执行期间被取消
+    };
+
+    // 当前时间对应的 tick
+    uint64_t clockTick() const;
+
+    TimerId add(uint64_t expire, uint64_t interval, Callback callback);
+
+    // 按到期 tick 放入对应层的槽
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void freeNode(uint32_t index);
+
+    // 把上层一个槽的定时器重新分配到下层
+    void cascade(uint32_t level, uint32_t slot);
+
+    // 处理 tick_ 这一个 tick
+    size_t runTick();
+
+    uint32_t tick_ms_;
+    uint64_t start_ms_;                 // tick 0 对应的时间
+    uint64_t tick_ = 0;                 // 下一个待处理的 tick
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_nodes_;
+    std::array<std::array<uint32_t, kSlots>, kLevels> heads_;
+    std::array<uint64_t, kLevels> occupied_{};
+    uint32_t detached_head_ = kNil;     // runTick 正在执行的槽
+    size_t size_ = 0;
+};
+
+} // namespace tiny_sql
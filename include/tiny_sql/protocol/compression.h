@@ -0,0 +1,84 @@
+#pragma once
+
+#include "tiny_sql/common/buffer.h"
+#include <cstddef>
+#include <cstdint>
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
+
+namespace tiny_sql {
+
+/**
+ * 压缩协议使用的算法
+ */
+enum class CompressionAlgorithm : uint8_t {
+    NONE,
+    ZLIB,       // CLIENT_COMPRESS
+    ZSTD        // CLIENT_ZSTD_COMPRESSION_ALGORITHM
+};
+
+/**
+ * MySQL 压缩协议的帧编解码（每个连接一个，位于 TcpConnection 和包处理之间）
+ * Compressed protocol framing, one per connection, between TcpConnection and packet handling
+ *
+ * 每帧 7 字节头：3 字节帧内容长度、1 字节压缩序号、3 字节压缩前长度（0 表示内容未压缩），
+ * 帧内容是普通 MySQL 包的字节流，一个包可以跨多个帧。短于 min_length 的内容和压缩后
+ * 没有变小的内容原样发送。压缩序号独立于包序号，由客户端每条命令的第一帧重新对齐。
+ * A 7-byte header (payload length, compressed sequence id, uncompressed length or 0 for
+ * stored payloads) precedes a slice of the ordinary packet stream; packets may span
+ * frames. Payloads shorter than min_length, or that don't shrink, are stored as-is.
+ */
+class CompressionCodec {
+public:
+    static constexpr size_t kHeaderSize = 7;
+    static constexpr size_t kMaxPayload = 0xFFFFFF;
+
+    CompressionCodec(CompressionAlgorithm algorithm, int level, size_t min_length);
+    ~CompressionCodec();
+
+    // 禁止拷贝
+    CompressionCodec(const CompressionCodec&) = delete;
+    CompressionCodec& operator=(const CompressionCodec&) = delete;
+
+    // 编译时是否带了该算法的库
+    static bool isAvailable(CompressionAlgorithm algorithm);
+
+    CompressionAlgorithm getAlgorithm() const { return algorithm_; }
+
+    /**
+     * 从 input 取出所有完整的帧，还原后追加到 output；不完整的帧留在 input
+     * 之后发出的帧的序号接在最后一个收到的帧之后
+     * @return 压缩数据损坏时为 false
+     */
+    bool decode(Buffer& input, Buffer& output);
+
+    /**
+     * 把 len 字节包流封成帧追加到 frames（超过单帧上限时拆成多帧）
+     */
+    void encode(const uint8_t* data, size_t len, Buffer& frames);
+
+    // 下一个发出的帧的序号
+    uint8_t getSequenceId() const { return sequence_id_; }
+
+private:
+    /**
+     * 把 data 压缩后追加到 out
+     * @return 压缩后的长度，失败时为 0（out 不变）
+     */
+    size_t compress(const uint8_t* data, size_t len, Buffer& out);
+
+    // 解压到 out，解出的长度必须正好是 out_len
+    bool decompress(const uint8_t* data, size_t len, uint8_t* out, size_t out_len);
+
+    CompressionAlgorithm algorithm_;
+    int level_;
+    size_t min_length_;
+    uint8_t sequence_id_ = 0;
+
+    // zstd 的压缩/解压上下文，按连接复用
+    ZSTD_CCtx_s* zstd_cctx_ = nullptr;
+    ZSTD_DCtx_s* zstd_dctx_ = nullptr;
+};
+
+} // namespace tiny_sql
@@ -36,6 +36,12 @@ namespace CapabilityFlags {
     constexpr uint32_t CLIENT_CAN_HANDLE_EXPIRED_PASSWORDS = 0x00400000;
     constexpr uint32_t CLIENT_SESSION_TRACK = 0x00800000;
     constexpr uint32_t CLIENT_DEPRECATE_EOF = 0x01000000;
+    constexpr uint32_t CLIENT_ZSTD_COMPRESSION_ALGORITHM = 0x04000000;
+
+    // 服务器默认通告的能力（压缩能力按编译和配置另行添加）
+    constexpr uint32_t SERVER_DEFAULT = CLIENT_LONG_PASSWORD | CLIENT_PROTOCOL_41 |
+                                        CLIENT_SECURE_CONNECTION | CLIENT_PLUGIN_AUTH |
+                                        CLIENT_CONNECT_WITH_DB | CLIENT_DEPRECATE_EOF;
 }
 
 /**
@@ -146,6 +152,8 @@ private:
  *   - lenenc-str: key
  *   - lenenc-str: value
  *   - ... more key-values
+ * - if CLIENT_ZSTD_COMPRESSION_ALGORITHM:
+ *   - 1 byte: zstd compression level
  */
 class HandshakeResponse41Packet : public Packet {
 public:
@@ -163,6 +171,7 @@ public:
     const std::vector<uint8_t>& getAuthResponse() const { return auth_response_; }
     const std::string& getDatabase() const { return database_; }
     const std::string& getAuthPluginName() const { return auth_plugin_name_; }
+    uint8_t getZstdCompressionLevel() const { return zstd_compression_level_; }
 
     // Setters
     void setCapabilityFlags(uint32_t flags) { capability_flags_ = flags; }
@@ -172,6 +181,7 @@ public:
     void setAuthResponse(const std::vector<uint8_t>& response) { auth_response_ = response; }
     void setDatabase(const std::string& database) { database_ = database; }
     void setAuthPluginName(const std::string& name) { auth_plugin_name_ = name; }
+    void setZstdCompressionLevel(uint8_t level) { zstd_compression_level_ = level; }
 
 private:
     uint32_t capability_flags_ = 0;
@@ -181,6 +191,7 @@ private:
     std::vector<uint8_t> auth_response_;
     std::string database_;
     std::string auth_plugin_name_;
+    uint8_t zstd_compression_level_ = 3;    // 客户端没有指定时 zstd 的默认级别
 };
 
 } // namespace tiny_sql
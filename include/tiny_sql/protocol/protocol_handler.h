@@ -4,6 +4,8 @@
 #include "tiny_sql/session/session.h"
 #include "tiny_sql/command/command_handler.h"
 #include "tiny_sql/network/tcp_connection.h"
+#include "tiny_sql/network/timer_wheel.h"
+#include "tiny_sql/protocol/compression.h"
 #include <memory>
 #include <functional>
 
@@ -12,11 +14,15 @@ namespace tiny_sql {
 /**
  * MySQL协议处理器
  * 负责处理完整的MySQL协议流程：握手、认证、命令处理
+ *
+ * 认证时协商了压缩协议的连接，OK 包之后的收发都经过 CompressionCodec：
+ * 收到的帧先还原到 plain_input_ 再按包处理，响应先攒在 plain_output_，
+ * 攒够一块或写出前封成帧放进连接的输出队列。
  */
 class ProtocolHandler {
 public:
     explicit ProtocolHandler(std::shared_ptr<TcpConnection> conn);
-    ~ProtocolHandler() = default;
+    ~ProtocolHandler();
 
     /**
      * 处理接收到的数据
@@ -36,6 +42,11 @@ public:
     void sendHandshake();
 
 private:
+    /**
+     * 处理一个完整的包（packet 中可能只剩这一个包）
+     */
+    bool handlePacket(Buffer& packet, size_t packet_size);
+
     /**
      * 处理认证响应
      */
@@ -47,13 +58,52 @@ private:
     bool handleCommand(Buffer& buffer);
 
     /**
-     * 发送响应包
+     * 发送响应包：移入连接的输出队列，由 flushResponses 统一写出
      */
     void sendResponse(Buffer& response);
 
+    /**
+     * 用一次 writev 写出已排队的响应段
+     */
+    void flushResponses();
+
+    /**
+     * 压缩协议：把 plain_output_ 中攒下的响应封成帧放进连接的输出队列
+     */
+    void queueCompressed();
+
+    /**
+     * 把已编码的数据移入连接的输出队列并计入发送字节数
+     */
+    void queueOutput(Buffer&& data);
+
+    /**
+     * 握手超时：connect_timeout 内没有完成认证，断开连接
+     */
+    void onHandshakeTimeout();
+
+    /**
+     * 空闲超时检查：距上一条命令结束超过空闲超时则发送 ER_CLIENT_INTERACTION_TIMEOUT 并断开，
+     * 否则按剩余时间重新定时（每条命令不必重设定时器）
+     */
+    void onIdleTimeout();
+
+    /**
+     * 在连接所在事件循环的时间轮上重设超时定时器（delay_ms 为 0 时只取消）
+     */
+    void armTimeout(uint64_t delay_ms, void (ProtocolHandler::*handler)());
+
     std::shared_ptr<TcpConnection> connection_;
     std::shared_ptr<Session> session_;
     std::unique_ptr<CommandDispatcher> command_dispatcher_;
+
+    std::unique_ptr<CompressionCodec> compression_;     // 未协商压缩时为空
+    Buffer plain_input_;                    // 解压后待处理的包
+    Buffer plain_output_;                   // 待压缩的响应
+
+    TimerWheel::TimerId timeout_timer_ = 0;
+    uint32_t idle_timeout_ = 0;             // 认证后的空闲超时（秒）
+    uint64_t last_activity_ns_ = 0;         // 上一个包处理完的时间
 };
 
 } // namespace tiny_sql
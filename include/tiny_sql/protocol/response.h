@@ -44,7 +44,7 @@ namespace MySQLCharset {
  * OK 包
  *
  * 包结构（Protocol 4.1）：
- * - 1 byte: header (0x00 for OK, 0xFE for EOF in some contexts)
+ * - 1 byte: header (0x00 for OK；协商了 CLIENT_DEPRECATE_EOF 时，结果集末尾的 OK 包为 0xFE)
  * - lenenc-int: affected rows
  * - lenenc-int: last insert id
  * - 2 bytes: status flags
@@ -63,6 +63,7 @@ public:
     size_t getPayloadLength() const override;
 
     // Getters
+    uint8_t getHeader() const { return header_; }
     uint64_t getAffectedRows() const { return affected_rows_; }
     uint64_t getLastInsertId() const { return last_insert_id_; }
     uint16_t getStatusFlags() const { return status_flags_; }
@@ -70,6 +71,7 @@ public:
     const std::string& getInfo() const { return info_; }
 
     // Setters
+    void setHeader(uint8_t header) { header_ = header; }
     void setAffectedRows(uint64_t rows) { affected_rows_ = rows; }
     void setLastInsertId(uint64_t id) { last_insert_id_ = id; }
     void setStatusFlags(uint16_t flags) { status_flags_ = flags; }
@@ -77,6 +79,7 @@ public:
     void setInfo(const std::string& info) { info_ = info; }
 
 private:
+    uint8_t header_ = 0x00;
     uint64_t affected_rows_;
     uint64_t last_insert_id_;
     uint16_t status_flags_;
@@ -225,6 +228,15 @@ public:
     void addValue(const Value& value);
     size_t getValueCount() const { return values_.size(); }
 
+    /**
+     * 直接把一行编码进 buffer，不复制值、不建临时 payload
+     * Encode a row straight into the buffer without copying values or a temporary payload
+     *
+     * @param projection 要输出的列下标（nullptr 表示所有列）
+     */
+    static void encodeRow(Buffer& buffer, const Row& row, const std::vector<size_t>* projection,
+                          uint8_t sequence_id);
+
 private:
     std::vector<Value> values_;
 };
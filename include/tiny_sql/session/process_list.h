@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tiny_sql {
+
+class Session;
+
+/**
+ * SHOW PROCESSLIST 的一行
+ */
+struct ProcessInfo {
+    uint32_t id = 0;
+    std::string user;
+    std::string host;
+    std::string db;
+    std::string command;        // Sleep / Query / Init DB / Killed ...
+    uint64_t time = 0;          // 处于当前状态的秒数
+    std::string state;          // 执行中为 "executing"
+    std::string info;           // 正在执行的语句
+};
+
+/**
+ * 全局会话注册表（全局单例）
+ * Global session registry (singleton)
+ *
+ * 每个连接在建立时登记，命令开始/结束时更新当前命令和语句。所有字段在注册表
+ * 锁内复制一份，其他线程（如管理端口）读取时不会访问会话对象本身的非原子字段。
+ * KILL 只设置会话的原子终止标记，正在执行的语句在下一个 morsel 检查点中断；
+ * 空闲连接的关闭回调只能在事件循环线程调用。
+ * Connections register on accept and update their current command around every
+ * dispatch. Fields are copied under the registry lock so other threads never touch
+ * the session's non-atomic state. KILL only sets the session's atomic flag; a running
+ * statement stops at its next morsel check, and idle connections may only be closed
+ * from the event loop thread.
+ */
+class ProcessList {
+public:
+    static ProcessList& instance();
+
+    /**
+     * 登记连接
+     * @param close_connection 关闭连接的回调（只在事件循环线程调用）
+     */
+    void add(Session& session, const std::string& host, std::function<void()> close_connection);
+
+    void remove(const Session& session);
+
+    // 命令开始：记录命令名和语句，并清除上一条语句遗留的 KILL QUERY 标记
+    void beginCommand(Session& session, const char* command, std::string_view query);
+
+    // 命令结束：回到 Sleep，同步用户名和当前数据库
+    void endCommand(Session& session);
+
+    // 按连接ID排序的快照
+    std::vector<ProcessInfo> snapshot() const;
+
+    enum class KillResult {
+        NOT_FOUND,
+        RUNNING,        // 目标正在执行命令，将在检查点中断
+        IDLE,           // 目标空闲
+    };
+
+    /**
+     * 设置终止标记
+     * @param query_only true 为 KILL QUERY（只中断当前语句），false 为 KILL CONNECTION
+     */
+    KillResult kill(uint32_t id, bool query_only);
+
+    /**
+     * 关闭空闲连接（只能在事件循环线程调用）
+     */
+    void closeConnection(uint32_t id);
+
+private:
+    ProcessList() = default;
+
+    struct Entry {
+        Session* session = nullptr;
+        std::string host;
+        std::function<void()> close_connection;
+        std::string user;
+        std::string db;
+        std::string command = "Connect";
+        std::string query;
+        bool running = false;
+        std::chrono::steady_clock::time_point since;
+    };
+
+    mutable std::mutex mutex_;
+    std::map<uint32_t, Entry> entries_;
+};
+
+} // namespace tiny_sql
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "tiny_sql/common/metrics.h"
+#include "tiny_sql/common/query_interrupt.h"
+#include <atomic>
 #include <string>
 #include <cstdint>
 #include <memory>
@@ -7,6 +10,8 @@
 
 namespace tiny_sql {
 
+class Transaction;
+
 /**
  * 会话状态枚举
  */
@@ -27,7 +32,7 @@ enum class SessionState {
 class Session {
 public:
     explicit Session(uint32_t connection_id);
-    ~Session() = default;
+    ~Session();
 
     // 禁止拷贝和赋值
     Session(const Session&) = delete;
@@ -40,6 +45,8 @@ public:
     const std::string& getCurrentDatabase() const { return current_database_; }
     uint8_t getSequenceId() const { return sequence_id_; }
     const std::array<uint8_t, 20>& getAuthPluginData() const { return auth_plugin_data_; }
+    uint32_t getClientFlags() const { return client_flags_; }
+    bool hasClientFlag(uint32_t flag) const { return (client_flags_ & flag) != 0; }
     bool isAuthenticated() const { return state_ == SessionState::AUTHENTICATED ||
                                           state_ == SessionState::COMMAND_PHASE; }
 
@@ -48,12 +55,28 @@ public:
     void setUsername(const std::string& username) { username_ = username; }
     void setCurrentDatabase(const std::string& database) { current_database_ = database; }
     void setAuthPluginData(const std::array<uint8_t, 20>& data) { auth_plugin_data_ = data; }
+    void setClientFlags(uint32_t flags) { client_flags_ = flags; }
 
     // 序列号管理
     uint8_t nextSequenceId() { return sequence_id_++; }
     void resetSequenceId() { sequence_id_ = 0; }
     void setSequenceId(uint8_t id) { sequence_id_ = id; }
 
+    // 事务管理（BEGIN 开启的显式事务；为空表示自动提交）
+    const std::shared_ptr<Transaction>& getTransaction() const { return transaction_; }
+    void setTransaction(std::shared_ptr<Transaction> txn) { transaction_ = std::move(txn); }
+    bool inTransaction() const { return transaction_ != nullptr; }
+
+    // OK/EOF 包中的服务器状态标志（SERVER_STATUS_AUTOCOMMIT，事务中加 SERVER_STATUS_IN_TRANS）
+    uint16_t getServerStatus() const;
+
+    // 当前语句的耗时和资源统计（每条命令开始时清零）
+    StatementStats& getStats() { return stats_; }
+
+    // 终止标记：KILL 可从任意线程设置，执行线程在检查点读取
+    std::atomic<KillState>& getKillState() { return kill_state_; }
+    bool isKilled() const { return kill_state_.load(std::memory_order_relaxed) == KillState::CONNECTION; }
+
     // 会话信息
     std::string getSessionInfo() const;
 
@@ -64,10 +87,13 @@ private:
     std::string current_database_;        // 当前数据库
     uint8_t sequence_id_;                 // MySQL协议包序列号
     std::array<uint8_t, 20> auth_plugin_data_;  // 认证挑战数据
+    uint32_t client_flags_ = 0;           // 双方都支持的能力标志（握手时协商）
+    std::shared_ptr<Transaction> transaction_;  // 当前显式事务
+    StatementStats stats_;                // 当前语句的耗时和资源统计
+    std::atomic<KillState> kill_state_{KillState::NONE};  // KILL 终止标记
 
     // 未来可以添加更多字段：
     // - 字符集
-    // - 事务状态
     // - 自动提交标志
     // - 时区
     // - SQL模式
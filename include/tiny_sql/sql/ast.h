@@ -24,16 +24,23 @@ public:
 };
 
 /**
- * 标识符表达式
+ * 标识符表达式（列名，可带表名/别名限定：a.x）
  */
 class Identifier : public Expression {
 public:
     explicit Identifier(const std::string& name) : name_(name) {}
+    Identifier(const std::string& qualifier, const std::string& name)
+        : qualifier_(qualifier), name_(name) {}
 
-    std::string toString() const override { return name_; }
+    std::string toString() const override {
+        return qualifier_.empty() ? name_ : qualifier_ + "." + name_;
+    }
     const std::string& getName() const { return name_; }
+    const std::string& getQualifier() const { return qualifier_; }
+    bool isQualified() const { return !qualifier_.empty(); }
 
 private:
+    std::string qualifier_;     // 表名或别名（可为空）
     std::string name_;
 };
 
@@ -91,6 +98,38 @@ private:
     std::unique_ptr<Expression> right_;
 };
 
+/**
+ * 函数调用表达式（目前用于聚合函数 COUNT/SUM/MIN/MAX/AVG）
+ */
+class FunctionCall : public Expression {
+public:
+    FunctionCall(const std::string& name, std::vector<std::unique_ptr<Expression>> args)
+        : name_(name)
+        , args_(std::move(args)) {}
+
+    std::string toString() const override {
+        std::string result = name_ + "(";
+        for (size_t i = 0; i < args_.size(); ++i) {
+            if (i > 0) result += ", ";
+            result += args_[i]->toString();
+        }
+        return result + ")";
+    }
+
+    const std::string& getName() const { return name_; }
+    const std::vector<std::unique_ptr<Expression>>& getArgs() const { return args_; }
+
+    // 是否为聚合函数
+    bool isAggregate() const {
+        return name_ == "COUNT" || name_ == "SUM" || name_ == "AVG" ||
+               name_ == "MIN" || name_ == "MAX";
+    }
+
+private:
+    std::string name_;      // 函数名（大写）
+    std::vector<std::unique_ptr<Expression>> args_;
+};
+
 /**
  * SQL 语句基类
  */
@@ -99,6 +138,37 @@ public:
     virtual ~Statement() = default;
 };
 
+/**
+ * ORDER BY 排序项
+ */
+struct OrderByItem {
+    std::unique_ptr<Expression> expr;
+    bool ascending = true;
+};
+
+/**
+ * 连接类型
+ */
+enum class JoinType {
+    INNER,
+    LEFT
+};
+
+/**
+ * JOIN 子句：JOIN table [alias] ON condition
+ */
+struct JoinClause {
+    JoinType type = JoinType::INNER;
+    std::string table_name;
+    std::string alias;                      // 为空时使用表名
+    std::unique_ptr<Expression> condition;
+
+    // 引用该表时使用的名字
+    const std::string& getReferenceName() const {
+        return alias.empty() ? table_name : alias;
+    }
+};
+
 /**
  * SELECT 语句
  */
@@ -114,10 +184,26 @@ public:
         table_name_ = table;
     }
 
+    void setTableAlias(const std::string& alias) {
+        table_alias_ = alias;
+    }
+
+    void setJoin(std::unique_ptr<JoinClause> join) {
+        join_ = std::move(join);
+    }
+
     void setWhereClause(std::unique_ptr<Expression> where) {
         where_clause_ = std::move(where);
     }
 
+    void addGroupBy(std::unique_ptr<Expression> expr) {
+        group_by_.push_back(std::move(expr));
+    }
+
+    void addOrderBy(std::unique_ptr<Expression> expr, bool ascending) {
+        order_by_.push_back(OrderByItem{std::move(expr), ascending});
+    }
+
     void setLimit(int limit) { limit_ = limit; }
     void setOffset(int offset) { offset_ = offset; }
 
@@ -125,14 +211,26 @@ public:
 
     const std::vector<std::unique_ptr<Expression>>& getColumns() const { return columns_; }
     const std::string& getTableName() const { return table_name_; }
+    const std::string& getTableAlias() const { return table_alias_; }
+    const JoinClause* getJoin() const { return join_.get(); }
+    bool hasJoin() const { return join_ != nullptr; }
     const Expression* getWhereClause() const { return where_clause_.get(); }
+    const std::vector<std::unique_ptr<Expression>>& getGroupBy() const { return group_by_; }
+    const std::vector<OrderByItem>& getOrderBy() const { return order_by_; }
     int getLimit() const { return limit_; }
     int getOffset() const { return offset_; }
 
+    // 是否包含聚合（聚合函数或GROUP BY）
+    bool hasAggregation() const;
+
 private:
     std::vector<std::unique_ptr<Expression>> columns_;
     std::string table_name_;
+    std::string table_alias_;
+    std::unique_ptr<JoinClause> join_;
     std::unique_ptr<Expression> where_clause_;
+    std::vector<std::unique_ptr<Expression>> group_by_;
+    std::vector<OrderByItem> order_by_;
     int limit_ = -1;
     int offset_ = 0;
 };
@@ -140,6 +238,11 @@ private:
 /**
  * INSERT 语句
  */
+struct Assignment {
+    std::string column;
+    std::unique_ptr<Expression> value;
+};
+
 class InsertStatement : public Statement {
 public:
     InsertStatement() = default;
@@ -150,20 +253,85 @@ public:
         columns_.push_back(column);
     }
 
-    void addValue(std::unique_ptr<Expression> value) {
-        values_.push_back(std::move(value));
+    // 一行 VALUES (...)；多行插入时依次添加
+    void addRow(std::vector<std::unique_ptr<Expression>> values) {
+        rows_.push_back(std::move(values));
+    }
+
+    // INSERT IGNORE：违反唯一约束的行被跳过
+    void setIgnore(bool ignore) { ignore_ = ignore; }
+
+    // ON DUPLICATE KEY UPDATE 的赋值（表达式中 VALUES(col) 引用待插入的值）
+    void addDuplicateAssignment(const std::string& column, std::unique_ptr<Expression> value) {
+        duplicate_assignments_.push_back({column, std::move(value)});
     }
 
     std::string toString() const override;
 
     const std::string& getTableName() const { return table_name_; }
     const std::vector<std::string>& getColumns() const { return columns_; }
-    const std::vector<std::unique_ptr<Expression>>& getValues() const { return values_; }
+    const std::vector<std::vector<std::unique_ptr<Expression>>>& getRows() const { return rows_; }
+    bool isIgnore() const { return ignore_; }
+    const std::vector<Assignment>& getDuplicateAssignments() const { return duplicate_assignments_; }
 
 private:
     std::string table_name_;
     std::vector<std::string> columns_;
-    std::vector<std::unique_ptr<Expression>> values_;
+    std::vector<std::vector<std::unique_ptr<Expression>>> rows_;
+    bool ignore_ = false;
+    std::vector<Assignment> duplicate_assignments_;
+};
+
+/**
+ * UPDATE 语句
+ */
+class UpdateStatement : public Statement {
+public:
+    UpdateStatement() = default;
+
+    void setTableName(const std::string& table) { table_name_ = table; }
+
+    void addAssignment(const std::string& column, std::unique_ptr<Expression> value) {
+        assignments_.push_back({column, std::move(value)});
+    }
+
+    void setWhereClause(std::unique_ptr<Expression> where) {
+        where_clause_ = std::move(where);
+    }
+
+    std::string toString() const override;
+
+    const std::string& getTableName() const { return table_name_; }
+    const std::vector<Assignment>& getAssignments() const { return assignments_; }
+    const Expression* getWhereClause() const { return where_clause_.get(); }
+
+private:
+    std::string table_name_;
+    std::vector<Assignment> assignments_;
+    std::unique_ptr<Expression> where_clause_;
+};
+
+/**
+ * DELETE 语句
+ */
+class DeleteStatement : public Statement {
+public:
+    DeleteStatement() = default;
+
+    void setTableName(const std::string& table) { table_name_ = table; }
+
+    void setWhereClause(std::unique_ptr<Expression> where) {
+        where_clause_ = std::move(where);
+    }
+
+    std::string toString() const override;
+
+    const std::string& getTableName() const { return table_name_; }
+    const Expression* getWhereClause() const { return where_clause_.get(); }
+
+private:
+    std::string table_name_;
+    std::unique_ptr<Expression> where_clause_;
 };
 
 /**
@@ -177,6 +345,7 @@ public:
         bool primary_key = false;
         bool not_null = false;
         bool auto_increment = false;
+        bool unique = false;
         std::string default_value;
     };
 
@@ -198,6 +367,66 @@ private:
     std::vector<ColumnDefinition> columns_;
 };
 
+/**
+ * CREATE INDEX 语句（单列二级索引）
+ */
+class CreateIndexStatement : public Statement {
+public:
+    CreateIndexStatement(const std::string& index, const std::string& table, const std::string& column)
+        : index_name_(index), table_name_(table), column_name_(column) {}
+
+    std::string toString() const override {
+        return "CREATE INDEX " + index_name_ + " ON " + table_name_ + " (" + column_name_ + ")";
+    }
+
+    const std::string& getIndexName() const { return index_name_; }
+    const std::string& getTableName() const { return table_name_; }
+    const std::string& getColumnName() const { return column_name_; }
+
+private:
+    std::string index_name_;
+    std::string table_name_;
+    std::string column_name_;
+};
+
+/**
+ * ANALYZE TABLE 语句
+ */
+class AnalyzeTableStatement : public Statement {
+public:
+    explicit AnalyzeTableStatement(const std::string& table) : table_name_(table) {}
+
+    std::string toString() const override {
+        return "ANALYZE TABLE " + table_name_;
+    }
+
+    const std::string& getTableName() const { return table_name_; }
+
+private:
+    std::string table_name_;
+};
+
+/**
+ * EXPLAIN [ANALYZE] SELECT 语句
+ */
+class ExplainStatement : public Statement {
+public:
+    ExplainStatement(bool analyze, std::unique_ptr<SelectStatement> select)
+        : analyze_(analyze), select_(std::move(select)) {}
+
+    std::string toString() const override {
+        return std::string(analyze_ ? "EXPLAIN ANALYZE " : "EXPLAIN ") + select_->toString();
+    }
+
+    // 是否实际执行查询并统计各算子
+    bool isAnalyze() const { return analyze_; }
+    const SelectStatement* getSelect() const { return select_.get(); }
+
+private:
+    bool analyze_;
+    std::unique_ptr<SelectStatement> select_;
+};
+
 /**
  * DROP TABLE 语句
  */
@@ -239,6 +468,125 @@ public:
     }
 };
 
+/**
+ * SHOW [GLOBAL | SESSION] STATUS [LIKE 'pattern'] 语句
+ * 状态变量都是服务器全局的，SESSION 与 GLOBAL 返回相同的值
+ */
+class ShowStatusStatement : public Statement {
+public:
+    ShowStatusStatement() = default;
+
+    void setGlobal(bool global) { global_ = global; }
+    void setLikePattern(const std::string& pattern) { like_pattern_ = pattern; has_like_ = true; }
+
+    std::string toString() const override {
+        std::string sql = global_ ? "SHOW GLOBAL STATUS" : "SHOW STATUS";
+        if (has_like_) {
+            sql += " LIKE '" + like_pattern_ + "'";
+        }
+        return sql;
+    }
+
+    bool isGlobal() const { return global_; }
+    bool hasLikePattern() const { return has_like_; }
+    const std::string& getLikePattern() const { return like_pattern_; }
+
+private:
+    bool global_ = false;
+    bool has_like_ = false;
+    std::string like_pattern_;
+};
+
+/**
+ * SHOW QUERY DIGESTS [LIMIT n]：按总耗时降序列出语句摘要
+ */
+class ShowQueryDigestsStatement : public Statement {
+public:
+    ShowQueryDigestsStatement() = default;
+
+    void setLimit(int limit) { limit_ = limit; }
+
+    std::string toString() const override {
+        std::string sql = "SHOW QUERY DIGESTS";
+        if (limit_ >= 0) {
+            sql += " LIMIT " + std::to_string(limit_);
+        }
+        return sql;
+    }
+
+    int getLimit() const { return limit_; }
+
+private:
+    int limit_ = -1;        // -1 表示不限制
+};
+
+/**
+ * SHOW [FULL] PROCESSLIST
+ */
+class ShowProcesslistStatement : public Statement {
+public:
+    ShowProcesslistStatement() = default;
+
+    void setFull(bool full) { full_ = full; }
+
+    std::string toString() const override {
+        return full_ ? "SHOW FULL PROCESSLIST" : "SHOW PROCESSLIST";
+    }
+
+    bool isFull() const { return full_; }
+
+private:
+    bool full_ = false;
+};
+
+/**
+ * KILL [QUERY | CONNECTION] id
+ */
+class KillStatement : public Statement {
+public:
+    KillStatement(uint32_t connection_id, bool query_only)
+        : connection_id_(connection_id), query_only_(query_only) {}
+
+    std::string toString() const override {
+        return std::string(query_only_ ? "KILL QUERY " : "KILL ") + std::to_string(connection_id_);
+    }
+
+    uint32_t getConnectionId() const { return connection_id_; }
+    bool isQueryOnly() const { return query_only_; }
+
+private:
+    uint32_t connection_id_;
+    bool query_only_;
+};
+
+/**
+ * 事务控制语句：BEGIN / START TRANSACTION / COMMIT / ROLLBACK
+ */
+class TransactionStatement : public Statement {
+public:
+    enum class Kind {
+        BEGIN,
+        COMMIT,
+        ROLLBACK
+    };
+
+    explicit TransactionStatement(Kind kind) : kind_(kind) {}
+
+    std::string toString() const override {
+        switch (kind_) {
+            case Kind::BEGIN: return "BEGIN";
+            case Kind::COMMIT: return "COMMIT";
+            case Kind::ROLLBACK: return "ROLLBACK";
+        }
+        return "";
+    }
+
+    Kind getKind() const { return kind_; }
+
+private:
+    Kind kind_;
+};
+
 /**
  * USE DATABASE 语句
  */
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace tiny_sql {
+
+/**
+ * SQL 指纹：把语句规范化为与字面量无关的形式，用于按语句模板聚合统计
+ * Query fingerprint: the statement with literals stripped, used to group statistics
+ *
+ * - 数字、字符串字面量（含负号）替换为 ?
+ * - 关键字转为大写，空白和注释合并为单个空格，去掉结尾的分号
+ * - 只含字面量的括号列表（IN 列表、VALUES 行）折叠为 (?+)，多行 VALUES 只保留一行
+ *
+ * 例：select * from t where id in (1, 2, 3) and name = 'x'
+ *  => SELECT * FROM t WHERE id IN (?+) AND name = ?
+ */
+std::string fingerprintQuery(const std::string& query);
+
+/**
+ * 指纹的64位哈希（FNV-1a）
+ */
+uint64_t fingerprintHash(const std::string& fingerprint);
+
+} // namespace tiny_sql
@@ -41,11 +41,36 @@ private:
      */
     std::unique_ptr<InsertStatement> parseInsertStatement();
 
+    /**
+     * 解析 UPDATE 语句
+     */
+    std::unique_ptr<UpdateStatement> parseUpdateStatement();
+
+    /**
+     * 解析 DELETE 语句
+     */
+    std::unique_ptr<DeleteStatement> parseDeleteStatement();
+
     /**
      * 解析 CREATE TABLE 语句
      */
     std::unique_ptr<CreateTableStatement> parseCreateTableStatement();
 
+    /**
+     * 解析 CREATE INDEX 语句
+     */
+    std::unique_ptr<CreateIndexStatement> parseCreateIndexStatement();
+
+    /**
+     * 解析 ANALYZE TABLE 语句
+     */
+    std::unique_ptr<AnalyzeTableStatement> parseAnalyzeStatement();
+
+    /**
+     * 解析 EXPLAIN [ANALYZE] 语句
+     */
+    std::unique_ptr<ExplainStatement> parseExplainStatement();
+
     /**
      * 解析 DROP TABLE 语句
      */
@@ -56,11 +81,38 @@ private:
      */
     std::unique_ptr<Statement> parseShowStatement();
 
+    /**
+     * 解析 KILL [QUERY | CONNECTION] id 语句
+     */
+    std::unique_ptr<KillStatement> parseKillStatement();
+
+    /**
+     * 解析事务控制语句（BEGIN / START TRANSACTION / COMMIT / ROLLBACK）
+     */
+    std::unique_ptr<TransactionStatement> parseTransactionStatement();
+
     /**
      * 解析 USE 语句
      */
     std::unique_ptr<UseDatabaseStatement> parseUseStatement();
 
+    /**
+     * 解析赋值列表：col = expr [, col = expr ...]（UPDATE SET / ON DUPLICATE KEY UPDATE）
+     * @return 语法是否正确
+     */
+    bool parseAssignments(std::vector<Assignment>& assignments);
+
+    /**
+     * 当前 token 是否为指定的非保留关键字（如 STATUS、GLOBAL，按标识符词法分析，不区分大小写）
+     */
+    bool isContextualKeyword(const char* word);
+
+    /**
+     * 解析可选的表别名：[AS] alias
+     * @return 语法是否正确
+     */
+    bool parseTableAlias(std::string& alias);
+
     /**
      * 解析表达式
      */
@@ -71,6 +123,11 @@ private:
      */
     std::unique_ptr<Expression> parsePrimaryExpression();
 
+    /**
+     * 解析函数调用（聚合函数）
+     */
+    std::unique_ptr<Expression> parseFunctionCall();
+
     /**
      * 解析二元表达式
      */
@@ -118,6 +118,16 @@ enum class TokenType {
     ASC,
     ASCENDING,
     DESCENDING,
+    ANALYZE,
+    EXPLAIN,
+    SET,
+    BEGIN,
+    START,
+    TRANSACTION,
+    COMMIT,
+    ROLLBACK,
+    IGNORE,
+    DUPLICATE,
 };
 
 /**
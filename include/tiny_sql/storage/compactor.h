@@ -0,0 +1,57 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+namespace tiny_sql {
+
+/**
+ * 后台压缩线程（全局单例）
+ * Background compaction thread (global singleton)
+ *
+ * 被 notify 唤醒时（事件循环每隔 compaction_interval_ms 通知一次）检查所有表，
+ * 已结束版本占比超过 compaction_dead_ratio 的表执行 Table::compact，
+ * 回收不再被任何活跃快照看到的旧版本并重建索引。
+ * When notified (the event loop does so every compaction_interval_ms) it checks all tables and
+ * compacts those whose dead-version ratio exceeds compaction_dead_ratio,
+ * reclaiming versions no active snapshot can see.
+ */
+class Compactor {
+public:
+    static Compactor& instance();
+
+    // 启动后台线程
+    // Start the background thread
+    void start();
+
+    // 停止后台线程并等待其退出
+    // Stop the background thread and wait for it to exit
+    void stop();
+
+    // 唤醒后台线程立即检查（DELETE/UPDATE 产生旧版本、事务结束推进水位后调用）
+    // Wake the thread for an immediate check (called after DELETE/UPDATE and transaction end)
+    void notify();
+
+    /**
+     * 检查并压缩所有超过阈值的表
+     * Compact every table above the threshold
+     * @return 回收的行数
+     */
+    size_t compactAll();
+
+private:
+    Compactor() = default;
+    ~Compactor();
+
+    void run();
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool running_ = false;
+    bool pending_ = false;
+};
+
+} // namespace tiny_sql
@@ -42,6 +42,21 @@ public:
                               const Row& row,
                               const std::vector<ColumnDef>& columns);
 
+    /**
+     * 解析标识符对应的列下标
+     * Resolve the column index of an identifier
+     *
+     * 连接查询中列名形如 "alias.column"：限定名精确匹配，
+     * 未限定名按后缀匹配，匹配多列时报歧义。
+     * In join queries column names look like "alias.column": qualified names
+     * match exactly, unqualified names match by suffix and must be unambiguous.
+     *
+     * @return 列下标，未找到返回-1
+     * @throws std::runtime_error 如果未限定列名有歧义
+     */
+    static int resolveColumn(const Identifier* id,
+                             const std::vector<ColumnDef>& columns);
+
 private:
     /**
      * 评估二元表达式（比较运算符和逻辑运算符）
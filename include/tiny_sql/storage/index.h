@@ -0,0 +1,145 @@
+#pragma once
+
+#include "tiny_sql/storage/value.h"
+#include <map>
+#include <unordered_map>
+#include <iterator>
+#include <vector>
+#include <cstddef>
+
+namespace tiny_sql {
+
+/**
+ * 有序索引 - 键到行号的有序映射
+ *
+ * 用于主键列：支持等值查找和按键顺序遍历（ORDER BY 主键时可免排序）。
+ * 行号即行在 Table 行数组中的下标。
+ */
+class OrderedIndex {
+public:
+    OrderedIndex() = default;
+
+    // 插入索引项
+    void insert(const Value& key, size_t row_id);
+
+    // 清空索引
+    void clear() { entries_.clear(); }
+
+    // 索引项数量
+    size_t size() const { return entries_.size(); }
+
+    // 等值查找，返回匹配的行号
+    std::vector<size_t> find(const Value& key) const;
+
+    /**
+     * 按键顺序遍历 [lower, upper] 范围内的非NULL键
+     * @param lower 下界（nullptr表示无下界）
+     * @param upper 上界（nullptr表示无上界）
+     * @param ascending true为升序，false为降序
+     * @param fn 回调 bool(size_t row_id)，返回false时停止遍历
+     */
+    template <typename Fn>
+    void scanRange(const Value* lower, bool lower_inclusive,
+                   const Value* upper, bool upper_inclusive,
+                   bool ascending, Fn&& fn) const {
+        // NULL 键排在最前，范围扫描总是跳过
+        auto first = lower ? (lower_inclusive ? entries_.lower_bound(*lower)
+                                              : entries_.upper_bound(*lower))
+                           : entries_.upper_bound(Value::Null());
+        auto last = upper ? (upper_inclusive ? entries_.upper_bound(*upper)
+                                             : entries_.lower_bound(*upper))
+                          : entries_.end();
+        if (lower && upper && *upper < *lower) {
+            return;
+        }
+
+        if (ascending) {
+            for (auto it = first; it != last; ++it) {
+                if (!fn(it->second)) {
+                    return;
+                }
+            }
+        } else {
+            for (auto it = std::make_reverse_iterator(last);
+                 it != std::make_reverse_iterator(first); ++it) {
+                if (!fn(it->second)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    /**
+     * 按键顺序遍历索引
+     * @param ascending true为升序，false为降序
+     * @param fn 回调 bool(size_t row_id)，返回false时停止遍历
+     */
+    template <typename Fn>
+    void scan(bool ascending, Fn&& fn) const {
+        if (ascending) {
+            for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+                if (!fn(it->second)) {
+                    return;
+                }
+            }
+        } else {
+            for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+                if (!fn(it->second)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    /**
+     * 将查找键转换为索引列的类型（索引按类型下标排序，类型必须一致）
+     * @return 能否无损转换；不能时该键不可能匹配任何索引项
+     */
+    static bool castKey(const Value& key, DataType type, Value& out);
+
+private:
+    std::multimap<Value, size_t> entries_;
+};
+
+/**
+ * 哈希索引 - 键到行号的哈希映射
+ *
+ * 用于主键和 UNIQUE 列的唯一性检查：等值探测 O(1)。
+ * 同一个键可能对应多个行版本（MVCC 旧版本），由调用方按版本时间戳判断是否冲突。
+ */
+class HashIndex {
+public:
+    HashIndex() = default;
+
+    // 插入索引项
+    void insert(const Value& key, size_t row_id) { entries_.emplace(key, row_id); }
+
+    // 清空索引
+    void clear() { entries_.clear(); }
+
+    // 索引项数量
+    size_t size() const { return entries_.size(); }
+
+    /**
+     * 等值探测
+     * @param fn 回调 bool(size_t row_id)，返回false时停止
+     */
+    template <typename Fn>
+    void probe(const Value& key, Fn&& fn) const {
+        auto range = entries_.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (!fn(it->second)) {
+                return;
+            }
+        }
+    }
+
+private:
+    struct KeyHash {
+        size_t operator()(const Value& key) const { return key.hash(); }
+    };
+
+    std::unordered_multimap<Value, size_t, KeyHash> entries_;
+};
+
+} // namespace tiny_sql
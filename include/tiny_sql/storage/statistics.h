@@ -0,0 +1,87 @@
+#pragma once
+
+#include "tiny_sql/storage/value.h"
+#include <vector>
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace tiny_sql {
+
+class Row;
+
+/**
+ * HyperLogLog 基数估计草图
+ *
+ * 2^kPrecision 个寄存器，标准误差约 1.04/sqrt(4096) ≈ 1.6%，
+ * 内存固定 4KB，与列中不同值的数量无关。
+ */
+class HyperLogLog {
+public:
+    static constexpr int kPrecision = 12;
+    static constexpr size_t kRegisters = size_t{1} << kPrecision;
+
+    HyperLogLog() { registers_.fill(0); }
+
+    // 加入一个值的64位哈希
+    void add(uint64_t hash);
+
+    // 合并另一个草图
+    void merge(const HyperLogLog& other);
+
+    // 估算不同值个数
+    uint64_t estimate() const;
+
+private:
+    std::array<uint8_t, kRegisters> registers_;
+};
+
+/**
+ * 单列统计信息（由 ANALYZE TABLE 生成）
+ */
+struct ColumnStatistics {
+    uint64_t null_count = 0;
+    uint64_t ndv = 0;                   // 不同值个数（HyperLogLog估计）
+    Value min;
+    Value max;
+
+    // 等深直方图：每个桶包含大致相同数量的非NULL值，保存各桶的上界（升序）
+    std::vector<Value> histogram;
+
+    /**
+     * 非NULL值中小于（或小于等于）value 的比例，范围 [0, 1]
+     */
+    double fractionBelow(const Value& value, bool inclusive) const;
+
+    /**
+     * 等值条件 col = value 的选择率（相对全部行）
+     */
+    double equalSelectivity(const Value& value, uint64_t row_count) const;
+};
+
+/**
+ * 表统计信息
+ */
+struct TableStatistics {
+    bool analyzed = false;              // 是否执行过 ANALYZE TABLE
+    uint64_t row_count = 0;             // ANALYZE 时的行数
+    std::vector<ColumnStatistics> columns;
+
+    // 直方图桶数
+    static constexpr size_t kHistogramBuckets = 32;
+
+    // 构建直方图时的最大采样行数（超过时蓄水池采样）
+    static constexpr size_t kHistogramSampleRows = 64 * 1024;
+
+    /**
+     * 扫描全部行重新计算统计信息
+     * @param rows 表中的行
+     * @param deleted 不可见行的位图（已删除或未提交的行不计入统计）
+     * @param column_count 列数
+     */
+    void analyze(const std::vector<Row>& rows, const std::vector<bool>& deleted,
+                 size_t column_count);
+};
+
+} // namespace tiny_sql
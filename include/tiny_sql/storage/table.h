@@ -1,10 +1,15 @@
 #pragma once
 
 #include "tiny_sql/storage/value.h"
+#include "tiny_sql/storage/index.h"
+#include "tiny_sql/storage/statistics.h"
+#include "tiny_sql/storage/transaction.h"
+#include <atomic>
 #include <vector>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <shared_mutex>
 
 namespace tiny_sql {
 
@@ -15,6 +20,7 @@ class Row {
 public:
     Row() = default;
     explicit Row(const std::vector<Value>& values) : values_(values) {}
+    explicit Row(std::vector<Value>&& values) : values_(std::move(values)) {}
 
     // 添加值
     void addValue(const Value& value) {
@@ -54,6 +60,11 @@ private:
 
 /**
  * 表 - 表示一个数据库表
+ *
+ * 每行是一个版本，带 [begin_ts, end_ts) 时间戳（见 transaction.h）：删除只设置
+ * end_ts，更新追加新版本并结束旧版本；旧版本和索引项保留到后台压缩时回收。
+ * 读取行时须用 isVisible 按读视图过滤。并发约定：语句执行期间查询持表锁的共享锁，
+ * 写语句持排他锁，除 compact() 外的方法本身不加锁。
  */
 class Table {
 public:
@@ -74,28 +85,167 @@ public:
     // 获取列数
     size_t getColumnCount() const { return columns_.size(); }
 
-    // 插入行
-    bool insertRow(const Row& row);
+    /**
+     * 插入行版本，新行号为 getRows().size() - 1
+     * @param begin_ts 版本的开始时间戳（未提交时为事务标记）
+     */
+    bool insertRow(const Row& row, uint64_t begin_ts);
 
-    // 获取所有行
+    /**
+     * 删除行：设置版本的 end_ts，空间由 compact 回收
+     * @param end_ts 结束时间戳（未提交时为事务标记）
+     * @return 版本已被删除（或被其他事务删除、尚未提交）时返回false
+     */
+    bool deleteRow(size_t row_id, uint64_t end_ts);
+
+    /**
+     * 更新行：结束旧版本，新版本追加到末尾并插入索引
+     * @return 旧版本已被删除或新行不合法时返回false
+     */
+    bool updateRow(size_t row_id, const Row& row, uint64_t ts);
+
+    /**
+     * 唯一约束冲突
+     */
+    struct UniqueConflict {
+        int64_t row_id = -1;        // 冲突版本的行号（-1表示没有冲突）
+        size_t column = 0;          // 冲突的约束列
+        std::string key_name;       // 约束名（主键为 PRIMARY，UNIQUE 列为列名）
+    };
+
+    /**
+     * 唯一约束检查（主键和 UNIQUE 列，哈希索引探测 O(1)）：查找键相同、
+     * 且未被已提交地结束的版本。自己删除的版本不算冲突，NULL 键不参与检查
+     * @param marker 当前事务的标记（自动提交的快速路径为0）
+     * @param exclude_row 不参与检查的版本（UPDATE 时为被替换的旧版本），没有时为-1
+     */
+    UniqueConflict findUniqueConflict(const Row& row, uint64_t marker,
+                                      int64_t exclude_row = -1) const;
+
+    /**
+     * 唯一约束（主键和 UNIQUE 列）及其哈希索引
+     */
+    struct UniqueKey {
+        std::string name;
+        size_t column;
+        HashIndex index;
+    };
+
+    const std::vector<UniqueKey>& getUniqueKeys() const { return unique_keys_; }
+
+    // 表上是否有唯一约束
+    bool hasUniqueKeys() const { return !unique_keys_.empty(); }
+
+    /**
+     * 提交：把版本上的事务标记替换为提交时间戳
+     */
+    void commitRow(size_t row_id, uint64_t marker, uint64_t commit_ts);
+
+    /**
+     * 回滚：撤销事务对版本的插入或删除
+     */
+    void abortRow(size_t row_id, uint64_t marker);
+
+    // 行版本对读视图是否可见
+    bool isVisible(size_t row_id, const ReadView& view) const {
+        return view.sees(versions_[row_id]);
+    }
+
+    // 所有行版本都对读视图可见（此时可直接使用 getRows()，免去逐行过滤）
+    bool allVisible(const ReadView& view) const {
+        return dead_rows_ == 0 && uncommitted_ == 0 && last_commit_ts_ <= view.read_ts;
+    }
+
+    // 获取行版本的时间戳
+    const RowVersion& getRowVersion(size_t row_id) const { return versions_[row_id]; }
+
+    // 获取所有行版本（包含对当前快照不可见的版本，需用 isVisible 过滤）
     const std::vector<Row>& getRows() const { return rows_; }
 
-    // 获取行数
-    size_t getRowCount() const { return rows_.size(); }
+    // 获取存活行数（估算用：不含已结束的版本）
+    size_t getRowCount() const { return rows_.size() - dead_rows_; }
+
+    // 已结束（删除/被更新/回滚）、尚未回收的版本数
+    size_t getDeadRowCount() const { return dead_rows_; }
+
+    /**
+     * 压缩：回收对所有快照都不可见的版本并重建所有索引（由后台压缩线程调用，自行加锁）
+     * 先持共享锁复制保留的版本并建好新索引，再持排他锁替换；复制期间表被修改，
+     * 或有未提交的写入（其写集合引用行号）时放弃本次压缩，等待下一轮
+     * @param min_dead_ratio 已结束版本占比低于该值时不压缩
+     * @param horizon 垃圾回收水位（TransactionManager::gcHorizon）
+     * @return 回收的版本数
+     */
+    size_t compact(double min_dead_ratio, uint64_t horizon);
+
+    // 表级读写锁
+    std::shared_mutex& getLock() const { return lock_; }
 
     // 查找主键列索引
     int getPrimaryKeyIndex() const;
 
+    // 获取主键有序索引（没有主键时返回nullptr）
+    const OrderedIndex* getPrimaryIndex() const {
+        return primary_key_index_ >= 0 ? &primary_index_ : nullptr;
+    }
+
+    /**
+     * 创建二级索引并用现有数据填充
+     * @return 同名索引已存在时返回false
+     */
+    bool createIndex(const std::string& index_name, size_t column);
+
+    // 是否存在同名索引（主键索引名为 PRIMARY）
+    bool hasIndex(const std::string& index_name) const;
+
+    // 获取列上的索引（主键优先，其次二级索引；没有时返回nullptr）
+    const OrderedIndex* getIndex(size_t column) const;
+
+    // 获取列上索引的名字（没有索引时返回空串）
+    std::string getIndexName(size_t column) const;
+
+    // 重新计算统计信息（ANALYZE TABLE）
+    // 统计基于 view 可见的行
+    void analyze(const ReadView& view);
+
+    // 获取统计信息（未执行过 ANALYZE 时 analyzed 为 false）
+    const TableStatistics& getStatistics() const { return statistics_; }
+
     // 查找自增列索引
     int getAutoIncrementIndex() const;
 
-    // 获取下一个自增值
-    int64_t getNextAutoIncrementValue();
+    /**
+     * 预留 count 个连续的自增值，返回第一个
+     * 一次原子 fetch_add 完成，不需要表锁；多行插入整条语句只预留一次
+     * Reserve count consecutive AUTO_INCREMENT values and return the first: a single
+     * atomic fetch_add with no table lock, once per multi-row INSERT
+     */
+    int64_t reserveAutoIncrement(size_t count = 1);
+
+    /**
+     * 自增列写入了显式值：把计数器推进到该值之后（原子取最大值）
+     * An explicit value was written to the AUTO_INCREMENT column: advance the counter past it
+     */
+    void observeAutoIncrementValue(int64_t value);
+
+    // 下一个将要分配的自增值
+    int64_t getAutoIncrementValue() const { return next_auto_increment_.load(std::memory_order_relaxed); }
 
     // 清空所有数据（保留表结构）
     void truncate() {
         rows_.clear();
-        next_auto_increment_ = 1;
+        versions_.clear();
+        dead_rows_ = 0;
+        uncommitted_ = 0;
+        version_++;
+        primary_index_.clear();
+        for (auto& secondary : secondary_indexes_) {
+            secondary.index.clear();
+        }
+        for (auto& unique_key : unique_keys_) {
+            unique_key.index.clear();
+        }
+        next_auto_increment_.store(1, std::memory_order_relaxed);
     }
 
     // 转换为字符串（显示表结构）
@@ -106,7 +256,36 @@ private:
     std::vector<ColumnDef> columns_;
     std::unordered_map<std::string, size_t> column_index_map_;
     std::vector<Row> rows_;
-    int64_t next_auto_increment_ = 1;
+    std::atomic<int64_t> next_auto_increment_{1};
+
+    // 行版本时间戳（与 rows_ 一一对应）、已结束的版本数和带事务标记的时间戳个数
+    std::vector<RowVersion> versions_;
+    size_t dead_rows_ = 0;
+    size_t uncommitted_ = 0;
+    uint64_t last_commit_ts_ = 0;       // 最大的已提交 begin_ts
+
+    // 修改计数：压缩时用于检测复制期间的写入
+    uint64_t version_ = 0;
+
+    mutable std::shared_mutex lock_;
+
+    // 主键列下标（-1表示无主键）及其有序索引
+    int primary_key_index_ = -1;
+    OrderedIndex primary_index_;
+
+    // 二级索引（CREATE INDEX）
+    struct SecondaryIndex {
+        std::string name;
+        size_t column;
+        OrderedIndex index;
+    };
+    std::vector<SecondaryIndex> secondary_indexes_;
+
+    // 唯一约束（主键和 UNIQUE 列）及其哈希索引
+    std::vector<UniqueKey> unique_keys_;
+
+    // 列统计信息（ANALYZE TABLE）
+    TableStatistics statistics_;
 };
 
 } // namespace tiny_sql
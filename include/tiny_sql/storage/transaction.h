@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tiny_sql {
+
+class Table;
+
+/**
+ * 多版本并发控制（MVCC）
+ * Multi-version concurrency control
+ *
+ * 每个行版本带有 [begin_ts, end_ts) 时间戳，时间戳取自全局单调时钟。
+ * 未提交的写入用事务标记（最高位置1的事务ID）占位，提交时统一替换为提交时间戳；
+ * 事务在开始时取得快照时间戳，只能看到在此之前提交的版本和自己的写入。
+ * Each row version carries [begin_ts, end_ts) from a global monotonic clock.
+ * Uncommitted writes hold a transaction marker (transaction id with the top bit set)
+ * that is replaced by the commit timestamp on commit; a transaction reads at the
+ * snapshot timestamp taken when it began and sees only versions committed before it
+ * plus its own writes.
+ */
+namespace mvcc {
+    constexpr uint64_t kInfinity = UINT64_MAX;              // 版本未被删除
+    constexpr uint64_t kUncommittedFlag = 1ULL << 63;       // 事务标记位
+    constexpr uint64_t kAborted = 0;                        // 回滚的插入：begin_ts = end_ts = 0
+
+    inline bool isUncommitted(uint64_t ts) { return ts != kInfinity && (ts & kUncommittedFlag); }
+}
+
+/**
+ * 行版本时间戳
+ */
+struct RowVersion {
+    uint64_t begin_ts = 0;
+    uint64_t end_ts = mvcc::kInfinity;
+};
+
+/**
+ * 读视图：语句读取行时使用的快照
+ */
+struct ReadView {
+    uint64_t read_ts = 0;       // 快照时间戳
+    uint64_t marker = 0;        // 所属事务的标记（自己的未提交写入可见）
+
+    /**
+     * 版本对该快照是否可见
+     */
+    bool sees(const RowVersion& version) const {
+        if (mvcc::isUncommitted(version.begin_ts)) {
+            if (version.begin_ts != marker) {
+                return false;
+            }
+        } else if (version.begin_ts > read_ts || version.begin_ts == mvcc::kAborted) {
+            return false;
+        }
+
+        if (version.end_ts == mvcc::kInfinity) {
+            return true;
+        }
+        if (mvcc::isUncommitted(version.end_ts)) {
+            return version.end_ts != marker;
+        }
+        return version.end_ts > read_ts;
+    }
+};
+
+/**
+ * 事务：快照和写集合
+ * Transaction: snapshot plus write set
+ */
+class Transaction {
+public:
+    Transaction(uint64_t id, uint64_t read_ts, bool explicit_txn)
+        : id_(id), explicit_(explicit_txn) {
+        view_.read_ts = read_ts;
+        view_.marker = id | mvcc::kUncommittedFlag;
+    }
+
+    uint64_t getId() const { return id_; }
+
+    // 写入的事务标记（写入行版本的 begin_ts/end_ts）
+    uint64_t getMarker() const { return view_.marker; }
+
+    const ReadView& getReadView() const { return view_; }
+
+    // BEGIN 开启的显式事务（否则为单条语句的自动提交事务）
+    bool isExplicit() const { return explicit_; }
+
+    // 记录写入的行版本（提交/回滚时按记录修改时间戳）
+    void recordWrite(const std::shared_ptr<Table>& table, size_t row_id) {
+        writes_.push_back({table, row_id});
+    }
+
+    struct WriteRecord {
+        std::shared_ptr<Table> table;
+        size_t row_id;
+    };
+
+    const std::vector<WriteRecord>& getWrites() const { return writes_; }
+
+private:
+    uint64_t id_;
+    bool explicit_;
+    ReadView view_;
+    std::vector<WriteRecord> writes_;
+};
+
+/**
+ * 事务管理器（单例）
+ * Transaction manager (singleton)
+ *
+ * 维护全局时钟和活跃快照。提交时先锁住写集合涉及的所有表，再分配提交时间戳并
+ * 替换事务标记，因此取到该时间戳之后的快照读这些表时必然等到替换完成，
+ * 要么看到事务的全部写入，要么全部看不到。
+ * 不再被任何活跃快照看到的旧版本由后台压缩回收（见 gcHorizon）。
+ * Maintains the global clock and the active snapshots. Commit locks every table in
+ * the write set before allocating the commit timestamp and stamping the writes, so
+ * a snapshot taken after that timestamp waits for the stamping and sees either all
+ * or none of a transaction. Old versions no active snapshot can see are reclaimed
+ * by background compaction (see gcHorizon).
+ */
+class TransactionManager {
+public:
+    static TransactionManager& instance();
+
+    /**
+     * 开始事务：取当前时钟为快照
+     * @param explicit_txn 是否为 BEGIN 开启的显式事务
+     */
+    std::shared_ptr<Transaction> begin(bool explicit_txn);
+
+    /**
+     * 提交事务：为写入的版本分配提交时间戳
+     */
+    void commit(Transaction& txn);
+
+    /**
+     * 回滚事务：撤销未提交的插入和删除
+     */
+    void rollback(Transaction& txn);
+
+    /**
+     * 分配提交时间戳（时钟原子自增，无锁）
+     * 自动提交的单行插入直接调用它写入已提交版本，不登记事务；
+     * 调用方须持有所写表的排他锁，直到版本写入完成
+     * Allocate a commit timestamp (atomic clock increment, lock-free). Autocommit
+     * single-row inserts call it directly and skip transaction bookkeeping; the
+     * caller must hold the table's exclusive lock until the version is written.
+     */
+    uint64_t allocateTimestamp() { return clock_.fetch_add(1, std::memory_order_acq_rel) + 1; }
+
+    /**
+     * 垃圾回收水位：end_ts 不大于该值的版本对所有活跃和将来的快照都不可见
+     * GC horizon: versions ending at or below it are invisible to every current and future snapshot
+     */
+    uint64_t gcHorizon() const;
+
+    // 当前时钟（最近一次提交的时间戳）
+    uint64_t now() const { return clock_.load(std::memory_order_acquire); }
+
+    // 活跃事务数
+    size_t getActiveCount() const;
+
+private:
+    TransactionManager() = default;
+
+    void finish(const Transaction& txn);
+
+    std::atomic<uint64_t> clock_{1};
+    std::atomic<uint64_t> next_txn_id_{1};
+
+    mutable std::mutex mutex_;
+    std::multimap<uint64_t, uint64_t> active_;      // 快照时间戳 -> 事务ID
+};
+
+} // namespace tiny_sql
@@ -80,6 +80,12 @@ public:
     bool operator>(const Value& other) const;
     bool operator>=(const Value& other) const;
 
+    // 三路比较（<0/0/>0）：数值类型之间按数值比较，其余按 operator< 的顺序，NULL最小
+    int compare(const Value& other) const;
+
+    // 哈希值（与operator==一致，用于分组/连接等哈希结构）
+    size_t hash() const;
+
     // 获取底层variant
     const ValueVariant& getData() const { return data_; }
 
@@ -96,6 +102,7 @@ struct ColumnDef {
     bool primary_key = false;
     bool not_null = false;
     bool auto_increment = false;
+    bool unique = false;
     Value default_value;
 
     ColumnDef() = default;
@@ -1,9 +1,14 @@
 #include "tiny_sql/network/server.h"
 #include "tiny_sql/protocol/protocol_handler.h"
 #include "tiny_sql/common/logger.h"
+#include "tiny_sql/common/config.h"
+#include "tiny_sql/common/buffer_pool.h"
+#include "tiny_sql/common/slow_query_log.h"
+#include "tiny_sql/common/worker_pool.h"
+#include "tiny_sql/storage/compactor.h"
+#include "tiny_sql/network/metrics_server.h"
 #include <csignal>
 #include <iostream>
-#include <unordered_map>
 #include <memory>
 
 using namespace tiny_sql;
@@ -11,22 +16,34 @@ using namespace tiny_sql;
 // 全局服务器实例,用于信号处理
 Server* g_server = nullptr;
 
+// 只能做异步信号安全的事：stop 只写原子变量和唤醒管道，日志由事件循环输出
 void signalHandler(int signum) {
-    LOG_INFO("Received signal " << signum);
     if (g_server) {
-        g_server->stop();
+        g_server->stop(signum);
     }
 }
 
 int main(int argc, char* argv[]) {
     // 解析命令行参数
-    uint16_t port = 3306;
-    if (argc > 1) {
-        port = static_cast<uint16_t>(std::atoi(argv[1]));
+    auto& config = Config::instance();
+    if (!config.parseArgs(argc, argv)) {
+        return 1;
     }
+    uint16_t port = config.port;
 
-    // 设置日志级别
-    Logger::instance().setLevel(LogLevel::DEBUG);
+    // 设置日志级别和输出
+    Logger::instance().setLevel(config.log_level);
+    if (!Logger::instance().setOutput(config.log_file)) {
+        std::cerr << "Cannot open log file: " << config.log_file << std::endl;
+        return 1;
+    }
+
+    // 慢查询日志
+    SlowQueryLog::instance().setLongQueryTime(config.long_query_time);
+    if (!SlowQueryLog::instance().setOutput(config.slow_query_log_file)) {
+        std::cerr << "Cannot open slow query log file: " << config.slow_query_log_file << std::endl;
+        return 1;
+    }
 
     LOG_INFO("Starting Tiny-SQL Server...");
     LOG_INFO("Version: 1.0.0");
@@ -34,55 +51,84 @@ int main(int argc, char* argv[]) {
 
     // 创建服务器
     Server server(port);
+    server.setOutputLimits(config.net_output_high_water, config.max_output_memory);
+    server.setUnixSocketPath(config.socket);
     g_server = &server;
 
     // 注册信号处理
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
-
-    // 协议处理器映射表（每个连接一个处理器）
-    std::unordered_map<int, std::shared_ptr<ProtocolHandler>> protocol_handlers;
+    // 对端已关闭时写 socket 返回 EPIPE，不能让 SIGPIPE 终止进程
+    std::signal(SIGPIPE, SIG_IGN);
 
     // 设置回调
-    server.setConnectionCallback([&protocol_handlers](std::shared_ptr<TcpConnection> conn) {
+    server.setConnectionCallback([&server](std::shared_ptr<TcpConnection> conn) {
         LOG_INFO("New connection established: " << conn->getPeerAddr());
 
-        // 创建协议处理器
+        // 创建协议处理器，放在连接所在的槽里，随连接一起释放
         auto handler = std::make_shared<ProtocolHandler>(conn);
-        protocol_handlers[conn->getFd()] = handler;
+        server.setContext(*conn, handler);
 
         // 发送握手包
         handler->sendHandshake();
     });
 
-    server.setMessageCallback([&protocol_handlers](std::shared_ptr<TcpConnection> conn, Buffer& buffer) {
-        LOG_DEBUG("Received " << buffer.readableBytes() << " bytes from " << conn->getPeerAddr());
+    server.setMessageCallback([](TcpConnection& conn, Buffer& buffer) {
+        LOG_DEBUG("Received " << buffer.readableBytes() << " bytes from " << conn.getPeerAddr());
 
-        // 查找对应的协议处理器
-        auto it = protocol_handlers.find(conn->getFd());
-        if (it == protocol_handlers.end()) {
-            LOG_ERROR("No protocol handler found for connection: " << conn->getFd());
+        // 连接上附加的协议处理器
+        auto* handler = static_cast<ProtocolHandler*>(conn.getContext());
+        if (!handler) {
+            LOG_ERROR("No protocol handler found for connection: " << conn.getFd());
             return;
         }
 
         // 处理数据
-        if (!it->second->handleData(buffer)) {
+        if (!handler->handleData(buffer)) {
             // 处理失败或连接需要关闭
-            LOG_INFO("Connection will be closed: " << conn->getPeerAddr());
-            conn->close();
+            LOG_INFO("Connection will be closed: " << conn.getPeerAddr());
+            conn.handleClose();
         }
     });
 
-    server.setCloseCallback([&protocol_handlers](std::shared_ptr<TcpConnection> conn) {
+    server.setCloseCallback([](std::shared_ptr<TcpConnection> conn) {
         LOG_INFO("Connection closed: " << conn->getPeerAddr());
+    });
+
+    // 启动后台压缩线程（回收 DELETE/UPDATE 留下的删除行）
+    Compactor::instance().start();
 
-        // 清理协议处理器
-        protocol_handlers.erase(conn->getFd());
+    // 周期性后台任务挂在事件循环的时间轮上
+    server.timers().scheduleEvery(config.compaction_interval_ms, [] {
+        Compactor::instance().notify();
     });
+    server.timers().scheduleEvery(10 * 1000, [] {
+        size_t freed = BufferPool::trim();
+        if (freed > 0) {
+            LOG_DEBUG("Buffer pool trimmed " << freed << " bytes");
+        }
+    });
+
+    // 指标导出端口
+    std::unique_ptr<MetricsServer> metrics_server;
+    if (config.admin_port != 0) {
+        metrics_server = std::make_unique<MetricsServer>(config.admin_port);
+        if (!metrics_server->start()) {
+            LOG_ERROR("Failed to start metrics endpoint on port " << config.admin_port);
+            metrics_server.reset();
+        }
+    }
 
     // 启动服务器
     server.start();
 
+    if (metrics_server) {
+        metrics_server->stop();
+    }
+    Compactor::instance().stop();
+    WorkerPool::instance().stop();
+
     LOG_INFO("Server shutdown completed");
+    Logger::instance().flush();
     return 0;
 }
@@ -5,8 +5,31 @@
 #include "tiny_sql/sql/parser.h"
 #include "tiny_sql/storage/storage_engine.h"
 #include "tiny_sql/storage/expression_evaluator.h"
+#include "tiny_sql/executor/aggregator.h"
+#include "tiny_sql/executor/sorter.h"
+#include "tiny_sql/executor/join.h"
+#include "tiny_sql/executor/cost_model.h"
+#include "tiny_sql/executor/query_profile.h"
+#include "tiny_sql/executor/query_arena.h"
+#include "tiny_sql/common/config.h"
+#include "tiny_sql/common/metrics.h"
+#include "tiny_sql/common/memory_tracker.h"
+#include "tiny_sql/common/slow_query_log.h"
+#include "tiny_sql/common/query_interrupt.h"
+#include "tiny_sql/session/process_list.h"
+#include "tiny_sql/sql/fingerprint.h"
+#include "tiny_sql/storage/compactor.h"
+#include "tiny_sql/storage/transaction.h"
 #include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <cctype>
 
 namespace tiny_sql {
@@ -69,6 +92,311 @@ static Value expressionToValue(const Expression* expr, DataType target_type) {
     return Value::Null();
 }
 
+// 辅助函数：检查表达式引用的列都存在且无歧义，否则发送 1054/1052 错误
+// clause 为错误信息中的子句名（如 "where clause"）
+static bool checkColumns(const Expression* expr,
+                         const std::vector<ColumnDef>& columns,
+                         const std::string& clause,
+                         Buffer& response,
+                         Session& session,
+                         const CommandHandler::ResponseCallback& response_callback) {
+    if (!expr) {
+        return true;
+    }
+
+    if (auto* id = dynamic_cast<const Identifier*>(expr)) {
+        if (id->getName() == "*") {
+            return true;
+        }
+
+        int index = -1;
+        try {
+            index = ExpressionEvaluator::resolveColumn(id, columns);
+        } catch (const std::exception&) {
+            ErrPacket err_packet(1052, "23000",
+                "Column '" + id->toString() + "' in " + clause + " is ambiguous");
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return false;
+        }
+
+        if (index < 0) {
+            ErrPacket err_packet(1054, "42S22",
+                "Unknown column '" + id->toString() + "' in '" + clause + "'");
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return false;
+        }
+        return true;
+    }
+
+    if (auto* bin = dynamic_cast<const BinaryExpression*>(expr)) {
+        return checkColumns(bin->getLeft(), columns, clause, response, session, response_callback) &&
+               checkColumns(bin->getRight(), columns, clause, response, session, response_callback);
+    }
+
+    if (auto* func = dynamic_cast<const FunctionCall*>(expr)) {
+        for (const auto& arg : func->getArgs()) {
+            if (!checkColumns(arg.get(), columns, clause, response, session, response_callback)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 辅助函数：判断合取项引用的列属于连接的哪一侧
+// 返回 0=只引用左表，1=只引用右表，-1=两侧都引用或不引用列
+static int conjunctSide(const Expression* expr,
+                        const std::vector<ColumnDef>& columns,
+                        size_t left_width) {
+    bool left = false;
+    bool right = false;
+    std::vector<const Expression*> stack{expr};
+
+    while (!stack.empty()) {
+        const Expression* e = stack.back();
+        stack.pop_back();
+
+        if (auto* id = dynamic_cast<const Identifier*>(e)) {
+            int index = ExpressionEvaluator::resolveColumn(id, columns);
+            if (index < 0) return -1;
+            (static_cast<size_t>(index) < left_width ? left : right) = true;
+        } else if (auto* bin = dynamic_cast<const BinaryExpression*>(e)) {
+            stack.push_back(bin->getLeft());
+            stack.push_back(bin->getRight());
+        } else if (auto* func = dynamic_cast<const FunctionCall*>(e)) {
+            for (const auto& arg : func->getArgs()) {
+                stack.push_back(arg.get());
+            }
+        }
+    }
+
+    if (left && !right) return 0;
+    if (right && !left) return 1;
+    return -1;
+}
+
+// 语句的事务上下文：显式事务中使用会话的事务，否则为本语句开始一个自动提交事务。
+// 自动提交事务在 commit() 时提交，未提交即析构（出错返回）时回滚。
+// 须在获取表锁之前创建：提交和回滚会获取表的排他锁。
+class StatementTransaction {
+public:
+    explicit StatementTransaction(Session& session)
+        : txn_(session.getTransaction()), autocommit_(!txn_) {
+        if (autocommit_) {
+            txn_ = TransactionManager::instance().begin(false);
+        }
+    }
+
+    ~StatementTransaction() {
+        if (autocommit_ && txn_) {
+            TransactionManager::instance().rollback(*txn_);
+        }
+    }
+
+    StatementTransaction(const StatementTransaction&) = delete;
+    StatementTransaction& operator=(const StatementTransaction&) = delete;
+
+    Transaction& get() { return *txn_; }
+    const ReadView& getReadView() const { return txn_->getReadView(); }
+
+    // 语句成功：自动提交事务立即提交，显式事务等待 COMMIT
+    void commit() {
+        if (autocommit_ && txn_) {
+            TransactionManager::instance().commit(*txn_);
+            txn_.reset();
+        }
+    }
+
+private:
+    std::shared_ptr<Transaction> txn_;
+    bool autocommit_;
+};
+
+// 辅助函数：按访问路径读取表中满足全部条件的可见行，返回读取的行数
+static size_t filterRows(const Table& table,
+                         const ReadView& view,
+                         const AccessPath& path,
+                         const std::vector<const Expression*>& conditions,
+                         std::vector<Row>& out) {
+    size_t scanned = 0;
+    path.forEachRow(table, view, true, [&](const Row& row) {
+        scanned++;
+        for (const Expression* condition : conditions) {
+            if (!ExpressionEvaluator::evaluate(condition, row, table.getColumns())) {
+                return true;
+            }
+        }
+        out.push_back(row);
+        return true;
+    });
+    return scanned;
+}
+
+// 辅助函数：合取条件的文字描述（EXPLAIN 输出）
+static std::string describeConditions(const std::vector<const Expression*>& conditions) {
+    std::string text;
+    for (size_t i = 0; i < conditions.size(); ++i) {
+        if (i > 0) text += " AND ";
+        text += conditions[i]->toString();
+    }
+    return text;
+}
+
+// 辅助函数：ORDER BY 的文字描述（EXPLAIN 输出）
+static std::string describeOrderBy(const SelectStatement* stmt) {
+    std::string text;
+    for (const auto& item : stmt->getOrderBy()) {
+        if (!text.empty()) text += ", ";
+        text += item.expr->toString() + (item.ascending ? "" : " DESC");
+    }
+    return text;
+}
+
+// 辅助函数：LIMIT/OFFSET 的文字描述（EXPLAIN 输出）
+static std::string describeLimit(const SelectStatement* stmt) {
+    std::string text = "Limit: ";
+    text += stmt->getLimit() >= 0 ? std::to_string(stmt->getLimit()) + " row(s)" : "all rows";
+    if (stmt->getOffset() > 0) {
+        text += ", offset " + std::to_string(stmt->getOffset());
+    }
+    return text;
+}
+
+// 辅助函数：连接算子的文字描述（EXPLAIN 输出）
+static std::string describeJoin(const JoinExecutor& executor, const JoinClause& join,
+                                const std::string& left_name, const std::string& right_name,
+                                bool analyze) {
+    std::string text = join.type == JoinType::LEFT ? "Left join" : "Inner join";
+    text += " using " + std::string(joinAlgorithmToString(executor.getAlgorithm()));
+    text += " on " + join.condition->toString();
+
+    switch (executor.getAlgorithm()) {
+        case JoinAlgorithm::HASH:
+            text += ", build " + (executor.buildsOnLeft() ? left_name : right_name);
+            if (analyze && executor.getPartitionCount() > 1) {
+                text += ", " + std::to_string(executor.getPartitionCount()) + " partitions";
+            }
+            break;
+        case JoinAlgorithm::INDEX_NESTED_LOOP:
+            text += ", inner " + (executor.indexOnLeft() ? left_name : right_name);
+            break;
+        case JoinAlgorithm::NESTED_LOOP:
+            break;
+    }
+    return text;
+}
+
+// 结果集每积累这么多字节就作为一段交给输出队列
+static constexpr size_t kResultSegmentBytes = 16 * 1024;
+
+// 辅助函数：编码完整的文本结果集（列数包、列定义、EOF、行数据、EOF）
+// 客户端协商了 CLIENT_DEPRECATE_EOF 时省去列定义后的 EOF，并以 0xFE 开头的 OK 包结束
+// projection 非空时只输出行中对应下标的列
+// rows 为 std::vector<Row> 或行指针列表，rowAt 把元素转换成 const Row&
+// emit_segment 非空时，行数据每满 kResultSegmentBytes 就交给它排队，大结果集不拼成一整块，
+// 由连接用 writev 一次写出；最后一段留在 response 中
+template <typename Rows, typename RowAt>
+static void encodeResultSet(Buffer& response,
+                            const std::vector<ColumnDef>& result_columns,
+                            const Rows& rows,
+                            RowAt rowAt,
+                            const std::vector<size_t>* projection,
+                            const std::string& table_name,
+                            const std::string& db_name,
+                            Session& session,
+                            const CommandHandler::ResponseCallback* emit_segment) {
+    PhaseTimer encode_timer(session.getStats().encode_ns);
+    ServerMetrics::instance().rows_returned.add(rows.size());
+    session.getStats().rows_returned += rows.size();
+
+    // 列数包
+    // Column count packet
+    Buffer col_count_buffer;
+    col_count_buffer.writeLenencInt(result_columns.size());
+
+    // 写入列数包的头部
+    // Write column count packet header
+    uint32_t col_count_len = static_cast<uint32_t>(col_count_buffer.readableBytes());
+    // Payload length (3 bytes, little-endian)
+    response.writeUint8(col_count_len & 0xFF);
+    response.writeUint8((col_count_len >> 8) & 0xFF);
+    response.writeUint8((col_count_len >> 16) & 0xFF);
+    response.writeUint8(session.nextSequenceId());  // sequence id
+    response.append(col_count_buffer.peek(), col_count_buffer.readableBytes());
+
+    // 列定义包
+    // Column definition packets
+    for (const auto& col : result_columns) {
+        ColumnDefinitionPacket col_def =
+            ColumnDefinitionPacket::fromColumnDef(col, table_name, db_name);
+        col_def.encode(response, session.nextSequenceId());
+    }
+
+    // 列定义后的EOF包
+    // EOF packet after column definitions
+    const bool deprecate_eof = session.hasClientFlag(CapabilityFlags::CLIENT_DEPRECATE_EOF);
+    if (!deprecate_eof) {
+        EofPacket eof1(0, session.getServerStatus());
+        eof1.encode(response, session.nextSequenceId());
+    }
+
+    // 行数据包：投影在编码时完成，不复制行
+    // Row data packets: projection happens while encoding, rows are not copied
+    for (const auto& row : rows) {
+        TextResultRowPacket::encodeRow(response, rowAt(row), projection, session.nextSequenceId());
+        if (emit_segment && response.readableBytes() >= kResultSegmentBytes) {
+            (*emit_segment)(response);
+        }
+    }
+
+    // 最终EOF包（或代替它的 OK 包）
+    // Final EOF packet (or the OK packet replacing it)
+    if (deprecate_eof) {
+        OkPacket ok(0, 0, session.getServerStatus(), 0);
+        ok.setHeader(0xFE);
+        ok.encode(response, session.nextSequenceId());
+    } else {
+        EofPacket eof2(0, session.getServerStatus());
+        eof2.encode(response, session.nextSequenceId());
+    }
+}
+
+static void encodeResultSet(Buffer& response,
+                            const std::vector<ColumnDef>& result_columns,
+                            const std::vector<Row>& rows,
+                            const std::vector<size_t>* projection,
+                            const std::string& table_name,
+                            const std::string& db_name,
+                            Session& session,
+                            const CommandHandler::ResponseCallback* emit_segment = nullptr) {
+    encodeResultSet(response, result_columns, rows, [](const Row& row) -> const Row& { return row; },
+                    projection, table_name, db_name, session, emit_segment);
+}
+
+static void encodeResultSet(Buffer& response,
+                            const std::vector<ColumnDef>& result_columns,
+                            const std::pmr::vector<const Row*>& rows,
+                            const std::vector<size_t>* projection,
+                            const std::string& table_name,
+                            const std::string& db_name,
+                            Session& session,
+                            const CommandHandler::ResponseCallback* emit_segment = nullptr) {
+    encodeResultSet(response, result_columns, rows, [](const Row* row) -> const Row& { return *row; },
+                    projection, table_name, db_name, session, emit_segment);
+}
+
+// 辅助函数：将查询剖析编码为单列 EXPLAIN 结果集，每个算子一行
+static void encodeExplain(Buffer& response, const QueryProfile& profile, Session& session) {
+    std::vector<ColumnDef> columns = {ColumnDef("EXPLAIN", DataType::VARCHAR)};
+    std::vector<Row> rows;
+    for (auto& line : profile.render()) {
+        rows.emplace_back(std::vector<Value>{Value(line)});
+    }
+    encodeResultSet(response, columns, rows, nullptr, "", "", session);
+}
+
 // ==================== PingCommandHandler ====================
 
 bool PingCommandHandler::handleCommand(MySQLCommand command,
@@ -79,7 +407,7 @@ bool PingCommandHandler::handleCommand(MySQLCommand command,
 
     // PING命令直接返回OK包
     Buffer response;
-    OkPacket ok_packet(0, 0, ServerStatus::SERVER_STATUS_AUTOCOMMIT, 0);
+    OkPacket ok_packet(0, 0, session.getServerStatus(), 0);
     ok_packet.encode(response, session.nextSequenceId());
 
     response_callback(response);
@@ -108,7 +436,7 @@ bool QueryCommandHandler::handleCommand(MySQLCommand command,
     // 读取SQL查询字符串
     std::string query = buffer.readString(buffer.readableBytes());
 
-    LOG_INFO("Query from " << session.getUsername() << ": " << query);
+    LOG_DEBUG("Query from " << session.getUsername() << ": " << query);
 
     // 移除查询字符串前后的空白字符
     query.erase(0, query.find_first_not_of(" \t\n\r"));
@@ -117,8 +445,10 @@ bool QueryCommandHandler::handleCommand(MySQLCommand command,
     Buffer response;
 
     // 使用SQL解析器解析查询
+    uint64_t parse_start = metrics::nowNs();
     Parser parser(query);
     auto stmt = parser.parse();
+    session.getStats().parse_ns += metrics::nowNs() - parse_start;
 
     // 如果解析出错，返回语法错误
     if (parser.hasErrors()) {
@@ -136,7 +466,7 @@ bool QueryCommandHandler::handleCommand(MySQLCommand command,
 
     // 如果解析为空，返回空结果
     if (!stmt) {
-        OkPacket ok_packet(0, 0, ServerStatus::SERVER_STATUS_AUTOCOMMIT, 0);
+        OkPacket ok_packet(0, 0, session.getServerStatus(), 0);
         ok_packet.encode(response, session.nextSequenceId());
         response_callback(response);
         return true;
@@ -146,17 +476,37 @@ bool QueryCommandHandler::handleCommand(MySQLCommand command,
 
     // 根据语句类型分发执行
     if (auto* select_stmt = dynamic_cast<SelectStatement*>(stmt.get())) {
-        return executeSelect(select_stmt, session, response_callback);
+        return executeSelect(select_stmt, session, response_callback, nullptr);
     } else if (auto* insert_stmt = dynamic_cast<InsertStatement*>(stmt.get())) {
         return executeInsert(insert_stmt, session, response_callback);
+    } else if (auto* update_stmt = dynamic_cast<UpdateStatement*>(stmt.get())) {
+        return executeUpdate(update_stmt, session, response_callback);
+    } else if (auto* delete_stmt = dynamic_cast<DeleteStatement*>(stmt.get())) {
+        return executeDelete(delete_stmt, session, response_callback);
     } else if (auto* create_stmt = dynamic_cast<CreateTableStatement*>(stmt.get())) {
         return executeCreateTable(create_stmt, session, response_callback);
     } else if (auto* drop_stmt = dynamic_cast<DropTableStatement*>(stmt.get())) {
         return executeDropTable(drop_stmt, session, response_callback);
+    } else if (auto* explain_stmt = dynamic_cast<ExplainStatement*>(stmt.get())) {
+        return executeExplain(explain_stmt, session, response_callback);
+    } else if (auto* index_stmt = dynamic_cast<CreateIndexStatement*>(stmt.get())) {
+        return executeCreateIndex(index_stmt, session, response_callback);
+    } else if (auto* analyze_stmt = dynamic_cast<AnalyzeTableStatement*>(stmt.get())) {
+        return executeAnalyzeTable(analyze_stmt, session, response_callback);
     } else if (auto* show_tables_stmt = dynamic_cast<ShowTablesStatement*>(stmt.get())) {
         return executeShowTables(session, response_callback);
     } else if (auto* show_dbs_stmt = dynamic_cast<ShowDatabasesStatement*>(stmt.get())) {
         return executeShowDatabases(session, response_callback);
+    } else if (auto* show_status_stmt = dynamic_cast<ShowStatusStatement*>(stmt.get())) {
+        return executeShowStatus(show_status_stmt, session, response_callback);
+    } else if (auto* digests_stmt = dynamic_cast<ShowQueryDigestsStatement*>(stmt.get())) {
+        return executeShowQueryDigests(digests_stmt, session, response_callback);
+    } else if (auto* processlist_stmt = dynamic_cast<ShowProcesslistStatement*>(stmt.get())) {
+        return executeShowProcesslist(processlist_stmt, session, response_callback);
+    } else if (auto* kill_stmt = dynamic_cast<KillStatement*>(stmt.get())) {
+        return executeKill(kill_stmt, session, response_callback);
+    } else if (auto* txn_stmt = dynamic_cast<TransactionStatement*>(stmt.get())) {
+        return executeTransaction(txn_stmt, session, response_callback);
     } else if (auto* use_db_stmt = dynamic_cast<UseDatabaseStatement*>(stmt.get())) {
         return executeUseDatabase(use_db_stmt, session, response_callback);
     }
@@ -171,8 +521,9 @@ bool QueryCommandHandler::handleCommand(MySQLCommand command,
 
 bool QueryCommandHandler::executeSelect(const SelectStatement* stmt,
                                        Session& session,
-                                       ResponseCallback response_callback) {
-    LOG_INFO("Executing SELECT: " << stmt->toString());
+                                       ResponseCallback response_callback,
+                                       QueryProfile* profile) {
+    LOG_DEBUG("Executing SELECT: " << stmt->toString());
 
     Buffer response;
 
@@ -207,45 +558,346 @@ bool QueryCommandHandler::executeSelect(const SelectStatement* stmt,
         return true;
     }
 
-    // 3. 确定要返回的列
-    // Determine which columns to return
-    std::vector<ColumnDef> result_columns;
-    std::vector<size_t> column_indices;
+    // 按事务快照读取；语句执行期间持有表的共享锁，阻止写语句和压缩交换行数组
+    // Read at the transaction's snapshot; hold the table's shared lock during the
+    // statement so writers and compaction cannot swap the rows
+    StatementTransaction txn(session);
+    const ReadView& view = txn.getReadView();
+    std::shared_lock<std::shared_mutex> table_lock(table->getLock(), std::defer_lock);
+    std::shared_lock<std::shared_mutex> right_table_lock;
+
+    // 3. 确定数据来源：单表或两表连接
+    // Determine the row source: a single table or a two-table join
+    const JoinClause* join = stmt->getJoin();
+    const std::vector<ColumnDef>* columns = &table->getColumns();
+    std::vector<ColumnDef> join_columns;
+    std::shared_ptr<Table> right_table;
+    std::unique_ptr<JoinExecutor> join_executor;
+    std::vector<const Expression*> left_conditions;
+    std::vector<const Expression*> right_conditions;
+    std::vector<Row> left_rows;
+    std::vector<Row> right_rows;
+    AccessPath access_path;
+    bool scan_ascending = true;
+    const std::string& table_ref = stmt->getTableAlias().empty() ? table_name : stmt->getTableAlias();
+
+    // 剖析算子（profile 为nullptr时均为nullptr，执行路径上只做空指针判断）
+    // Profiled operators (all nullptr unless profiling)
+    OperatorProfile* source_op = nullptr;
+    OperatorProfile* filter_op = nullptr;
+    OperatorProfile* sort_op = nullptr;
+    OperatorProfile* limit_op = nullptr;
+    bool analyze = profile && profile->isAnalyze();
+
+    if (join) {
+        right_table = db->getTable(join->table_name);
+        if (!right_table) {
+            ErrPacket err_packet(1146, "42S02",
+                "Table '" + db_name + "." + join->table_name + "' doesn't exist");
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+        // 两张表同时加锁（std::lock 避免与按地址顺序加锁的事务提交死锁）
+        // Lock both tables together (std::lock avoids deadlock with commits locking in address order)
+        if (right_table != table) {
+            right_table_lock = std::shared_lock<std::shared_mutex>(right_table->getLock(), std::defer_lock);
+            std::lock(table_lock, right_table_lock);
+        } else {
+            table_lock.lock();
+        }
 
-    if (stmt->getColumns().size() == 1) {
-        auto* first_col = dynamic_cast<const Identifier*>(stmt->getColumns()[0].get());
-        if (first_col && first_col->getName() == "*") {
-            // SELECT * - 所有列
-            // SELECT * - all columns
-            result_columns = table->getColumns();
-            for (size_t i = 0; i < result_columns.size(); ++i) {
-                column_indices.push_back(i);
+        const std::string& left_name = table_ref;
+        const std::string& right_name = join->getReferenceName();
+        if (left_name == right_name) {
+            ErrPacket err_packet(1066, "42000", "Not unique table/alias: '" + right_name + "'");
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+
+        join_columns = JoinExecutor::combineColumns(left_name, table->getColumns(),
+                                                    right_name, right_table->getColumns());
+        columns = &join_columns;
+
+        if (!checkColumns(join->condition.get(), join_columns, "on clause", response, session,
+                          response_callback)) {
+            return true;
+        }
+
+        if (!checkColumns(stmt->getWhereClause(), join_columns, "where clause", response, session,
+                          response_callback)) {
+            return true;
+        }
+
+        // 下推只引用单表的WHERE条件（LEFT JOIN 只能下推到左表）
+        // Push down single-table WHERE conjuncts (only to the left side for LEFT JOIN)
+        for (const Expression* conjunct : CostModel::splitConjuncts(stmt->getWhereClause())) {
+            int side = conjunctSide(conjunct, join_columns, table->getColumnCount());
+            if (side == 0) {
+                left_conditions.push_back(conjunct);
+            } else if (side == 1 && join->type == JoinType::INNER) {
+                right_conditions.push_back(conjunct);
             }
-        } else {
-            // 单个特定列
-            // Single specific column
-            if (!first_col) {
-                ErrPacket err_packet(1064, "42000", "Invalid column expression");
-                err_packet.encode(response, session.nextSequenceId());
-                response_callback(response);
-                return true;
+        }
+
+        // 提取等值连接键
+        // Extract the equi-join key
+        int left_key = -1;
+        int right_key = -1;
+        bool needs_residual = true;
+        bool has_equi_key = JoinExecutor::extractEquiKey(join->condition.get(), join_columns,
+                                                         table->getColumnCount(),
+                                                         left_key, right_key, needs_residual);
+
+        // 读取连接的一侧：有下推条件时按其访问路径过滤并物化（EXPLAIN 只做估算）
+        // Prepare one join input: filter and materialize through its access path when
+        // conditions were pushed down (EXPLAIN only estimates)
+        auto prepare_input = [&](const Table& side_table, const std::string& alias,
+                                 const std::vector<const Expression*>& conditions,
+                                 std::vector<Row>& filtered, JoinInput& input,
+                                 JoinSideEstimate& estimate) -> OperatorProfile* {
+            input.rows = conditions.empty() ? &side_table.getRows() : &filtered;
+            input.table = conditions.empty() ? &side_table : nullptr;
+            input.view = &view;
+            input.width = side_table.getColumnCount();
+            estimate.table_rows = static_cast<double>(side_table.getRowCount());
+            estimate.rows = estimate.table_rows;
+
+            AccessPath path;
+            path.estimated_rows = estimate.table_rows;
+            if (!conditions.empty()) {
+                PhaseTimer plan_timer(session.getStats().plan_ns);
+                path = CostModel::chooseAccessPath(side_table, conditions);
+                estimate.rows *= CostModel::estimateSelectivity(side_table, conditions);
             }
 
-            int col_idx = table->getColumnIndex(first_col->getName());
-            if (col_idx < 0) {
-                ErrPacket err_packet(1054, "42S22",
-                    "Unknown column '" + first_col->getName() + "' in 'field list'");
-                err_packet.encode(response, session.nextSequenceId());
-                response_callback(response);
+            OperatorProfile* access_op = nullptr;
+            OperatorProfile* side_filter_op = nullptr;
+            if (profile) {
+                access_op = profile->add(path.describe(side_table, alias, true), path.estimated_rows);
+                access_op->rows_in = conditions.empty() ? side_table.getRowCount() : 0;
+                access_op->rows_out = access_op->rows_in;
+                if (!conditions.empty()) {
+                    side_filter_op = profile->wrap("Filter: " + describeConditions(conditions),
+                                                   access_op, estimate.rows);
+                    side_filter_op->filters = true;
+                }
+            }
+
+            if (conditions.empty() || (profile && !analyze)) {
+                return side_filter_op ? side_filter_op : access_op;
+            }
+
+            OperatorTimer timer(side_filter_op);
+            size_t scanned = filterRows(side_table, view, path, conditions, filtered);
+            estimate.rows = static_cast<double>(filtered.size());
+
+            if (side_filter_op) {
+                access_op->rows_in = scanned;
+                access_op->rows_out = scanned;
+                side_filter_op->rows_in = scanned;
+                side_filter_op->rows_out = filtered.size();
+                side_filter_op->rows_filtered = scanned - filtered.size();
+                for (const auto& row : filtered) {
+                    side_filter_op->bytes += ExternalSorter::estimateRowSize(row);
+                }
+            }
+            return side_filter_op;
+        };
+
+        JoinInput left_input;
+        JoinInput right_input;
+        JoinSideEstimate left_estimate;
+        JoinSideEstimate right_estimate;
+        OperatorProfile* left_op = nullptr;
+        OperatorProfile* right_op = nullptr;
+        try {
+            left_op = prepare_input(*table, left_name, left_conditions, left_rows,
+                                    left_input, left_estimate);
+            right_op = prepare_input(*right_table, right_name, right_conditions, right_rows,
+                                     right_input, right_estimate);
+        } catch (const std::exception& e) {
+            ErrPacket err_packet(1064, "42000",
+                "Error evaluating WHERE clause: " + std::string(e.what()));
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+
+        if (has_equi_key) {
+            // 已过滤的输入不再与表的行号对应，不能走索引
+            // Filtered inputs no longer line up with table row ids, so no index lookups
+            left_input.key_column = left_key;
+            left_input.key_type = table->getColumns()[left_key].type;
+            left_input.index = left_conditions.empty() ? table->getIndex(left_key) : nullptr;
+            right_input.key_column = right_key;
+            right_input.key_type = right_table->getColumns()[right_key].type;
+            right_input.index = right_conditions.empty() ? right_table->getIndex(right_key) : nullptr;
+
+            left_estimate.key_ndv = CostModel::estimateKeyNdv(*table, left_key);
+            left_estimate.has_index = left_input.index != nullptr;
+            right_estimate.key_ndv = CostModel::estimateKeyNdv(*right_table, right_key);
+            right_estimate.has_index = right_input.index != nullptr;
+        }
+
+        JoinPlan plan;
+        {
+            PhaseTimer plan_timer(session.getStats().plan_ns);
+            plan = CostModel::planJoin(join->type, has_equi_key, left_estimate, right_estimate);
+        }
+        join_executor = std::make_unique<JoinExecutor>(
+            join->type, left_input, right_input,
+            needs_residual ? join->condition.get() : nullptr, join_columns, plan);
+
+        if (profile) {
+            source_op = profile->add(describeJoin(*join_executor, *join, left_name, right_name, analyze),
+                                     plan.estimated_rows);
+            source_op->children = {left_op, right_op};
+            source_op->rows_in = left_input.rows->size() + right_input.rows->size();
+            source_op->bytes = join_executor->getBuildBytes();
+        }
+    } else {
+        table_lock.lock();
+        if (!checkColumns(stmt->getWhereClause(), *columns, "where clause", response, session,
+                          response_callback)) {
+            return true;
+        }
+
+        // 单表：由代价模型选择全表扫描、主键查找或二级索引
+        // Single table: the cost model picks full scan, PK lookup or a secondary index
+        try {
+            PhaseTimer plan_timer(session.getStats().plan_ns);
+            access_path = CostModel::chooseAccessPath(
+                *table, CostModel::splitConjuncts(stmt->getWhereClause()));
+        } catch (const std::exception& e) {
+            ErrPacket err_packet(1064, "42000",
+                "Error evaluating WHERE clause: " + std::string(e.what()));
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+        LOG_DEBUG("Access path for " << table_name << ": "
+                  << accessPathTypeToString(access_path.type)
+                  << (access_path.usesIndex() ? " using " + access_path.index_name : "")
+                  << ", estimated rows: " << access_path.estimated_rows);
+    }
+
+    // 按来源逐行扫描（连接结果或表的访问路径），consume 返回false时停止
+    // Scan rows from the source (join output or the table's access path); stop when consume returns false
+    auto scan = [&](const std::function<bool(const Row&)>& consume) {
+        auto run = [&](const std::function<bool(const Row&)>& fn) {
+            if (join_executor) {
+                join_executor->run([&fn](Row&& row) { return fn(row); });
+            } else {
+                access_path.forEachRow(*table, view, scan_ascending, fn);
+            }
+        };
+
+        if (!source_op) {
+            run(consume);
+            return;
+        }
+
+        // 剖析：数据源只计自身耗时，扣除下游算子的耗时
+        // Profiling: the source is charged its own time only, excluding downstream operators
+        uint64_t downstream_ns = 0;
+        uint64_t start_ns = QueryProfile::nowNs();
+        run([&](const Row& row) {
+            if (!join_executor) {
+                source_op->rows_in++;
+            }
+            source_op->rows_out++;
+            uint64_t consume_start_ns = QueryProfile::nowNs();
+            bool more = consume(row);
+            downstream_ns += QueryProfile::nowNs() - consume_start_ns;
+            return more;
+        });
+        source_op->time_ns += QueryProfile::nowNs() - start_ns - downstream_ns;
+    };
+
+    // 聚合查询走哈希聚合路径
+    // Aggregate queries go through the hash aggregation path
+    if (stmt->hasAggregation()) {
+        if (profile && !join_executor) {
+            source_op = profile->add(access_path.describe(*table, table_ref, true),
+                                     access_path.estimated_rows);
+        }
+        if (profile && !analyze) {
+            // EXPLAIN：聚合算子由 executeAggregateSelect 添加，不读取数据
+            // EXPLAIN: the aggregate operators are added by executeAggregateSelect, no rows are read
+            return executeAggregateSelect(stmt, {}, *columns, table_name, db_name, session,
+                                          response_callback, profile);
+        }
+        if (!join_executor && !access_path.usesIndex() && table->allVisible(view)) {
+            metrics::addRowsScanned(table->getRowCount());
+            if (source_op) {
+                source_op->rows_in = table->getRowCount();
+                source_op->rows_out = table->getRowCount();
+            }
+            return executeAggregateSelect(stmt, table->getRows(), table->getColumns(),
+                                          table_name, db_name, session, response_callback, profile);
+        }
+        if (!join_executor) {
+            std::vector<Row> candidate_rows;
+            scan([&candidate_rows](const Row& row) {
+                candidate_rows.push_back(row);
+                return true;
+            });
+            return executeAggregateSelect(stmt, candidate_rows, table->getColumns(),
+                                          table_name, db_name, session, response_callback, profile);
+        }
+
+        std::vector<Row> joined_rows;
+        try {
+            OperatorTimer timer(source_op);
+            join_executor->run([&joined_rows](Row&& row) {
+                joined_rows.push_back(std::move(row));
                 return true;
+            });
+            if (source_op) {
+                source_op->rows_out = joined_rows.size();
             }
+        } catch (const std::exception& e) {
+            ErrPacket err_packet(1064, "42000",
+                "Error evaluating JOIN condition: " + std::string(e.what()));
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+        return executeAggregateSelect(stmt, joined_rows, join_columns,
+                                      table_name, db_name, session, response_callback, profile);
+    }
+
+    // 4. 确定要返回的列
+    // Determine which columns to return
+    std::vector<ColumnDef> result_columns;
+    std::vector<size_t> column_indices;
 
-            result_columns.push_back(table->getColumns()[col_idx]);
-            column_indices.push_back(col_idx);
+    // 结果集中显示不带限定的列名
+    // Result set shows unqualified column names
+    auto add_result_column = [&](size_t index) {
+        ColumnDef column = (*columns)[index];
+        size_t dot = column.name.rfind('.');
+        if (join && dot != std::string::npos) {
+            column.name = column.name.substr(dot + 1);
+        }
+        result_columns.push_back(column);
+        column_indices.push_back(index);
+    };
+
+    auto* first_col = stmt->getColumns().size() == 1
+        ? dynamic_cast<const Identifier*>(stmt->getColumns()[0].get()) : nullptr;
+
+    if (first_col && first_col->getName() == "*") {
+        // SELECT * - 所有列
+        // SELECT * - all columns
+        for (size_t i = 0; i < columns->size(); ++i) {
+            add_result_column(i);
         }
     } else {
-        // 多个特定列
-        // Multiple specific columns
+        // 特定列（可带表名/别名限定）
+        // Specific columns (optionally qualified)
         for (const auto& col_expr : stmt->getColumns()) {
             auto* id = dynamic_cast<const Identifier*>(col_expr.get());
             if (!id) {
@@ -255,127 +907,1040 @@ bool QueryCommandHandler::executeSelect(const SelectStatement* stmt,
                 return true;
             }
 
-            int col_idx = table->getColumnIndex(id->getName());
-            if (col_idx < 0) {
-                ErrPacket err_packet(1054, "42S22",
-                    "Unknown column '" + id->getName() + "' in 'field list'");
+            if (!checkColumns(id, *columns, "field list", response, session, response_callback)) {
+                return true;
+            }
+            add_result_column(ExpressionEvaluator::resolveColumn(id, *columns));
+        }
+    }
+
+    // 5. 解析ORDER BY
+    // Resolve ORDER BY columns
+    std::vector<SortKey> sort_keys;
+    for (const auto& item : stmt->getOrderBy()) {
+        auto* id = dynamic_cast<const Identifier*>(item.expr.get());
+        if (!id) {
+            ErrPacket err_packet(1054, "42S22",
+                "Unknown column '" + item.expr->toString() + "' in 'order clause'");
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+        if (!checkColumns(id, *columns, "order clause", response, session, response_callback)) {
+            return true;
+        }
+        sort_keys.push_back({static_cast<size_t>(ExpressionEvaluator::resolveColumn(id, *columns)),
+                             item.ascending});
+    }
+
+    // 6. 扫描、过滤并排序
+    // Scan, filter and sort
+    size_t offset = stmt->getOffset();
+    int limit = stmt->getLimit();
+    size_t needed = limit >= 0 ? offset + static_cast<size_t>(limit) : SIZE_MAX;
+
+    // 结果行：单表不排序时直接引用表中的行（表锁持有到编码完成），排序和连接产生的行
+    // 存放在 owned_rows 中（记入语句内存用量）；指针列表从语句内存池分配
+    // Result rows: without sorting, single-table results point straight into the table
+    // (locked until encoded); sorted and joined rows live in owned_rows. The pointer
+    // list comes from the statement arena.
+    std::vector<Row> owned_rows;
+    TrackedMemory owned_memory;
+    std::pmr::vector<const Row*> result_rows(QueryArena::resource());
+    const Expression* where_clause = stmt->getWhereClause();
+
+    // 排序列上有索引且访问路径不冲突时，按索引顺序读取即可免排序
+    // When the sort column is indexed and compatible with the access path, read in index order
+    bool index_order = !join && sort_keys.size() == 1 &&
+                       table->getIndex(sort_keys[0].column) &&
+                       (!access_path.usesIndex() ||
+                        access_path.column == static_cast<int>(sort_keys[0].column));
+    if (index_order) {
+        if (!access_path.usesIndex()) {
+            PhaseTimer plan_timer(session.getStats().plan_ns);
+            access_path = CostModel::indexScan(*table, sort_keys[0].column);
+        }
+        scan_ascending = sort_keys[0].ascending;
+    }
+
+    // 构建计划树：数据源 -> 过滤 -> 排序 -> LIMIT
+    // Build the plan tree: source -> filter -> sort -> limit
+    if (profile) {
+        if (!join) {
+            source_op = profile->add(access_path.describe(*table, table_ref, scan_ascending),
+                                     access_path.estimated_rows);
+        }
+        if (where_clause) {
+            double estimate = join ? -1 : static_cast<double>(table->getRowCount()) *
+                CostModel::estimateSelectivity(*table, CostModel::splitConjuncts(where_clause));
+            filter_op = profile->wrap("Filter: " + where_clause->toString(), source_op, estimate);
+            filter_op->filters = true;
+        }
+        if (!sort_keys.empty() && !index_order) {
+            std::string name = "Sort: " + describeOrderBy(stmt);
+            if (limit >= 0) {
+                name += ", limit input to " + std::to_string(needed) + " row(s)";
+            }
+            sort_op = profile->wrap(name, profile->getRoot());
+        }
+        if (limit >= 0 || offset > 0) {
+            limit_op = profile->wrap(describeLimit(stmt), profile->getRoot());
+        }
+
+        if (!analyze) {
+            encodeExplain(response, *profile, session);
+            response_callback(response);
+            return true;
+        }
+    }
+
+    auto matches = [&](const Row& row) {
+        if (!where_clause) {
+            return true;
+        }
+        if (!filter_op) {
+            return ExpressionEvaluator::evaluate(where_clause, row, *columns);
+        }
+        OperatorTimer timer(filter_op);
+        bool ok = ExpressionEvaluator::evaluate(where_clause, row, *columns);
+        filter_op->rows_in++;
+        (ok ? filter_op->rows_out : filter_op->rows_filtered)++;
+        return ok;
+    };
+
+    try {
+        if (sort_keys.empty() || index_order) {
+            // 无排序（或按索引顺序读取）：取够 OFFSET+LIMIT 行即可停止扫描
+            // No sort needed: stop scanning once OFFSET+LIMIT rows are found
+            size_t found = 0;
+            scan([&](const Row& row) {
+                if (found >= needed) {
+                    return false;
+                }
+                if (matches(row)) {
+                    // 连接结果是临时行，需要复制
+                    if (join_executor) {
+                        owned_memory.add(ExternalSorter::estimateRowSize(row));
+                        owned_rows.push_back(row);
+                    } else {
+                        result_rows.push_back(&row);
+                    }
+                    found++;
+                }
+                return found < needed;
+            });
+        } else if (limit >= 0) {
+            // ORDER BY ... LIMIT：Top-N 堆，只保留 OFFSET+LIMIT 行
+            // ORDER BY ... LIMIT: bounded top-N heap
+            TopNHeap heap(sort_keys, needed);
+            scan([&](const Row& row) {
+                if (matches(row)) {
+                    OperatorTimer timer(sort_op);
+                    heap.push(row);
+                    if (sort_op) sort_op->rows_in++;
+                }
+                return true;
+            });
+            {
+                OperatorTimer timer(sort_op);
+                owned_rows = heap.finish();
+            }
+            for (const auto& row : owned_rows) {
+                owned_memory.add(ExternalSorter::estimateRowSize(row));
+            }
+            if (sort_op) {
+                sort_op->bytes = owned_memory.bytes();
+            }
+        } else {
+            // 无LIMIT：外部排序，超过 sort_buffer_size 时溢出到临时文件
+            // No LIMIT: external merge sort, spills past sort_buffer_size
+            const auto& config = Config::instance();
+            ExternalSorter sorter(sort_keys, config.sort_buffer_size, config.tmpdir);
+            scan([&](const Row& row) {
+                if (matches(row)) {
+                    OperatorTimer timer(sort_op);
+                    sorter.add(row);
+                    if (sort_op) {
+                        sort_op->rows_in++;
+                        sort_op->bytes += ExternalSorter::estimateRowSize(row);
+                    }
+                }
+                return true;
+            });
+            {
+                OperatorTimer timer(sort_op);
+                sorter.finish([&](Row&& row) {
+                    owned_memory.add(ExternalSorter::estimateRowSize(row));
+                    owned_rows.push_back(std::move(row));
+                    return true;
+                });
+            }
+            if (sort_op && sorter.getRunCount() > 0) {
+                sort_op->name += ", spilled to " + std::to_string(sorter.getRunCount()) + " run(s)";
+            }
+        }
+        if (sort_op) {
+            sort_op->rows_out = owned_rows.size();
+        }
+        result_rows.reserve(result_rows.size() + owned_rows.size());
+        for (const auto& row : owned_rows) {
+            result_rows.push_back(&row);
+        }
+    } catch (const SortError& e) {
+        ErrPacket err_packet(1030, "HY000", "Error sorting result: " + std::string(e.what()));
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    } catch (const std::exception& e) {
+        ErrPacket err_packet(1064, "42000",
+            "Error evaluating WHERE clause: " + std::string(e.what()));
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // 7. 应用OFFSET（LIMIT已在扫描/排序阶段应用）
+    // Apply OFFSET (LIMIT was applied during scan/sort)
+    if (limit_op) {
+        limit_op->rows_in = result_rows.size();
+    }
+    if (offset >= result_rows.size()) {
+        result_rows.clear();
+    } else {
+        if (offset > 0) {
+            result_rows.erase(result_rows.begin(),
+                              result_rows.begin() + offset);
+        }
+
+        if (limit >= 0 && static_cast<size_t>(limit) < result_rows.size()) {
+            result_rows.resize(limit);
+        }
+    }
+
+    LOG_DEBUG("SELECT result: " << result_rows.size() << " rows matched");
+
+    // 8. 发送结果集（EXPLAIN ANALYZE 丢弃结果，返回各算子统计）
+    // Send result set (EXPLAIN ANALYZE discards the rows and returns operator statistics)
+    if (profile) {
+        if (limit_op) {
+            limit_op->rows_out = result_rows.size();
+        }
+        encodeExplain(response, *profile, session);
+    } else {
+        encodeResultSet(response, result_columns, result_rows, &column_indices,
+                        table_name, db_name, session, &response_callback);
+    }
+
+    // 发送响应
+    // Send response
+    response_callback(response);
+    return true;
+}
+
+bool QueryCommandHandler::executeExplain(const ExplainStatement* stmt,
+                                         Session& session,
+                                         ResponseCallback response_callback) {
+    LOG_DEBUG("Executing " << stmt->toString());
+
+    // EXPLAIN 只规划不执行；EXPLAIN ANALYZE 执行查询并统计各算子，丢弃结果行
+    // EXPLAIN plans only; EXPLAIN ANALYZE runs the query, profiles each operator and discards the rows
+    QueryProfile profile(stmt->isAnalyze());
+    return executeSelect(stmt->getSelect(), session, response_callback, &profile);
+}
+
+bool QueryCommandHandler::executeAggregateSelect(const SelectStatement* stmt,
+                                                const std::vector<Row>& rows,
+                                                const std::vector<ColumnDef>& columns,
+                                                const std::string& table_name,
+                                                const std::string& db_name,
+                                                Session& session,
+                                                ResponseCallback response_callback,
+                                                QueryProfile* profile) {
+    Buffer response;
+    const auto& group_by = stmt->getGroupBy();
+
+    // 1. 解析SELECT列表：每一列要么是聚合函数，要么是GROUP BY中的表达式
+    // Resolve select list: each item is either an aggregate or a GROUP BY expression
+    std::vector<AggregateSpec> aggregates;
+    std::vector<ColumnDef> result_columns;
+    std::vector<size_t> output_indices;   // 结果行布局为 [分组键..., 聚合值...]
+    bool count_star_only = true;
+
+    try {
+        for (size_t i = 0; i < stmt->getColumns().size(); ++i) {
+            const Expression* expr = stmt->getColumns()[i].get();
+            ColumnDef result_col;
+            result_col.name = expr->toString();
+
+            if (auto* func = dynamic_cast<const FunctionCall*>(expr)) {
+                AggregateSpec spec = AggregateSpec::fromFunctionCall(func);
+                if (spec.kind != AggregateKind::COUNT_STAR) {
+                    count_star_only = false;
+                }
+
+                // 参数列的类型决定结果类型
+                // Argument column type determines the result type
+                DataType arg_type = DataType::VARCHAR;
+                if (auto* arg_id = dynamic_cast<const Identifier*>(spec.argument)) {
+                    if (!checkColumns(arg_id, columns, "field list", response, session,
+                                      response_callback)) {
+                        return true;
+                    }
+                    arg_type = columns[ExpressionEvaluator::resolveColumn(arg_id, columns)].type;
+                }
+
+                switch (spec.kind) {
+                    case AggregateKind::COUNT_STAR:
+                    case AggregateKind::COUNT:
+                        result_col.type = DataType::BIGINT;
+                        break;
+                    case AggregateKind::SUM:
+                        result_col.type = (arg_type == DataType::INT || arg_type == DataType::BIGINT ||
+                                           arg_type == DataType::BOOLEAN)
+                                          ? DataType::BIGINT : DataType::DOUBLE;
+                        break;
+                    case AggregateKind::AVG:
+                        result_col.type = DataType::DOUBLE;
+                        break;
+                    case AggregateKind::MIN:
+                    case AggregateKind::MAX:
+                        result_col.type = arg_type;
+                        break;
+                }
+
+                output_indices.push_back(group_by.size() + aggregates.size());
+                aggregates.push_back(spec);
+            } else {
+                count_star_only = false;
+
+                // 非聚合列必须出现在GROUP BY中（ONLY_FULL_GROUP_BY语义）
+                // Non-aggregated columns must appear in GROUP BY (ONLY_FULL_GROUP_BY)
+                size_t key_idx = group_by.size();
+                for (size_t k = 0; k < group_by.size(); ++k) {
+                    if (group_by[k]->toString() == result_col.name) {
+                        key_idx = k;
+                        break;
+                    }
+                }
+                if (key_idx == group_by.size()) {
+                    ErrPacket err_packet(1055, "42000",
+                        "Expression #" + std::to_string(i + 1) +
+                        " of SELECT list is not in GROUP BY clause: '" + result_col.name + "'");
+                    err_packet.encode(response, session.nextSequenceId());
+                    response_callback(response);
+                    return true;
+                }
+
+                result_col.type = DataType::VARCHAR;
+                if (auto* id = dynamic_cast<const Identifier*>(expr)) {
+                    int idx = ExpressionEvaluator::resolveColumn(id, columns);
+                    if (idx >= 0) {
+                        result_col = columns[idx];
+                        result_col.name = id->getName();
+                    }
+                }
+                output_indices.push_back(key_idx);
+            }
+
+            result_columns.push_back(result_col);
+        }
+    } catch (const std::exception& e) {
+        ErrPacket err_packet(1064, "42000", e.what());
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // 2. 解析ORDER BY：映射到结果行中的位置（SELECT列表项或GROUP BY表达式）
+    // Resolve ORDER BY to positions in the result row (select item or GROUP BY expression)
+    std::vector<SortKey> sort_keys;
+    for (const auto& item : stmt->getOrderBy()) {
+        std::string name = item.expr->toString();
+        size_t position = SIZE_MAX;
+        for (size_t i = 0; i < result_columns.size() && position == SIZE_MAX; ++i) {
+            if (result_columns[i].name == name) {
+                position = output_indices[i];
+            }
+        }
+        for (size_t k = 0; k < group_by.size() && position == SIZE_MAX; ++k) {
+            if (group_by[k]->toString() == name) {
+                position = k;
+            }
+        }
+        if (position == SIZE_MAX) {
+            ErrPacket err_packet(1054, "42S22",
+                "Unknown column '" + name + "' in 'order clause'");
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+        sort_keys.push_back({position, item.ascending});
+    }
+
+    size_t offset = stmt->getOffset();
+    int limit = stmt->getLimit();
+
+    // 构建计划树：数据源（由调用方添加）-> 聚合 -> 排序 -> LIMIT
+    // Build the plan tree: source (added by the caller) -> aggregate -> sort -> limit
+    OperatorProfile* aggregate_op = nullptr;
+    OperatorProfile* sort_op = nullptr;
+    OperatorProfile* limit_op = nullptr;
+    if (profile) {
+        std::string name = "Aggregate";
+        if (!group_by.empty()) {
+            name = "Group aggregate using hash table: ";
+            for (size_t k = 0; k < group_by.size(); ++k) {
+                if (k > 0) name += ", ";
+                name += group_by[k]->toString();
+            }
+        }
+        if (stmt->getWhereClause()) {
+            name += ", filter: " + stmt->getWhereClause()->toString();
+        }
+        aggregate_op = profile->wrap(name, profile->getRoot());
+        aggregate_op->filters = stmt->getWhereClause() != nullptr;
+
+        if (!sort_keys.empty()) {
+            sort_op = profile->wrap("Sort: " + describeOrderBy(stmt), aggregate_op);
+        }
+        if (limit >= 0 || offset > 0) {
+            limit_op = profile->wrap(describeLimit(stmt), profile->getRoot());
+        }
+
+        if (!profile->isAnalyze()) {
+            encodeExplain(response, *profile, session);
+            response_callback(response);
+            return true;
+        }
+    }
+
+    // 3. 执行聚合
+    // Run aggregation
+    std::vector<Row> result_rows;
+    TrackedMemory result_memory;
+    OperatorTimer aggregate_timer(aggregate_op);
+
+    if (count_star_only && group_by.empty() && !stmt->getWhereClause()) {
+        // COUNT(*) 无WHERE时直接使用表行数，O(1)
+        // COUNT(*) without WHERE is answered from the row count in O(1)
+        Row row;
+        Value count(static_cast<int64_t>(rows.size()));
+        for (size_t i = 0; i < aggregates.size(); ++i) {
+            row.addValue(count);
+        }
+        result_rows.push_back(std::move(row));
+    } else {
+        std::vector<const Expression*> group_exprs;
+        for (const auto& expr : group_by) {
+            group_exprs.push_back(expr.get());
+        }
+
+        try {
+            HashAggregator aggregator(std::move(aggregates), std::move(group_exprs), columns);
+            aggregator.run(rows, stmt->getWhereClause());
+            result_rows = aggregator.getResults();
+            for (const auto& row : result_rows) {
+                result_memory.add(ExternalSorter::estimateRowSize(row));
+            }
+            if (aggregate_op) {
+                aggregate_op->rows_filtered = rows.size() - aggregator.getMatchedRows();
+                aggregate_op->bytes = aggregator.getMemoryBytes();
+            }
+        } catch (const std::exception& e) {
+            ErrPacket err_packet(1064, "42000",
+                "Error evaluating aggregate query: " + std::string(e.what()));
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+    }
+
+    if (aggregate_op) {
+        aggregate_op->rows_in = rows.size();
+        aggregate_op->rows_out = result_rows.size();
+        aggregate_timer.stop();
+    }
+
+    // 4. 排序分组结果
+    // Sort grouped results
+    if (!sort_keys.empty()) {
+        OperatorTimer timer(sort_op);
+        size_t needed = limit >= 0 ? offset + static_cast<size_t>(limit) : SIZE_MAX;
+        if (needed < result_rows.size()) {
+            TopNHeap heap(sort_keys, needed);
+            for (const auto& row : result_rows) {
+                heap.push(row);
+            }
+            result_rows = heap.finish();
+        } else {
+            ExternalSorter::parallelSort(result_rows, RowComparator(sort_keys));
+        }
+        if (sort_op) {
+            sort_op->rows_in = sort_op->children[0]->rows_out;
+            sort_op->rows_out = result_rows.size();
+        }
+    }
+
+    // 5. 应用LIMIT和OFFSET
+    // Apply LIMIT and OFFSET
+    if (limit_op) {
+        limit_op->rows_in = result_rows.size();
+    }
+    if (offset >= result_rows.size()) {
+        result_rows.clear();
+    } else {
+        if (offset > 0) {
+            result_rows.erase(result_rows.begin(), result_rows.begin() + offset);
+        }
+        if (limit >= 0 && static_cast<size_t>(limit) < result_rows.size()) {
+            result_rows.resize(limit);
+        }
+    }
+
+    LOG_DEBUG("Aggregate SELECT result: " << result_rows.size() << " groups");
+
+    // 6. 发送结果集（EXPLAIN ANALYZE 返回各算子统计）
+    // Send result set (EXPLAIN ANALYZE returns operator statistics)
+    if (profile) {
+        if (limit_op) {
+            limit_op->rows_out = result_rows.size();
+        }
+        encodeExplain(response, *profile, session);
+    } else {
+        encodeResultSet(response, result_columns, result_rows, &output_indices,
+                        table_name, db_name, session, &response_callback);
+    }
+    response_callback(response);
+    return true;
+}
+
+// 辅助函数：计算 UPDATE / ON DUPLICATE KEY UPDATE 的赋值结果并转换为列类型
+// 字面量与 INSERT 相同处理；其他表达式求值后转换，不能转换时抛出异常
+static Value evaluateAssignment(const Expression* expr, const Row& row,
+                                const std::vector<ColumnDef>& columns, const ColumnDef& column) {
+    if (dynamic_cast<const NumberLiteral*>(expr) || dynamic_cast<const StringLiteral*>(expr)) {
+        return expressionToValue(expr, column.type);
+    }
+
+    Value value = ExpressionEvaluator::evaluateValue(expr, row, columns);
+    Value converted;
+    if (value.isNull() || OrderedIndex::castKey(value, column.type, converted)) {
+        return value.isNull() ? value : converted;
+    }
+    if (column.type == DataType::VARCHAR || column.type == DataType::TEXT) {
+        return Value(value.toString());
+    }
+    throw std::runtime_error("Incorrect value '" + value.toString() +
+                             "' for column '" + column.name + "'");
+}
+
+bool QueryCommandHandler::executeInsert(const InsertStatement* stmt,
+                                       Session& session,
+                                       ResponseCallback response_callback) {
+    LOG_DEBUG("Executing INSERT: " << stmt->toString());
+
+    Buffer response;
+
+    // 获取当前数据库
+    const std::string& db_name = session.getCurrentDatabase();
+    if (db_name.empty()) {
+        ErrPacket err_packet(1046, "3D000", "No database selected");
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // 获取数据库
+    auto& storage = StorageEngine::instance();
+    auto db = storage.getDatabase(db_name);
+    if (!db) {
+        ErrPacket err_packet(1049, "42000", "Unknown database '" + db_name + "'");
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // 获取表
+    const std::string& table_name = stmt->getTableName();
+    auto table = db->getTable(table_name);
+    if (!table) {
+        ErrPacket err_packet(1146, "42S02", "Table '" + db_name + "." + table_name + "' doesn't exist");
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // 每列的值在 VALUES 中的位置（-1 表示未提供，使用默认值或自增值）
+    // Position of each column's value inside VALUES (-1: not given, use the default or AUTO_INCREMENT)
+    const auto& columns = table->getColumns();
+    const auto& value_rows = stmt->getRows();
+    const auto& col_names = stmt->getColumns();
+    std::vector<int> positions(columns.size(), -1);
+    size_t value_count = columns.size();
+    if (!col_names.empty()) {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            auto it = std::find(col_names.begin(), col_names.end(), columns[i].name);
+            if (it != col_names.end()) {
+                positions[i] = static_cast<int>(std::distance(col_names.begin(), it));
+            }
+        }
+        value_count = col_names.size();
+    } else {
+        for (size_t i = 0; i < columns.size(); ++i) {
+            positions[i] = static_cast<int>(i);
+        }
+    }
+
+    // 准备行数据
+    std::vector<Row> rows;
+    rows.reserve(value_rows.size());
+    for (const auto& values : value_rows) {
+        // 验证列数匹配
+        if (values.size() != value_count) {
+            ErrPacket err_packet(1136, "21S01", "Column count doesn't match value count at row " +
+                                 std::to_string(rows.size() + 1));
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+
+        Row row;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            const auto& col_def = columns[i];
+            if (positions[i] >= 0) {
+                row.addValue(expressionToValue(values[positions[i]].get(), col_def.type));
+            } else if (!col_def.default_value.isNull()) {
+                row.addValue(col_def.default_value);
+            } else {
+                // 自增列稍后统一分配；其余列使用NULL
+                row.addValue(Value::Null());
+            }
+        }
+        rows.push_back(std::move(row));
+    }
+
+    // 自增列：未提供、NULL 或 0 时生成新值，一次原子 fetch_add 为整条语句预留连续区间；
+    // 显式给出的值推进计数器，之后生成的值不会与它重复
+    // AUTO_INCREMENT: a missing, NULL or 0 value is generated; one atomic fetch_add reserves
+    // a consecutive range for the whole statement. Explicit values advance the counter so
+    // later generated values never collide with them
+    int auto_column = table->getAutoIncrementIndex();
+    int64_t first_insert_id = 0;
+    if (auto_column >= 0) {
+        const ColumnDef& auto_def = columns[auto_column];
+        std::vector<size_t> generate;
+        for (size_t r = 0; r < rows.size(); ++r) {
+            const Value& value = rows[r].getValue(auto_column);
+            int64_t explicit_value = value.isInt() ? value.asInt() : value.isBigInt() ? value.asBigInt() : 0;
+            if (explicit_value == 0) {
+                generate.push_back(r);
+            } else {
+                table->observeAutoIncrementValue(explicit_value);
+            }
+        }
+
+        if (!generate.empty()) {
+            first_insert_id = table->reserveAutoIncrement(generate.size());
+            int64_t last = first_insert_id + static_cast<int64_t>(generate.size()) - 1;
+            if (auto_def.type != DataType::BIGINT && last > std::numeric_limits<int32_t>::max()) {
+                ErrPacket err_packet(1467, "HY000",
+                    "Failed to read auto-increment value from storage engine");
+                err_packet.encode(response, session.nextSequenceId());
+                response_callback(response);
+                return true;
+            }
+            for (size_t i = 0; i < generate.size(); ++i) {
+                int64_t id = first_insert_id + static_cast<int64_t>(i);
+                rows[generate[i]].setValue(auto_column, auto_def.type == DataType::BIGINT
+                    ? Value(id) : Value(static_cast<int32_t>(id)));
+            }
+        }
+    }
+
+    // ON DUPLICATE KEY UPDATE：赋值表达式基于“旧行 + VALUES(col)”求值，先解析目标列
+    // ON DUPLICATE KEY UPDATE: assignments are evaluated against the old row extended
+    // with VALUES(col) for the inserted values; resolve the targets up front
+    const auto& duplicate_assignments = stmt->getDuplicateAssignments();
+    std::vector<ColumnDef> extended_columns;
+    std::vector<size_t> targets;
+    if (!duplicate_assignments.empty()) {
+        extended_columns = columns;
+        for (const auto& col_def : columns) {
+            extended_columns.emplace_back("VALUES(" + col_def.name + ")", col_def.type);
+        }
+        for (const auto& assignment : duplicate_assignments) {
+            int index = table->getColumnIndex(assignment.column);
+            if (index < 0) {
+                ErrPacket err_packet(1054, "42S22",
+                    "Unknown column '" + assignment.column + "' in 'field list'");
+                err_packet.encode(response, session.nextSequenceId());
+                response_callback(response);
+                return true;
+            }
+            if (!checkColumns(assignment.value.get(), extended_columns, "field list", response,
+                              session, response_callback)) {
+                return true;
+            }
+            targets.push_back(static_cast<size_t>(index));
+        }
+    }
+
+    // 插入行：单行的自动提交插入走乐观快速路径，在表锁内完成唯一约束检查后直接写入
+    // 已提交版本，不经过事务管理器登记和二次打戳；显式事务和多行插入的新版本带事务标记，
+    // 提交后可见，语句失败时整条回滚
+    // Insert: a single-row autocommit insert takes the optimistic fast path, checking the
+    // unique keys and writing a committed version directly under the table lock, with no
+    // transaction bookkeeping and no second stamping pass; explicit transactions and
+    // multi-row inserts write versions carrying the transaction marker, visible on commit
+    // and rolled back as a whole when the statement fails
+    std::optional<StatementTransaction> txn;
+    if (session.inTransaction() || rows.size() > 1) {
+        txn.emplace(session);
+    }
+    uint64_t marker = txn ? txn->get().getMarker() : 0;
+    ReadView view = txn ? txn->getReadView() : ReadView{TransactionManager::instance().now(), 0};
+    std::unique_lock<std::shared_mutex> table_lock(table->getLock());
+
+    uint64_t affected = 0;
+    uint16_t warnings = 0;
+    bool updated = false;
+    for (const Row& row : rows) {
+        // 唯一约束检查：主键和 UNIQUE 列的哈希索引探测，不扫描表
+        // Unique check: probe the primary key / UNIQUE hash indexes instead of scanning
+        Table::UniqueConflict conflict = table->findUniqueConflict(row, marker);
+        if (conflict.row_id < 0) {
+            uint64_t begin_ts = txn ? marker : TransactionManager::instance().allocateTimestamp();
+            if (!table->insertRow(row, begin_ts)) {
+                ErrPacket err_packet(1062, "23000", "Failed to insert row");
+                err_packet.encode(response, session.nextSequenceId());
+                response_callback(response);
+                return true;
+            }
+            if (txn) {
+                txn->get().recordWrite(table, table->getRows().size() - 1);
+            }
+            affected++;
+            continue;
+        }
+
+        size_t conflict_id = static_cast<size_t>(conflict.row_id);
+        const RowVersion& version = table->getRowVersion(conflict_id);
+        if ((mvcc::isUncommitted(version.begin_ts) && version.begin_ts != marker) ||
+            mvcc::isUncommitted(version.end_ts)) {
+            // 其他事务插入或删除了相同键的行、尚未提交
+            ErrPacket err_packet(1020, "HY000",
+                "Record has changed since last read in table '" + table_name + "'");
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+
+        if (stmt->isIgnore()) {
+            // INSERT IGNORE：跳过该行，记一个警告
+            warnings++;
+            continue;
+        }
+
+        if (duplicate_assignments.empty()) {
+            ErrPacket err_packet(1062, "23000",
+                "Duplicate entry '" + row.getValue(conflict.column).toString() +
+                "' for key '" + conflict.key_name + "'");
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+
+        // 冲突行在快照之后才提交：更新它会覆盖本事务看不到的写入
+        // The conflicting row was committed after our snapshot: updating it would
+        // overwrite a write this transaction cannot see
+        if (!view.sees(version)) {
+            ErrPacket err_packet(1020, "HY000",
+                "Record has changed since last read in table '" + table_name + "'");
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+
+        const Row& old_row = table->getRows()[conflict_id];
+        Row extended_row = old_row;
+        for (const auto& value : row.getValues()) {
+            extended_row.addValue(value);
+        }
+        Row new_row = old_row;
+        try {
+            for (size_t i = 0; i < targets.size(); ++i) {
+                new_row.setValue(targets[i], evaluateAssignment(
+                    duplicate_assignments[i].value.get(), extended_row, extended_columns,
+                    columns[targets[i]]));
+            }
+        } catch (const std::exception& e) {
+            ErrPacket err_packet(1064, "42000",
+                "Error evaluating UPDATE: " + std::string(e.what()));
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+
+        for (size_t target : targets) {
+            if (columns[target].not_null && new_row.getValue(target).isNull()) {
+                ErrPacket err_packet(1048, "23000",
+                    "Column '" + columns[target].name + "' cannot be null");
+                err_packet.encode(response, session.nextSequenceId());
+                response_callback(response);
+                return true;
+            }
+        }
+
+        // 与 MySQL 一致：行被更新时计 2 个 affected_rows，值未变化时不计
+        // As in MySQL: an updated row counts 2 affected rows, an unchanged one counts none
+        if (new_row.getValues() == old_row.getValues()) {
+            continue;
+        }
+        Table::UniqueConflict update_conflict =
+            table->findUniqueConflict(new_row, marker, conflict.row_id);
+        if (update_conflict.row_id >= 0) {
+            ErrPacket err_packet(1062, "23000",
+                "Duplicate entry '" + new_row.getValue(update_conflict.column).toString() +
+                "' for key '" + update_conflict.key_name + "'");
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+
+        uint64_t ts = txn ? marker : TransactionManager::instance().allocateTimestamp();
+        table->updateRow(conflict_id, new_row, ts);
+        if (txn) {
+            txn->get().recordWrite(table, conflict_id);
+            txn->get().recordWrite(table, table->getRows().size() - 1);
+        }
+        affected += 2;
+        updated = true;
+    }
+    table_lock.unlock();
+    if (txn) {
+        txn->commit();
+    }
+
+    LOG_DEBUG("Inserted " << rows.size() << " rows into table: " << table_name);
+    if (updated) {
+        Compactor::instance().notify();
+    }
+
+    // last_insert_id 为本语句生成的第一个自增值
+    OkPacket ok_packet(affected, static_cast<uint64_t>(first_insert_id),
+                       session.getServerStatus(), warnings);
+    ok_packet.encode(response, session.nextSequenceId());
+    response_callback(response);
+    return true;
+}
+
+bool QueryCommandHandler::executeUpdate(const UpdateStatement* stmt,
+                                       Session& session,
+                                       ResponseCallback response_callback) {
+    LOG_DEBUG("Executing UPDATE: " << stmt->toString());
+
+    Buffer response;
+
+    // 获取当前数据库
+    const std::string& db_name = session.getCurrentDatabase();
+    if (db_name.empty()) {
+        ErrPacket err_packet(1046, "3D000", "No database selected");
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // 获取数据库
+    auto& storage = StorageEngine::instance();
+    auto db = storage.getDatabase(db_name);
+    if (!db) {
+        ErrPacket err_packet(1049, "42000", "Unknown database '" + db_name + "'");
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // 获取表
+    const std::string& table_name = stmt->getTableName();
+    auto table = db->getTable(table_name);
+    if (!table) {
+        ErrPacket err_packet(1146, "42S02", "Table '" + db_name + "." + table_name + "' doesn't exist");
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // 解析赋值的目标列并检查表达式引用的列
+    // Resolve assignment targets and check the columns referenced by the expressions
+    const auto& columns = table->getColumns();
+    std::vector<size_t> targets;
+    for (const auto& assignment : stmt->getAssignments()) {
+        int index = table->getColumnIndex(assignment.column);
+        if (index < 0) {
+            ErrPacket err_packet(1054, "42S22",
+                "Unknown column '" + assignment.column + "' in 'field list'");
+            err_packet.encode(response, session.nextSequenceId());
+            response_callback(response);
+            return true;
+        }
+        if (!checkColumns(assignment.value.get(), columns, "field list", response, session,
+                          response_callback)) {
+            return true;
+        }
+        targets.push_back(static_cast<size_t>(index));
+    }
+
+    if (!checkColumns(stmt->getWhereClause(), columns, "where clause", response, session,
+                      response_callback)) {
+        return true;
+    }
+
+    StatementTransaction txn(session);
+    std::unique_lock<std::shared_mutex> table_lock(table->getLock());
+
+    // 先收集匹配行及其新值，再统一写回：新行追加在表尾，边扫描边写会再次读到
+    // Collect matching rows and their new values first, then apply: new rows are appended
+    // at the end of the table and would be scanned again otherwise
+    std::vector<std::pair<size_t, Row>> updates;
+    size_t matched = 0;
+    bool conflict = false;
+    try {
+        auto conditions = CostModel::splitConjuncts(stmt->getWhereClause());
+        AccessPath access_path;
+        {
+            PhaseTimer plan_timer(session.getStats().plan_ns);
+            access_path = CostModel::chooseAccessPath(*table, conditions);
+        }
+        const auto& rows = table->getRows();
+        access_path.forEachRowId(*table, txn.getReadView(), true, [&](size_t row_id) {
+            const Row& row = rows[row_id];
+            for (const Expression* condition : conditions) {
+                if (!ExpressionEvaluator::evaluate(condition, row, columns)) {
+                    return true;
+                }
+            }
+            matched++;
+
+            // 快照可见的版本已被其他事务删除或更新（先更新者胜）
+            // The visible version was already ended by another transaction (first updater wins)
+            if (table->getRowVersion(row_id).end_ts != mvcc::kInfinity) {
+                conflict = true;
+                return false;
+            }
+
+            // 所有赋值都基于旧行求值
+            // Every assignment is evaluated against the old row
+            Row new_row = row;
+            for (size_t i = 0; i < targets.size(); ++i) {
+                new_row.setValue(targets[i], evaluateAssignment(
+                    stmt->getAssignments()[i].value.get(), row, columns, columns[targets[i]]));
+            }
+            if (new_row.getValues() != row.getValues()) {
+                updates.emplace_back(row_id, std::move(new_row));
+            }
+            return true;
+        });
+    } catch (const std::exception& e) {
+        ErrPacket err_packet(1064, "42000",
+            "Error evaluating UPDATE: " + std::string(e.what()));
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    if (conflict) {
+        ErrPacket err_packet(1020, "HY000",
+            "Record has changed since last read in table '" + table_name + "'");
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // NOT NULL 约束在写回前统一检查，保证语句要么全部生效要么不生效
+    // Check NOT NULL before applying anything so the statement is all-or-nothing
+    for (const auto& update : updates) {
+        for (size_t target : targets) {
+            if (columns[target].not_null && update.second.getValue(target).isNull()) {
+                ErrPacket err_packet(1048, "23000",
+                    "Column '" + columns[target].name + "' cannot be null");
                 err_packet.encode(response, session.nextSequenceId());
                 response_callback(response);
                 return true;
             }
-
-            result_columns.push_back(table->getColumns()[col_idx]);
-            column_indices.push_back(col_idx);
         }
     }
 
-    // 4. 使用WHERE子句过滤行
-    // Filter rows with WHERE clause
-    std::vector<Row> filtered_rows;
-    const Expression* where_clause = stmt->getWhereClause();
-
-    for (const auto& row : table->getRows()) {
-        bool matches = true;
-
-        if (where_clause) {
-            try {
-                matches = ExpressionEvaluator::evaluate(
-                    where_clause, row, table->getColumns()
-                );
-            } catch (const std::exception& e) {
-                ErrPacket err_packet(1064, "42000",
-                    "Error evaluating WHERE clause: " + std::string(e.what()));
+    // 唯一约束：新值不能与表中其他行（被替换的旧版本除外）或本语句的其他新行重复
+    // Unique keys: a new value must not collide with another row (except the version it
+    // replaces) or with another new row of this statement
+    uint64_t marker = txn.get().getMarker();
+    if (table->hasUniqueKeys()) {
+        std::set<std::pair<size_t, Value>> new_keys;
+        for (const auto& update : updates) {
+            Table::UniqueConflict unique_conflict =
+                table->findUniqueConflict(update.second, marker, static_cast<int64_t>(update.first));
+            if (unique_conflict.row_id >= 0) {
+                const RowVersion& version =
+                    table->getRowVersion(static_cast<size_t>(unique_conflict.row_id));
+                if ((mvcc::isUncommitted(version.begin_ts) && version.begin_ts != marker) ||
+                    mvcc::isUncommitted(version.end_ts)) {
+                    ErrPacket err_packet(1020, "HY000",
+                        "Record has changed since last read in table '" + table_name + "'");
+                    err_packet.encode(response, session.nextSequenceId());
+                    response_callback(response);
+                    return true;
+                }
+            } else {
+                const Row& old_row = table->getRows()[update.first];
+                for (const auto& unique_key : table->getUniqueKeys()) {
+                    const Value& key = update.second.getValue(unique_key.column);
+                    if (key.isNull() || key == old_row.getValue(unique_key.column)) {
+                        continue;
+                    }
+                    if (!new_keys.insert({unique_key.column, key}).second) {
+                        unique_conflict.row_id = static_cast<int64_t>(update.first);
+                        unique_conflict.column = unique_key.column;
+                        unique_conflict.key_name = unique_key.name;
+                        break;
+                    }
+                }
+            }
+            if (unique_conflict.row_id >= 0) {
+                ErrPacket err_packet(1062, "23000",
+                    "Duplicate entry '" + update.second.getValue(unique_conflict.column).toString() +
+                    "' for key '" + unique_conflict.key_name + "'");
                 err_packet.encode(response, session.nextSequenceId());
                 response_callback(response);
                 return true;
             }
         }
-
-        if (matches) {
-            filtered_rows.push_back(row);
-        }
-    }
-
-    // 5. 应用LIMIT和OFFSET
-    // Apply LIMIT and OFFSET
-    size_t offset = stmt->getOffset();
-    int limit = stmt->getLimit();
-
-    if (offset >= filtered_rows.size()) {
-        filtered_rows.clear();
-    } else {
-        if (offset > 0) {
-            filtered_rows.erase(filtered_rows.begin(),
-                              filtered_rows.begin() + offset);
-        }
-
-        if (limit >= 0 && static_cast<size_t>(limit) < filtered_rows.size()) {
-            filtered_rows.resize(limit);
-        }
     }
 
-    LOG_INFO("SELECT result: " << filtered_rows.size() << " rows matched");
-
-    // 6. 发送结果集
-    // Send result set
-
-    // 6a. 列数包
-    // Column count packet
-    Buffer col_count_buffer;
-    col_count_buffer.writeLenencInt(result_columns.size());
-
-    // 写入列数包的头部
-    // Write column count packet header
-    uint32_t col_count_len = static_cast<uint32_t>(col_count_buffer.readableBytes());
-    // Payload length (3 bytes, little-endian)
-    response.writeUint8(col_count_len & 0xFF);
-    response.writeUint8((col_count_len >> 8) & 0xFF);
-    response.writeUint8((col_count_len >> 16) & 0xFF);
-    response.writeUint8(session.nextSequenceId());  // sequence id
-    response.append(col_count_buffer.peek(), col_count_buffer.readableBytes());
-
-    // 6b. 列定义包
-    // Column definition packets
-    for (const auto& col : result_columns) {
-        ColumnDefinitionPacket col_def =
-            ColumnDefinitionPacket::fromColumnDef(col, table_name, db_name);
-        col_def.encode(response, session.nextSequenceId());
+    for (const auto& update : updates) {
+        table->updateRow(update.first, update.second, marker);
+        txn.get().recordWrite(table, update.first);
+        txn.get().recordWrite(table, table->getRows().size() - 1);
     }
+    table_lock.unlock();
+    txn.commit();
 
-    // 6c. 列定义后的EOF包
-    // EOF packet after column definitions
-    EofPacket eof1(0, ServerStatus::SERVER_STATUS_AUTOCOMMIT);
-    eof1.encode(response, session.nextSequenceId());
-
-    // 6d. 行数据包
-    // Row data packets
-    for (const auto& row : filtered_rows) {
-        // 投影选定的列
-        // Project only selected columns
-        Row projected_row;
-        for (size_t idx : column_indices) {
-            projected_row.addValue(row.getValue(idx));
-        }
-
-        TextResultRowPacket row_packet(projected_row);
-        row_packet.encode(response, session.nextSequenceId());
+    LOG_DEBUG("Updated " << updates.size() << " rows in table: " << table_name);
+    if (!updates.empty()) {
+        Compactor::instance().notify();
     }
 
-    // 6e. 最终EOF包
-    // Final EOF packet
-    EofPacket eof2(0, ServerStatus::SERVER_STATUS_AUTOCOMMIT);
-    eof2.encode(response, session.nextSequenceId());
-
-    // 发送响应
-    // Send response
+    std::string info = "Rows matched: " + std::to_string(matched) +
+                       "  Changed: " + std::to_string(updates.size()) + "  Warnings: 0";
+    OkPacket ok_packet(updates.size(), 0, session.getServerStatus(), 0, info);
+    ok_packet.encode(response, session.nextSequenceId());
     response_callback(response);
     return true;
 }
 
-bool QueryCommandHandler::executeInsert(const InsertStatement* stmt,
+bool QueryCommandHandler::executeDelete(const DeleteStatement* stmt,
                                        Session& session,
                                        ResponseCallback response_callback) {
-    LOG_INFO("Executing INSERT: " << stmt->toString());
+    LOG_DEBUG("Executing DELETE: " << stmt->toString());
 
     Buffer response;
 
@@ -408,76 +1973,69 @@ bool QueryCommandHandler::executeInsert(const InsertStatement* stmt,
         return true;
     }
 
-    // 准备行数据
-    Row row;
-    const auto& columns = table->getColumns();
-    const auto& values = stmt->getValues();
-
-    // 如果指定了列名，按列名插入
-    if (!stmt->getColumns().empty()) {
-        const auto& col_names = stmt->getColumns();
+    if (!checkColumns(stmt->getWhereClause(), table->getColumns(), "where clause", response,
+                      session, response_callback)) {
+        return true;
+    }
 
-        // 验证列数匹配
-        if (col_names.size() != values.size()) {
-            ErrPacket err_packet(1136, "21S01", "Column count doesn't match value count");
-            err_packet.encode(response, session.nextSequenceId());
-            response_callback(response);
-            return true;
+    StatementTransaction txn(session);
+    std::unique_lock<std::shared_mutex> table_lock(table->getLock());
+
+    // 收集匹配的行号后再结束这些版本
+    // Collect the matching row ids, then end those versions
+    std::vector<size_t> row_ids;
+    bool conflict = false;
+    try {
+        auto conditions = CostModel::splitConjuncts(stmt->getWhereClause());
+        AccessPath access_path;
+        {
+            PhaseTimer plan_timer(session.getStats().plan_ns);
+            access_path = CostModel::chooseAccessPath(*table, conditions);
         }
-
-        // 为每一列准备值（包括未指定的列）
-        for (size_t i = 0; i < columns.size(); ++i) {
-            const auto& col_def = columns[i];
-
-            // 查找该列在INSERT语句中的位置
-            auto it = std::find(col_names.begin(), col_names.end(), col_def.name);
-
-            if (it != col_names.end()) {
-                // 找到了，使用提供的值
-                size_t idx = std::distance(col_names.begin(), it);
-                Value val = expressionToValue(values[idx].get(), col_def.type);
-                row.addValue(val);
-            } else {
-                // 未提供，处理默认值或自增
-                if (col_def.auto_increment) {
-                    // 自增列
-                    row.addValue(Value(static_cast<int32_t>(table->getNextAutoIncrementValue())));
-                } else if (!col_def.default_value.isNull()) {
-                    // 使用默认值
-                    row.addValue(col_def.default_value);
-                } else {
-                    // 使用NULL
-                    row.addValue(Value::Null());
+        const auto& rows = table->getRows();
+        access_path.forEachRowId(*table, txn.getReadView(), true, [&](size_t row_id) {
+            for (const Expression* condition : conditions) {
+                if (!ExpressionEvaluator::evaluate(condition, rows[row_id], table->getColumns())) {
+                    return true;
                 }
             }
-        }
-    } else {
-        // 没有指定列名，按顺序插入所有列
-        if (values.size() != columns.size()) {
-            ErrPacket err_packet(1136, "21S01", "Column count doesn't match value count");
-            err_packet.encode(response, session.nextSequenceId());
-            response_callback(response);
+            if (table->getRowVersion(row_id).end_ts != mvcc::kInfinity) {
+                conflict = true;
+                return false;
+            }
+            row_ids.push_back(row_id);
             return true;
-        }
-
-        for (size_t i = 0; i < columns.size(); ++i) {
-            Value val = expressionToValue(values[i].get(), columns[i].type);
-            row.addValue(val);
-        }
+        });
+    } catch (const std::exception& e) {
+        ErrPacket err_packet(1064, "42000",
+            "Error evaluating WHERE clause: " + std::string(e.what()));
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
     }
 
-    // 插入行
-    if (!table->insertRow(row)) {
-        ErrPacket err_packet(1062, "23000", "Failed to insert row");
+    if (conflict) {
+        ErrPacket err_packet(1020, "HY000",
+            "Record has changed since last read in table '" + table_name + "'");
         err_packet.encode(response, session.nextSequenceId());
         response_callback(response);
         return true;
     }
 
-    LOG_INFO("Inserted row into table: " << table_name);
+    uint64_t marker = txn.get().getMarker();
+    for (size_t row_id : row_ids) {
+        table->deleteRow(row_id, marker);
+        txn.get().recordWrite(table, row_id);
+    }
+    table_lock.unlock();
+    txn.commit();
+
+    LOG_DEBUG("Deleted " << row_ids.size() << " rows from table: " << table_name);
+    if (!row_ids.empty()) {
+        Compactor::instance().notify();
+    }
 
-    // 返回成功，affected_rows=1
-    OkPacket ok_packet(0, 1, ServerStatus::SERVER_STATUS_AUTOCOMMIT, 0);
+    OkPacket ok_packet(row_ids.size(), 0, session.getServerStatus(), 0);
     ok_packet.encode(response, session.nextSequenceId());
     response_callback(response);
     return true;
@@ -529,6 +2087,7 @@ bool QueryCommandHandler::executeCreateTable(const CreateTableStatement* stmt,
         col_def.primary_key = ast_col.primary_key;
         col_def.not_null = ast_col.not_null;
         col_def.auto_increment = ast_col.auto_increment;
+        col_def.unique = ast_col.unique;
 
         if (!ast_col.default_value.empty()) {
             col_def.default_value = Value(ast_col.default_value);
@@ -548,7 +2107,7 @@ bool QueryCommandHandler::executeCreateTable(const CreateTableStatement* stmt,
     LOG_INFO("Created table: " << table_name << " in database: " << db_name);
 
     // 返回成功
-    OkPacket ok_packet(0, 0, ServerStatus::SERVER_STATUS_AUTOCOMMIT, 0);
+    OkPacket ok_packet(0, 0, session.getServerStatus(), 0);
     ok_packet.encode(response, session.nextSequenceId());
     response_callback(response);
     return true;
@@ -592,12 +2151,126 @@ bool QueryCommandHandler::executeDropTable(const DropTableStatement* stmt,
     LOG_INFO("Dropped table: " << table_name << " from database: " << db_name);
 
     // 返回成功
-    OkPacket ok_packet(0, 0, ServerStatus::SERVER_STATUS_AUTOCOMMIT, 0);
+    OkPacket ok_packet(0, 0, session.getServerStatus(), 0);
+    ok_packet.encode(response, session.nextSequenceId());
+    response_callback(response);
+    return true;
+}
+
+bool QueryCommandHandler::executeCreateIndex(const CreateIndexStatement* stmt,
+                                            Session& session,
+                                            ResponseCallback response_callback) {
+    LOG_INFO("Executing CREATE INDEX: " << stmt->toString());
+
+    Buffer response;
+
+    // 获取当前数据库
+    const std::string& db_name = session.getCurrentDatabase();
+    if (db_name.empty()) {
+        ErrPacket err_packet(1046, "3D000", "No database selected");
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // 获取表
+    auto& storage = StorageEngine::instance();
+    auto db = storage.getDatabase(db_name);
+    const std::string& table_name = stmt->getTableName();
+    auto table = db ? db->getTable(table_name) : nullptr;
+    if (!table) {
+        ErrPacket err_packet(1146, "42S02",
+            "Table '" + db_name + "." + table_name + "' doesn't exist");
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    int column = table->getColumnIndex(stmt->getColumnName());
+    if (column < 0) {
+        ErrPacket err_packet(1054, "42S22",
+            "Key column '" + stmt->getColumnName() + "' doesn't exist in table");
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // 创建索引（用已有行构建）
+    // Create the index, building it from the existing rows
+    std::unique_lock<std::shared_mutex> table_lock(table->getLock());
+    if (!table->createIndex(stmt->getIndexName(), static_cast<size_t>(column))) {
+        ErrPacket err_packet(1061, "42000", "Duplicate key name '" + stmt->getIndexName() + "'");
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    LOG_INFO("Created index " << stmt->getIndexName() << " on " << table_name
+             << " (" << stmt->getColumnName() << ")");
+
+    OkPacket ok_packet(0, 0, session.getServerStatus(), 0);
     ok_packet.encode(response, session.nextSequenceId());
     response_callback(response);
     return true;
 }
 
+bool QueryCommandHandler::executeAnalyzeTable(const AnalyzeTableStatement* stmt,
+                                             Session& session,
+                                             ResponseCallback response_callback) {
+    LOG_INFO("Executing ANALYZE TABLE: " << stmt->toString());
+
+    Buffer response;
+
+    // 获取当前数据库
+    const std::string& db_name = session.getCurrentDatabase();
+    if (db_name.empty()) {
+        ErrPacket err_packet(1046, "3D000", "No database selected");
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // 获取表
+    auto& storage = StorageEngine::instance();
+    auto db = storage.getDatabase(db_name);
+    const std::string& table_name = stmt->getTableName();
+    auto table = db ? db->getTable(table_name) : nullptr;
+    if (!table) {
+        ErrPacket err_packet(1146, "42S02",
+            "Table '" + db_name + "." + table_name + "' doesn't exist");
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // 收集统计信息（行数、NDV、最值、直方图）
+    // Collect statistics (row count, NDV, min/max, histograms)
+    {
+        std::unique_lock<std::shared_mutex> table_lock(table->getLock());
+        table->analyze(ReadView{TransactionManager::instance().now(), 0});
+    }
+    LOG_INFO("Analyzed table " << db_name << "." << table_name << ": "
+             << table->getStatistics().row_count << " rows");
+
+    // 与 MySQL 相同的结果集格式
+    // Same result set shape as MySQL
+    std::vector<ColumnDef> result_columns = {
+        ColumnDef("Table", DataType::VARCHAR),
+        ColumnDef("Op", DataType::VARCHAR),
+        ColumnDef("Msg_type", DataType::VARCHAR),
+        ColumnDef("Msg_text", DataType::VARCHAR)
+    };
+    std::vector<Row> rows;
+    rows.emplace_back(std::vector<Value>{
+        Value(db_name + "." + table_name), Value(std::string("analyze")),
+        Value(std::string("status")), Value(std::string("OK"))
+    });
+
+    encodeResultSet(response, result_columns, rows, nullptr, "", "", session);
+    response_callback(response);
+    return true;
+}
+
 bool QueryCommandHandler::executeShowTables(Session& session,
                                            ResponseCallback response_callback) {
     LOG_INFO("Executing SHOW TABLES");
@@ -618,7 +2291,7 @@ bool QueryCommandHandler::executeShowTables(Session& session,
     auto db = storage.getDatabase(db_name);
     if (!db) {
         // 数据库不存在，返回空结果
-        OkPacket ok_packet(0, 0, ServerStatus::SERVER_STATUS_AUTOCOMMIT, 0, "No tables in database");
+        OkPacket ok_packet(0, 0, session.getServerStatus(), 0, "No tables in database");
         ok_packet.encode(response, session.nextSequenceId());
         response_callback(response);
         return true;
@@ -638,7 +2311,7 @@ bool QueryCommandHandler::executeShowTables(Session& session,
         }
     }
 
-    OkPacket ok_packet(0, 0, ServerStatus::SERVER_STATUS_AUTOCOMMIT, 0, result);
+    OkPacket ok_packet(0, 0, session.getServerStatus(), 0, result);
     ok_packet.encode(response, session.nextSequenceId());
     response_callback(response);
     return true;
@@ -661,7 +2334,186 @@ bool QueryCommandHandler::executeShowDatabases(Session& session,
         result += db_names[i];
     }
 
-    OkPacket ok_packet(0, 0, ServerStatus::SERVER_STATUS_AUTOCOMMIT, 0, result);
+    OkPacket ok_packet(0, 0, session.getServerStatus(), 0, result);
+    ok_packet.encode(response, session.nextSequenceId());
+    response_callback(response);
+    return true;
+}
+
+// 辅助函数：SQL LIKE 匹配（% 任意串，_ 单个字符，不区分大小写）
+static bool likeMatch(const std::string& text, const std::string& pattern) {
+    size_t t = 0, p = 0;
+    size_t star_p = std::string::npos, star_t = 0;
+    auto lower = [](char c) { return std::tolower(static_cast<unsigned char>(c)); };
+    while (t < text.size()) {
+        if (p < pattern.size() && (pattern[p] == '_' || lower(pattern[p]) == lower(text[t]))) {
+            t++;
+            p++;
+        } else if (p < pattern.size() && pattern[p] == '%') {
+            star_p = p++;
+            star_t = t;
+        } else if (star_p != std::string::npos) {
+            p = star_p + 1;
+            t = ++star_t;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '%') {
+        p++;
+    }
+    return p == pattern.size();
+}
+
+bool QueryCommandHandler::executeShowStatus(const ShowStatusStatement* stmt,
+                                           Session& session,
+                                           ResponseCallback response_callback) {
+    LOG_DEBUG("Executing " << stmt->toString());
+
+    std::vector<ColumnDef> result_columns = {
+        ColumnDef("Variable_name", DataType::VARCHAR),
+        ColumnDef("Value", DataType::VARCHAR),
+    };
+
+    std::vector<Row> rows;
+    for (const auto& var : MetricsRegistry::instance().statusVariables()) {
+        if (stmt->hasLikePattern() && !likeMatch(var.first, stmt->getLikePattern())) {
+            continue;
+        }
+        Row row;
+        row.addValue(Value(var.first));
+        row.addValue(Value(var.second));
+        rows.push_back(std::move(row));
+    }
+
+    Buffer response;
+    encodeResultSet(response, result_columns, rows, nullptr, "", "", session);
+    response_callback(response);
+    return true;
+}
+
+bool QueryCommandHandler::executeShowQueryDigests(const ShowQueryDigestsStatement* stmt,
+                                                 Session& session,
+                                                 ResponseCallback response_callback) {
+    LOG_DEBUG("Executing " << stmt->toString());
+
+    std::vector<ColumnDef> result_columns = {
+        ColumnDef("Digest", DataType::VARCHAR),
+        ColumnDef("Fingerprint", DataType::VARCHAR),
+        ColumnDef("Exec_count", DataType::BIGINT),
+        ColumnDef("Total_time", DataType::VARCHAR),
+        ColumnDef("Avg_time", DataType::VARCHAR),
+        ColumnDef("Max_time", DataType::VARCHAR),
+        ColumnDef("Rows_scanned", DataType::BIGINT),
+        ColumnDef("Rows_returned", DataType::BIGINT),
+        ColumnDef("Bytes_sent", DataType::BIGINT),
+        ColumnDef("Max_peak_memory", DataType::BIGINT),
+        ColumnDef("Sample_query", DataType::VARCHAR),
+    };
+
+    // 时间以秒为单位，保留微秒精度
+    auto seconds = [](double ns) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.6f", ns / 1e9);
+        return std::string(buf);
+    };
+
+    size_t limit = stmt->getLimit() >= 0 ? static_cast<size_t>(stmt->getLimit()) : SIZE_MAX;
+    std::vector<Row> rows;
+    for (const auto& digest : SlowQueryLog::instance().topDigests(limit)) {
+        char hex[20];
+        std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(digest.digest));
+
+        Row row;
+        row.addValue(Value(std::string(hex)));
+        row.addValue(Value(digest.fingerprint));
+        row.addValue(Value(static_cast<int64_t>(digest.count)));
+        row.addValue(Value(seconds(static_cast<double>(digest.total_ns))));
+        row.addValue(Value(seconds(static_cast<double>(digest.total_ns) / digest.count)));
+        row.addValue(Value(seconds(static_cast<double>(digest.max_ns))));
+        row.addValue(Value(static_cast<int64_t>(digest.rows_scanned)));
+        row.addValue(Value(static_cast<int64_t>(digest.rows_returned)));
+        row.addValue(Value(static_cast<int64_t>(digest.bytes_sent)));
+        row.addValue(Value(static_cast<int64_t>(digest.max_peak_memory)));
+        row.addValue(Value(digest.sample_query));
+        rows.push_back(std::move(row));
+    }
+
+    Buffer response;
+    encodeResultSet(response, result_columns, rows, nullptr, "", "", session);
+    response_callback(response);
+    return true;
+}
+
+bool QueryCommandHandler::executeShowProcesslist(const ShowProcesslistStatement* stmt,
+                                                Session& session,
+                                                ResponseCallback response_callback) {
+    LOG_DEBUG("Executing " << stmt->toString());
+
+    std::vector<ColumnDef> result_columns = {
+        ColumnDef("Id", DataType::BIGINT),
+        ColumnDef("User", DataType::VARCHAR),
+        ColumnDef("Host", DataType::VARCHAR),
+        ColumnDef("db", DataType::VARCHAR),
+        ColumnDef("Command", DataType::VARCHAR),
+        ColumnDef("Time", DataType::BIGINT),
+        ColumnDef("State", DataType::VARCHAR),
+        ColumnDef("Info", DataType::VARCHAR),
+    };
+
+    // 与 MySQL 一致：不带 FULL 时 Info 只显示前100个字符
+    constexpr size_t kInfoPrefix = 100;
+    auto text_or_null = [](std::string text) {
+        return text.empty() ? Value::Null() : Value(std::move(text));
+    };
+
+    std::vector<Row> rows;
+    for (auto& process : ProcessList::instance().snapshot()) {
+        if (!stmt->isFull() && process.info.size() > kInfoPrefix) {
+            process.info.resize(kInfoPrefix);
+        }
+        Row row;
+        row.addValue(Value(static_cast<int64_t>(process.id)));
+        row.addValue(Value(process.user));
+        row.addValue(Value(process.host));
+        row.addValue(text_or_null(std::move(process.db)));
+        row.addValue(Value(process.command));
+        row.addValue(Value(static_cast<int64_t>(process.time)));
+        row.addValue(Value(process.state));
+        row.addValue(text_or_null(std::move(process.info)));
+        rows.push_back(std::move(row));
+    }
+
+    Buffer response;
+    encodeResultSet(response, result_columns, rows, nullptr, "", "", session);
+    response_callback(response);
+    return true;
+}
+
+bool QueryCommandHandler::executeKill(const KillStatement* stmt,
+                                     Session& session,
+                                     ResponseCallback response_callback) {
+    LOG_INFO("Executing " << stmt->toString());
+
+    uint32_t id = stmt->getConnectionId();
+    auto result = ProcessList::instance().kill(id, stmt->isQueryOnly());
+    if (result == ProcessList::KillResult::NOT_FOUND) {
+        Buffer response;
+        ErrPacket err_packet(1094, "HY000", "Unknown thread id: " + std::to_string(id));
+        err_packet.encode(response, session.nextSequenceId());
+        response_callback(response);
+        return true;
+    }
+
+    // 空闲的其他连接立即关闭；正在执行的连接在检查点中断后由连接自己关闭，
+    // 杀死自己的连接在回复OK之后关闭（见 ProtocolHandler::handleCommand）
+    if (!stmt->isQueryOnly() && result == ProcessList::KillResult::IDLE &&
+        id != session.getConnectionId()) {
+        ProcessList::instance().closeConnection(id);
+    }
+
+    Buffer response;
+    OkPacket ok_packet(0, 0, session.getServerStatus(), 0);
     ok_packet.encode(response, session.nextSequenceId());
     response_callback(response);
     return true;
@@ -677,7 +2529,40 @@ bool QueryCommandHandler::executeUseDatabase(const UseDatabaseStatement* stmt,
 
     Buffer response;
     std::string result = "Database changed to: " + stmt->getDatabaseName();
-    OkPacket ok_packet(0, 0, ServerStatus::SERVER_STATUS_AUTOCOMMIT, 0, result);
+    OkPacket ok_packet(0, 0, session.getServerStatus(), 0, result);
+    ok_packet.encode(response, session.nextSequenceId());
+    response_callback(response);
+    return true;
+}
+
+bool QueryCommandHandler::executeTransaction(const TransactionStatement* stmt,
+                                            Session& session,
+                                            ResponseCallback response_callback) {
+    LOG_INFO("Executing " << stmt->toString() << " for session: " << session.getConnectionId());
+
+    auto& manager = TransactionManager::instance();
+    std::shared_ptr<Transaction> txn = session.getTransaction();
+
+    // BEGIN 隐式提交当前事务；没有事务时 COMMIT/ROLLBACK 不做任何事
+    // BEGIN implicitly commits the open transaction; COMMIT/ROLLBACK without one is a no-op
+    if (txn) {
+        if (stmt->getKind() == TransactionStatement::Kind::ROLLBACK) {
+            manager.rollback(*txn);
+        } else {
+            manager.commit(*txn);
+        }
+        session.setTransaction(nullptr);
+        if (!txn->getWrites().empty()) {
+            Compactor::instance().notify();
+        }
+    }
+
+    if (stmt->getKind() == TransactionStatement::Kind::BEGIN) {
+        session.setTransaction(manager.begin(true));
+    }
+
+    Buffer response;
+    OkPacket ok_packet(0, 0, session.getServerStatus(), 0);
     ok_packet.encode(response, session.nextSequenceId());
     response_callback(response);
     return true;
@@ -700,7 +2585,7 @@ bool InitDbCommandHandler::handleCommand(MySQLCommand command,
 
     // 返回OK包
     Buffer response;
-    OkPacket ok_packet(0, 0, ServerStatus::SERVER_STATUS_AUTOCOMMIT, 0);
+    OkPacket ok_packet(0, 0, session.getServerStatus(), 0);
     ok_packet.encode(response, session.nextSequenceId());
 
     response_callback(response);
@@ -716,9 +2601,123 @@ CommandDispatcher::CommandDispatcher()
     , init_db_handler_(std::make_unique<InitDbCommandHandler>())
 {}
 
+// 辅助函数：把一条语句的各阶段耗时记入直方图
+// 执行时间为总耗时减去解析、计划、编码和网络写的时间；没有经历的阶段不记录
+static void recordStatementTimings(const StatementStats& stats, uint64_t total_ns) {
+    auto& metrics = ServerMetrics::instance();
+    uint64_t accounted = stats.parse_ns + stats.plan_ns + stats.encode_ns + stats.network_ns;
+
+    metrics.parse_time.record(stats.parse_ns);
+    if (stats.plan_ns > 0) {
+        metrics.plan_time.record(stats.plan_ns);
+    }
+    if (stats.encode_ns > 0) {
+        metrics.encode_time.record(stats.encode_ns);
+    }
+    metrics.execute_time.record(total_ns > accounted ? total_ns - accounted : 0);
+}
+
+// 辅助函数：执行一条 COM_QUERY 并统计其资源用量，结束后记入直方图、语句摘要和慢查询日志
+static bool executeAccountedQuery(CommandHandler& handler, Buffer& buffer, Session& session,
+                                  CommandHandler::ResponseCallback response_callback,
+                                  const CommandHandler::FlushCallback& flush_callback) {
+    QueryRecord record;
+    record.query.assign(reinterpret_cast<const char*>(buffer.peek()), buffer.readableBytes());
+    record.start_time = std::chrono::system_clock::now();
+
+    StatementStats& stats = session.getStats();
+    bool result = true;
+    {
+        CurrentStatementScope statement_scope(stats);
+        MemoryTracker statement_memory;
+        MemoryTrackerScope memory_scope(&statement_memory);
+        uint64_t start = metrics::nowNs();
+
+        // 语句的中断条件：会话的 KILL 标记和 max_execution_time
+        InterruptContext interrupt_context;
+        interrupt_context.kill_state = &session.getKillState();
+        uint32_t max_execution_time = Config::instance().max_execution_time;
+        if (max_execution_time > 0) {
+            interrupt_context.deadline_ns = start + uint64_t(max_execution_time) * 1000000;
+        }
+        InterruptScope interrupt_scope(&interrupt_context);
+
+        try {
+            result = handler.handleCommand(MySQLCommand::COM_QUERY, buffer, session, response_callback);
+        } catch (const QueryInterrupted& e) {
+            Buffer response;
+            if (e.getReason() == QueryInterrupted::Reason::TIMEOUT) {
+                LOG_WARN("Query exceeded max_execution_time on session " << session.getConnectionId());
+                ErrPacket err_packet(3024, "HY000",
+                    "Query execution was interrupted, maximum statement execution time exceeded");
+                err_packet.encode(response, session.nextSequenceId());
+            } else {
+                LOG_INFO("Query killed on session " << session.getConnectionId());
+                // KILL QUERY 只中断这一条语句
+                KillState expected = KillState::QUERY;
+                session.getKillState().compare_exchange_strong(expected, KillState::NONE,
+                                                               std::memory_order_relaxed);
+                ErrPacket err_packet(1317, "70100", "Query execution was interrupted");
+                err_packet.encode(response, session.nextSequenceId());
+            }
+            response_callback(response);
+        }
+        // 在语句计时内写出响应，网络写时间计入这条语句
+        if (flush_callback) {
+            flush_callback();
+        }
+        record.total_ns = metrics::nowNs() - start;
+        stats.peak_memory = statement_memory.peak();
+    }
+    recordStatementTimings(stats, record.total_ns);
+
+    // 去掉首尾空白后计算指纹
+    size_t begin = record.query.find_first_not_of(" \t\n\r");
+    size_t end = record.query.find_last_not_of(" \t\n\r;");
+    record.query = begin == std::string::npos ? "" : record.query.substr(begin, end - begin + 1);
+    record.fingerprint = fingerprintQuery(record.query);
+    record.digest = fingerprintHash(record.fingerprint);
+    record.connection_id = session.getConnectionId();
+    record.user = session.getUsername();
+    record.database = session.getCurrentDatabase();
+    record.stats = stats;
+    SlowQueryLog::instance().record(record);
+    return result;
+}
+
+// 辅助函数：SHOW PROCESSLIST 中显示的命令名
+static const char* commandName(MySQLCommand command) {
+    switch (command) {
+        case MySQLCommand::COM_QUIT: return "Quit";
+        case MySQLCommand::COM_INIT_DB: return "Init DB";
+        case MySQLCommand::COM_QUERY: return "Query";
+        case MySQLCommand::COM_PROCESS_INFO: return "Processlist";
+        case MySQLCommand::COM_PROCESS_KILL: return "Kill";
+        case MySQLCommand::COM_PING: return "Ping";
+        default: return "Command";
+    }
+}
+
+// RAII：命令执行期间在进程列表中显示为运行中
+class ProcessCommandScope {
+public:
+    ProcessCommandScope(Session& session, MySQLCommand command, std::string_view query)
+        : session_(session) {
+        ProcessList::instance().beginCommand(session_, commandName(command), query);
+    }
+    ~ProcessCommandScope() { ProcessList::instance().endCommand(session_); }
+
+    ProcessCommandScope(const ProcessCommandScope&) = delete;
+    ProcessCommandScope& operator=(const ProcessCommandScope&) = delete;
+
+private:
+    Session& session_;
+};
+
 bool CommandDispatcher::dispatch(Buffer& buffer,
                                 Session& session,
-                                CommandHandler::ResponseCallback response_callback) {
+                                CommandHandler::ResponseCallback response_callback,
+                                CommandHandler::FlushCallback flush_callback) {
     // 读取包头
     if (buffer.readableBytes() < 4) {
         LOG_ERROR("Insufficient data for packet header");
@@ -749,10 +2748,21 @@ bool CommandDispatcher::dispatch(Buffer& buffer,
 
     uint8_t cmd_byte = buffer.readUint8();
     MySQLCommand command = static_cast<MySQLCommand>(cmd_byte);
+    ServerMetrics::instance().questions.add();
+    session.getStats() = StatementStats();
 
     LOG_DEBUG("Dispatching command: " << static_cast<int>(cmd_byte)
               << " for session: " << session.getConnectionId());
 
+    std::string_view query;
+    if (command == MySQLCommand::COM_QUERY) {
+        query = std::string_view(reinterpret_cast<const char*>(buffer.peek()), payload_length - 1);
+    }
+    ProcessCommandScope process_scope(session, command, query);
+
+    // 语句内存池在命令结束时整体回收
+    QueryArenaScope arena_scope;
+
     // 分发到对应的处理器
     switch (command) {
         case MySQLCommand::COM_PING:
@@ -762,11 +2772,31 @@ bool CommandDispatcher::dispatch(Buffer& buffer,
             return quit_handler_->handleCommand(command, buffer, session, response_callback);
 
         case MySQLCommand::COM_QUERY:
-            return query_handler_->handleCommand(command, buffer, session, response_callback);
+            return executeAccountedQuery(*query_handler_, buffer, session, response_callback,
+                                         flush_callback);
 
         case MySQLCommand::COM_INIT_DB:
             return init_db_handler_->handleCommand(command, buffer, session, response_callback);
 
+        case MySQLCommand::COM_PROCESS_INFO: {
+            ShowProcesslistStatement stmt;
+            return query_handler_->executeShowProcesslist(&stmt, session, response_callback);
+        }
+
+        case MySQLCommand::COM_PROCESS_KILL: {
+            // payload：4字节连接ID（小端序）
+            if (payload_length < 5) {
+                Buffer response;
+                ErrPacket err_packet(1047, "08S01", "Malformed COM_PROCESS_KILL packet");
+                err_packet.encode(response, session.nextSequenceId());
+                response_callback(response);
+                return false;
+            }
+            uint32_t id = buffer.readUint32();
+            KillStatement stmt(id, false);
+            return query_handler_->executeKill(&stmt, session, response_callback);
+        }
+
         default:
             LOG_WARN("Unsupported command: " << static_cast<int>(cmd_byte));
             Buffer response;
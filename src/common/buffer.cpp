@@ -2,30 +2,94 @@
 #include <unistd.h>
 #include <sys/uio.h>
 #include <errno.h>
+#include <algorithm>
 
 namespace tiny_sql {
 
+namespace {
+
+// 每个线程一块 64KB 的读溢出区，代替每次 readFromFd 在栈上开 64KB
+constexpr size_t kReadScratchSize = 65536;
+
+uint8_t* readScratch() {
+    thread_local uint8_t scratch[kReadScratchSize];
+    return scratch;
+}
+
+} // namespace
+
+void Buffer::grow(size_t len) {
+    size_t required = write_index_ + len;
+    size_t capacity = std::max(required, data_.capacity() * 2);
+
+    std::vector<uint8_t> storage = BufferPool::acquire(capacity);
+    storage.assign(data_.begin(), data_.end());
+    BufferPool::release(std::move(data_));
+    data_ = std::move(storage);
+}
+
+void Buffer::shrink() {
+    size_t readable = readableBytes();
+    if (readable == 0) {
+        read_index_ = 0;
+        write_index_ = 0;
+        BufferPool::release(std::move(data_));
+        data_.clear();
+        return;
+    }
+
+    if (data_.capacity() > BufferPool::classSize(readable)) {
+        // 存储比未读数据大一级以上：换一块合适大小的
+        std::vector<uint8_t> storage = BufferPool::acquire(readable);
+        storage.assign(data_.begin() + read_index_, data_.begin() + write_index_);
+        BufferPool::release(std::move(data_));
+        data_ = std::move(storage);
+    } else if (read_index_ > 0) {
+        data_.erase(data_.begin(), data_.begin() + read_index_);
+    }
+    read_index_ = 0;
+    write_index_ = readable;
+}
+
 ssize_t Buffer::readFromFd(int fd) {
-    // 使用栈上的临时缓冲区,避免频繁扩容
-    char extrabuf[65536];
-    struct iovec vec[2];
+    // 数据已全部读完时回收空间，避免缓冲区无限增长
+    if (readableBytes() == 0) {
+        reset();
+    }
 
+    uint8_t* extrabuf = readScratch();
     size_t writable = writableBytes();
+
+    // 没有存储（空闲连接已把存储还给池）或已写满：先读到溢出区，再按实际长度取存储
+    if (writable == 0) {
+        ssize_t n = ::read(fd, extrabuf, kReadScratchSize);
+        if (n > 0) {
+            append(extrabuf, static_cast<size_t>(n));
+        }
+        return n;
+    }
+
+    struct iovec vec[2];
+
+    // 将剩余容量纳入 data_ 的有效范围，保证 size() 始终等于 write_index_
+    data_.resize(data_.capacity());
     vec[0].iov_base = beginWrite();
     vec[0].iov_len = writable;
     vec[1].iov_base = extrabuf;
-    vec[1].iov_len = sizeof(extrabuf);
+    vec[1].iov_len = kReadScratchSize;
 
-    const int iovcnt = (writable < sizeof(extrabuf)) ? 2 : 1;
+    const int iovcnt = (writable < kReadScratchSize) ? 2 : 1;
     ssize_t n = ::readv(fd, vec, iovcnt);
 
     if (n < 0) {
+        data_.resize(write_index_);
         return n;
     } else if (static_cast<size_t>(n) <= writable) {
         write_index_ += n;
+        data_.resize(write_index_);
     } else {
-        write_index_ = data_.capacity();
-        writeBytes(reinterpret_cast<const uint8_t*>(extrabuf), n - writable);
+        write_index_ = data_.size();
+        writeBytes(extrabuf, n - writable);
     }
 
     return n;
@@ -0,0 +1,70 @@
+#include "tiny_sql/common/buffer_chain.h"
+
+#include <sys/uio.h>
+#include <errno.h>
+
+namespace tiny_sql {
+
+void BufferChain::append(Buffer&& segment) {
+    size_t len = segment.readableBytes();
+    if (len == 0) {
+        return;
+    }
+    segments_.push_back(std::move(segment));
+    bytes_ += len;
+}
+
+void BufferChain::append(const uint8_t* data, size_t len) {
+    if (len == 0) {
+        return;
+    }
+    if (segments_.empty() || segments_.back().writableBytes() < len) {
+        segments_.emplace_back(len);
+    }
+    segments_.back().writeBytes(data, len);
+    bytes_ += len;
+}
+
+void BufferChain::clear() {
+    segments_.clear();
+    bytes_ = 0;
+}
+
+ssize_t BufferChain::writeToFd(int fd) {
+    if (segments_.empty()) {
+        return 0;
+    }
+
+    struct iovec vec[kMaxIovecs];
+    int iovcnt = 0;
+    for (const auto& segment : segments_) {
+        if (iovcnt == static_cast<int>(kMaxIovecs)) {
+            break;
+        }
+        vec[iovcnt].iov_base = const_cast<uint8_t*>(segment.peek());
+        vec[iovcnt].iov_len = segment.readableBytes();
+        ++iovcnt;
+    }
+
+    ssize_t n = ::writev(fd, vec, iovcnt);
+    if (n > 0) {
+        consume(static_cast<size_t>(n));
+    }
+    return n;
+}
+
+void BufferChain::consume(size_t n) {
+    bytes_ -= n;
+    while (n > 0) {
+        Buffer& front = segments_.front();
+        size_t readable = front.readableBytes();
+        if (n < readable) {
+            front.skip(n);
+            return;
+        }
+        n -= readable;
+        segments_.pop_front();
+    }
+}
+
+} // namespace tiny_sql
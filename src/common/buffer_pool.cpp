@@ -0,0 +1,132 @@
+#include "tiny_sql/common/buffer_pool.h"
+
+#include <algorithm>
+#include <array>
+
+namespace tiny_sql {
+
+namespace {
+
+// 级别 k 的容量为 kMinClassSize << k
+size_t classIndexFor(size_t min_capacity) {
+    size_t index = 0;
+    size_t size = BufferPool::kMinClassSize;
+    while (size < min_capacity) {
+        size <<= 1;
+        ++index;
+    }
+    return index;
+}
+
+struct PoolState {
+    std::array<std::vector<std::vector<uint8_t>>, BufferPool::kNumClasses> free_lists;
+    // 上次 trim 以来每级空闲链表的最短长度：这么多块在整个间隔内都没被用到
+    std::array<size_t, BufferPool::kNumClasses> low_water{};
+    size_t cached_bytes = 0;
+
+    PoolState();
+    ~PoolState();
+};
+
+// 线程退出时池可能先于其他线程局部对象析构，之后的取用和归还绕过池
+enum class PoolLifetime : uint8_t { UNINITIALIZED, ALIVE, DESTROYED };
+thread_local PoolLifetime t_pool_lifetime = PoolLifetime::UNINITIALIZED;
+
+PoolState::PoolState() {
+    t_pool_lifetime = PoolLifetime::ALIVE;
+}
+
+PoolState::~PoolState() {
+    t_pool_lifetime = PoolLifetime::DESTROYED;
+}
+
+// 已析构时返回 nullptr
+PoolState* pool() {
+    if (t_pool_lifetime == PoolLifetime::DESTROYED) {
+        return nullptr;
+    }
+    thread_local PoolState state;
+    return &state;
+}
+
+} // namespace
+
+size_t BufferPool::classSize(size_t min_capacity) {
+    if (min_capacity > kMaxClassSize) {
+        return min_capacity;
+    }
+    return kMinClassSize << classIndexFor(min_capacity);
+}
+
+std::vector<uint8_t> BufferPool::acquire(size_t min_capacity) {
+    std::vector<uint8_t> storage;
+    if (min_capacity > kMaxClassSize) {
+        storage.reserve(min_capacity);
+        return storage;
+    }
+
+    size_t index = classIndexFor(min_capacity);
+    PoolState* state = pool();
+    if (state && !state->free_lists[index].empty()) {
+        auto& free_list = state->free_lists[index];
+        storage = std::move(free_list.back());
+        free_list.pop_back();
+        state->cached_bytes -= storage.capacity();
+        state->low_water[index] = std::min(state->low_water[index], free_list.size());
+        return storage;
+    }
+
+    storage.reserve(kMinClassSize << index);
+    return storage;
+}
+
+void BufferPool::release(std::vector<uint8_t>&& storage) {
+    size_t capacity = storage.capacity();
+    if (capacity == 0) {
+        return;
+    }
+    // 大于最大级别两倍的存储归到最大级别会浪费太多，直接释放
+    PoolState* state = capacity >= kMinClassSize && capacity < 2 * kMaxClassSize ? pool() : nullptr;
+    if (!state || state->cached_bytes + capacity > kMaxCachedBytes) {
+        std::vector<uint8_t>().swap(storage);
+        return;
+    }
+
+    // 向下取整：容量不小于所在级别
+    size_t index = classIndexFor(capacity);
+    if ((kMinClassSize << index) > capacity) {
+        --index;
+    }
+
+    storage.clear();
+    state->cached_bytes += capacity;
+    state->free_lists[index].push_back(std::move(storage));
+}
+
+size_t BufferPool::trim() {
+    PoolState* state = pool();
+    if (!state) {
+        return 0;
+    }
+
+    size_t released = 0;
+    for (size_t index = 0; index < kNumClasses; ++index) {
+        auto& free_list = state->free_lists[index];
+        // 链表按后进先出使用，前面的块最久没被用过
+        size_t idle = std::min(state->low_water[index], free_list.size());
+        for (size_t i = 0; i < idle; ++i) {
+            released += free_list[i].capacity();
+        }
+        free_list.erase(free_list.begin(), free_list.begin() + static_cast<std::ptrdiff_t>(idle));
+        state->low_water[index] = free_list.size();
+    }
+    state->cached_bytes -= released;
+    return released;
+}
+
+size_t BufferPool::cachedBytes() {
+    PoolState* state = pool();
+    return state ? state->cached_bytes : 0;
+}
+
+} // namespace tiny_sql
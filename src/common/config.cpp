@@ -0,0 +1,149 @@
+#include "tiny_sql/common/config.h"
+#include "tiny_sql/common/logger.h"
+#include <cstdlib>
+
+namespace tiny_sql {
+
+// 辅助函数：解析带单位后缀的大小（如 64K, 8M, 1G）
+static bool parseSize(const std::string& value, size_t& out) {
+    if (value.empty()) {
+        return false;
+    }
+
+    char* end = nullptr;
+    unsigned long long number = std::strtoull(value.c_str(), &end, 10);
+    if (end == value.c_str()) {
+        return false;
+    }
+
+    std::string suffix(end);
+    if (suffix.empty()) {
+        out = number;
+    } else if (suffix == "K" || suffix == "k") {
+        out = number << 10;
+    } else if (suffix == "M" || suffix == "m") {
+        out = number << 20;
+    } else if (suffix == "G" || suffix == "g") {
+        out = number << 30;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool Config::parseArgs(int argc, char* argv[]) {
+    bool ok = true;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        // 兼容旧用法：第一个非选项参数为端口号
+        if (arg.rfind("--", 0) != 0) {
+            port = static_cast<uint16_t>(std::atoi(arg.c_str()));
+            continue;
+        }
+
+        size_t eq = arg.find('=');
+        std::string name = arg.substr(2, eq == std::string::npos ? std::string::npos : eq - 2);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+        if (!setOption(name, value)) {
+            LOG_ERROR("Invalid option: " << arg);
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+bool Config::setOption(const std::string& name, const std::string& value) {
+    if (name == "port") {
+        port = static_cast<uint16_t>(std::atoi(value.c_str()));
+        return port != 0;
+    }
+    if (name == "socket") {
+        socket = value;
+        return !socket.empty();
+    }
+    if (name == "sort-buffer-size") {
+        return parseSize(value, sort_buffer_size) && sort_buffer_size > 0;
+    }
+    if (name == "join-buffer-size") {
+        return parseSize(value, join_buffer_size) && join_buffer_size > 0;
+    }
+    if (name == "connect-timeout" || name == "wait-timeout" || name == "interactive-timeout") {
+        char* end = nullptr;
+        unsigned long seconds = std::strtoul(value.c_str(), &end, 10);
+        uint32_t& target = name == "connect-timeout" ? connect_timeout
+                         : name == "wait-timeout"    ? wait_timeout
+                                                     : interactive_timeout;
+        target = static_cast<uint32_t>(seconds);
+        return end != value.c_str() && *end == '\0' && seconds <= UINT32_MAX;
+    }
+    if (name == "protocol-compression-algorithms") {
+        // 只接受已知的算法名
+        size_t pos = 0;
+        while (pos < value.size()) {
+            size_t comma = value.find(',', pos);
+            std::string algorithm = value.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+            if (algorithm != "zlib" && algorithm != "zstd") {
+                return false;
+            }
+            pos = comma == std::string::npos ? value.size() : comma + 1;
+        }
+        protocol_compression_algorithms = value;
+        return true;
+    }
+    if (name == "compression-min-length") {
+        return parseSize(value, compression_min_length);
+    }
+    if (name == "net-output-high-water") {
+        return parseSize(value, net_output_high_water);
+    }
+    if (name == "max-output-memory") {
+        return parseSize(value, max_output_memory);
+    }
+    if (name == "compaction-dead-ratio") {
+        char* end = nullptr;
+        compaction_dead_ratio = std::strtod(value.c_str(), &end);
+        return end != value.c_str() && *end == '\0' &&
+               compaction_dead_ratio > 0.0 && compaction_dead_ratio <= 1.0;
+    }
+    if (name == "compaction-interval") {
+        compaction_interval_ms = static_cast<uint32_t>(std::atoi(value.c_str()));
+        return compaction_interval_ms > 0;
+    }
+    if (name == "admin-port") {
+        admin_port = static_cast<uint16_t>(std::atoi(value.c_str()));
+        return admin_port != 0;
+    }
+    if (name == "log-level") {
+        return parseLogLevel(value, log_level);
+    }
+    if (name == "log-file") {
+        log_file = value;
+        return true;
+    }
+    if (name == "slow-query-log-file") {
+        slow_query_log_file = value;
+        return !slow_query_log_file.empty();
+    }
+    if (name == "long-query-time") {
+        char* end = nullptr;
+        long_query_time = std::strtod(value.c_str(), &end);
+        return end != value.c_str() && *end == '\0' && long_query_time >= 0.0;
+    }
+    if (name == "max-execution-time") {
+        char* end = nullptr;
+        unsigned long ms = std::strtoul(value.c_str(), &end, 10);
+        max_execution_time = static_cast<uint32_t>(ms);
+        return end != value.c_str() && *end == '\0' && ms <= UINT32_MAX;
+    }
+    if (name == "tmpdir") {
+        tmpdir = value;
+        return !tmpdir.empty();
+    }
+    return false;
+}
+
+} // namespace tiny_sql
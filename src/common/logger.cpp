@@ -0,0 +1,283 @@
+#include "tiny_sql/common/logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace tiny_sql {
+
+namespace {
+
+// 写线程的刷出间隔；缓冲区过半或有 ERROR 以上的日志时提前唤醒
+constexpr auto kFlushInterval = std::chrono::milliseconds(100);
+
+const char* levelToString(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO:  return "INFO ";
+        case LogLevel::WARN:  return "WARN ";
+        case LogLevel::ERROR: return "ERROR";
+        case LogLevel::FATAL: return "FATAL";
+        default: return "UNKNOWN";
+    }
+}
+
+// 写满整个缓冲区（处理部分写入和 EINTR）
+void writeAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+}
+
+} // namespace
+
+/**
+ * 单生产者单消费者无锁环形缓冲区
+ * 生产者为所属线程，消费者为持有 drain_mutex_ 的写线程或 flush 调用者
+ * Single-producer single-consumer lock-free ring: the owning thread produces, whoever
+ * holds drain_mutex_ consumes
+ */
+class LogRing {
+public:
+    static constexpr size_t kCapacity = 4096;       // 2的幂
+
+    LogRing() : slots_(kCapacity) {}
+
+    // 生产者：写入一条记录，缓冲区满时返回false
+    bool push(LogRecord&& record, size_t& size) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size = tail - head_.load(std::memory_order_acquire);
+        if (size == kCapacity) {
+            return false;
+        }
+        slots_[tail & (kCapacity - 1)] = std::move(record);
+        tail_.store(tail + 1, std::memory_order_release);
+        size++;
+        return true;
+    }
+
+    // 消费者：取出当前所有记录
+    void drain(std::vector<LogRecord>& out) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            out.push_back(std::move(slots_[head & (kCapacity - 1)]));
+        }
+        head_.store(head, std::memory_order_release);
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    // 所属线程已退出，取空后可以回收
+    std::atomic<bool> closed{false};
+
+private:
+    std::vector<LogRecord> slots_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+bool parseLogLevel(const std::string& name, LogLevel& level) {
+    std::string lower;
+    for (char c : name) {
+        lower.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+    if (lower == "debug") level = LogLevel::DEBUG;
+    else if (lower == "info") level = LogLevel::INFO;
+    else if (lower == "warn" || lower == "warning") level = LogLevel::WARN;
+    else if (lower == "error") level = LogLevel::ERROR;
+    else if (lower == "fatal") level = LogLevel::FATAL;
+    else return false;
+    return true;
+}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : fd_(STDOUT_FILENO) {
+    thread_ = std::thread(&Logger::run, this);
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    drain();
+    if (owns_fd_) {
+        ::close(fd_);
+    }
+}
+
+bool Logger::setOutput(const std::string& path) {
+    int fd = STDOUT_FILENO;
+    if (!path.empty()) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+    }
+
+    // 先把已提交的日志写到旧的输出
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    drainLocked();
+    if (owns_fd_) {
+        ::close(fd_);
+    }
+    fd_ = fd;
+    owns_fd_ = !path.empty();
+    return true;
+}
+
+LogRing& Logger::localRing() {
+    // 线程退出时标记缓冲区关闭，由写线程取空后回收
+    struct Holder {
+        std::shared_ptr<LogRing> ring;
+        ~Holder() {
+            if (ring) {
+                ring->closed.store(true, std::memory_order_release);
+            }
+        }
+    };
+    thread_local Holder holder;
+
+    if (!holder.ring) {
+        holder.ring = std::make_shared<LogRing>();
+        std::lock_guard<std::mutex> lock(mutex_);
+        rings_.push_back(holder.ring);
+    }
+    return *holder.ring;
+}
+
+void Logger::log(LogLevel level, const char* file, int line, std::string message) {
+    LogRecord record;
+    record.time = std::chrono::system_clock::now();
+    record.level = level;
+    record.file = file;
+    record.line = line;
+    record.message = std::move(message);
+
+    size_t size = 0;
+    if (!localRing().push(std::move(record), size)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (level == LogLevel::FATAL) {
+        flush();
+    } else if (level >= LogLevel::ERROR || size == LogRing::kCapacity / 2) {
+        cv_.notify_one();
+    }
+}
+
+void Logger::flush() {
+    drain();
+}
+
+void Logger::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        cv_.wait_for(lock, kFlushInterval);
+        lock.unlock();
+        drain();
+        lock.lock();
+    }
+}
+
+void Logger::drain() {
+    std::lock_guard<std::mutex> lock(drain_mutex_);
+    drainLocked();
+}
+
+void Logger::drainLocked() {
+    std::vector<std::shared_ptr<LogRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 回收已退出线程的空缓冲区
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const auto& ring) {
+            return ring->closed.load(std::memory_order_acquire) && ring->empty();
+        }), rings_.end());
+        rings = rings_;
+    }
+
+    batch_.clear();
+    for (const auto& ring : rings) {
+        ring->drain(batch_);
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (batch_.empty() && dropped == reported_dropped_) {
+        return;
+    }
+
+    // 各线程的记录合并后按时间排序
+    std::stable_sort(batch_.begin(), batch_.end(), [](const LogRecord& a, const LogRecord& b) {
+        return a.time < b.time;
+    });
+
+    buffer_.clear();
+    for (const auto& record : batch_) {
+        format(record, buffer_);
+    }
+    if (dropped != reported_dropped_) {
+        LogRecord record;
+        record.time = std::chrono::system_clock::now();
+        record.level = LogLevel::WARN;
+        record.file = __FILE__;
+        record.line = __LINE__;
+        record.message = std::to_string(dropped - reported_dropped_) +
+                         " log records dropped (ring buffer full)";
+        format(record, buffer_);
+        reported_dropped_ = dropped;
+    }
+
+    writeAll(fd_, buffer_.data(), buffer_.size());
+    batch_.clear();
+}
+
+void Logger::format(const LogRecord& record, std::string& out) {
+    // 时间戳
+    time_t second = std::chrono::system_clock::to_time_t(record.time);
+    if (second != cached_second_ || cached_time_[0] == '\0') {
+        struct tm tm;
+        localtime_r(&second, &tm);
+        std::strftime(cached_time_, sizeof(cached_time_), "%Y-%m-%d %H:%M:%S", &tm);
+        cached_second_ = second;
+    }
+    out.append(cached_time_);
+
+    // 日志级别
+    out.append(" [");
+    out.append(levelToString(record.level));
+    out.append("] ");
+
+    // 文件和行号
+    out.push_back('[');
+    out.append(record.file);
+    out.push_back(':');
+    out.append(std::to_string(record.line));
+    out.append("] ");
+
+    // 消息
+    out.append(record.message);
+    out.push_back('\n');
+}
+
+} // namespace tiny_sql
@@ -0,0 +1,18 @@
+#include "tiny_sql/common/memory_tracker.h"
+
+namespace tiny_sql {
+
+void MemoryTracker::consume(int64_t bytes) {
+    int64_t usage = usage_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = peak_.load(std::memory_order_relaxed);
+    while (usage > peak &&
+           !peak_.compare_exchange_weak(peak, usage, std::memory_order_relaxed)) {
+    }
+}
+
+MemoryTracker*& memory_tracker::current() {
+    thread_local MemoryTracker* tracker = nullptr;
+    return tracker;
+}
+
+} // namespace tiny_sql
@@ -0,0 +1,288 @@
+#include "tiny_sql/common/metrics.h"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstdio>
+#include <sstream>
+
+namespace tiny_sql {
+
+size_t metrics::shardIndex() {
+    static std::atomic<size_t> next_shard{0};
+    thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kShards;
+    return shard;
+}
+
+StatementStats*& metrics::currentStatement() {
+    thread_local StatementStats* statement = nullptr;
+    return statement;
+}
+
+void metrics::addRowsScanned(uint64_t rows) {
+    ServerMetrics::instance().rows_scanned.add(rows);
+    if (StatementStats* stats = currentStatement()) {
+        stats->rows_scanned += rows;
+    }
+}
+
+// ==================== Counter ====================
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+// ==================== Histogram ====================
+
+size_t Histogram::bucketIndex(uint64_t value) {
+    if (value < kLinearBuckets) {
+        return static_cast<size_t>(value);
+    }
+    // 最高位之后保留4位：value >> shift 落在 [16, 32)
+    size_t msb = static_cast<size_t>(std::bit_width(value)) - 1;
+    size_t shift = msb - 4;
+    return kLinearBuckets + (shift - 1) * kSubBuckets +
+           static_cast<size_t>(value >> shift) - kSubBuckets;
+}
+
+uint64_t Histogram::bucketUpperBound(size_t index) {
+    if (index < kLinearBuckets) {
+        return index;
+    }
+    size_t k = index - kLinearBuckets;
+    size_t shift = k / kSubBuckets + 1;
+    uint64_t mantissa = k % kSubBuckets + kSubBuckets;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void Histogram::record(uint64_t value) {
+    Shard& shard = shards_[metrics::shardIndex()];
+    shard.buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t max = max_.load(std::memory_order_relaxed);
+    while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot snapshot;
+    snapshot.buckets.assign(kBuckets, 0);
+    for (const auto& shard : shards_) {
+        for (size_t i = 0; i < kBuckets; ++i) {
+            snapshot.buckets[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+        snapshot.count += shard.count.load(std::memory_order_relaxed);
+        snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+    }
+    snapshot.max = max_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+uint64_t Histogram::Snapshot::percentile(double q) const {
+    uint64_t total = 0;
+    for (uint64_t n : buckets) {
+        total += n;
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total) + 0.5);
+    rank = std::clamp<uint64_t>(rank, 1, total);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), max);
+        }
+    }
+    return max;
+}
+
+// ==================== MetricsRegistry ====================
+
+namespace {
+
+// 分位数及其在 SHOW STATUS 中的后缀
+const std::pair<double, const char*> kQuantiles[] = {
+    {0.5, "p50"}, {0.95, "p95"}, {0.99, "p99"},
+};
+
+std::string prometheusName(const std::string& name) {
+    std::string out = "tiny_sql_";
+    for (char c : name) {
+        out.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+    return out;
+}
+
+std::string formatDouble(double value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.9g", value);
+    return buf;
+}
+
+} // namespace
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::MetricsRegistry() : start_time_(std::chrono::steady_clock::now()) {}
+
+MetricsRegistry::Entry& MetricsRegistry::findOrAdd(Kind kind, const std::string& name,
+                                                   const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries_) {
+        if (entry->name == name && entry->kind == kind) {
+            return *entry;
+        }
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->kind = kind;
+    entry->name = name;
+    entry->help = help;
+    switch (kind) {
+        case Kind::COUNTER: entry->counter = std::make_unique<Counter>(); break;
+        case Kind::GAUGE: entry->gauge = std::make_unique<Gauge>(); break;
+        case Kind::HISTOGRAM: entry->histogram = std::make_unique<Histogram>(); break;
+    }
+    entries_.push_back(std::move(entry));
+    return *entries_.back();
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help) {
+    return *findOrAdd(Kind::COUNTER, name, help).counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help) {
+    return *findOrAdd(Kind::GAUGE, name, help).gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help) {
+    return *findOrAdd(Kind::HISTOGRAM, name, help).histogram;
+}
+
+std::vector<std::pair<std::string, std::string>> MetricsRegistry::statusVariables() const {
+    std::vector<std::pair<std::string, std::string>> vars;
+    auto uptime = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now() - start_time_).count();
+    vars.emplace_back("Uptime", std::to_string(uptime));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : entries_) {
+        switch (entry->kind) {
+            case Kind::COUNTER:
+                vars.emplace_back(entry->name, std::to_string(entry->counter->value()));
+                break;
+            case Kind::GAUGE:
+                vars.emplace_back(entry->name, std::to_string(entry->gauge->value()));
+                break;
+            case Kind::HISTOGRAM: {
+                Histogram::Snapshot snapshot = entry->histogram->snapshot();
+                vars.emplace_back(entry->name + "_count", std::to_string(snapshot.count));
+                vars.emplace_back(entry->name + "_avg_us", formatDouble(snapshot.mean() / 1000.0));
+                for (const auto& quantile : kQuantiles) {
+                    vars.emplace_back(entry->name + "_" + quantile.second + "_us",
+                                      formatDouble(snapshot.percentile(quantile.first) / 1000.0));
+                }
+                vars.emplace_back(entry->name + "_max_us", formatDouble(snapshot.max / 1000.0));
+                break;
+            }
+        }
+    }
+
+    std::sort(vars.begin(), vars.end());
+    return vars;
+}
+
+std::string MetricsRegistry::renderPrometheus() const {
+    std::ostringstream oss;
+    auto uptime = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now() - start_time_).count();
+    oss << "# HELP tiny_sql_uptime_seconds Seconds since the server started.\n"
+        << "# TYPE tiny_sql_uptime_seconds gauge\n"
+        << "tiny_sql_uptime_seconds " << uptime << "\n";
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : entries_) {
+        std::string name = prometheusName(entry->name);
+        switch (entry->kind) {
+            case Kind::COUNTER:
+                name += "_total";
+                oss << "# HELP " << name << " " << entry->help << "\n"
+                    << "# TYPE " << name << " counter\n"
+                    << name << " " << entry->counter->value() << "\n";
+                break;
+            case Kind::GAUGE:
+                oss << "# HELP " << name << " " << entry->help << "\n"
+                    << "# TYPE " << name << " gauge\n"
+                    << name << " " << entry->gauge->value() << "\n";
+                break;
+            case Kind::HISTOGRAM: {
+                name += "_seconds";
+                Histogram::Snapshot snapshot = entry->histogram->snapshot();
+                oss << "# HELP " << name << " " << entry->help << "\n"
+                    << "# TYPE " << name << " summary\n";
+                for (const auto& quantile : kQuantiles) {
+                    oss << name << "{quantile=\"" << quantile.first << "\"} "
+                        << formatDouble(snapshot.percentile(quantile.first) / 1e9) << "\n";
+                }
+                oss << name << "_sum " << formatDouble(snapshot.sum / 1e9) << "\n"
+                    << name << "_count " << snapshot.count << "\n";
+                break;
+            }
+        }
+    }
+    return oss.str();
+}
+
+// ==================== ServerMetrics ====================
+
+ServerMetrics& ServerMetrics::instance() {
+    static ServerMetrics metrics;
+    return metrics;
+}
+
+ServerMetrics::ServerMetrics()
+    : connections(MetricsRegistry::instance().counter(
+          "Connections", "Connection attempts accepted by the server."))
+    , aborted_connects(MetricsRegistry::instance().counter(
+          "Aborted_connects", "Connections rejected because max connections was reached."))
+    , threads_connected(MetricsRegistry::instance().gauge(
+          "Threads_connected", "Currently open client connections."))
+    , bytes_received(MetricsRegistry::instance().counter(
+          "Bytes_received", "Bytes of protocol packets received from clients."))
+    , bytes_sent(MetricsRegistry::instance().counter(
+          "Bytes_sent", "Bytes of protocol packets sent to clients."))
+    , output_buffer_bytes(MetricsRegistry::instance().gauge(
+          "Output_buffer_bytes", "Response bytes queued for clients that are not reading fast enough."))
+    , aborted_slow_clients(MetricsRegistry::instance().counter(
+          "Aborted_slow_clients", "Connections closed because queued output exceeded max_output_memory."))
+    , questions(MetricsRegistry::instance().counter(
+          "Questions", "Commands received from clients."))
+    , rows_scanned(MetricsRegistry::instance().counter(
+          "Rows_scanned", "Visible rows read through table access paths."))
+    , rows_returned(MetricsRegistry::instance().counter(
+          "Rows_returned", "Rows sent to clients in result sets."))
+    , slow_queries(MetricsRegistry::instance().counter(
+          "Slow_queries", "Statements that took longer than long_query_time."))
+    , parse_time(MetricsRegistry::instance().histogram(
+          "Query_parse_time", "Time spent parsing SQL statements."))
+    , plan_time(MetricsRegistry::instance().histogram(
+          "Query_plan_time", "Time spent choosing access paths and join plans."))
+    , execute_time(MetricsRegistry::instance().histogram(
+          "Query_execute_time", "Time spent executing statements, excluding parse, plan, encode and network write."))
+    , encode_time(MetricsRegistry::instance().histogram(
+          "Query_encode_time", "Time spent encoding result sets."))
+    , network_write_time(MetricsRegistry::instance().histogram(
+          "Network_write_time", "Time spent writing responses to client sockets.")) {}
+
+} // namespace tiny_sql
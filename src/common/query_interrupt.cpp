@@ -0,0 +1,25 @@
+#include "tiny_sql/common/query_interrupt.h"
+#include "tiny_sql/common/metrics.h"
+
+namespace tiny_sql {
+
+InterruptContext*& interrupt::current() {
+    thread_local InterruptContext* context = nullptr;
+    return context;
+}
+
+void interrupt::check() {
+    const InterruptContext* context = current();
+    if (!context) {
+        return;
+    }
+    if (context->kill_state &&
+        context->kill_state->load(std::memory_order_relaxed) != KillState::NONE) {
+        throw QueryInterrupted(QueryInterrupted::Reason::KILLED);
+    }
+    if (context->deadline_ns != 0 && metrics::nowNs() >= context->deadline_ns) {
+        throw QueryInterrupted(QueryInterrupted::Reason::TIMEOUT);
+    }
+}
+
+} // namespace tiny_sql
@@ -0,0 +1,179 @@
+#include "tiny_sql/common/slow_query_log.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <ctime>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace tiny_sql {
+
+namespace {
+
+// 写满整个缓冲区（处理部分写入和 EINTR）
+void writeAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+}
+
+} // namespace
+
+SlowQueryLog& SlowQueryLog::instance() {
+    static SlowQueryLog log;
+    return log;
+}
+
+SlowQueryLog::~SlowQueryLog() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+bool SlowQueryLog::setOutput(const std::string& path) {
+    int fd = -1;
+    if (!path.empty()) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = fd;
+    return true;
+}
+
+void SlowQueryLog::setLongQueryTime(double seconds) {
+    long_query_time_ns_.store(static_cast<uint64_t>(seconds * 1e9), std::memory_order_relaxed);
+}
+
+double SlowQueryLog::getLongQueryTime() const {
+    return static_cast<double>(long_query_time_ns_.load(std::memory_order_relaxed)) / 1e9;
+}
+
+bool SlowQueryLog::record(const QueryRecord& record) {
+    bool slow = record.total_ns > long_query_time_ns_.load(std::memory_order_relaxed);
+    std::string entry;
+    if (slow) {
+        ServerMetrics::instance().slow_queries.add();
+        format(record, entry);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = digests_.find(record.digest);
+    if (it == digests_.end()) {
+        if (digests_.size() >= kMaxDigests) {
+            auto victim = std::min_element(digests_.begin(), digests_.end(),
+                [](const auto& a, const auto& b) { return a.second.total_ns < b.second.total_ns; });
+            digests_.erase(victim);
+        }
+        it = digests_.emplace(record.digest, QueryDigest()).first;
+        it->second.digest = record.digest;
+        it->second.fingerprint = record.fingerprint;
+    }
+
+    QueryDigest& digest = it->second;
+    digest.sample_query = record.query;
+    digest.count++;
+    digest.total_ns += record.total_ns;
+    digest.max_ns = std::max(digest.max_ns, record.total_ns);
+    digest.rows_scanned += record.stats.rows_scanned;
+    digest.rows_returned += record.stats.rows_returned;
+    digest.bytes_sent += record.stats.bytes_sent;
+    digest.max_peak_memory = std::max(digest.max_peak_memory, record.stats.peak_memory);
+
+    if (slow && fd_ >= 0) {
+        writeAll(fd_, entry.data(), entry.size());
+    }
+    return slow;
+}
+
+std::vector<QueryDigest> SlowQueryLog::topDigests(size_t k) const {
+    std::vector<QueryDigest> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result.reserve(digests_.size());
+        for (const auto& entry : digests_) {
+            result.push_back(entry.second);
+        }
+    }
+
+    auto by_total_time = [](const QueryDigest& a, const QueryDigest& b) {
+        return a.total_ns > b.total_ns;
+    };
+    if (k < result.size()) {
+        std::partial_sort(result.begin(), result.begin() + k, result.end(), by_total_time);
+        result.resize(k);
+    } else {
+        std::sort(result.begin(), result.end(), by_total_time);
+    }
+    return result;
+}
+
+void SlowQueryLog::resetDigests() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    digests_.clear();
+}
+
+void SlowQueryLog::format(const QueryRecord& record, std::string& out) {
+    char buf[256];
+
+    // # Time: 2024-01-01T12:00:00.123456Z
+    auto since_epoch = record.start_time.time_since_epoch();
+    time_t seconds = std::chrono::system_clock::to_time_t(record.start_time);
+    long micros = static_cast<long>(
+        std::chrono::duration_cast<std::chrono::microseconds>(since_epoch).count() % 1000000);
+    struct tm tm;
+    gmtime_r(&seconds, &tm);
+    size_t n = std::strftime(buf, sizeof(buf), "# Time: %Y-%m-%dT%H:%M:%S", &tm);
+    std::snprintf(buf + n, sizeof(buf) - n, ".%06ldZ\n", micros);
+    out.append(buf);
+
+    out.append("# User@Host: " + record.user + "[" + record.user + "] @ localhost []  Id: " +
+               std::to_string(record.connection_id) + "\n");
+
+    const StatementStats& stats = record.stats;
+    std::snprintf(buf, sizeof(buf),
+                  "# Query_time: %.6f  Lock_time: 0.000000  Rows_sent: %" PRIu64
+                  "  Rows_examined: %" PRIu64 "\n",
+                  static_cast<double>(record.total_ns) / 1e9, stats.rows_returned, stats.rows_scanned);
+    out.append(buf);
+
+    std::snprintf(buf, sizeof(buf),
+                  "# Bytes_sent: %" PRIu64 "  Peak_memory: %" PRIu64
+                  "  Parse_time: %.6f  Plan_time: %.6f\n",
+                  stats.bytes_sent, stats.peak_memory,
+                  static_cast<double>(stats.parse_ns) / 1e9, static_cast<double>(stats.plan_ns) / 1e9);
+    out.append(buf);
+
+    std::snprintf(buf, sizeof(buf), "# Digest: %016" PRIx64 "\n", record.digest);
+    out.append(buf);
+    out.append("# Fingerprint: ");
+    out.append(record.fingerprint);
+    out.push_back('\n');
+
+    if (!record.database.empty()) {
+        out.append("use ");
+        out.append(record.database);
+        out.append(";\n");
+    }
+    std::snprintf(buf, sizeof(buf), "SET timestamp=%lld;\n", static_cast<long long>(seconds));
+    out.append(buf);
+    out.append(record.query);
+    out.append(";\n");
+}
+
+} // namespace tiny_sql
@@ -0,0 +1,146 @@
+#include "tiny_sql/common/worker_pool.h"
+#include "tiny_sql/common/logger.h"
+#include <algorithm>
+#include <system_error>
+
+namespace tiny_sql {
+
+WorkerPool& WorkerPool::instance() {
+    static WorkerPool pool;
+    return pool;
+}
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+void WorkerPool::start() {
+    // 调用者持有 mutex_
+    started_ = true;
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    size_t wanted = std::min(hardware, kMaxThreads) - 1;
+
+    threads_.reserve(wanted);
+    for (size_t i = 0; i < wanted; ++i) {
+        try {
+            threads_.emplace_back(&WorkerPool::workerLoop, this);
+        } catch (const std::system_error& e) {
+            // 线程数或内存到了上限：用已经创建的线程继续，调用线程总能兜底
+            LOG_WARN("Worker pool started with " << threads_.size() << " of " << wanted
+                     << " threads: " << e.what());
+            break;
+        }
+    }
+}
+
+void WorkerPool::stop() {
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        threads.swap(threads_);
+    }
+    work_cv_.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+size_t WorkerPool::concurrency() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!started_ && !stopping_) {
+        start();
+    }
+    return threads_.size() + 1;
+}
+
+void WorkerPool::run(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) {
+        return;
+    }
+
+    auto batch = std::make_shared<Batch>();
+    batch->task = &task;
+    batch->count = count;
+    batch->interrupt = interrupt::current();
+    batch->memory = memory_tracker::current();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!started_ && !stopping_) {
+            start();
+        }
+        if (count > 1 && !threads_.empty()) {
+            queue_.push_back(batch);
+        }
+    }
+    work_cv_.notify_all();
+
+    // 调用线程也领取任务；领完后等工作线程手上的任务结束
+    drain(*batch);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = std::find(queue_.begin(), queue_.end(), batch);
+    if (it != queue_.end()) {
+        queue_.erase(it);
+    }
+    done_cv_.wait(lock, [&] { return batch->finished == batch->count; });
+
+    if (batch->error) {
+        std::rethrow_exception(batch->error);
+    }
+}
+
+void WorkerPool::drain(Batch& batch) {
+    InterruptScope interrupt_scope(batch.interrupt);
+    MemoryTrackerScope memory_scope(batch.memory);
+
+    while (true) {
+        size_t index = batch.next.fetch_add(1);
+        if (index >= batch.count) {
+            return;
+        }
+
+        std::exception_ptr error;
+        try {
+            (*batch.task)(index);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        bool done;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (error && !batch.error) {
+                batch.error = error;
+            }
+            done = ++batch.finished == batch.count;
+        }
+        if (done) {
+            done_cv_.notify_all();
+        }
+    }
+}
+
+void WorkerPool::workerLoop() {
+    while (true) {
+        std::shared_ptr<Batch> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            batch = queue_.front();
+            // 任务都被领走的批次移出队列，其他线程不必再看它
+            if (batch->next.load() >= batch->count) {
+                queue_.pop_front();
+                continue;
+            }
+        }
+
+        drain(*batch);
+    }
+}
+
+} // namespace tiny_sql
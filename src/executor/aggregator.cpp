@@ -0,0 +1,357 @@
+#include "tiny_sql/executor/aggregator.h"
+#include "tiny_sql/storage/expression_evaluator.h"
+#include "tiny_sql/common/logger.h"
+#include "tiny_sql/common/worker_pool.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace tiny_sql {
+
+// ==================== AggregateSpec ====================
+
+AggregateSpec AggregateSpec::fromFunctionCall(const FunctionCall* func) {
+    const std::string& name = func->getName();
+    const auto& args = func->getArgs();
+
+    if (args.size() != 1) {
+        throw std::runtime_error("Incorrect parameter count in the call to " + name);
+    }
+
+    AggregateSpec spec;
+    spec.argument = args[0].get();
+
+    auto* id = dynamic_cast<const Identifier*>(spec.argument);
+    bool is_star = id && id->getName() == "*";
+
+    if (name == "COUNT") {
+        spec.kind = is_star ? AggregateKind::COUNT_STAR : AggregateKind::COUNT;
+        if (is_star) {
+            spec.argument = nullptr;
+        }
+        return spec;
+    }
+
+    if (is_star) {
+        throw std::runtime_error("Invalid use of '*' in " + name);
+    }
+
+    if (name == "SUM") spec.kind = AggregateKind::SUM;
+    else if (name == "AVG") spec.kind = AggregateKind::AVG;
+    else if (name == "MIN") spec.kind = AggregateKind::MIN;
+    else if (name == "MAX") spec.kind = AggregateKind::MAX;
+    else throw std::runtime_error("Unsupported aggregate function: " + name);
+
+    return spec;
+}
+
+// ==================== AggregateState ====================
+
+void AggregateState::update(AggregateKind kind, const Value& value) {
+    if (kind == AggregateKind::COUNT_STAR) {
+        count++;
+        return;
+    }
+
+    // 聚合函数忽略NULL输入
+    // Aggregate functions ignore NULL input
+    if (value.isNull()) {
+        return;
+    }
+    count++;
+
+    switch (kind) {
+        case AggregateKind::SUM:
+        case AggregateKind::AVG:
+            if (value.isInt()) {
+                int_sum += value.asInt();
+            } else if (value.isBigInt()) {
+                int_sum += value.asBigInt();
+            } else if (value.isBool()) {
+                int_sum += value.asBool() ? 1 : 0;
+            } else if (value.isFloat()) {
+                double_sum += value.asFloat();
+                is_floating = true;
+            } else if (value.isDouble()) {
+                double_sum += value.asDouble();
+                is_floating = true;
+            } else if (value.isString()) {
+                // 与MySQL一致：字符串按数值前缀参与计算
+                double_sum += std::strtod(value.asString().c_str(), nullptr);
+                is_floating = true;
+            }
+            break;
+
+        case AggregateKind::MIN:
+            if (extreme.isNull() || value < extreme) {
+                extreme = value;
+            }
+            break;
+
+        case AggregateKind::MAX:
+            if (extreme.isNull() || value > extreme) {
+                extreme = value;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void AggregateState::merge(AggregateKind kind, const AggregateState& other) {
+    count += other.count;
+    int_sum += other.int_sum;
+    double_sum += other.double_sum;
+    is_floating = is_floating || other.is_floating;
+
+    if (other.extreme.isNull()) {
+        return;
+    }
+    if (kind == AggregateKind::MIN && (extreme.isNull() || other.extreme < extreme)) {
+        extreme = other.extreme;
+    } else if (kind == AggregateKind::MAX && (extreme.isNull() || other.extreme > extreme)) {
+        extreme = other.extreme;
+    }
+}
+
+Value AggregateState::finalize(AggregateKind kind) const {
+    switch (kind) {
+        case AggregateKind::COUNT_STAR:
+        case AggregateKind::COUNT:
+            return Value(count);
+
+        case AggregateKind::SUM:
+            if (count == 0) {
+                return Value::Null();
+            }
+            if (is_floating) {
+                return Value(static_cast<double>(int_sum) + double_sum);
+            }
+            return Value(int_sum);
+
+        case AggregateKind::AVG:
+            if (count == 0) {
+                return Value::Null();
+            }
+            return Value((static_cast<double>(int_sum) + double_sum) / static_cast<double>(count));
+
+        case AggregateKind::MIN:
+        case AggregateKind::MAX:
+            return extreme;
+    }
+    return Value::Null();
+}
+
+// ==================== GroupHashTable ====================
+
+GroupHashTable::GroupHashTable(size_t aggregate_count, size_t initial_capacity)
+    : aggregate_count_(aggregate_count)
+{
+    size_t capacity = 16;
+    while (capacity < initial_capacity) {
+        capacity <<= 1;
+    }
+    mask_ = capacity - 1;
+    slots_.assign(capacity, kEmptySlot);
+}
+
+size_t GroupHashTable::memoryBytes() const {
+    size_t bytes = slots_.capacity() * sizeof(uint32_t)
+                 + hashes_.capacity() * sizeof(size_t)
+                 + keys_.capacity() * sizeof(std::vector<Value>)
+                 + states_.capacity() * sizeof(AggregateState);
+    return bytes + key_bytes_;
+}
+
+size_t GroupHashTable::hashKey(const std::vector<Value>& key) {
+    size_t h = 0xCBF29CE484222325ULL;
+    for (const auto& value : key) {
+        h ^= value.hash();
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+size_t GroupHashTable::findOrInsert(const std::vector<Value>& key, size_t hash) {
+    size_t pos = hash & mask_;
+    while (true) {
+        uint32_t group = slots_[pos];
+        if (group == kEmptySlot) {
+            break;
+        }
+        if (hashes_[group] == hash && keys_[group] == key) {
+            return group;
+        }
+        pos = (pos + 1) & mask_;
+    }
+
+    // 插入新分组
+    // Insert new group
+    uint32_t group = static_cast<uint32_t>(keys_.size());
+    slots_[pos] = group;
+    hashes_.push_back(hash);
+    keys_.push_back(key);
+    key_bytes_ += keys_.back().capacity() * sizeof(Value);
+    states_.resize(states_.size() + aggregate_count_);
+
+    // 负载因子超过0.5时扩容，保证探测链较短
+    // Grow when load factor exceeds 0.5 to keep probe sequences short
+    if (keys_.size() * 2 > slots_.size()) {
+        grow();
+    }
+    return group;
+}
+
+void GroupHashTable::grow() {
+    size_t capacity = slots_.size() * 2;
+    mask_ = capacity - 1;
+    slots_.assign(capacity, kEmptySlot);
+
+    for (uint32_t group = 0; group < keys_.size(); ++group) {
+        size_t pos = hashes_[group] & mask_;
+        while (slots_[pos] != kEmptySlot) {
+            pos = (pos + 1) & mask_;
+        }
+        slots_[pos] = group;
+    }
+}
+
+// ==================== HashAggregator ====================
+
+HashAggregator::HashAggregator(std::vector<AggregateSpec> aggregates,
+                               std::vector<const Expression*> group_by,
+                               const std::vector<ColumnDef>& columns)
+    : aggregates_(std::move(aggregates))
+    , group_by_(std::move(group_by))
+    , columns_(columns)
+    , result_table_(aggregates_.size())
+{}
+
+size_t HashAggregator::consumeRange(GroupHashTable& table, TrackedMemory& memory,
+                                    const std::vector<Row>& rows,
+                                    size_t begin, size_t end,
+                                    const Expression* where) const {
+    std::vector<Value> key(group_by_.size());
+    size_t matched = 0;
+    MorselCheck morsel;
+
+    for (size_t i = begin; i < end; ++i) {
+        morsel.tick();
+        if ((i - begin) % interrupt::kMorselRows == 0) {
+            memory.set(table.memoryBytes());
+        }
+        const Row& row = rows[i];
+
+        if (where && !ExpressionEvaluator::evaluate(where, row, columns_)) {
+            continue;
+        }
+        matched++;
+
+        for (size_t k = 0; k < group_by_.size(); ++k) {
+            key[k] = ExpressionEvaluator::evaluateValue(group_by_[k], row, columns_);
+        }
+
+        size_t group = table.findOrInsert(key, GroupHashTable::hashKey(key));
+        AggregateState* states = table.getStates(group);
+
+        for (size_t a = 0; a < aggregates_.size(); ++a) {
+            const AggregateSpec& spec = aggregates_[a];
+            if (spec.kind == AggregateKind::COUNT_STAR) {
+                states[a].update(spec.kind, Value::Null());
+            } else {
+                states[a].update(spec.kind,
+                    ExpressionEvaluator::evaluateValue(spec.argument, row, columns_));
+            }
+        }
+    }
+    memory.set(table.memoryBytes());
+    return matched;
+}
+
+void HashAggregator::mergeInto(GroupHashTable& target, const GroupHashTable& source) const {
+    for (size_t group = 0; group < source.size(); ++group) {
+        size_t target_group = target.findOrInsert(source.getKey(group), source.getHash(group));
+        AggregateState* target_states = target.getStates(target_group);
+        const AggregateState* source_states = source.getStates(group);
+
+        for (size_t a = 0; a < aggregates_.size(); ++a) {
+            target_states[a].merge(aggregates_[a].kind, source_states[a]);
+        }
+    }
+}
+
+void HashAggregator::run(const std::vector<Row>& rows, const Expression* where) {
+    size_t thread_count = 1;
+    if (rows.size() >= kParallelThreshold) {
+        thread_count = std::min<size_t>(WorkerPool::instance().concurrency(),
+                                        rows.size() / (kParallelThreshold / 4));
+    }
+
+    if (thread_count <= 1) {
+        matched_rows_ += consumeRange(result_table_, result_memory_, rows, 0, rows.size(), where);
+        return;
+    }
+
+    // 每个分片在自己的哈希表上做部分聚合，结束后统一合并
+    // Each slice aggregates into its own table; partials are merged at the end
+    LOG_DEBUG("Parallel aggregation over " << rows.size() << " rows in "
+              << thread_count << " slices");
+
+    std::vector<GroupHashTable> partials;
+    partials.reserve(thread_count);
+    for (size_t t = 0; t < thread_count; ++t) {
+        partials.emplace_back(aggregates_.size());
+    }
+    std::vector<size_t> matched(thread_count, 0);
+    std::vector<TrackedMemory> partial_memory(thread_count);
+
+    // 在常驻工作线程上执行，任务继承调用者的中断条件，异常在全部结束后重新抛出
+    size_t chunk = (rows.size() + thread_count - 1) / thread_count;
+    WorkerPool::instance().run(thread_count, [&](size_t t) {
+        size_t begin = std::min(rows.size(), t * chunk);
+        size_t end = std::min(rows.size(), begin + chunk);
+        matched[t] = consumeRange(partials[t], partial_memory[t], rows, begin, end, where);
+    });
+
+    for (size_t t = 0; t < thread_count; ++t) {
+        mergeInto(result_table_, partials[t]);
+        result_memory_.set(result_table_.memoryBytes());
+        matched_rows_ += matched[t];
+    }
+}
+
+std::vector<Row> HashAggregator::getResults() const {
+    std::vector<Row> results;
+
+    // 无GROUP BY的聚合在空输入上也返回一行
+    // Aggregation without GROUP BY returns one row even for empty input
+    if (result_table_.size() == 0) {
+        if (!group_by_.empty()) {
+            return results;
+        }
+        Row row;
+        AggregateState empty;
+        for (const auto& spec : aggregates_) {
+            row.addValue(empty.finalize(spec.kind));
+        }
+        results.push_back(std::move(row));
+        return results;
+    }
+
+    results.reserve(result_table_.size());
+    for (size_t group = 0; group < result_table_.size(); ++group) {
+        Row row;
+        for (const auto& key : result_table_.getKey(group)) {
+            row.addValue(key);
+        }
+        const AggregateState* states = result_table_.getStates(group);
+        for (size_t a = 0; a < aggregates_.size(); ++a) {
+            row.addValue(states[a].finalize(aggregates_[a].kind));
+        }
+        results.push_back(std::move(row));
+    }
+    return results;
+}
+
+} // namespace tiny_sql
@@ -0,0 +1,411 @@
+#include "tiny_sql/executor/cost_model.h"
+#include "tiny_sql/storage/expression_evaluator.h"
+#include "tiny_sql/common/metrics.h"
+#include "tiny_sql/common/query_interrupt.h"
+#include <algorithm>
+#include <cmath>
+
+namespace tiny_sql {
+
+const char* accessPathTypeToString(AccessPathType type) {
+    switch (type) {
+        case AccessPathType::FULL_SCAN: return "ALL";
+        case AccessPathType::PK_LOOKUP: return "const";
+        case AccessPathType::INDEX_LOOKUP: return "ref";
+        case AccessPathType::INDEX_RANGE: return "range";
+        case AccessPathType::INDEX_SCAN: return "index";
+    }
+    return "unknown";
+}
+
+// ==================== AccessPath ====================
+
+void AccessPath::forEachRow(const Table& table, const ReadView& view, bool ascending,
+                            const std::function<bool(const Row&)>& fn) const {
+    const auto& rows = table.getRows();
+    forEachRowId(table, view, ascending, [&](size_t row_id) { return fn(rows[row_id]); });
+}
+
+void AccessPath::forEachRowId(const Table& table, const ReadView& view, bool ascending,
+                              const std::function<bool(size_t)>& fn) const {
+    // 读取的可见行数在扫描结束时一次性计入 Rows_scanned 和当前语句的统计
+    uint64_t scanned = 0;
+    struct ScanCounter {
+        uint64_t& scanned;
+        ~ScanCounter() { metrics::addRowsScanned(scanned); }
+    } scan_counter{scanned};
+    MorselCheck morsel;
+
+    if (!index) {
+        size_t row_count = table.getRows().size();
+        for (size_t row_id = 0; row_id < row_count; ++row_id) {
+            morsel.tick();
+            if (table.isVisible(row_id, view) && (++scanned, !fn(row_id))) {
+                return;
+            }
+        }
+        return;
+    }
+
+    // 索引中包含所有版本的索引项，跳过对快照不可见的版本
+    auto visit = [&](size_t row_id) {
+        morsel.tick();
+        return !table.isVisible(row_id, view) || (++scanned, fn(row_id));
+    };
+    if (type == AccessPathType::INDEX_SCAN) {
+        index->scan(ascending, visit);
+    } else {
+        index->scanRange(has_lower ? &lower : nullptr, lower_inclusive,
+                         has_upper ? &upper : nullptr, upper_inclusive,
+                         ascending, visit);
+    }
+}
+
+std::string AccessPath::describe(const Table& table, const std::string& alias,
+                                 bool ascending) const {
+    if (!index) {
+        return "Table scan on " + alias;
+    }
+
+    const std::string& column_name = table.getColumns()[column].name;
+    std::string text;
+    switch (type) {
+        case AccessPathType::PK_LOOKUP:
+            text = "Single-row index lookup on " + alias + " using " + index_name
+                 + " (" + column_name + " = " + lower.toString() + ")";
+            break;
+        case AccessPathType::INDEX_LOOKUP:
+            text = "Index lookup on " + alias + " using " + index_name
+                 + " (" + column_name + " = " + lower.toString() + ")";
+            break;
+        case AccessPathType::INDEX_RANGE: {
+            std::string range;
+            if (has_lower) {
+                range += lower.toString() + (lower_inclusive ? " <= " : " < ");
+            }
+            range += column_name;
+            if (has_upper) {
+                range += (upper_inclusive ? " <= " : " < ") + upper.toString();
+            }
+            text = "Index range scan on " + alias + " using " + index_name + " (" + range + ")";
+            break;
+        }
+        default:
+            text = "Index scan on " + alias + " using " + index_name;
+            break;
+    }
+    return ascending ? text : text + " (reverse)";
+}
+
+// ==================== 谓词分析 ====================
+
+namespace {
+
+/**
+ * 可用于索引的简单谓词：column op literal
+ */
+struct SargablePredicate {
+    size_t column;
+    std::string op;         // =, <, <=, >, >=
+    Value value;
+};
+
+// 交换比较运算符两侧时的运算符
+std::string flipOperator(const std::string& op) {
+    if (op == "<") return ">";
+    if (op == ">") return "<";
+    if (op == "<=") return ">=";
+    if (op == ">=") return "<=";
+    return op;
+}
+
+bool isLiteral(const Expression* expr) {
+    return dynamic_cast<const NumberLiteral*>(expr) || dynamic_cast<const StringLiteral*>(expr);
+}
+
+// 识别 column op literal / literal op column
+bool toSargable(const Expression* expr, const Table& table, SargablePredicate& out) {
+    auto* bin = dynamic_cast<const BinaryExpression*>(expr);
+    if (!bin) return false;
+
+    const std::string& op = bin->getOperator();
+    if (op != "=" && op != "<" && op != "<=" && op != ">" && op != ">=") {
+        return false;
+    }
+
+    const Expression* column_side = bin->getLeft();
+    const Expression* literal_side = bin->getRight();
+    out.op = op;
+    if (isLiteral(column_side)) {
+        std::swap(column_side, literal_side);
+        out.op = flipOperator(op);
+    }
+
+    auto* id = dynamic_cast<const Identifier*>(column_side);
+    if (!id || !isLiteral(literal_side)) return false;
+
+    int column = ExpressionEvaluator::resolveColumn(id, table.getColumns());
+    if (column < 0) return false;
+
+    out.column = static_cast<size_t>(column);
+    out.value = ExpressionEvaluator::evaluateValue(literal_side, Row(), {});
+    return !out.value.isNull();
+}
+
+double nonNullFraction(const ColumnStatistics& stats, uint64_t row_count) {
+    if (row_count == 0) return 1.0;
+    return 1.0 - static_cast<double>(stats.null_count) / static_cast<double>(row_count);
+}
+
+// 单个谓词的选择率
+double predicateSelectivity(const Table& table, const SargablePredicate& pred) {
+    const auto& stats = table.getStatistics();
+    double rows = static_cast<double>(std::max<size_t>(table.getRowCount(), 1));
+
+    if (!stats.analyzed || pred.column >= stats.columns.size()) {
+        if (pred.op == "=") {
+            return static_cast<int>(pred.column) == table.getPrimaryKeyIndex()
+                ? 1.0 / rows : CostModel::kDefaultEqSelectivity;
+        }
+        return CostModel::kDefaultRangeSelectivity;
+    }
+
+    const ColumnStatistics& col = stats.columns[pred.column];
+    double non_null = nonNullFraction(col, stats.row_count);
+
+    if (pred.op == "=") return col.equalSelectivity(pred.value, stats.row_count);
+    if (pred.op == "<") return non_null * col.fractionBelow(pred.value, false);
+    if (pred.op == "<=") return non_null * col.fractionBelow(pred.value, true);
+    if (pred.op == ">") return non_null * (1.0 - col.fractionBelow(pred.value, true));
+    if (pred.op == ">=") return non_null * (1.0 - col.fractionBelow(pred.value, false));
+    return CostModel::kDefaultRangeSelectivity;
+}
+
+} // namespace
+
+// ==================== CostModel ====================
+
+std::vector<const Expression*> CostModel::splitConjuncts(const Expression* expr) {
+    std::vector<const Expression*> conjuncts;
+    if (!expr) {
+        return conjuncts;
+    }
+
+    std::vector<const Expression*> stack{expr};
+    while (!stack.empty()) {
+        const Expression* e = stack.back();
+        stack.pop_back();
+        auto* bin = dynamic_cast<const BinaryExpression*>(e);
+        if (bin && bin->getOperator() == "AND") {
+            stack.push_back(bin->getRight());
+            stack.push_back(bin->getLeft());
+        } else {
+            conjuncts.push_back(e);
+        }
+    }
+    return conjuncts;
+}
+
+double CostModel::estimateSelectivity(const Table& table,
+                                      const std::vector<const Expression*>& conjuncts) {
+    double selectivity = 1.0;
+    for (const Expression* expr : conjuncts) {
+        SargablePredicate pred;
+        selectivity *= toSargable(expr, table, pred)
+            ? predicateSelectivity(table, pred) : kDefaultRangeSelectivity;
+    }
+    return selectivity;
+}
+
+double CostModel::estimateKeyNdv(const Table& table, size_t column) {
+    double rows = static_cast<double>(table.getRowCount());
+    const auto& stats = table.getStatistics();
+    if (stats.analyzed && column < stats.columns.size()) {
+        return std::max<double>(1.0, static_cast<double>(stats.columns[column].ndv));
+    }
+    if (static_cast<int>(column) == table.getPrimaryKeyIndex()) {
+        return std::max(1.0, rows);
+    }
+    return std::max(1.0, std::min(rows, 1.0 / kDefaultEqSelectivity));
+}
+
+AccessPath CostModel::indexScan(const Table& table, size_t column) {
+    AccessPath path;
+    path.index = table.getIndex(column);
+    if (!path.index) {
+        path.estimated_rows = static_cast<double>(table.getRowCount());
+        path.cost = path.estimated_rows * kSeqRowCost;
+        return path;
+    }
+    path.type = AccessPathType::INDEX_SCAN;
+    path.column = static_cast<int>(column);
+    path.index_name = table.getIndexName(column);
+    path.estimated_rows = static_cast<double>(table.getRowCount());
+    path.cost = path.estimated_rows * (kIndexRowCost + kSeqRowCost);
+    return path;
+}
+
+AccessPath CostModel::chooseAccessPath(const Table& table,
+                                       const std::vector<const Expression*>& conjuncts) {
+    const double rows = static_cast<double>(table.getRowCount());
+    const auto& columns = table.getColumns();
+
+    // 全表扫描作为基准
+    // Full scan is the baseline
+    AccessPath best;
+    best.estimated_rows = rows;
+    best.cost = rows * kSeqRowCost;
+
+    // 按列收集可用于索引的谓词
+    // Collect sargable predicates per indexed column
+    std::vector<std::vector<SargablePredicate>> by_column(columns.size());
+    for (const Expression* expr : conjuncts) {
+        SargablePredicate pred;
+        if (toSargable(expr, table, pred) && table.getIndex(pred.column)) {
+            by_column[pred.column].push_back(pred);
+        }
+    }
+
+    for (size_t col = 0; col < columns.size(); ++col) {
+        if (by_column[col].empty()) continue;
+
+        AccessPath path;
+        path.column = static_cast<int>(col);
+        path.index = table.getIndex(col);
+        path.index_name = table.getIndexName(col);
+
+        // 合并同一列上的条件为一个扫描区间
+        // Merge the predicates on this column into one scan interval
+        bool equality = false;
+        bool impossible = false;
+        double selectivity = 1.0;
+        for (const auto& pred : by_column[col]) {
+            Value key;
+            if (!OrderedIndex::castKey(pred.value, columns[col].type, key)) {
+                // 类型无法转换（如 INT 列与非整数比较）时不使用该谓词定界
+                continue;
+            }
+
+            if (pred.op == "=") {
+                if (equality && key.compare(path.lower) != 0) {
+                    impossible = true;
+                }
+                equality = true;
+                path.has_lower = path.has_upper = true;
+                path.lower = path.upper = key;
+                path.lower_inclusive = path.upper_inclusive = true;
+                selectivity = predicateSelectivity(table, pred);
+                continue;
+            }
+            if (equality) continue;
+
+            bool is_lower = pred.op == ">" || pred.op == ">=";
+            bool inclusive = pred.op == ">=" || pred.op == "<=";
+            if (is_lower) {
+                int c = path.has_lower ? key.compare(path.lower) : 1;
+                if (c > 0 || (c == 0 && !inclusive)) {
+                    path.has_lower = true;
+                    path.lower = key;
+                    path.lower_inclusive = inclusive;
+                }
+            } else {
+                int c = path.has_upper ? key.compare(path.upper) : -1;
+                if (c < 0 || (c == 0 && !inclusive)) {
+                    path.has_upper = true;
+                    path.upper = key;
+                    path.upper_inclusive = inclusive;
+                }
+            }
+        }
+
+        if (!path.has_lower && !path.has_upper) continue;
+
+        if (!equality) {
+            // 区间选择率：有直方图时用上下界的累计比例之差
+            // Interval selectivity from the histogram CDF when available
+            const auto& stats = table.getStatistics();
+            if (stats.analyzed && col < stats.columns.size()) {
+                const auto& cs = stats.columns[col];
+                double hi = path.has_upper ? cs.fractionBelow(path.upper, path.upper_inclusive) : 1.0;
+                double lo = path.has_lower ? cs.fractionBelow(path.lower, !path.lower_inclusive) : 0.0;
+                selectivity = std::max(0.0, hi - lo) * nonNullFraction(cs, stats.row_count);
+            } else {
+                selectivity = (path.has_lower && path.has_upper)
+                    ? kDefaultRangeSelectivity * kDefaultRangeSelectivity
+                    : kDefaultRangeSelectivity;
+            }
+        }
+        if (impossible) {
+            selectivity = 0.0;
+        }
+
+        bool primary = static_cast<int>(col) == table.getPrimaryKeyIndex();
+        path.type = equality ? (primary ? AccessPathType::PK_LOOKUP : AccessPathType::INDEX_LOOKUP)
+                             : AccessPathType::INDEX_RANGE;
+        path.estimated_rows = std::min(rows, std::max(equality && primary ? 1.0 : 0.0,
+                                                      std::ceil(rows * selectivity)));
+        path.cost = std::log2(rows + 1.0) * kIndexSeekCost +
+                    path.estimated_rows * (kIndexRowCost + kSeqRowCost);
+
+        if (path.cost < best.cost) {
+            best = std::move(path);
+        }
+    }
+
+    return best;
+}
+
+JoinPlan CostModel::planJoin(JoinType type, bool has_equi_key,
+                             const JoinSideEstimate& left,
+                             const JoinSideEstimate& right) {
+    JoinPlan plan;
+
+    if (!has_equi_key) {
+        plan.algorithm = JoinAlgorithm::NESTED_LOOP;
+        plan.cost = left.rows * right.rows * kSeqRowCost;
+        plan.estimated_rows = left.rows * right.rows * kDefaultRangeSelectivity;
+        return plan;
+    }
+
+    double ndv = std::max({left.key_ndv, right.key_ndv, 1.0});
+    plan.estimated_rows = left.rows * right.rows / ndv;
+    if (type == JoinType::LEFT) {
+        plan.estimated_rows = std::max(plan.estimated_rows, left.rows);
+    }
+
+    // 哈希连接：在较小一侧建表
+    // Hash join: build on the smaller side
+    plan.algorithm = JoinAlgorithm::HASH;
+    plan.build_left = left.rows < right.rows;
+    plan.cost = std::min(left.rows, right.rows) * kHashBuildCost +
+                std::max(left.rows, right.rows) * kHashProbeCost;
+
+    // 索引嵌套循环：外表每行一次索引查找，再回表读取匹配行
+    // Index nested loop: one index seek per outer row plus fetching the matches
+    auto inlj_cost = [](const JoinSideEstimate& outer, const JoinSideEstimate& inner) {
+        double matches = inner.table_rows / std::max(inner.key_ndv, 1.0);
+        return outer.rows * (std::log2(inner.table_rows + 1.0) * kIndexSeekCost +
+                             matches * kIndexRowCost);
+    };
+
+    if (right.has_index) {
+        double cost = inlj_cost(left, right);
+        if (cost < plan.cost) {
+            plan.algorithm = JoinAlgorithm::INDEX_NESTED_LOOP;
+            plan.index_on_left = false;
+            plan.cost = cost;
+        }
+    }
+    if (type == JoinType::INNER && left.has_index) {
+        double cost = inlj_cost(right, left);
+        if (cost < plan.cost) {
+            plan.algorithm = JoinAlgorithm::INDEX_NESTED_LOOP;
+            plan.index_on_left = true;
+            plan.cost = cost;
+        }
+    }
+
+    return plan;
+}
+
+} // namespace tiny_sql
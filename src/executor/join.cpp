@@ -0,0 +1,402 @@
+#include "tiny_sql/executor/join.h"
+#include "tiny_sql/storage/expression_evaluator.h"
+#include "tiny_sql/common/config.h"
+#include "tiny_sql/common/logger.h"
+#include "tiny_sql/common/query_interrupt.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace tiny_sql {
+
+const char* joinAlgorithmToString(JoinAlgorithm algorithm) {
+    switch (algorithm) {
+        case JoinAlgorithm::HASH: return "hash join";
+        case JoinAlgorithm::INDEX_NESTED_LOOP: return "index nested loop";
+        case JoinAlgorithm::NESTED_LOOP: return "nested loop";
+    }
+    return "unknown";
+}
+
+// ==================== 连接键比较 ====================
+
+// 辅助函数：整数类型取int64
+static bool asInteger(const Value& v, int64_t& out) {
+    if (v.isInt()) { out = v.asInt(); return true; }
+    if (v.isBigInt()) { out = v.asBigInt(); return true; }
+    return false;
+}
+
+// 辅助函数：浮点类型取double
+static bool asFloating(const Value& v, double& out) {
+    if (v.isFloat()) { out = v.asFloat(); return true; }
+    if (v.isDouble()) { out = v.asDouble(); return true; }
+    return false;
+}
+
+uint64_t JoinExecutor::hashKey(const Value& key) {
+    int64_t i;
+    double d;
+    if (asInteger(key, i)) {
+        return std::hash<int64_t>{}(i) * 0x9E3779B97F4A7C15ULL;
+    }
+    if (asFloating(key, d)) {
+        // 整数值的浮点数与对应整数哈希一致（1 = 1.0）
+        if (std::floor(d) == d && std::fabs(d) < 9.2e18) {
+            return std::hash<int64_t>{}(static_cast<int64_t>(d)) * 0x9E3779B97F4A7C15ULL;
+        }
+        return std::hash<double>{}(d) * 0x9E3779B97F4A7C15ULL;
+    }
+    return key.hash() * 0x9E3779B97F4A7C15ULL;
+}
+
+bool JoinExecutor::keysEqual(const Value& a, const Value& b) {
+    if (a.isNull() || b.isNull()) {
+        return false;
+    }
+
+    int64_t ia, ib;
+    double da, db;
+    bool a_int = asInteger(a, ia);
+    bool b_int = asInteger(b, ib);
+    if (a_int && b_int) {
+        return ia == ib;
+    }
+    bool a_num = a_int || asFloating(a, da);
+    bool b_num = b_int || asFloating(b, db);
+    if (a_num && b_num) {
+        if (a_int) da = static_cast<double>(ia);
+        if (b_int) db = static_cast<double>(ib);
+        return da == db;
+    }
+    return a == b;
+}
+
+// ==================== JoinExecutor ====================
+
+std::vector<ColumnDef> JoinExecutor::combineColumns(const std::string& left_name,
+                                                    const std::vector<ColumnDef>& left_columns,
+                                                    const std::string& right_name,
+                                                    const std::vector<ColumnDef>& right_columns) {
+    std::vector<ColumnDef> columns;
+    columns.reserve(left_columns.size() + right_columns.size());
+    for (const auto& column : left_columns) {
+        columns.push_back(column);
+        columns.back().name = left_name + "." + column.name;
+    }
+    for (const auto& column : right_columns) {
+        columns.push_back(column);
+        columns.back().name = right_name + "." + column.name;
+    }
+    return columns;
+}
+
+bool JoinExecutor::extractEquiKey(const Expression* condition,
+                                  const std::vector<ColumnDef>& columns,
+                                  size_t left_width,
+                                  int& left_key,
+                                  int& right_key,
+                                  bool& needs_residual) {
+    // 按AND展开合取项
+    // Flatten the top-level AND conjuncts
+    std::vector<const Expression*> conjuncts;
+    std::vector<const Expression*> stack{condition};
+    while (!stack.empty()) {
+        const Expression* expr = stack.back();
+        stack.pop_back();
+        auto* bin = dynamic_cast<const BinaryExpression*>(expr);
+        if (bin && bin->getOperator() == "AND") {
+            stack.push_back(bin->getRight());
+            stack.push_back(bin->getLeft());
+        } else {
+            conjuncts.push_back(expr);
+        }
+    }
+
+    for (const Expression* expr : conjuncts) {
+        auto* bin = dynamic_cast<const BinaryExpression*>(expr);
+        if (!bin || bin->getOperator() != "=") continue;
+
+        auto* a = dynamic_cast<const Identifier*>(bin->getLeft());
+        auto* b = dynamic_cast<const Identifier*>(bin->getRight());
+        if (!a || !b) continue;
+
+        int ia = ExpressionEvaluator::resolveColumn(a, columns);
+        int ib = ExpressionEvaluator::resolveColumn(b, columns);
+        if (ia < 0 || ib < 0) continue;
+
+        // 一列来自左表、一列来自右表
+        // One column from each side
+        bool a_left = static_cast<size_t>(ia) < left_width;
+        bool b_left = static_cast<size_t>(ib) < left_width;
+        if (a_left == b_left) continue;
+
+        left_key = a_left ? ia : ib;
+        right_key = static_cast<int>((a_left ? ib : ia) - left_width);
+        needs_residual = conjuncts.size() > 1;
+        return true;
+    }
+
+    needs_residual = true;
+    return false;
+}
+
+JoinExecutor::JoinExecutor(JoinType type,
+                           const JoinInput& left,
+                           const JoinInput& right,
+                           const Expression* residual,
+                           const std::vector<ColumnDef>& columns,
+                           const JoinPlan& plan)
+    : type_(type), left_(left), right_(right), residual_(residual), columns_(columns) {
+    algorithm_ = plan.algorithm;
+    build_left_ = plan.build_left;
+    index_on_left_ = plan.index_on_left;
+
+    // 校验计划的前提条件
+    // Validate the plan's preconditions
+    bool has_keys = left_.key_column >= 0 && right_.key_column >= 0;
+    if (!has_keys) {
+        algorithm_ = JoinAlgorithm::NESTED_LOOP;
+    } else if (algorithm_ == JoinAlgorithm::INDEX_NESTED_LOOP) {
+        const JoinInput& inner = index_on_left_ ? left_ : right_;
+        bool outer_join_ok = type_ == JoinType::INNER || !index_on_left_;
+        if (!inner.index || !outer_join_ok) {
+            algorithm_ = JoinAlgorithm::HASH;
+        }
+    }
+
+    // 建表侧超过 join_buffer_size 时分区（分区数为2的幂）
+    // Partition the build side once it exceeds join_buffer_size
+    if (algorithm_ == JoinAlgorithm::HASH) {
+        size_t build_rows = build_left_ ? left_.rows->size() : right_.rows->size();
+        build_bytes_ = build_rows * kEntryBytes;
+        size_t budget = Config::instance().join_buffer_size;
+        while (partitions_ < 1024 && build_bytes_ > budget * partitions_) {
+            partitions_ <<= 1;
+        }
+    }
+}
+
+void JoinExecutor::run(const RowCallback& emit) {
+    LOG_DEBUG("Join: " << joinAlgorithmToString(algorithm_)
+              << ", left rows: " << left_.rows->size()
+              << ", right rows: " << right_.rows->size()
+              << (algorithm_ != JoinAlgorithm::HASH ? "" : build_left_ ? ", build left" : ", build right")
+              << ", partitions: " << partitions_);
+
+    switch (algorithm_) {
+        case JoinAlgorithm::HASH:
+            runHash(emit);
+            break;
+        case JoinAlgorithm::INDEX_NESTED_LOOP:
+            runIndexNestedLoop(emit);
+            break;
+        case JoinAlgorithm::NESTED_LOOP:
+            runNestedLoop(emit);
+            break;
+    }
+}
+
+Row JoinExecutor::combine(const Row& left, const Row* right) const {
+    std::vector<Value> values;
+    values.reserve(left_.width + right_.width);
+    values.insert(values.end(), left.getValues().begin(), left.getValues().end());
+    if (right) {
+        values.insert(values.end(), right->getValues().begin(), right->getValues().end());
+    } else {
+        values.resize(left_.width + right_.width);
+    }
+    return Row(std::move(values));
+}
+
+bool JoinExecutor::residualMatches(const Row& combined) const {
+    return !residual_ || ExpressionEvaluator::evaluate(residual_, combined, columns_);
+}
+
+bool JoinExecutor::emitUnmatchedLeft(const std::vector<bool>& matched, const RowCallback& emit) const {
+    const auto& rows = *left_.rows;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (!matched[i] && left_.isLive(i) && !emit(combine(rows[i], nullptr))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void JoinExecutor::runHash(const RowCallback& emit) {
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+
+    const JoinInput& build = build_left_ ? left_ : right_;
+    const JoinInput& probe = build_left_ ? right_ : left_;
+    const auto& build_rows = *build.rows;
+    const auto& probe_rows = *probe.rows;
+    const size_t build_key = static_cast<size_t>(build.key_column);
+    const size_t probe_key = static_cast<size_t>(probe.key_column);
+    const bool left_outer = type_ == JoinType::LEFT;
+
+    // 1. 计算哈希并按高位分区（NULL键不参与匹配）
+    // Hash every key and partition by the high bits (NULL keys never match)
+    const int shift = 64 - static_cast<int>(std::log2(static_cast<double>(partitions_)));
+    auto partition_of = [&](uint64_t hash) -> size_t {
+        return partitions_ == 1 ? 0 : static_cast<size_t>(hash >> shift);
+    };
+
+    MorselCheck morsel;
+    std::vector<uint64_t> build_hashes(build_rows.size());
+    std::vector<std::vector<uint32_t>> build_parts(partitions_);
+    for (size_t i = 0; i < build_rows.size(); ++i) {
+        morsel.tick();
+        const Value& key = build_rows[i].getValue(build_key);
+        if (key.isNull() || !build.isLive(i)) continue;
+        build_hashes[i] = hashKey(key);
+        build_parts[partition_of(build_hashes[i])].push_back(static_cast<uint32_t>(i));
+    }
+
+    std::vector<uint64_t> probe_hashes(probe_rows.size());
+    std::vector<std::vector<uint32_t>> probe_parts(partitions_);
+    for (size_t i = 0; i < probe_rows.size(); ++i) {
+        morsel.tick();
+        const Value& key = probe_rows[i].getValue(probe_key);
+        if (key.isNull() || !probe.isLive(i)) continue;
+        probe_hashes[i] = hashKey(key);
+        probe_parts[partition_of(probe_hashes[i])].push_back(static_cast<uint32_t>(i));
+    }
+
+    std::vector<bool> left_matched(left_outer ? left_.rows->size() : 0, false);
+
+    // 2. 逐个分区：建表、探测
+    // Per partition: build, then probe
+    std::vector<uint32_t> heads;
+    std::vector<uint32_t> next;
+    for (size_t p = 0; p < partitions_; ++p) {
+        const auto& part = build_parts[p];
+        if (part.empty()) continue;
+
+        size_t bucket_count = 1;
+        while (bucket_count < part.size() * 2) {
+            bucket_count <<= 1;
+        }
+        const uint64_t mask = bucket_count - 1;
+
+        heads.assign(bucket_count, kEmpty);
+        next.resize(part.size());
+        for (size_t k = 0; k < part.size(); ++k) {
+            size_t bucket = build_hashes[part[k]] & mask;
+            next[k] = heads[bucket];
+            heads[bucket] = static_cast<uint32_t>(k);
+        }
+
+        for (uint32_t probe_id : probe_parts[p]) {
+            morsel.tick();
+            uint64_t hash = probe_hashes[probe_id];
+            const Row& probe_row = probe_rows[probe_id];
+            const Value& probe_value = probe_row.getValue(probe_key);
+
+            for (uint32_t k = heads[hash & mask]; k != kEmpty; k = next[k]) {
+                uint32_t build_id = part[k];
+                if (build_hashes[build_id] != hash ||
+                    !keysEqual(build_rows[build_id].getValue(build_key), probe_value)) {
+                    continue;
+                }
+
+                const Row& build_row = build_rows[build_id];
+                Row combined = build_left_ ? combine(build_row, &probe_row)
+                                           : combine(probe_row, &build_row);
+                if (!residualMatches(combined)) {
+                    continue;
+                }
+
+                if (left_outer) {
+                    left_matched[build_left_ ? build_id : probe_id] = true;
+                }
+                if (!emit(std::move(combined))) {
+                    return;
+                }
+            }
+        }
+    }
+
+    // 3. LEFT JOIN：补齐未匹配的左表行
+    // LEFT JOIN: emit unmatched left rows padded with NULLs
+    if (left_outer) {
+        emitUnmatchedLeft(left_matched, emit);
+    }
+}
+
+void JoinExecutor::runIndexNestedLoop(const RowCallback& emit) {
+    const JoinInput& outer = index_on_left_ ? right_ : left_;
+    const JoinInput& inner = index_on_left_ ? left_ : right_;
+    const auto& inner_rows = *inner.rows;
+    const bool left_outer = type_ == JoinType::LEFT;   // 此时外表一定是左表
+
+    const auto& outer_rows = *outer.rows;
+    MorselCheck morsel;
+    for (size_t outer_id = 0; outer_id < outer_rows.size(); ++outer_id) {
+        morsel.tick();
+        if (!outer.isLive(outer_id)) {
+            continue;
+        }
+        const Row& outer_row = outer_rows[outer_id];
+        bool matched = false;
+        const Value& key = outer_row.getValue(static_cast<size_t>(outer.key_column));
+
+        Value probe_key;
+        if (!key.isNull() && OrderedIndex::castKey(key, inner.key_type, probe_key)) {
+            for (size_t row_id : inner.index->find(probe_key)) {
+                if (!inner.isLive(row_id)) {
+                    continue;
+                }
+                const Row& inner_row = inner_rows[row_id];
+                Row combined = index_on_left_ ? combine(inner_row, &outer_row)
+                                              : combine(outer_row, &inner_row);
+                if (!residualMatches(combined)) {
+                    continue;
+                }
+                matched = true;
+                if (!emit(std::move(combined))) {
+                    return;
+                }
+            }
+        }
+
+        if (left_outer && !matched && !emit(combine(outer_row, nullptr))) {
+            return;
+        }
+    }
+}
+
+void JoinExecutor::runNestedLoop(const RowCallback& emit) {
+    const bool left_outer = type_ == JoinType::LEFT;
+
+    const auto& left_rows = *left_.rows;
+    const auto& right_rows = *right_.rows;
+    MorselCheck morsel;
+    for (size_t left_id = 0; left_id < left_rows.size(); ++left_id) {
+        if (!left_.isLive(left_id)) {
+            continue;
+        }
+        const Row& left_row = left_rows[left_id];
+        bool matched = false;
+        for (size_t right_id = 0; right_id < right_rows.size(); ++right_id) {
+            morsel.tick();
+            if (!right_.isLive(right_id)) {
+                continue;
+            }
+            const Row& right_row = right_rows[right_id];
+            Row combined = combine(left_row, &right_row);
+            if (!residualMatches(combined)) {
+                continue;
+            }
+            matched = true;
+            if (!emit(std::move(combined))) {
+                return;
+            }
+        }
+
+        if (left_outer && !matched && !emit(combine(left_row, nullptr))) {
+            return;
+        }
+    }
+}
+
+} // namespace tiny_sql
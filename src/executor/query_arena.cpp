@@ -0,0 +1,58 @@
+#include "tiny_sql/executor/query_arena.h"
+#include "tiny_sql/common/memory_tracker.h"
+#include <memory>
+
+namespace tiny_sql {
+
+namespace {
+
+// 上游分配器：首块之后从堆上申请的块记入当前语句的内存用量。
+// 块在语句结束后（记账作用域之外）由 reset 整体归还，此时没有当前语句，不再扣除
+class TrackedUpstream : public std::pmr::memory_resource {
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        if (MemoryTracker* tracker = memory_tracker::current()) {
+            tracker->consume(static_cast<int64_t>(bytes));
+        }
+        return p;
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        if (MemoryTracker* tracker = memory_tracker::current()) {
+            tracker->release(static_cast<int64_t>(bytes));
+        }
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+struct ArenaState {
+    alignas(std::max_align_t) std::byte initial[QueryArena::kInitialBlockSize];
+    TrackedUpstream upstream;
+    std::pmr::monotonic_buffer_resource resource{initial, sizeof(initial), &upstream};
+};
+
+// 按需创建：不执行查询的线程（如排序、聚合的工作线程）不占用首块内存
+thread_local std::unique_ptr<ArenaState> t_arena;
+
+} // namespace
+
+std::pmr::memory_resource* QueryArena::resource() {
+    if (!t_arena) {
+        t_arena = std::make_unique<ArenaState>();
+    }
+    return &t_arena->resource;
+}
+
+void QueryArena::reset() {
+    // release 归还从上游申请的块并回到首块开头，块数随用量按几何级数增长，开销可以忽略
+    if (t_arena) {
+        t_arena->resource.release();
+    }
+}
+
+} // namespace tiny_sql
@@ -0,0 +1,71 @@
+#include "tiny_sql/executor/query_profile.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace tiny_sql {
+
+OperatorProfile* QueryProfile::add(const std::string& name, double estimated_rows) {
+    operators_.emplace_back();
+    OperatorProfile* op = &operators_.back();
+    op->name = name;
+    op->estimated_rows = estimated_rows;
+    root_ = op;
+    return op;
+}
+
+OperatorProfile* QueryProfile::wrap(const std::string& name, OperatorProfile* child,
+                                    double estimated_rows) {
+    OperatorProfile* op = add(name, estimated_rows);
+    if (child) {
+        op->children.push_back(child);
+    }
+    return op;
+}
+
+uint64_t QueryProfile::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+std::vector<std::string> QueryProfile::render() const {
+    std::vector<std::string> lines;
+    if (root_) {
+        renderOperator(root_, 0, lines);
+    }
+    return lines;
+}
+
+void QueryProfile::renderOperator(const OperatorProfile* op, int depth,
+                                  std::vector<std::string>& lines) const {
+    // 格式：-> 名称  (rows=估算) (actual time=毫秒 rows_in=.. rows_out=.. ...)
+    std::string line(static_cast<size_t>(depth) * 4, ' ');
+    line += "-> " + op->name;
+
+    if (op->estimated_rows >= 0) {
+        line += "  (rows=" + std::to_string(std::llround(op->estimated_rows)) + ")";
+    }
+
+    if (analyze_) {
+        char time_buf[32];
+        std::snprintf(time_buf, sizeof(time_buf), "%.3f", static_cast<double>(op->time_ns) / 1e6);
+        line += std::string(" (actual time=") + time_buf + " ms"
+              + " rows_in=" + std::to_string(op->rows_in)
+              + " rows_out=" + std::to_string(op->rows_out);
+        if (op->filters) {
+            line += " filtered=" + std::to_string(op->rows_filtered);
+        }
+        if (op->bytes > 0) {
+            line += " bytes=" + std::to_string(op->bytes);
+        }
+        line += ")";
+    }
+
+    lines.push_back(std::move(line));
+
+    for (const OperatorProfile* child : op->children) {
+        renderOperator(child, depth + 1, lines);
+    }
+}
+
+} // namespace tiny_sql
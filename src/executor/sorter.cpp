@@ -0,0 +1,384 @@
+#include "tiny_sql/executor/sorter.h"
+#include "tiny_sql/common/logger.h"
+#include "tiny_sql/common/query_interrupt.h"
+#include "tiny_sql/common/worker_pool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <queue>
+#include <unistd.h>
+
+namespace tiny_sql {
+
+// ==================== RowComparator ====================
+
+int RowComparator::compare(const Row& a, const Row& b) const {
+    for (const auto& key : keys_) {
+        int c = a.getValue(key.column).compare(b.getValue(key.column));
+        if (c != 0) {
+            return key.ascending ? c : -c;
+        }
+    }
+    return 0;
+}
+
+// ==================== TopNHeap ====================
+
+TopNHeap::TopNHeap(std::vector<SortKey> keys, size_t limit)
+    : comparator_(std::move(keys)), limit_(limit) {
+    heap_.reserve(std::min<size_t>(limit_, 4096));
+}
+
+void TopNHeap::push(const Row& row) {
+    if (limit_ == 0) {
+        return;
+    }
+
+    // 堆未满时直接加入
+    if (heap_.size() < limit_) {
+        heap_.push_back(row);
+        std::push_heap(heap_.begin(), heap_.end(), comparator_);
+        return;
+    }
+
+    // 堆已满：只有比堆顶（当前第k名）更靠前的行才替换
+    if (comparator_(row, heap_.front())) {
+        std::pop_heap(heap_.begin(), heap_.end(), comparator_);
+        heap_.back() = row;
+        std::push_heap(heap_.begin(), heap_.end(), comparator_);
+    }
+}
+
+std::vector<Row> TopNHeap::finish() {
+    std::sort_heap(heap_.begin(), heap_.end(), comparator_);
+    return std::move(heap_);
+}
+
+// ==================== 有序段序列化 ====================
+
+// 类型标签，与 Value::ValueVariant 的下标一致
+enum : uint8_t {
+    TAG_NULL = 0,
+    TAG_INT = 1,
+    TAG_BIGINT = 2,
+    TAG_FLOAT = 3,
+    TAG_DOUBLE = 4,
+    TAG_STRING = 5,
+    TAG_BOOL = 6
+};
+
+// 辅助函数：写入定长数据
+template <typename T>
+static void writePod(FILE* fp, const T& v) {
+    if (std::fwrite(&v, sizeof(T), 1, fp) != 1) {
+        throw SortError("Failed to write sort run");
+    }
+}
+
+// 辅助函数：读取定长数据，文件结束返回false
+template <typename T>
+static bool readPod(FILE* fp, T& v) {
+    return std::fread(&v, sizeof(T), 1, fp) == 1;
+}
+
+static void writeRow(FILE* fp, const Row& row) {
+    uint32_t count = static_cast<uint32_t>(row.getColumnCount());
+    writePod(fp, count);
+
+    for (const auto& value : row.getValues()) {
+        uint8_t tag = static_cast<uint8_t>(value.getData().index());
+        writePod(fp, tag);
+
+        switch (tag) {
+            case TAG_NULL: break;
+            case TAG_INT: writePod(fp, value.asInt()); break;
+            case TAG_BIGINT: writePod(fp, value.asBigInt()); break;
+            case TAG_FLOAT: writePod(fp, value.asFloat()); break;
+            case TAG_DOUBLE: writePod(fp, value.asDouble()); break;
+            case TAG_STRING: {
+                const std::string& s = value.asString();
+                uint32_t len = static_cast<uint32_t>(s.size());
+                writePod(fp, len);
+                if (len > 0 && std::fwrite(s.data(), 1, len, fp) != len) {
+                    throw SortError("Failed to write sort run");
+                }
+                break;
+            }
+            case TAG_BOOL: writePod(fp, static_cast<uint8_t>(value.asBool())); break;
+        }
+    }
+}
+
+// 读取一行，文件结束返回false
+static bool readRow(FILE* fp, Row& row) {
+    uint32_t count;
+    if (!readPod(fp, count)) {
+        return false;
+    }
+
+    std::vector<Value> values;
+    values.reserve(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        uint8_t tag;
+        bool ok = readPod(fp, tag);
+
+        switch (tag) {
+            case TAG_NULL: values.push_back(Value::Null()); break;
+            case TAG_INT: { int32_t v; ok = ok && readPod(fp, v); values.emplace_back(v); break; }
+            case TAG_BIGINT: { int64_t v; ok = ok && readPod(fp, v); values.emplace_back(v); break; }
+            case TAG_FLOAT: { float v; ok = ok && readPod(fp, v); values.emplace_back(v); break; }
+            case TAG_DOUBLE: { double v; ok = ok && readPod(fp, v); values.emplace_back(v); break; }
+            case TAG_STRING: {
+                uint32_t len;
+                ok = ok && readPod(fp, len);
+                std::string s(ok ? len : 0, '\0');
+                ok = ok && (len == 0 || std::fread(s.data(), 1, len, fp) == len);
+                values.emplace_back(s);
+                break;
+            }
+            case TAG_BOOL: { uint8_t v; ok = ok && readPod(fp, v); values.emplace_back(v != 0); break; }
+            default: ok = false; break;
+        }
+
+        if (!ok) {
+            throw SortError("Corrupted sort run");
+        }
+    }
+
+    row = Row(values);
+    return true;
+}
+
+// ==================== ExternalSorter ====================
+
+ExternalSorter::ExternalSorter(std::vector<SortKey> keys, size_t memory_budget, const std::string& tmpdir)
+    : comparator_(std::move(keys)), memory_budget_(memory_budget), tmpdir_(tmpdir) {
+}
+
+ExternalSorter::~ExternalSorter() {
+    for (const auto& path : runs_) {
+        ::unlink(path.c_str());
+    }
+}
+
+size_t ExternalSorter::estimateRowSize(const Row& row) {
+    size_t size = sizeof(Row) + row.getColumnCount() * sizeof(Value);
+    for (const auto& value : row.getValues()) {
+        if (value.isString()) {
+            size += value.asString().capacity();
+        }
+    }
+    return size;
+}
+
+void ExternalSorter::parallelSort(std::vector<Row>& rows, const RowComparator& comparator) {
+    size_t n = rows.size();
+    auto& pool = WorkerPool::instance();
+    size_t threads = n < kParallelSortThreshold ? 1 : pool.concurrency();
+
+    if (threads <= 1) {
+        std::sort(rows.begin(), rows.end(), comparator);
+        return;
+    }
+
+    // 切分为若干块，在常驻工作线程上并行排序（任务继承中断条件，异常回到调用线程）
+    std::vector<size_t> bounds;
+    for (size_t t = 0; t <= threads; ++t) {
+        bounds.push_back(n * t / threads);
+    }
+
+    pool.run(threads, [&](size_t t) {
+        interrupt::check();
+        std::sort(rows.begin() + bounds[t], rows.begin() + bounds[t + 1], comparator);
+    });
+
+    // 相邻块两两归并，直到只剩一块；同一轮的归并互不重叠，也并行执行
+    for (size_t width = 1; width < threads; width *= 2) {
+        size_t pairs = (threads - width + 2 * width - 1) / (2 * width);
+        pool.run(pairs, [&, width](size_t p) {
+            interrupt::check();
+            size_t i = p * 2 * width;
+            size_t hi = std::min(i + 2 * width, threads);
+            std::inplace_merge(rows.begin() + bounds[i],
+                               rows.begin() + bounds[i + width],
+                               rows.begin() + bounds[hi],
+                               comparator);
+        });
+    }
+}
+
+void ExternalSorter::add(const Row& row) {
+    buffer_bytes_ += estimateRowSize(row);
+    buffer_.push_back(row);
+    buffer_memory_.set(buffer_bytes_);
+
+    if (buffer_bytes_ >= memory_budget_) {
+        spill();
+    }
+}
+
+void ExternalSorter::spill() {
+    if (buffer_.empty()) {
+        return;
+    }
+
+    interrupt::check();
+    parallelSort(buffer_, comparator_);
+
+    FILE* fp = createRun();
+    ++spilled_runs_;
+
+    try {
+        MorselCheck morsel;
+        for (const auto& row : buffer_) {
+            morsel.tick();
+            writeRow(fp, row);
+        }
+    } catch (...) {
+        std::fclose(fp);
+        throw;
+    }
+
+    if (std::fclose(fp) != 0) {
+        throw SortError("Failed to write sort run");
+    }
+
+    LOG_DEBUG("Sort spilled run #" << spilled_runs_ << " (" << buffer_.size()
+              << " rows, ~" << buffer_bytes_ << " bytes)");
+
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    buffer_bytes_ = 0;
+    buffer_memory_.set(0);
+}
+
+void ExternalSorter::finish(const RowCallback& callback) {
+    // 全部在内存中：直接排序输出
+    MorselCheck morsel;
+    if (runs_.empty()) {
+        interrupt::check();
+        parallelSort(buffer_, comparator_);
+        // 行被移交给 callback，之后由接收方记账
+        buffer_bytes_ = 0;
+        buffer_memory_.set(0);
+        for (auto& row : buffer_) {
+            morsel.tick();
+            if (!callback(std::move(row))) {
+                break;
+            }
+        }
+        buffer_.clear();
+        return;
+    }
+
+    // 剩余数据也作为一个有序段落盘，随后k路归并
+    spill();
+
+    // 段太多时先把最早（最小）的段归并成新段，只归并到恰好剩 kMaxMergeWidth 段为止
+    while (runs_.size() > kMaxMergeWidth) {
+        mergeFront(std::min(kMaxMergeWidth, runs_.size() - kMaxMergeWidth + 1));
+    }
+
+    mergeRuns(runs_, callback);
+}
+
+FILE* ExternalSorter::createRun() {
+    std::string path = tmpdir_ + "/tiny-sql-sort-XXXXXX";
+    int fd = ::mkstemp(path.data());
+    if (fd < 0) {
+        throw SortError("Can't create temporary file in '" + tmpdir_ + "': " + std::strerror(errno));
+    }
+    runs_.push_back(path);
+
+    FILE* fp = ::fdopen(fd, "wb");
+    if (!fp) {
+        ::close(fd);
+        throw SortError("Can't open sort run: " + std::string(std::strerror(errno)));
+    }
+    return fp;
+}
+
+void ExternalSorter::mergeFront(size_t width) {
+    std::vector<std::string> inputs(runs_.begin(), runs_.begin() + width);
+
+    FILE* fp = createRun();
+    try {
+        mergeRuns(inputs, [fp](Row&& row) {
+            writeRow(fp, row);
+            return true;
+        });
+    } catch (...) {
+        std::fclose(fp);
+        throw;
+    }
+    if (std::fclose(fp) != 0) {
+        throw SortError("Failed to write sort run");
+    }
+
+    for (const auto& path : inputs) {
+        ::unlink(path.c_str());
+    }
+    runs_.erase(runs_.begin(), runs_.begin() + width);
+
+    LOG_DEBUG("Sort merged " << width << " runs, " << runs_.size() << " left");
+}
+
+void ExternalSorter::mergeRuns(const std::vector<std::string>& paths, const RowCallback& callback) {
+    MorselCheck morsel;
+
+    struct RunReader {
+        FILE* fp = nullptr;
+        Row current;
+    };
+
+    std::vector<RunReader> readers(paths.size());
+    auto close_all = [&readers] {
+        for (auto& r : readers) {
+            if (r.fp) {
+                std::fclose(r.fp);
+                r.fp = nullptr;
+            }
+        }
+    };
+
+    // 堆中保存段下标，比较各段当前行；priority_queue 为最大堆，故比较取反
+    auto greater = [&](size_t a, size_t b) {
+        return comparator_(readers[b].current, readers[a].current);
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> heap(greater);
+
+    try {
+        for (size_t i = 0; i < paths.size(); ++i) {
+            readers[i].fp = std::fopen(paths[i].c_str(), "rb");
+            if (!readers[i].fp) {
+                throw SortError("Can't open sort run: " + std::string(std::strerror(errno)));
+            }
+            if (readRow(readers[i].fp, readers[i].current)) {
+                heap.push(i);
+            }
+        }
+
+        while (!heap.empty()) {
+            morsel.tick();
+            size_t i = heap.top();
+            heap.pop();
+
+            Row row = std::move(readers[i].current);
+            if (readRow(readers[i].fp, readers[i].current)) {
+                heap.push(i);
+            }
+
+            if (!callback(std::move(row))) {
+                break;
+            }
+        }
+    } catch (...) {
+        close_all();
+        throw;
+    }
+
+    close_all();
+}
+
+} // namespace tiny_sql
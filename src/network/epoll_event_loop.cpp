@@ -28,11 +28,11 @@ bool EpollEventLoop::init() {
     return true;
 }
 
-bool EpollEventLoop::addFd(int fd, uint32_t events) {
+bool EpollEventLoop::addFd(int fd, uint32_t events, uint64_t token) {
     struct epoll_event ev;
     std::memset(&ev, 0, sizeof(ev));
     ev.events = toEpollEvents(events);
-    ev.data.fd = fd;
+    ev.data.u64 = token;
 
     if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
         LOG_ERROR("epoll_ctl ADD failed for fd " << fd << ": " << strerror(errno));
@@ -43,11 +43,11 @@ bool EpollEventLoop::addFd(int fd, uint32_t events) {
     return true;
 }
 
-bool EpollEventLoop::modifyFd(int fd, uint32_t events) {
+bool EpollEventLoop::modifyFd(int fd, uint32_t events, uint64_t token) {
     struct epoll_event ev;
     std::memset(&ev, 0, sizeof(ev));
     ev.events = toEpollEvents(events);
-    ev.data.fd = fd;
+    ev.data.u64 = token;
 
     if (::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, fd, &ev) < 0) {
         LOG_ERROR("epoll_ctl MOD failed for fd " << fd << ": " << strerror(errno));
@@ -82,11 +82,11 @@ int EpollEventLoop::wait(int timeout) {
     return ready_count_;
 }
 
-int EpollEventLoop::getReadyFd(int index) const {
+uint64_t EpollEventLoop::getReadyToken(int index) const {
     if (index < 0 || index >= ready_count_) {
-        return -1;
+        return kInvalidToken;
     }
-    return events_[index].data.fd;
+    return events_[index].data.u64;
 }
 
 uint32_t EpollEventLoop::getReadyEvents(int index) const {
@@ -5,6 +5,7 @@
 #include <sys/event.h>
 #include <sys/time.h>
 #include <unistd.h>
+#include <cstdint>
 #include <cstring>
 #include <errno.h>
 
@@ -29,37 +30,37 @@ bool KqueueEventLoop::init() {
     return true;
 }
 
-bool KqueueEventLoop::addFd(int fd, uint32_t events) {
-    if (!updateEvents(fd, events, true)) {
+bool KqueueEventLoop::addFd(int fd, uint32_t events, uint64_t token) {
+    if (!updateEvents(fd, events, true, token)) {
         return false;
     }
-    fd_events_[fd] = events;
+    fd_events_[fd] = {events, token};
     LOG_DEBUG("Added fd " << fd << " to kqueue with events " << events);
     return true;
 }
 
-bool KqueueEventLoop::modifyFd(int fd, uint32_t events) {
+bool KqueueEventLoop::modifyFd(int fd, uint32_t events, uint64_t token) {
     auto it = fd_events_.find(fd);
     if (it == fd_events_.end()) {
         LOG_ERROR("Cannot modify fd " << fd << " that is not in kqueue");
         return false;
     }
 
-    uint32_t old_events = it->second;
+    auto [old_events, old_token] = it->second;
 
     // 先删除旧事件
-    if (!updateEvents(fd, old_events, false)) {
+    if (!updateEvents(fd, old_events, false, old_token)) {
         return false;
     }
 
     // 添加新事件
-    if (!updateEvents(fd, events, true)) {
+    if (!updateEvents(fd, events, true, token)) {
         // 如果失败，尝试恢复旧事件
-        updateEvents(fd, old_events, true);
+        updateEvents(fd, old_events, true, old_token);
         return false;
     }
 
-    fd_events_[fd] = events;
+    fd_events_[fd] = {events, token};
     LOG_DEBUG("Modified fd " << fd << " in kqueue with events " << events);
     return true;
 }
@@ -70,7 +71,7 @@ bool KqueueEventLoop::removeFd(int fd) {
         return true;  // 已经不存在
     }
 
-    if (!updateEvents(fd, it->second, false)) {
+    if (!updateEvents(fd, it->second.first, false, it->second.second)) {
         return false;
     }
 
@@ -103,11 +104,11 @@ int KqueueEventLoop::wait(int timeout) {
     return ready_count_;
 }
 
-int KqueueEventLoop::getReadyFd(int index) const {
+uint64_t KqueueEventLoop::getReadyToken(int index) const {
     if (index < 0 || index >= ready_count_) {
-        return -1;
+        return kInvalidToken;
     }
-    return static_cast<int>(events_[index].ident);
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(events_[index].udata));
 }
 
 uint32_t KqueueEventLoop::getReadyEvents(int index) const {
@@ -143,7 +144,10 @@ void KqueueEventLoop::close() {
     }
 }
 
-bool KqueueEventLoop::updateEvents(int fd, uint32_t events, bool enable) {
+bool KqueueEventLoop::updateEvents(int fd, uint32_t events, bool enable, uint64_t token) {
+    // token 放在 udata 中随事件返回
+    void* udata = reinterpret_cast<void*>(static_cast<uintptr_t>(token));
+
     struct kevent changes[2];
     int n_changes = 0;
 
@@ -151,7 +155,7 @@ bool KqueueEventLoop::updateEvents(int fd, uint32_t events, bool enable) {
     if (events & static_cast<uint32_t>(EventType::READ)) {
         EV_SET(&changes[n_changes], fd, EVFILT_READ,
                enable ? EV_ADD | EV_CLEAR : EV_DELETE,
-               0, 0, nullptr);
+               0, 0, udata);
         n_changes++;
     }
 
@@ -159,7 +163,7 @@ bool KqueueEventLoop::updateEvents(int fd, uint32_t events, bool enable) {
     if (events & static_cast<uint32_t>(EventType::WRITE)) {
         EV_SET(&changes[n_changes], fd, EVFILT_WRITE,
                enable ? EV_ADD | EV_CLEAR : EV_DELETE,
-               0, 0, nullptr);
+               0, 0, udata);
         n_changes++;
     }
 
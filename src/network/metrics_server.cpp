@@ -0,0 +1,181 @@
+#include "tiny_sql/network/metrics_server.h"
+#include "tiny_sql/network/socket_utils.h"
+#include "tiny_sql/common/metrics.h"
+#include "tiny_sql/common/logger.h"
+#include "tiny_sql/session/process_list.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace tiny_sql {
+
+namespace {
+
+// 轮询间隔：stop() 最多等待这么久
+constexpr int kPollIntervalMs = 200;
+
+// 单个请求的读超时
+constexpr int kRequestTimeoutMs = 1000;
+
+void writeAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return;
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+// 查询串中的参数值（不存在时返回空串）
+std::string queryParam(const std::string& query, const std::string& name) {
+    size_t pos = 0;
+    while (pos < query.size()) {
+        size_t end = query.find('&', pos);
+        if (end == std::string::npos) {
+            end = query.size();
+        }
+        std::string pair = query.substr(pos, end - pos);
+        size_t eq = pair.find('=');
+        if (pair.substr(0, eq) == name) {
+            return eq == std::string::npos ? "" : pair.substr(eq + 1);
+        }
+        pos = end + 1;
+    }
+    return "";
+}
+
+// 进程列表的文本形式，每行一个连接，字段以制表符分隔
+std::string renderProcessList() {
+    std::string body = "Id\tUser\tHost\tdb\tCommand\tTime\tState\tInfo\n";
+    for (const auto& process : ProcessList::instance().snapshot()) {
+        body += std::to_string(process.id) + "\t" + process.user + "\t" + process.host + "\t" +
+                process.db + "\t" + process.command + "\t" + std::to_string(process.time) + "\t" +
+                process.state + "\t" + process.info + "\n";
+    }
+    return body;
+}
+
+} // namespace
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start() {
+    listen_fd_ = SocketUtils::createListenSocket(port_, 16, true);
+    if (listen_fd_ < 0) {
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&MetricsServer::run, this);
+    LOG_INFO("Metrics endpoint listening on 127.0.0.1:" << port_);
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    SocketUtils::closeSocket(listen_fd_);
+    listen_fd_ = -1;
+}
+
+void MetricsServer::run() {
+    while (running_) {
+        struct pollfd pfd = {listen_fd_, POLLIN, 0};
+        int n = ::poll(&pfd, 1, kPollIntervalMs);
+        if (n <= 0) {
+            continue;
+        }
+
+        std::string peer_addr;
+        int fd = SocketUtils::acceptConnection(listen_fd_, peer_addr);
+        if (fd < 0) {
+            continue;
+        }
+        handleClient(fd);
+        SocketUtils::closeSocket(fd);
+    }
+}
+
+void MetricsServer::handleClient(int fd) {
+    // 读取请求头（只需要请求行）
+    std::string request;
+    char buf[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        if (::poll(&pfd, 1, kRequestTimeoutMs) <= 0) {
+            return;
+        }
+        ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            return;
+        }
+        request.append(buf, static_cast<size_t>(n));
+    }
+
+    // 请求行：GET /metrics HTTP/1.1
+    size_t line_end = request.find("\r\n");
+    std::string line = request.substr(0, line_end);
+    size_t sp1 = line.find(' ');
+    size_t sp2 = sp1 == std::string::npos ? std::string::npos : line.find(' ', sp1 + 1);
+    std::string method = line.substr(0, sp1);
+    std::string path = sp1 == std::string::npos ? "" : line.substr(sp1 + 1, sp2 - sp1 - 1);
+    std::string query;
+    size_t question = path.find('?');
+    if (question != std::string::npos) {
+        query = path.substr(question + 1);
+        path.resize(question);
+    }
+
+    std::string status = "200 OK";
+    std::string body;
+    if (method != "GET") {
+        status = "405 Method Not Allowed";
+        body = "Method not allowed\n";
+    } else if (path == "/metrics" || path == "/") {
+        body = MetricsRegistry::instance().renderPrometheus();
+    } else if (path == "/processlist") {
+        body = renderProcessList();
+    } else if (path == "/kill") {
+        // 事件循环阻塞在长查询里时 SQL 的 KILL 发不进来，这里只设置终止标记：
+        // 正在执行的语句在下一个检查点中断，空闲连接在下一条命令时关闭
+        std::string id = queryParam(query, "id");
+        char* end = nullptr;
+        unsigned long value = std::strtoul(id.c_str(), &end, 10);
+        if (id.empty() || *end != '\0') {
+            status = "400 Bad Request";
+            body = "Missing or invalid id\n";
+        } else {
+            bool query_only = queryParam(query, "query") == "1";
+            auto result = ProcessList::instance().kill(static_cast<uint32_t>(value), query_only);
+            if (result == ProcessList::KillResult::NOT_FOUND) {
+                status = "404 Not Found";
+                body = "Unknown thread id: " + id + "\n";
+            } else {
+                body = "OK\n";
+            }
+        }
+    } else {
+        status = "404 Not Found";
+        body = "Not found\n";
+    }
+
+    std::string response = "HTTP/1.0 " + status + "\r\n"
+                           "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n\r\n" + body;
+    writeAll(fd, response);
+}
+
+} // namespace tiny_sql
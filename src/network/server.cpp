@@ -1,7 +1,11 @@
 #include "tiny_sql/network/server.h"
 #include "tiny_sql/network/socket_utils.h"
 #include "tiny_sql/common/logger.h"
+#include "tiny_sql/common/metrics.h"
+#include <fcntl.h>
 #include <unistd.h>
+#include <algorithm>
+#include <vector>
 
 namespace tiny_sql {
 
@@ -14,6 +18,7 @@ Server::Server(uint16_t port, int max_connections)
 
 Server::~Server() {
     stop();
+    shutdown();
 }
 
 void Server::start() {
@@ -28,6 +33,7 @@ void Server::start() {
     if (!SocketUtils::setNonBlocking(listen_fd_)) {
         LOG_FATAL("Failed to set listen socket non-blocking");
         SocketUtils::closeSocket(listen_fd_);
+        listen_fd_ = -1;
         return;
     }
 
@@ -35,6 +41,7 @@ void Server::start() {
     if (!event_loop_->init()) {
         LOG_FATAL("Failed to initialize event loop");
         SocketUtils::closeSocket(listen_fd_);
+        listen_fd_ = -1;
         return;
     }
 
@@ -43,29 +50,76 @@ void Server::start() {
         LOG_FATAL("Failed to add listen socket to event loop");
         event_loop_->close();
         SocketUtils::closeSocket(listen_fd_);
+        listen_fd_ = -1;
         return;
     }
 
+    if (!initWakeup()) {
+        LOG_FATAL("Failed to create wakeup pipe");
+        shutdown();
+        return;
+    }
+
+    // 本机客户端走 Unix 域 socket，省去 TCP 协议栈
+    if (!unix_socket_path_.empty()) {
+        unix_listen_fd_ = SocketUtils::createUnixListenSocket(unix_socket_path_);
+        if (unix_listen_fd_ < 0 || !SocketUtils::setNonBlocking(unix_listen_fd_) ||
+            !event_loop_->addFd(unix_listen_fd_, static_cast<uint32_t>(EventType::READ))) {
+            LOG_FATAL("Failed to listen on unix socket " << unix_socket_path_);
+            shutdown();
+            return;
+        }
+    }
+
     running_ = true;
     LOG_INFO("Tiny-SQL server started on port " << port_);
 
     // 进入事件循环
     eventLoop();
+    shutdown();
 }
 
-void Server::stop() {
-    if (!running_) {
+void Server::stop(int signum) {
+    if (!running_.exchange(false)) {
         return;
     }
 
-    running_ = false;
-    LOG_INFO("Stopping server...");
+    // 可能在信号处理函数中：不加锁、不分配内存、不写日志，连接由事件循环退出后的
+    // shutdown 释放。信号可能落在其他线程上，因此写管道唤醒阻塞在 wait 中的事件循环
+    stop_signal_.store(signum);
+    if (wakeup_fds_[1] >= 0) {
+        ssize_t n = ::write(wakeup_fds_[1], "x", 1);
+        (void)n;
+    }
+}
+
+bool Server::initWakeup() {
+    if (::pipe(wakeup_fds_) != 0) {
+        wakeup_fds_[0] = wakeup_fds_[1] = -1;
+        return false;
+    }
+    for (int fd : wakeup_fds_) {
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        SocketUtils::setNonBlocking(fd);
+    }
+    return event_loop_->addFd(wakeup_fds_[0], static_cast<uint32_t>(EventType::READ));
+}
+
+void Server::shutdown() {
+    if (listen_fd_ < 0 && unix_listen_fd_ < 0 && wakeup_fds_[0] < 0 && slots_.empty()) {
+        return;
+    }
 
     // 关闭所有连接
-    for (auto& pair : connections_) {
-        pair.second->forceClose();
+    for (auto& slot : slots_) {
+        if (slot.conn) {
+            slot.conn->forceClose();
+        }
     }
-    connections_.clear();
+    ServerMetrics::instance().threads_connected.sub(static_cast<int64_t>(connection_count_));
+    slots_.clear();
+    closed_.clear();
+    connection_count_ = 0;
 
     // 关闭事件循环
     if (event_loop_) {
@@ -77,13 +131,25 @@ void Server::stop() {
         SocketUtils::closeSocket(listen_fd_);
         listen_fd_ = -1;
     }
+    if (unix_listen_fd_ >= 0) {
+        SocketUtils::closeSocket(unix_listen_fd_);
+        unix_listen_fd_ = -1;
+        ::unlink(unix_socket_path_.c_str());
+    }
+    for (int& fd : wakeup_fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
 
     LOG_INFO("Server stopped");
 }
 
 void Server::eventLoop() {
     while (running_) {
-        int n = event_loop_->wait(-1);
+        // 没有定时器时一直等待，否则最多等到最近的定时器到期
+        int n = event_loop_->wait(timers_.nextTimeoutMs());
 
         if (n < 0) {
             LOG_ERROR("Event loop wait error");
@@ -91,42 +157,56 @@ void Server::eventLoop() {
         }
 
         for (int i = 0; i < n; i++) {
-            int fd = event_loop_->getReadyFd(i);
+            uint64_t token = event_loop_->getReadyToken(i);
             uint32_t events = event_loop_->getReadyEvents(i);
 
-            if (fd == listen_fd_) {
+            int fd = static_cast<int>(static_cast<uint32_t>(token));
+            if (fd == listen_fd_ || (unix_listen_fd_ >= 0 && fd == unix_listen_fd_)) {
                 // 新连接
-                handleAccept();
+                handleAccept(fd);
+            } else if (fd == wakeup_fds_[0]) {
+                // stop() 的唤醒，循环条件会让事件循环退出
+                char drain[64];
+                while (::read(fd, drain, sizeof(drain)) > 0) {
+                }
             } else {
                 // 客户端连接的事件
-                if (events & (static_cast<uint32_t>(EventType::ERROR) |
-                             static_cast<uint32_t>(EventType::CLOSE))) {
-                    // 错误或关闭
-                    handleClose(fd);
-                } else if (events & static_cast<uint32_t>(EventType::READ)) {
-                    // 可读
-                    handleRead(fd);
-                } else if (events & static_cast<uint32_t>(EventType::WRITE)) {
-                    // 可写
-                    handleWrite(fd);
-                }
+                handleEvents(token, events);
             }
         }
+
+        // 到期的定时器（握手/空闲超时、后台维护）
+        timers_.advance();
+
+        if (max_output_memory_ > 0 &&
+            ServerMetrics::instance().output_buffer_bytes.value() >
+                static_cast<int64_t>(max_output_memory_)) {
+            shedSlowConsumers();
+        }
+
+        // 本轮关闭的连接和它们的协议处理器到这里才析构
+        closed_.clear();
     }
+
+    if (int signum = stop_signal_.load(); signum != 0) {
+        LOG_INFO("Received signal " << signum);
+    }
+    LOG_INFO("Stopping server...");
 }
 
-void Server::handleAccept() {
+void Server::handleAccept(int listen_fd) {
     while (true) {
         std::string peer_addr;
-        int conn_fd = SocketUtils::acceptConnection(listen_fd_, peer_addr);
+        int conn_fd = SocketUtils::acceptConnection(listen_fd, peer_addr);
 
         if (conn_fd < 0) {
             break;  // 没有更多连接
         }
 
         // 检查连接数限制
-        if (static_cast<int>(connections_.size()) >= max_connections_) {
+        if (static_cast<int>(connection_count_) >= max_connections_) {
             LOG_WARN("Max connections reached, rejecting connection from " << peer_addr);
+            ServerMetrics::instance().aborted_connects.add();
             SocketUtils::closeSocket(conn_fd);
             continue;
         }
@@ -138,8 +218,10 @@ void Server::handleAccept() {
             continue;
         }
 
-        // 设置TCP_NODELAY
-        SocketUtils::setTcpNoDelay(conn_fd);
+        // 设置TCP_NODELAY（Unix 域 socket 没有这个选项）
+        if (listen_fd == listen_fd_) {
+            SocketUtils::setTcpNoDelay(conn_fd);
+        }
 
         // 创建TcpConnection
         auto conn = std::make_shared<TcpConnection>(conn_fd, peer_addr);
@@ -153,15 +235,30 @@ void Server::handleAccept() {
             }
         });
 
+        // 占用 fd 对应的槽，新的代号让之前使用这个 fd 的连接残留的事件失效
+        if (static_cast<size_t>(conn_fd) >= slots_.size()) {
+            slots_.resize(std::max<size_t>(static_cast<size_t>(conn_fd) + 1, slots_.size() * 2));
+        }
+        ConnectionSlot& slot = slots_[conn_fd];
+        ++slot.generation;
+        const uint64_t token = (static_cast<uint64_t>(slot.generation) << 32) |
+                               static_cast<uint32_t>(conn_fd);
+
         // 添加到事件循环
-        if (!event_loop_->addFd(conn_fd, static_cast<uint32_t>(EventType::READ))) {
+        if (!event_loop_->addFd(conn_fd, static_cast<uint32_t>(EventType::READ), token)) {
             LOG_ERROR("Failed to add connection to event loop");
             conn->forceClose();
             continue;
         }
+        conn->setEventLoop(event_loop_.get(), static_cast<uint32_t>(EventType::READ), token);
+        conn->setHighWaterMark(high_water_mark_);
+        conn->setTimerWheel(&timers_);
 
         // 保存连接
-        connections_[conn_fd] = conn;
+        slot.conn = conn;
+        ++connection_count_;
+        ServerMetrics::instance().connections.add();
+        ServerMetrics::instance().threads_connected.add();
 
         // 调用连接回调
         if (connection_callback_) {
@@ -172,44 +269,92 @@ void Server::handleAccept() {
     }
 }
 
-void Server::handleRead(int fd) {
-    auto it = connections_.find(fd);
-    if (it == connections_.end()) {
+void Server::setContext(TcpConnection& conn, std::shared_ptr<void> context) {
+    int fd = conn.getFd();
+    if (fd < 0 || static_cast<size_t>(fd) >= slots_.size() || slots_[fd].conn.get() != &conn) {
         LOG_WARN("Connection not found for fd " << fd);
         return;
     }
-
-    auto conn = it->second;
-    conn->handleRead();
+    conn.setContext(context.get());
+    slots_[fd].context = std::move(context);
 }
 
-void Server::handleWrite(int fd) {
-    auto it = connections_.find(fd);
-    if (it == connections_.end()) {
-        LOG_WARN("Connection not found for fd " << fd);
+void Server::handleEvents(uint64_t token, uint32_t events) {
+    const uint32_t fd = static_cast<uint32_t>(token);
+    const uint32_t generation = static_cast<uint32_t>(token >> 32);
+
+    // 连接已在本轮关闭，或 fd 已被新连接复用：丢弃残留的事件
+    if (fd >= slots_.size() || !slots_[fd].conn || slots_[fd].generation != generation) {
         return;
     }
 
-    auto conn = it->second;
-    conn->handleWrite();
+    // 关闭的连接要到本轮结束才释放，裸指针在整个处理过程中有效
+    // （处理过程中可能接受新连接使 slots_ 扩容，不能持有槽的引用）
+    TcpConnection* conn = slots_[fd].conn.get();
 
-    // 如果输出缓冲区为空,只监听读事件
-    if (conn->getOutputBuffer().readableBytes() == 0) {
-        event_loop_->modifyFd(fd, static_cast<uint32_t>(EventType::READ));
+    if (events & (static_cast<uint32_t>(EventType::ERROR) |
+                  static_cast<uint32_t>(EventType::CLOSE))) {
+        // 错误或关闭
+        conn->handleClose();
+        return;
+    }
+
+    // 同一次通知可能既可写又可读：先写出积压，可能因此恢复读取
+    // 写完积压后连接自己取消可写事件
+    if (events & static_cast<uint32_t>(EventType::WRITE)) {
+        conn->handleWrite();
+    }
+    // 写出错时连接已被关闭
+    if ((events & static_cast<uint32_t>(EventType::READ)) && conn->isConnected()) {
+        conn->handleRead();
     }
 }
 
 void Server::handleClose(int fd) {
-    auto it = connections_.find(fd);
-    if (it == connections_.end()) {
+    if (fd < 0 || static_cast<size_t>(fd) >= slots_.size() || !slots_[fd].conn) {
         return;
     }
 
     LOG_DEBUG("Closing connection (fd=" << fd << ")");
 
-    auto conn = it->second;
+    // 连接对象可能正在调用栈上（如在 handleRead 中关闭），移到 closed_ 推迟释放
+    ConnectionSlot& slot = slots_[fd];
     event_loop_->removeFd(fd);
-    connections_.erase(it);
+    closed_.push_back({std::move(slot.conn), std::move(slot.context), slot.generation});
+    slot.conn.reset();
+    slot.context.reset();
+    --connection_count_;
+    ServerMetrics::instance().threads_connected.sub();
+}
+
+void Server::shedSlowConsumers() {
+    std::vector<TcpConnection*> backlogged;
+    for (const auto& slot : slots_) {
+        if (slot.conn && slot.conn->pendingSinceNs() != 0) {
+            backlogged.push_back(slot.conn.get());
+        }
+    }
+
+    // 积压最久的连接读得最慢，先断开；同时开始积压的先断开积压多的
+    std::sort(backlogged.begin(), backlogged.end(),
+              [](TcpConnection* a, TcpConnection* b) {
+                  if (a->pendingSinceNs() != b->pendingSinceNs()) {
+                      return a->pendingSinceNs() < b->pendingSinceNs();
+                  }
+                  return a->getOutputBuffer().readableBytes() > b->getOutputBuffer().readableBytes();
+              });
+
+    auto& metrics = ServerMetrics::instance();
+    for (TcpConnection* conn : backlogged) {
+        if (metrics.output_buffer_bytes.value() <= static_cast<int64_t>(max_output_memory_)) {
+            break;
+        }
+        LOG_WARN("Output memory " << metrics.output_buffer_bytes.value() << " bytes exceeds limit "
+                 << max_output_memory_ << ", closing slow client " << conn->getPeerAddr()
+                 << " with " << conn->getOutputBuffer().readableBytes() << " bytes pending");
+        metrics.aborted_slow_clients.add();
+        conn->handleClose();
+    }
 }
 
 } // namespace tiny_sql
@@ -2,6 +2,8 @@
 #include "tiny_sql/common/logger.h"
 
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
@@ -12,7 +14,22 @@
 
 namespace tiny_sql {
 
-int SocketUtils::createListenSocket(uint16_t port, int backlog) {
+// 辅助函数：格式化 socket 地址（IPv4 为 ip:port，Unix 域为 localhost）
+static std::string formatAddress(const struct sockaddr_storage& addr) {
+    if (addr.ss_family == AF_UNIX) {
+        return "localhost";
+    }
+    if (addr.ss_family != AF_INET) {
+        return "unknown";
+    }
+
+    const auto& in = reinterpret_cast<const struct sockaddr_in&>(addr);
+    char ip[INET_ADDRSTRLEN];
+    ::inet_ntop(AF_INET, &in.sin_addr, ip, sizeof(ip));
+    return std::string(ip) + ":" + std::to_string(ntohs(in.sin_port));
+}
+
+int SocketUtils::createListenSocket(uint16_t port, int backlog, bool loopback_only) {
     int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
     if (listen_fd < 0) {
         LOG_ERROR("Failed to create socket: " << strerror(errno));
@@ -29,7 +46,7 @@ int SocketUtils::createListenSocket(uint16_t port, int backlog) {
     struct sockaddr_in addr;
     std::memset(&addr, 0, sizeof(addr));
     addr.sin_family = AF_INET;
-    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_addr.s_addr = htonl(loopback_only ? INADDR_LOOPBACK : INADDR_ANY);
     addr.sin_port = htons(port);
 
     if (::bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
@@ -49,6 +66,60 @@ int SocketUtils::createListenSocket(uint16_t port, int backlog) {
     return listen_fd;
 }
 
+int SocketUtils::createUnixListenSocket(const std::string& path, int backlog) {
+    struct sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        LOG_ERROR("Invalid unix socket path: " << path);
+        return -1;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size());
+
+    // 上次异常退出残留的 socket 文件：能连上说明还有服务器在用，否则删除
+    struct stat st;
+    if (::lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            LOG_ERROR("Unix socket path exists and is not a socket: " << path);
+            return -1;
+        }
+        int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        bool in_use = probe >= 0 &&
+                      ::connect(probe, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0;
+        closeSocket(probe);
+        if (in_use) {
+            LOG_ERROR("Another server is already listening on " << path);
+            return -1;
+        }
+        ::unlink(path.c_str());
+    }
+
+    int listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        LOG_ERROR("Failed to create unix socket: " << strerror(errno));
+        return -1;
+    }
+
+    if (::bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        LOG_ERROR("Failed to bind " << path << ": " << strerror(errno));
+        closeSocket(listen_fd);
+        return -1;
+    }
+
+    // 和 mysqld 一样允许本机所有用户连接，权限由账号认证控制
+    ::chmod(path.c_str(), 0777);
+
+    if (::listen(listen_fd, backlog) < 0) {
+        LOG_ERROR("Failed to listen: " << strerror(errno));
+        closeSocket(listen_fd);
+        ::unlink(path.c_str());
+        return -1;
+    }
+
+    LOG_INFO("Listening on unix socket " << path);
+    return listen_fd;
+}
+
 bool SocketUtils::setNonBlocking(int fd) {
     int flags = ::fcntl(fd, F_GETFL, 0);
     if (flags < 0) {
@@ -107,35 +178,29 @@ void SocketUtils::closeSocket(int fd) {
 }
 
 std::string SocketUtils::getPeerAddress(int fd) {
-    struct sockaddr_in addr;
+    struct sockaddr_storage addr;
     socklen_t addr_len = sizeof(addr);
 
     if (::getpeername(fd, reinterpret_cast<struct sockaddr*>(&addr), &addr_len) < 0) {
         return "unknown";
     }
 
-    char ip[INET_ADDRSTRLEN];
-    ::inet_ntop(AF_INET, &addr.sin_addr, ip, sizeof(ip));
-
-    return std::string(ip) + ":" + std::to_string(ntohs(addr.sin_port));
+    return formatAddress(addr);
 }
 
 std::string SocketUtils::getLocalAddress(int fd) {
-    struct sockaddr_in addr;
+    struct sockaddr_storage addr;
     socklen_t addr_len = sizeof(addr);
 
     if (::getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addr_len) < 0) {
         return "unknown";
     }
 
-    char ip[INET_ADDRSTRLEN];
-    ::inet_ntop(AF_INET, &addr.sin_addr, ip, sizeof(ip));
-
-    return std::string(ip) + ":" + std::to_string(ntohs(addr.sin_port));
+    return formatAddress(addr);
 }
 
 int SocketUtils::acceptConnection(int listen_fd, std::string& peer_addr) {
-    struct sockaddr_in addr;
+    struct sockaddr_storage addr;
     socklen_t addr_len = sizeof(addr);
 
     int conn_fd = ::accept(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), &addr_len);
@@ -146,10 +211,7 @@ int SocketUtils::acceptConnection(int listen_fd, std::string& peer_addr) {
         return -1;
     }
 
-    char ip[INET_ADDRSTRLEN];
-    ::inet_ntop(AF_INET, &addr.sin_addr, ip, sizeof(ip));
-    peer_addr = std::string(ip) + ":" + std::to_string(ntohs(addr.sin_port));
-
+    peer_addr = formatAddress(addr);
     return conn_fd;
 }
 
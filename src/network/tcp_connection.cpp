@@ -1,6 +1,8 @@
 #include "tiny_sql/network/tcp_connection.h"
 #include "tiny_sql/network/socket_utils.h"
+#include "tiny_sql/network/event_loop.h"
 #include "tiny_sql/common/logger.h"
+#include "tiny_sql/common/metrics.h"
 
 #include <sys/socket.h>
 #include <unistd.h>
@@ -46,6 +48,13 @@ ssize_t TcpConnection::send(const void* data, size_t len) {
         return -1;
     }
 
+    // 还有未写完的数据时直接排队，不能越过它先写
+    if (!output_buffer_.empty()) {
+        output_buffer_.append(static_cast<const uint8_t*>(data), len);
+        updateOutputState();
+        return 0;
+    }
+
     // 尝试直接发送
     ssize_t n = ::write(fd_, data, len);
     if (n < 0) {
@@ -54,16 +63,18 @@ ssize_t TcpConnection::send(const void* data, size_t len) {
             return -1;
         }
         // EAGAIN, 写入输出缓冲区
-        output_buffer_.writeBytes(static_cast<const uint8_t*>(data), len);
+        output_buffer_.append(static_cast<const uint8_t*>(data), len);
+        updateOutputState();
         return 0;
     }
 
     // 部分发送成功
     if (static_cast<size_t>(n) < len) {
-        output_buffer_.writeBytes(
+        output_buffer_.append(
             static_cast<const uint8_t*>(data) + n,
             len - n
         );
+        updateOutputState();
     }
 
     return n;
@@ -74,8 +85,72 @@ ssize_t TcpConnection::send(const std::string& data) {
 }
 
 ssize_t TcpConnection::send(const Buffer& buffer) {
-    const auto& data = buffer.data();
-    return send(data.data(), data.size());
+    return send(buffer.peek(), buffer.readableBytes());
+}
+
+void TcpConnection::queue(Buffer&& buffer) {
+    if (connected_) {
+        output_buffer_.append(std::move(buffer));
+    }
+}
+
+ssize_t TcpConnection::flush() {
+    if (!connected_) {
+        return -1;
+    }
+
+    ssize_t total = 0;
+    while (!output_buffer_.empty()) {
+        ssize_t n = output_buffer_.writeToFd(fd_);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                LOG_ERROR("Write error to " << peer_addr_ << ": " << strerror(errno));
+                return -1;
+            }
+            break;  // EAGAIN，剩余部分等待可写事件
+        }
+        total += n;
+    }
+    updateOutputState();
+    return total;
+}
+
+bool TcpConnection::updateOutputState() {
+    size_t pending = output_buffer_.readableBytes();
+
+    // 只有积压量变化时才更新全局统计（大多数命令在 flush 中一次写完，不产生积压）
+    if (pending != accounted_output_) {
+        auto& gauge = ServerMetrics::instance().output_buffer_bytes;
+        gauge.add(static_cast<int64_t>(pending) - static_cast<int64_t>(accounted_output_));
+        accounted_output_ = pending;
+    }
+    if (pending == 0) {
+        pending_since_ns_ = 0;
+    } else if (pending_since_ns_ == 0) {
+        pending_since_ns_ = metrics::nowNs();
+    }
+
+    // 高水位以上暂停读取新命令，降到一半以下恢复
+    bool resumed = false;
+    if (high_water_mark_ > 0) {
+        if (!reading_paused_ && pending >= high_water_mark_) {
+            reading_paused_ = true;
+            LOG_DEBUG("Output backlog " << pending << " bytes, pausing reads from " << peer_addr_);
+        } else if (reading_paused_ && pending <= high_water_mark_ / 2) {
+            reading_paused_ = false;
+            resumed = true;
+        }
+    }
+
+    // 有积压时关注可写事件；暂停期间不关注可读事件
+    uint32_t interest = (reading_paused_ ? 0 : static_cast<uint32_t>(EventType::READ)) |
+                        (pending > 0 ? static_cast<uint32_t>(EventType::WRITE) : 0);
+    if (loop_ && connected_ && interest != interest_) {
+        if (loop_->modifyFd(fd_, interest, token_)) {
+            interest_ = interest;
+        }
+    }
+    return resumed;
 }
 
 void TcpConnection::close() {
@@ -85,6 +160,10 @@ void TcpConnection::close() {
 
     connected_ = false;
     LOG_INFO("Closing connection to " << peer_addr_);
+
+    // 丢弃未发送的数据并从全局积压中扣除
+    output_buffer_.clear();
+    updateOutputState();
     SocketUtils::closeSocket(fd_);
     fd_ = -1;
 }
@@ -94,15 +173,33 @@ void TcpConnection::forceClose() {
 }
 
 void TcpConnection::handleRead() {
-    ssize_t n = read();
-    if (n < 0) {
-        handleClose();
+    // 输出积压期间不读新命令，恢复时由 handleWrite 重新调用
+    if (reading_paused_) {
         return;
     }
 
-    if (n > 0 && message_callback_) {
-        message_callback_(shared_from_this(), input_buffer_);
+    // 边缘触发：必须读到 EAGAIN，否则一次读不完的大包（如多行 INSERT）会一直留在内核里
+    ssize_t total = 0;
+    while (true) {
+        ssize_t n = read();
+        if (n < 0) {
+            handleClose();
+            return;
+        }
+        if (n == 0) {
+            break;
+        }
+        total += n;
     }
+
+    // 从暂停中恢复时可能没有读到新数据，但输入缓冲区（或上层解压后的缓冲区）里
+    // 还有未处理的命令，因此总是交给上层
+    if (message_callback_) {
+        message_callback_(*this, input_buffer_);
+    }
+
+    // 命令处理完后压缩输入缓冲区；读空时存储还给池，空闲连接不占缓冲区内存
+    input_buffer_.shrink();
 }
 
 void TcpConnection::handleWrite() {
@@ -110,23 +207,25 @@ void TcpConnection::handleWrite() {
         return;
     }
 
-    ssize_t n = output_buffer_.writeToFd(fd_);
-    if (n < 0) {
-        if (errno != EAGAIN && errno != EWOULDBLOCK) {
-            LOG_ERROR("Write error to " << peer_addr_ << ": " << strerror(errno));
-            handleError();
-            return;
-        }
+    bool was_paused = reading_paused_;
+    if (flush() < 0) {
+        handleError();
+        return;
     }
 
-    if (output_buffer_.readableBytes() == 0 && write_complete_callback_) {
+    if (output_buffer_.empty() && write_complete_callback_) {
         write_complete_callback_(shared_from_this());
     }
+
+    // 积压降到高水位一半以下：继续处理暂停期间到达的命令
+    if (was_paused && !reading_paused_ && connected_) {
+        handleRead();
+    }
 }
 
 void TcpConnection::handleClose() {
     if (connected_) {
-        connected_ = false;
+        // 先通知上层清理（fd 仍有效，可以从事件循环中移除），再关闭 socket
         if (close_callback_) {
             close_callback_(shared_from_this());
         }
@@ -0,0 +1,247 @@
+#include "tiny_sql/network/timer_wheel.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+namespace tiny_sql {
+
+namespace {
+
+// 正在执行的槽（已从轮上摘下）用的层号
+constexpr uint8_t kDetachedLevel = 0xFF;
+
+uint64_t nowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+TimerWheel::TimerWheel(uint32_t tick_ms)
+    : tick_ms_(std::max<uint32_t>(tick_ms, 1)), start_ms_(nowMs()) {
+    for (auto& level : heads_) {
+        level.fill(kNil);
+    }
+}
+
+uint64_t TimerWheel::clockTick() const {
+    return (nowMs() - start_ms_) / tick_ms_;
+}
+
+TimerWheel::TimerId TimerWheel::schedule(uint64_t delay_ms, Callback callback) {
+    uint64_t ticks = (delay_ms + tick_ms_ - 1) / tick_ms_;
+    return add(clockTick() + std::max<uint64_t>(ticks, 1), 0, std::move(callback));
+}
+
+TimerWheel::TimerId TimerWheel::scheduleEvery(uint64_t interval_ms, Callback callback) {
+    uint64_t ticks = std::max<uint64_t>((interval_ms + tick_ms_ - 1) / tick_ms_, 1);
+    return add(clockTick() + ticks, ticks, std::move(callback));
+}
+
+TimerWheel::TimerId TimerWheel::add(uint64_t expire, uint64_t interval, Callback callback) {
+    uint32_t index;
+    if (!free_nodes_.empty()) {
+        index = free_nodes_.back();
+        free_nodes_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    Node& node = nodes_[index];
+    node.expire = expire;
+    node.interval = interval;
+    node.callback = std::move(callback);
+    node.state = State::PENDING;
+    node.cancelled = false;
+    link(index);
+    ++size_;
+
+    return (static_cast<uint64_t>(node.generation) << 32) | index;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    uint32_t index = static_cast<uint32_t>(id & 0xFFFFFFFF);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+    if (index >= nodes_.size() || nodes_[index].generation != generation) {
+        return false;
+    }
+
+    Node& node = nodes_[index];
+    switch (node.state) {
+        case State::PENDING:
+            unlink(index);
+            freeNode(index);
+            return true;
+        case State::FIRING:
+            // 回调返回后由 runTick 释放
+            node.cancelled = true;
+            return true;
+        case State::FREE:
+            break;
+    }
+    return false;
+}
+
+void TimerWheel::link(uint32_t index) {
+    Node& node = nodes_[index];
+    node.expire = std::max(node.expire, tick_);
+
+    // 超出最高层范围的定时器先放在最高层最远的槽，级联时重新计算
+    constexpr uint64_t kRange = uint64_t(1) << (kSlotBits * kLevels);
+    uint64_t delta = node.expire - tick_;
+    uint64_t expire = delta < kRange ? node.expire : tick_ + kRange - 1;
+    if (delta >= kRange) {
+        delta = kRange - 1;
+    }
+
+    uint32_t level = 0;
+    while (level + 1 < kLevels && delta >= (uint64_t(1) << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+    uint32_t slot = static_cast<uint32_t>((expire >> (kSlotBits * level)) & (kSlots - 1));
+
+    node.level = static_cast<uint8_t>(level);
+    node.slot = static_cast<uint8_t>(slot);
+    node.prev = kNil;
+    node.next = heads_[level][slot];
+    if (node.next != kNil) {
+        nodes_[node.next].prev = index;
+    }
+    heads_[level][slot] = index;
+    occupied_[level] |= uint64_t(1) << slot;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    uint32_t& head = node.level == kDetachedLevel ? detached_head_ : heads_[node.level][node.slot];
+
+    if (node.prev != kNil) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        head = node.next;
+    }
+    if (node.next != kNil) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.prev = kNil;
+    node.next = kNil;
+
+    if (node.level != kDetachedLevel && head == kNil) {
+        occupied_[node.level] &= ~(uint64_t(1) << node.slot);
+    }
+}
+
+void TimerWheel::freeNode(uint32_t index) {
+    Node& node = nodes_[index];
+    node.callback = nullptr;
+    node.state = State::FREE;
+    node.cancelled = false;
+    ++node.generation;
+    free_nodes_.push_back(index);
+    --size_;
+}
+
+void TimerWheel::cascade(uint32_t level, uint32_t slot) {
+    uint32_t index = heads_[level][slot];
+    heads_[level][slot] = kNil;
+    occupied_[level] &= ~(uint64_t(1) << slot);
+
+    while (index != kNil) {
+        uint32_t next = nodes_[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+size_t TimerWheel::runTick() {
+    uint32_t slot = static_cast<uint32_t>(tick_ & (kSlots - 1));
+
+    // 第 0 层转完一圈：上层对应的槽下放一层（上层也转完一圈时继续向上）
+    if (slot == 0) {
+        for (uint32_t level = 1; level < kLevels; ++level) {
+            uint32_t upper = static_cast<uint32_t>((tick_ >> (kSlotBits * level)) & (kSlots - 1));
+            cascade(level, upper);
+            if (upper != 0) {
+                break;
+            }
+        }
+    }
+
+    // 摘下这个槽再执行：回调中新加的定时器（包括周期定时器本身）不会在本轮被执行
+    const uint64_t fired_tick = tick_;
+    ++tick_;
+    detached_head_ = heads_[0][slot];
+    heads_[0][slot] = kNil;
+    occupied_[0] &= ~(uint64_t(1) << slot);
+    for (uint32_t index = detached_head_; index != kNil; index = nodes_[index].next) {
+        nodes_[index].level = kDetachedLevel;
+    }
+
+    size_t fired = 0;
+    while (detached_head_ != kNil) {
+        uint32_t index = detached_head_;
+        unlink(index);
+
+        // 回调可能添加定时器导致 nodes_ 扩容，执行前后都按下标访问
+        nodes_[index].state = State::FIRING;
+        Callback callback = std::move(nodes_[index].callback);
+        callback();
+        ++fired;
+
+        Node& node = nodes_[index];
+        if (node.interval > 0 && !node.cancelled) {
+            node.callback = std::move(callback);
+            node.expire = fired_tick + node.interval;
+            node.state = State::PENDING;
+            link(index);
+        } else {
+            freeNode(index);
+        }
+    }
+    return fired;
+}
+
+size_t TimerWheel::advance() {
+    const uint64_t now_tick = clockTick();
+    size_t fired = 0;
+    while (tick_ <= now_tick) {
+        if (size_ == 0) {
+            tick_ = now_tick + 1;
+            break;
+        }
+        fired += runTick();
+    }
+    return fired;
+}
+
+int TimerWheel::nextTimeoutMs() const {
+    if (size_ == 0) {
+        return -1;
+    }
+
+    // 第 0 层下一个非空槽的距离（按当前位置循环移位后数末尾的 0）
+    const uint32_t slot = static_cast<uint32_t>(tick_ & (kSlots - 1));
+    uint64_t ticks = kSlots;
+    if (occupied_[0] != 0) {
+        ticks = static_cast<uint64_t>(std::countr_zero(std::rotr(occupied_[0], static_cast<int>(slot))));
+    }
+    // 上层有定时器时，第 0 层转完一圈需要级联
+    bool upper_occupied = false;
+    for (uint32_t level = 1; level < kLevels; ++level) {
+        upper_occupied |= occupied_[level] != 0;
+    }
+    if (upper_occupied) {
+        ticks = std::min<uint64_t>(ticks, (kSlots - slot) & (kSlots - 1));
+    }
+
+    const uint64_t due_ms = start_ms_ + (tick_ + ticks) * tick_ms_;
+    const uint64_t now = nowMs();
+    if (due_ms <= now) {
+        return 0;
+    }
+    return static_cast<int>(std::min<uint64_t>(due_ms - now, INT32_MAX));
+}
+
+} // namespace tiny_sql
@@ -0,0 +1,175 @@
+#include "tiny_sql/protocol/compression.h"
+
+#include <algorithm>
+
+#ifdef TINY_SQL_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef TINY_SQL_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace tiny_sql {
+
+namespace {
+
+uint32_t readUint24(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) |
+           (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16);
+}
+
+void writeUint24(Buffer& buffer, uint32_t val) {
+    buffer.writeUint8(static_cast<uint8_t>(val & 0xFF));
+    buffer.writeUint8(static_cast<uint8_t>((val >> 8) & 0xFF));
+    buffer.writeUint8(static_cast<uint8_t>((val >> 16) & 0xFF));
+}
+
+// 压缩输出的暂存区，每个线程一个，不随连接常驻
+Buffer& compressScratch() {
+    thread_local Buffer scratch;
+    return scratch;
+}
+
+} // namespace
+
+CompressionCodec::CompressionCodec(CompressionAlgorithm algorithm, int level, size_t min_length)
+    : algorithm_(algorithm), level_(level), min_length_(min_length) {
+#ifdef TINY_SQL_WITH_ZSTD
+    if (algorithm_ == CompressionAlgorithm::ZSTD) {
+        zstd_cctx_ = ZSTD_createCCtx();
+        zstd_dctx_ = ZSTD_createDCtx();
+    }
+#endif
+}
+
+CompressionCodec::~CompressionCodec() {
+#ifdef TINY_SQL_WITH_ZSTD
+    ZSTD_freeCCtx(zstd_cctx_);
+    ZSTD_freeDCtx(zstd_dctx_);
+#endif
+}
+
+bool CompressionCodec::isAvailable(CompressionAlgorithm algorithm) {
+    switch (algorithm) {
+        case CompressionAlgorithm::NONE:
+            return true;
+        case CompressionAlgorithm::ZLIB:
+#ifdef TINY_SQL_WITH_ZLIB
+            return true;
+#else
+            return false;
+#endif
+        case CompressionAlgorithm::ZSTD:
+#ifdef TINY_SQL_WITH_ZSTD
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+bool CompressionCodec::decode(Buffer& input, Buffer& output) {
+    while (input.readableBytes() >= kHeaderSize) {
+        const uint8_t* header = input.peek();
+        size_t payload_len = readUint24(header);
+        uint8_t sequence_id = header[3];
+        size_t raw_len = readUint24(header + 4);
+
+        if (input.readableBytes() < kHeaderSize + payload_len) {
+            break;  // 帧不完整
+        }
+
+        const uint8_t* payload = header + kHeaderSize;
+        if (raw_len == 0) {
+            output.append(payload, payload_len);
+        } else {
+            uint8_t* out = output.extend(raw_len);
+            if (!decompress(payload, payload_len, out, raw_len)) {
+                output.retract(raw_len);
+                return false;
+            }
+        }
+
+        input.skip(kHeaderSize + payload_len);
+        sequence_id_ = static_cast<uint8_t>(sequence_id + 1);
+    }
+    return true;
+}
+
+void CompressionCodec::encode(const uint8_t* data, size_t len, Buffer& frames) {
+    Buffer& scratch = compressScratch();
+
+    while (len > 0) {
+        size_t chunk = std::min(len, kMaxPayload);
+
+        scratch.reset();
+        size_t compressed = chunk >= min_length_ ? compress(data, chunk, scratch) : 0;
+
+        // 太短、压缩失败或压缩后没有变小（已压缩过的数据等）时原样发送
+        bool stored = compressed == 0 || compressed >= chunk;
+        writeUint24(frames, static_cast<uint32_t>(stored ? chunk : compressed));
+        frames.writeUint8(sequence_id_++);
+        writeUint24(frames, static_cast<uint32_t>(stored ? 0 : chunk));
+        frames.append(stored ? data : scratch.peek(), stored ? chunk : compressed);
+
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+size_t CompressionCodec::compress(const uint8_t* data, size_t len, Buffer& out) {
+    switch (algorithm_) {
+#ifdef TINY_SQL_WITH_ZLIB
+        case CompressionAlgorithm::ZLIB: {
+            uLongf bound = ::compressBound(static_cast<uLong>(len));
+            uint8_t* dst = out.extend(bound);
+            uLongf written = bound;
+            if (::compress2(dst, &written, data, static_cast<uLong>(len), level_) != Z_OK) {
+                out.retract(bound);
+                return 0;
+            }
+            out.retract(bound - written);
+            return written;
+        }
+#endif
+#ifdef TINY_SQL_WITH_ZSTD
+        case CompressionAlgorithm::ZSTD: {
+            size_t bound = ZSTD_compressBound(len);
+            uint8_t* dst = out.extend(bound);
+            size_t written = ZSTD_compressCCtx(zstd_cctx_, dst, bound, data, len, level_);
+            if (ZSTD_isError(written)) {
+                out.retract(bound);
+                return 0;
+            }
+            out.retract(bound - written);
+            return written;
+        }
+#endif
+        default:
+            return 0;
+    }
+}
+
+bool CompressionCodec::decompress(const uint8_t* data, size_t len, uint8_t* out, size_t out_len) {
+    switch (algorithm_) {
+#ifdef TINY_SQL_WITH_ZLIB
+        case CompressionAlgorithm::ZLIB: {
+            uLongf written = static_cast<uLongf>(out_len);
+            return ::uncompress(out, &written, data, static_cast<uLong>(len)) == Z_OK &&
+                   written == out_len;
+        }
+#endif
+#ifdef TINY_SQL_WITH_ZSTD
+        case CompressionAlgorithm::ZSTD: {
+            size_t written = ZSTD_decompressDCtx(zstd_dctx_, out, out_len, data, len);
+            return !ZSTD_isError(written) && written == out_len;
+        }
+#endif
+        default:
+            return false;
+    }
+}
+
+} // namespace tiny_sql
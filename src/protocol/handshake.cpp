@@ -9,14 +9,7 @@ HandshakeV10Packet::HandshakeV10Packet()
     : protocol_version_(10)
     , server_version_("1.0.0-tiny-sql")
     , connection_id_(0)
-    , capability_flags_(
-        CapabilityFlags::CLIENT_LONG_PASSWORD |
-        CapabilityFlags::CLIENT_PROTOCOL_41 |
-        CapabilityFlags::CLIENT_SECURE_CONNECTION |
-        CapabilityFlags::CLIENT_PLUGIN_AUTH |
-        CapabilityFlags::CLIENT_CONNECT_WITH_DB |
-        CapabilityFlags::CLIENT_DEPRECATE_EOF
-      )
+    , capability_flags_(CapabilityFlags::SERVER_DEFAULT)
     , character_set_(Charset::UTF8MB4_GENERAL_CI)
     , status_flags_(ServerStatus::SERVER_STATUS_AUTOCOMMIT)
     , auth_plugin_name_("mysql_native_password")
@@ -222,8 +215,22 @@ bool HandshakeResponse41Packet::decode(Buffer& buffer) {
         auth_plugin_name_ = buffer.readNullTerminatedString();
     }
 
+    const size_t end_pos = start_pos + header.payload_length;
+
     // 跳过connect attributes（如果有）
-    // 这里暂时简单处理
+    if ((capability_flags_ & CapabilityFlags::CLIENT_CONNECT_ATTRS) && buffer.readerIndex() < end_pos) {
+        uint64_t attrs_len = buffer.readLenencInt();
+        if (buffer.readerIndex() > end_pos || attrs_len > end_pos - buffer.readerIndex()) {
+            return false;
+        }
+        buffer.skip(static_cast<size_t>(attrs_len));
+    }
+
+    // zstd 压缩级别
+    if ((capability_flags_ & CapabilityFlags::CLIENT_ZSTD_COMPRESSION_ALGORITHM) &&
+        buffer.readerIndex() < end_pos) {
+        zstd_compression_level_ = buffer.readUint8();
+    }
 
     return true;
 }
@@ -268,6 +275,11 @@ void HandshakeResponse41Packet::encode(Buffer& buffer, uint8_t sequence_id) {
         payload.writeUint8(0);
     }
 
+    // zstd 压缩级别（不发送 connect attributes，紧跟在插件名之后）
+    if (capability_flags_ & CapabilityFlags::CLIENT_ZSTD_COMPRESSION_ALGORITHM) {
+        payload.writeUint8(zstd_compression_level_);
+    }
+
     writeHeader(buffer, static_cast<uint32_t>(payload.readableBytes()), sequence_id);
     buffer.append(payload.peek(), payload.readableBytes());
 }
@@ -301,6 +313,10 @@ size_t HandshakeResponse41Packet::getPayloadLength() const {
         len += auth_plugin_name_.size() + 1;
     }
 
+    if (capability_flags_ & CapabilityFlags::CLIENT_ZSTD_COMPRESSION_ALGORITHM) {
+        len += 1;
+    }
+
     return len;
 }
 
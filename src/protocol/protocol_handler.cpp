@@ -3,15 +3,70 @@
 #include "tiny_sql/protocol/response.h"
 #include "tiny_sql/protocol/packet.h"
 #include "tiny_sql/auth/authenticator.h"
+#include "tiny_sql/common/config.h"
 #include "tiny_sql/common/logger.h"
+#include "tiny_sql/common/metrics.h"
+#include "tiny_sql/session/process_list.h"
+#include <algorithm>
 
 namespace tiny_sql {
 
+namespace {
+
+// 压缩协议下攒够这么多响应就封一帧，不必等到语句结束
+constexpr size_t kCompressChunkBytes = 64 * 1024;
+
+// zlib 使用与 mysqld 相同的默认级别
+constexpr int kZlibCompressionLevel = 6;
+
+/**
+ * 服务器可以声明的压缩能力：配置允许且编译时带了对应的库
+ */
+uint32_t compressionCapabilities() {
+    const std::string& algorithms = Config::instance().protocol_compression_algorithms;
+    auto allowed = [&algorithms](const std::string& name) {
+        size_t pos = 0;
+        while (pos <= algorithms.size()) {
+            size_t comma = algorithms.find(',', pos);
+            size_t end = comma == std::string::npos ? algorithms.size() : comma;
+            if (algorithms.compare(pos, end - pos, name) == 0) {
+                return true;
+            }
+            pos = end + 1;
+        }
+        return false;
+    };
+
+    uint32_t flags = 0;
+    if (allowed("zlib") && CompressionCodec::isAvailable(CompressionAlgorithm::ZLIB)) {
+        flags |= CapabilityFlags::CLIENT_COMPRESS;
+    }
+    if (allowed("zstd") && CompressionCodec::isAvailable(CompressionAlgorithm::ZSTD)) {
+        flags |= CapabilityFlags::CLIENT_ZSTD_COMPRESSION_ALGORITHM;
+    }
+    return flags;
+}
+
+} // namespace
+
 ProtocolHandler::ProtocolHandler(std::shared_ptr<TcpConnection> conn)
     : connection_(conn)
     , session_(std::make_shared<Session>(conn->getFd()))
     , command_dispatcher_(std::make_unique<CommandDispatcher>())
-{}
+{
+    // 登记到进程列表；KILL 空闲连接时在事件循环线程上关闭它
+    std::weak_ptr<TcpConnection> weak_conn = conn;
+    ProcessList::instance().add(*session_, conn->getPeerAddr(), [weak_conn] {
+        if (auto c = weak_conn.lock()) {
+            c->handleClose();
+        }
+    });
+}
+
+ProtocolHandler::~ProtocolHandler() {
+    armTimeout(0, nullptr);
+    ProcessList::instance().remove(*session_);
+}
 
 void ProtocolHandler::sendHandshake() {
     LOG_DEBUG("Sending handshake to connection: " << session_->getConnectionId());
@@ -20,6 +75,7 @@ void ProtocolHandler::sendHandshake() {
     HandshakeV10Packet handshake;
     handshake.setConnectionId(session_->getConnectionId());
     handshake.generateAuthPluginData();
+    handshake.setCapabilityFlags(handshake.getCapabilityFlags() | compressionCapabilities());
 
     // 保存auth_plugin_data到session
     session_->setAuthPluginData(handshake.getAuthPluginData());
@@ -29,33 +85,78 @@ void ProtocolHandler::sendHandshake() {
     handshake.encode(response, 0);
 
     // 发送握手包
-    connection_->send(response.peek(), response.readableBytes());
+    sendResponse(response);
+    flushResponses();
 
     // 更新会话状态
     session_->setState(SessionState::HANDSHAKE_SENT);
     session_->resetSequenceId();
+
+    // 不完成握手的连接不能一直占用连接数
+    armTimeout(uint64_t(Config::instance().connect_timeout) * 1000, &ProtocolHandler::onHandshakeTimeout);
 }
 
 bool ProtocolHandler::handleData(Buffer& buffer) {
-    // 检查是否有完整的包
-    size_t packet_size = checkPacketComplete(buffer);
-    if (packet_size == 0) {
-        // 包不完整，等待更多数据
-        return true;
+    // 一次读取可能包含客户端流水线发来的多个包，逐个处理；
+    // 连接因输出积压暂停读取时，剩下的包留在缓冲区，恢复后继续
+    while (!connection_->isReadingPaused()) {
+        // 压缩协议：先把收到的完整帧还原成包流
+        Buffer* input = &buffer;
+        if (compression_) {
+            if (!compression_->decode(buffer, plain_input_)) {
+                LOG_WARN("Malformed compressed packet from " << connection_->getPeerAddr());
+                return false;
+            }
+            input = &plain_input_;
+        }
+
+        // 检查是否有完整的包
+        size_t packet_size = checkPacketComplete(*input);
+        if (packet_size == 0) {
+            // 包不完整，等待更多数据
+            plain_input_.shrink();
+            return true;
+        }
+
+        bool keep_open;
+        if (input->readableBytes() == packet_size) {
+            // 常见情况：缓冲区里正好一个包，直接处理，处理器没读完的部分丢弃
+            size_t end = input->readerIndex() + packet_size;
+            keep_open = handlePacket(*input, packet_size);
+            input->setReaderIndex(end);
+        } else {
+            // 处理器会把剩余数据当作本包的内容，多个包时拆出当前包
+            Buffer packet(packet_size);
+            packet.writeBytes(input->peek(), packet_size);
+            input->skip(packet_size);
+            keep_open = handlePacket(packet, packet_size);
+        }
+
+        if (!keep_open) {
+            return false;
+        }
     }
+    return true;
+}
+
+bool ProtocolHandler::handlePacket(Buffer& packet, size_t packet_size) {
+    ServerMetrics::instance().bytes_received.add(packet_size);
 
     LOG_DEBUG("Handling data for session: " << session_->getConnectionId()
               << ", state: " << static_cast<int>(session_->getState())
               << ", packet size: " << packet_size);
 
     // 根据会话状态处理数据
+    bool keep_open = false;
     switch (session_->getState()) {
         case SessionState::HANDSHAKE_SENT:
-            return handleAuthentication(buffer);
+            keep_open = handleAuthentication(packet);
+            break;
 
         case SessionState::AUTHENTICATED:
         case SessionState::COMMAND_PHASE:
-            return handleCommand(buffer);
+            keep_open = handleCommand(packet);
+            break;
 
         case SessionState::CLOSING:
         case SessionState::CLOSED:
@@ -65,6 +166,11 @@ bool ProtocolHandler::handleData(Buffer& buffer) {
             LOG_ERROR("Unexpected session state: " << static_cast<int>(session_->getState()));
             return false;
     }
+
+    // 这个包产生的所有响应段一次写出
+    flushResponses();
+    last_activity_ns_ = metrics::nowNs();
+    return keep_open;
 }
 
 bool ProtocolHandler::handleAuthentication(Buffer& buffer) {
@@ -100,6 +206,15 @@ bool ProtocolHandler::handleAuthentication(Buffer& buffer) {
             session_->setCurrentDatabase(auth_response.getDatabase());
         }
         session_->setState(SessionState::AUTHENTICATED);
+        session_->setClientFlags(auth_response.getCapabilityFlags() &
+                                 (CapabilityFlags::SERVER_DEFAULT | compressionCapabilities()));
+        ProcessList::instance().endCommand(*session_);
+
+        // 握手完成，换成空闲超时
+        const auto& config = Config::instance();
+        bool interactive = auth_response.getCapabilityFlags() & CapabilityFlags::CLIENT_INTERACTIVE;
+        idle_timeout_ = interactive ? config.interactive_timeout : config.wait_timeout;
+        armTimeout(uint64_t(idle_timeout_) * 1000, &ProtocolHandler::onIdleTimeout);
 
         OkPacket ok_packet(0, 0, ServerStatus::SERVER_STATUS_AUTOCOMMIT, 0);
         ok_packet.encode(response, 2);
@@ -115,6 +230,22 @@ bool ProtocolHandler::handleAuthentication(Buffer& buffer) {
     }
 
     sendResponse(response);
+
+    // 协商了压缩协议：OK 包照常发出，之后的收发都使用压缩帧（zstd 优先）
+    uint32_t compress_flags = auth_response.getCapabilityFlags() & compressionCapabilities();
+    if (compress_flags != 0) {
+        flushResponses();
+
+        const size_t min_length = Config::instance().compression_min_length;
+        if (compress_flags & CapabilityFlags::CLIENT_ZSTD_COMPRESSION_ALGORITHM) {
+            int level = std::clamp<int>(auth_response.getZstdCompressionLevel(), 1, 22);
+            compression_ = std::make_unique<CompressionCodec>(CompressionAlgorithm::ZSTD, level, min_length);
+        } else {
+            compression_ = std::make_unique<CompressionCodec>(CompressionAlgorithm::ZLIB,
+                                                              kZlibCompressionLevel, min_length);
+        }
+        LOG_DEBUG("Compressed protocol enabled for session " << session_->getConnectionId());
+    }
     return true;
 }
 
@@ -131,17 +262,25 @@ bool ProtocolHandler::handleCommand(Buffer& buffer) {
         return false;
     }
 
-    // 使用命令分发器处理命令
+    // 被 KILL 的连接不再执行新命令
+    if (session_->isKilled()) {
+        return false;
+    }
+
+    // 使用命令分发器处理命令；语句结束前写出响应，网络时间计入语句统计
     bool result = command_dispatcher_->dispatch(
         buffer,
         *session_,
         [this](Buffer& response) {
             this->sendResponse(response);
+        },
+        [this] {
+            this->flushResponses();
         }
     );
 
-    // 如果是QUIT命令，返回false以关闭连接
-    if (session_->getState() == SessionState::CLOSING) {
+    // 如果是QUIT命令或连接已被 KILL，返回false以关闭连接
+    if (session_->getState() == SessionState::CLOSING || session_->isKilled()) {
         return false;
     }
 
@@ -149,9 +288,111 @@ bool ProtocolHandler::handleCommand(Buffer& buffer) {
 }
 
 void ProtocolHandler::sendResponse(Buffer& response) {
-    if (response.readableBytes() > 0) {
-        connection_->send(response.peek(), response.readableBytes());
+    if (response.readableBytes() == 0) {
+        return;
+    }
+
+    if (compression_) {
+        // 攒到一块再压缩，小响应在 flushResponses 时合成一帧
+        plain_output_.append(response.peek(), response.readableBytes());
+        response.reset();
+        if (plain_output_.readableBytes() >= kCompressChunkBytes) {
+            queueCompressed();
+        }
+        return;
+    }
+
+    // 移入输出队列，不复制；调用方的 response 变为空
+    queueOutput(std::move(response));
+}
+
+void ProtocolHandler::queueCompressed() {
+    Buffer frames;
+    compression_->encode(plain_output_.peek(), plain_output_.readableBytes(), frames);
+    plain_output_.reset();
+    queueOutput(std::move(frames));
+}
+
+void ProtocolHandler::queueOutput(Buffer&& data) {
+    size_t len = data.readableBytes();
+    connection_->queue(std::move(data));
+
+    // 按实际发出的字节数计（压缩协议下为压缩后的大小）
+    ServerMetrics::instance().bytes_sent.add(len);
+    session_->getStats().bytes_sent += len;
+}
+
+void ProtocolHandler::flushResponses() {
+    if (compression_ && plain_output_.readableBytes() > 0) {
+        queueCompressed();
+    }
+
+    if (connection_->getOutputBuffer().empty()) {
+        return;
+    }
+
+    auto& metrics = ServerMetrics::instance();
+    uint64_t start = metrics::nowNs();
+    connection_->flush();
+    uint64_t elapsed = metrics::nowNs() - start;
+
+    metrics.network_write_time.record(elapsed);
+    session_->getStats().network_ns += elapsed;
+}
+
+void ProtocolHandler::armTimeout(uint64_t delay_ms, void (ProtocolHandler::*handler)()) {
+    TimerWheel* timers = connection_->getTimerWheel();
+    if (!timers) {
+        return;
+    }
+    if (timeout_timer_ != 0) {
+        timers->cancel(timeout_timer_);
+        timeout_timer_ = 0;
+    }
+    if (delay_ms > 0 && handler) {
+        timeout_timer_ = timers->schedule(delay_ms, [this, handler] {
+            timeout_timer_ = 0;
+            (this->*handler)();
+        });
+    }
+}
+
+void ProtocolHandler::onHandshakeTimeout() {
+    if (session_->isAuthenticated()) {
+        return;
+    }
+    LOG_WARN("Handshake timeout for connection " << session_->getConnectionId()
+             << " from " << connection_->getPeerAddr());
+    ServerMetrics::instance().aborted_connects.add();
+
+    connection_->handleClose();
+}
+
+void ProtocolHandler::onIdleTimeout() {
+    const uint64_t timeout_ms = uint64_t(idle_timeout_) * 1000;
+    const uint64_t idle_ms = (metrics::nowNs() - last_activity_ns_) / 1000000;
+
+    // 还没到期（期间执行过命令），或客户端正在读积压的结果：按剩余时间重新定时
+    if (idle_ms < timeout_ms || connection_->isReadingPaused()) {
+        armTimeout(idle_ms < timeout_ms ? timeout_ms - idle_ms : timeout_ms,
+                   &ProtocolHandler::onIdleTimeout);
+        return;
     }
+
+    LOG_INFO("Closing idle connection " << session_->getConnectionId()
+             << " from " << connection_->getPeerAddr() << " after " << idle_ms / 1000 << "s");
+
+    // 服务器主动断开，序列号从0开始
+    Buffer response;
+    ErrPacket err_packet(4031, "HY000",
+        "The client was disconnected by the server because of inactivity. "
+        "See wait_timeout and interactive_timeout for configuring this behavior.");
+    session_->resetSequenceId();
+    err_packet.encode(response, session_->nextSequenceId());
+    sendResponse(response);
+    flushResponses();
+
+    connection_->handleClose();
 }
 
 } // namespace tiny_sql
@@ -1,5 +1,6 @@
 #include "tiny_sql/protocol/response.h"
 #include "tiny_sql/common/logger.h"
+#include <charconv>
 
 namespace tiny_sql {
 
@@ -38,6 +39,7 @@ bool OkPacket::decode(Buffer& buffer) {
         LOG_ERROR("Invalid OK packet header: " << static_cast<int>(packet_header));
         return false;
     }
+    header_ = packet_header;
 
     affected_rows_ = buffer.readLenencInt();
     last_insert_id_ = buffer.readLenencInt();
@@ -59,8 +61,8 @@ bool OkPacket::decode(Buffer& buffer) {
 void OkPacket::encode(Buffer& buffer, uint8_t sequence_id) {
     Buffer payload;
 
-    // header (0x00 for OK)
-    payload.writeUint8(0x00);
+    // header (0x00 for OK, 0xFE 结束结果集)
+    payload.writeUint8(header_);
 
     // affected rows
     payload.writeLenencInt(affected_rows_);
@@ -500,6 +502,40 @@ size_t ColumnDefinitionPacket::getPayloadLength() const {
 
 // ==================== TextResultRowPacket ====================
 
+// 辅助函数：以文本协议编码一个值（NULL 为 0xFB，其余为 length-encoded string）
+// 数值用 to_chars 格式化到栈上，格式与 Value::toString 一致，不产生临时字符串
+static void writeTextValue(Buffer& buffer, const Value& value) {
+    if (value.isNull()) {
+        buffer.writeUint8(0xFB);
+        return;
+    }
+    if (value.isString()) {
+        const std::string& str = value.asString();
+        buffer.writeLenencInt(str.size());
+        buffer.writeBytes(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+        return;
+    }
+
+    char text[128];
+    std::to_chars_result result{text, std::errc::value_too_large};
+    if (value.isInt()) {
+        result = std::to_chars(text, text + sizeof(text), value.asInt());
+    } else if (value.isBigInt()) {
+        result = std::to_chars(text, text + sizeof(text), value.asBigInt());
+    } else if (value.isFloat()) {
+        result = std::to_chars(text, text + sizeof(text), value.asFloat(), std::chars_format::fixed, 2);
+    } else if (value.isDouble()) {
+        result = std::to_chars(text, text + sizeof(text), value.asDouble(), std::chars_format::fixed, 4);
+    }
+    if (result.ec != std::errc()) {
+        buffer.writeLenencString(value.toString());
+        return;
+    }
+    size_t len = static_cast<size_t>(result.ptr - text);
+    buffer.writeLenencInt(len);
+    buffer.writeBytes(reinterpret_cast<const uint8_t*>(text), len);
+}
+
 TextResultRowPacket::TextResultRowPacket()
 {}
 
@@ -516,27 +552,32 @@ bool TextResultRowPacket::decode(Buffer& buffer) {
 }
 
 void TextResultRowPacket::encode(Buffer& buffer, uint8_t sequence_id) {
-    Buffer payload;
-
-    // 对每个值编码为length-encoded string
-    // Encode each value as length-encoded string
+    size_t header = buffer.writerIndex();
+    writeHeader(buffer, 0, sequence_id);
     for (const auto& value : values_) {
-        if (value.isNull()) {
-            // NULL值用0xFB表示
-            // NULL value is represented by 0xFB
-            payload.writeUint8(0xFB);
-        } else {
-            // 其他值转换为字符串后用length-encoded string编码
-            // Other values converted to string then encoded as length-encoded string
-            std::string str = value.toString();
-            payload.writeLenencString(str);
+        writeTextValue(buffer, value);
+    }
+    buffer.writeUint24At(header, static_cast<uint32_t>(buffer.writerIndex() - header - 4));
+}
+
+void TextResultRowPacket::encodeRow(Buffer& buffer, const Row& row,
+                                    const std::vector<size_t>* projection, uint8_t sequence_id) {
+    // 先写占位包头，值编码完成后回填payload长度
+    // Write a placeholder header and patch the payload length once the values are encoded
+    size_t header = buffer.writerIndex();
+    writeHeader(buffer, 0, sequence_id);
+
+    if (projection) {
+        for (size_t index : *projection) {
+            writeTextValue(buffer, row.getValue(index));
+        }
+    } else {
+        for (const auto& value : row.getValues()) {
+            writeTextValue(buffer, value);
         }
     }
 
-    // 写包头和payload
-    // Write header and payload
-    writeHeader(buffer, static_cast<uint32_t>(payload.readableBytes()), sequence_id);
-    buffer.append(payload.peek(), payload.readableBytes());
+    buffer.writeUint24At(header, static_cast<uint32_t>(buffer.writerIndex() - header - 4));
 }
 
 size_t TextResultRowPacket::getPayloadLength() const {
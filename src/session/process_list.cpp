@@ -0,0 +1,125 @@
+#include "tiny_sql/session/process_list.h"
+#include "tiny_sql/session/session.h"
+
+namespace tiny_sql {
+
+ProcessList& ProcessList::instance() {
+    static ProcessList list;
+    return list;
+}
+
+void ProcessList::add(Session& session, const std::string& host,
+                      std::function<void()> close_connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[session.getConnectionId()];
+    entry = Entry();
+    entry.session = &session;
+    entry.host = host;
+    entry.close_connection = std::move(close_connection);
+    entry.since = std::chrono::steady_clock::now();
+}
+
+void ProcessList::remove(const Session& session) {
+    std::function<void()> close_connection;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(session.getConnectionId());
+        if (it == entries_.end() || it->second.session != &session) {
+            return;
+        }
+        // 回调持有的对象在锁外析构
+        close_connection = std::move(it->second.close_connection);
+        entries_.erase(it);
+    }
+}
+
+void ProcessList::beginCommand(Session& session, const char* command, std::string_view query) {
+    // KILL QUERY 只作用于发出时正在执行的语句
+    KillState expected = KillState::QUERY;
+    session.getKillState().compare_exchange_strong(expected, KillState::NONE,
+                                                   std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(session.getConnectionId());
+    if (it == entries_.end()) {
+        return;
+    }
+    Entry& entry = it->second;
+    entry.command = command;
+    entry.query.assign(query.data(), query.size());
+    entry.running = true;
+    entry.since = std::chrono::steady_clock::now();
+}
+
+void ProcessList::endCommand(Session& session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(session.getConnectionId());
+    if (it == entries_.end()) {
+        return;
+    }
+    Entry& entry = it->second;
+    entry.user = session.getUsername();
+    entry.db = session.getCurrentDatabase();
+    entry.command = "Sleep";
+    entry.query.clear();
+    entry.running = false;
+    entry.since = std::chrono::steady_clock::now();
+}
+
+std::vector<ProcessInfo> ProcessList::snapshot() const {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<ProcessInfo> processes;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    processes.reserve(entries_.size());
+    for (const auto& [id, entry] : entries_) {
+        ProcessInfo info;
+        info.id = id;
+        info.user = entry.user;
+        info.host = entry.host;
+        info.db = entry.db;
+        info.command = entry.session->isKilled() ? "Killed" : entry.command;
+        info.time = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::seconds>(now - entry.since).count());
+        info.state = entry.running ? "executing" : "";
+        info.info = entry.query;
+        processes.push_back(std::move(info));
+    }
+    return processes;
+}
+
+ProcessList::KillResult ProcessList::kill(uint32_t id, bool query_only) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        return KillResult::NOT_FOUND;
+    }
+
+    auto& kill_state = it->second.session->getKillState();
+    if (query_only) {
+        // 不覆盖已设置的 KILL CONNECTION
+        KillState expected = KillState::NONE;
+        kill_state.compare_exchange_strong(expected, KillState::QUERY, std::memory_order_relaxed);
+    } else {
+        kill_state.store(KillState::CONNECTION, std::memory_order_relaxed);
+    }
+    return it->second.running ? KillResult::RUNNING : KillResult::IDLE;
+}
+
+void ProcessList::closeConnection(uint32_t id) {
+    std::function<void()> close_connection;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(id);
+        if (it == entries_.end()) {
+            return;
+        }
+        close_connection = it->second.close_connection;
+    }
+    // 关闭连接会析构会话并调用 remove，必须在锁外进行
+    if (close_connection) {
+        close_connection();
+    }
+}
+
+} // namespace tiny_sql
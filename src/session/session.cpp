@@ -1,4 +1,6 @@
 #include "tiny_sql/session/session.h"
+#include "tiny_sql/storage/transaction.h"
+#include "tiny_sql/protocol/handshake.h"
 #include <sstream>
 
 namespace tiny_sql {
@@ -13,6 +15,21 @@ Session::Session(uint32_t connection_id)
     auth_plugin_data_.fill(0);
 }
 
+Session::~Session() {
+    // 连接断开时回滚未提交的事务
+    if (transaction_) {
+        TransactionManager::instance().rollback(*transaction_);
+    }
+}
+
+uint16_t Session::getServerStatus() const {
+    uint16_t status = ServerStatus::SERVER_STATUS_AUTOCOMMIT;
+    if (transaction_) {
+        status |= ServerStatus::SERVER_STATUS_IN_TRANS;
+    }
+    return status;
+}
+
 std::string Session::getSessionInfo() const {
     std::ostringstream oss;
     oss << "Session[id=" << connection_id_
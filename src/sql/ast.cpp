@@ -18,12 +18,41 @@ std::string SelectStatement::toString() const {
 
     if (!table_name_.empty()) {
         oss << " FROM " << table_name_;
+        if (!table_alias_.empty()) {
+            oss << " " << table_alias_;
+        }
+    }
+
+    if (join_) {
+        oss << (join_->type == JoinType::LEFT ? " LEFT JOIN " : " JOIN ") << join_->table_name;
+        if (!join_->alias.empty()) {
+            oss << " " << join_->alias;
+        }
+        if (join_->condition) {
+            oss << " ON " << join_->condition->toString();
+        }
     }
 
     if (where_clause_) {
         oss << " WHERE " << where_clause_->toString();
     }
 
+    if (!group_by_.empty()) {
+        oss << " GROUP BY ";
+        for (size_t i = 0; i < group_by_.size(); ++i) {
+            if (i > 0) oss << ", ";
+            oss << group_by_[i]->toString();
+        }
+    }
+
+    if (!order_by_.empty()) {
+        oss << " ORDER BY ";
+        for (size_t i = 0; i < order_by_.size(); ++i) {
+            if (i > 0) oss << ", ";
+            oss << order_by_[i].expr->toString() << (order_by_[i].ascending ? " ASC" : " DESC");
+        }
+    }
+
     if (limit_ >= 0) {
         oss << " LIMIT " << limit_;
     }
@@ -35,9 +64,22 @@ std::string SelectStatement::toString() const {
     return oss.str();
 }
 
+bool SelectStatement::hasAggregation() const {
+    if (!group_by_.empty()) {
+        return true;
+    }
+    for (const auto& col : columns_) {
+        auto* func = dynamic_cast<const FunctionCall*>(col.get());
+        if (func && func->isAggregate()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 std::string InsertStatement::toString() const {
     std::ostringstream oss;
-    oss << "INSERT INTO " << table_name_;
+    oss << (ignore_ ? "INSERT IGNORE INTO " : "INSERT INTO ") << table_name_;
 
     if (!columns_.empty()) {
         oss << " (";
@@ -48,12 +90,52 @@ std::string InsertStatement::toString() const {
         oss << ")";
     }
 
-    oss << " VALUES (";
-    for (size_t i = 0; i < values_.size(); ++i) {
+    oss << " VALUES ";
+    for (size_t r = 0; r < rows_.size(); ++r) {
+        if (r > 0) oss << ", ";
+        oss << "(";
+        for (size_t i = 0; i < rows_[r].size(); ++i) {
+            if (i > 0) oss << ", ";
+            oss << rows_[r][i]->toString();
+        }
+        oss << ")";
+    }
+
+    if (!duplicate_assignments_.empty()) {
+        oss << " ON DUPLICATE KEY UPDATE ";
+        for (size_t i = 0; i < duplicate_assignments_.size(); ++i) {
+            if (i > 0) oss << ", ";
+            oss << duplicate_assignments_[i].column << " = "
+                << duplicate_assignments_[i].value->toString();
+        }
+    }
+
+    return oss.str();
+}
+
+std::string UpdateStatement::toString() const {
+    std::ostringstream oss;
+    oss << "UPDATE " << table_name_ << " SET ";
+
+    for (size_t i = 0; i < assignments_.size(); ++i) {
         if (i > 0) oss << ", ";
-        oss << values_[i]->toString();
+        oss << assignments_[i].column << " = " << assignments_[i].value->toString();
+    }
+
+    if (where_clause_) {
+        oss << " WHERE " << where_clause_->toString();
+    }
+
+    return oss.str();
+}
+
+std::string DeleteStatement::toString() const {
+    std::ostringstream oss;
+    oss << "DELETE FROM " << table_name_;
+
+    if (where_clause_) {
+        oss << " WHERE " << where_clause_->toString();
     }
-    oss << ")";
 
     return oss.str();
 }
@@ -76,6 +158,10 @@ std::string CreateTableStatement::toString() const {
             oss << " PRIMARY KEY";
         }
 
+        if (col.unique) {
+            oss << " UNIQUE";
+        }
+
         if (col.auto_increment) {
             oss << " AUTO_INCREMENT";
         }
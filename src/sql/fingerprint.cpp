@@ -0,0 +1,147 @@
+#include "tiny_sql/sql/fingerprint.h"
+#include "tiny_sql/sql/lexer.h"
+#include <cctype>
+#include <vector>
+
+namespace tiny_sql {
+
+namespace {
+
+// 规范化后的片段类别，决定负号折叠、括号折叠和空格
+enum class PartKind {
+    VALUE,      // ? 字面量
+    LIST,       // (?+) 折叠后的字面量列表
+    NAME,       // 标识符
+    OPEN,       // (
+    CLOSE,      // )
+    COMMA,      // ,
+    DOT,        // .
+    OTHER,      // 关键字、操作符
+};
+
+struct Part {
+    PartKind kind;
+    std::string text;
+    bool glued = false;     // 与前一个片段之间不留空格
+};
+
+bool isAggregateKeyword(TokenType type) {
+    return type == TokenType::COUNT || type == TokenType::SUM || type == TokenType::AVG ||
+           type == TokenType::MAX || type == TokenType::MIN;
+}
+
+// 前一个片段能结束一个操作数时，后面的 - 是减号而不是负号
+bool endsOperand(const std::vector<Part>& parts) {
+    if (parts.empty()) {
+        return false;
+    }
+    PartKind kind = parts.back().kind;
+    return kind == PartKind::VALUE || kind == PartKind::LIST ||
+           kind == PartKind::NAME || kind == PartKind::CLOSE;
+}
+
+// 遇到 ) 时：若括号内只有字面量，则整体替换为 (?+)；连续的 (?+), (?+) 只保留一个
+void closeParen(std::vector<Part>& parts) {
+    size_t open = parts.size();
+    bool literals_only = true;
+    while (open > 0) {
+        const Part& part = parts[open - 1];
+        if (part.kind == PartKind::OPEN) {
+            break;
+        }
+        bool expect_value = (parts.size() - open) % 2 == 0;
+        if (part.kind != (expect_value ? PartKind::VALUE : PartKind::COMMA)) {
+            literals_only = false;
+        }
+        open--;
+    }
+
+    if (open == 0 || open == parts.size() || !literals_only ||
+        parts[parts.size() - 1].kind != PartKind::VALUE) {
+        parts.push_back({PartKind::CLOSE, ")"});
+        return;
+    }
+
+    parts.resize(open - 1);
+    if (parts.size() >= 2 && parts.back().kind == PartKind::COMMA &&
+        parts[parts.size() - 2].kind == PartKind::LIST) {
+        parts.pop_back();
+        return;
+    }
+    parts.push_back({PartKind::LIST, "(?+)"});
+}
+
+} // namespace
+
+std::string fingerprintQuery(const std::string& query) {
+    Lexer lexer(query);
+    std::vector<Part> parts;
+    TokenType previous_type = TokenType::EOF_TOKEN;
+
+    for (Token token = lexer.nextToken(); token.type != TokenType::EOF_TOKEN;
+         token = lexer.nextToken()) {
+        TokenType type = token.type;
+        switch (type) {
+            case TokenType::NUMBER:
+            case TokenType::STRING:
+                if (!parts.empty() && parts.back().text == "-" && parts.back().kind == PartKind::OTHER) {
+                    parts.pop_back();
+                    if (endsOperand(parts)) {
+                        parts.push_back({PartKind::OTHER, "-"});
+                    }
+                }
+                parts.push_back({PartKind::VALUE, "?"});
+                break;
+            case TokenType::IDENTIFIER:
+                parts.push_back({PartKind::NAME, token.literal});
+                break;
+            case TokenType::LPAREN:
+                // 聚合函数名与括号之间不留空格：COUNT(*)
+                parts.push_back({PartKind::OPEN, "(", isAggregateKeyword(previous_type)});
+                break;
+            case TokenType::RPAREN:
+                closeParen(parts);
+                break;
+            case TokenType::COMMA:
+                parts.push_back({PartKind::COMMA, ","});
+                break;
+            case TokenType::DOT:
+                parts.push_back({PartKind::DOT, "."});
+                break;
+            case TokenType::SEMICOLON:
+                break;
+            default: {
+                std::string text = token.literal;
+                for (char& c : text) {
+                    c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                }
+                parts.push_back({PartKind::OTHER, std::move(text)});
+                break;
+            }
+        }
+        previous_type = type;
+    }
+
+    std::string fingerprint;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        const Part& part = parts[i];
+        if (i > 0 && !part.glued && part.kind != PartKind::COMMA && part.kind != PartKind::CLOSE &&
+            part.kind != PartKind::DOT && parts[i - 1].kind != PartKind::DOT &&
+            parts[i - 1].kind != PartKind::OPEN) {
+            fingerprint.push_back(' ');
+        }
+        fingerprint.append(part.text);
+    }
+    return fingerprint;
+}
+
+uint64_t fingerprintHash(const std::string& fingerprint) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : fingerprint) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // namespace tiny_sql
@@ -1,5 +1,7 @@
 #include "tiny_sql/sql/parser.h"
 #include "tiny_sql/common/logger.h"
+#include <cctype>
+#include <cstring>
 
 namespace tiny_sql {
 
@@ -30,9 +32,24 @@ std::unique_ptr<Statement> Parser::parse() {
         case TokenType::INSERT:
             return parseInsertStatement();
 
+        case TokenType::UPDATE:
+            return parseUpdateStatement();
+
+        case TokenType::DELETE:
+            return parseDeleteStatement();
+
         case TokenType::CREATE:
+            if (peekToken().type == TokenType::INDEX) {
+                return parseCreateIndexStatement();
+            }
             return parseCreateTableStatement();
 
+        case TokenType::ANALYZE:
+            return parseAnalyzeStatement();
+
+        case TokenType::EXPLAIN:
+            return parseExplainStatement();
+
         case TokenType::DROP:
             return parseDropTableStatement();
 
@@ -42,7 +59,16 @@ std::unique_ptr<Statement> Parser::parse() {
         case TokenType::USE:
             return parseUseStatement();
 
+        case TokenType::BEGIN:
+        case TokenType::START:
+        case TokenType::COMMIT:
+        case TokenType::ROLLBACK:
+            return parseTransactionStatement();
+
         default:
+            if (isContextualKeyword("KILL")) {
+                return parseKillStatement();
+            }
             addError("Unexpected token: " + currentToken().literal);
             return nullptr;
     }
@@ -83,6 +109,54 @@ std::unique_ptr<SelectStatement> Parser::parseSelectStatement() {
         }
         stmt->setTableName(currentToken().literal);
         nextToken();
+
+        std::string alias;
+        if (!parseTableAlias(alias)) {
+            return nullptr;
+        }
+        stmt->setTableAlias(alias);
+
+        // JOIN 子句：[INNER | LEFT [OUTER]] JOIN table [[AS] alias] ON condition
+        if (currentToken().type == TokenType::JOIN ||
+            currentToken().type == TokenType::INNER ||
+            currentToken().type == TokenType::LEFT) {
+            auto join = std::make_unique<JoinClause>();
+
+            if (currentToken().type == TokenType::LEFT) {
+                join->type = JoinType::LEFT;
+                nextToken();
+                if (currentToken().type == TokenType::OUTER) {
+                    nextToken();
+                }
+            } else if (currentToken().type == TokenType::INNER) {
+                nextToken();
+            }
+
+            if (!expectAndNext(TokenType::JOIN)) {
+                return nullptr;
+            }
+
+            if (currentToken().type != TokenType::IDENTIFIER) {
+                addError("Expected table name after JOIN");
+                return nullptr;
+            }
+            join->table_name = currentToken().literal;
+            nextToken();
+
+            if (!parseTableAlias(join->alias)) {
+                return nullptr;
+            }
+
+            if (!expectAndNext(TokenType::ON)) {
+                return nullptr;
+            }
+            join->condition = parseExpression();
+            if (!join->condition) {
+                return nullptr;
+            }
+
+            stmt->setJoin(std::move(join));
+        }
     }
 
     // WHERE 子句
@@ -95,7 +169,57 @@ std::unique_ptr<SelectStatement> Parser::parseSelectStatement() {
         stmt->setWhereClause(std::move(where));
     }
 
-    // LIMIT 子句
+    // GROUP BY 子句
+    if (currentToken().type == TokenType::GROUP) {
+        nextToken();
+        if (!expectAndNext(TokenType::BY)) {
+            return nullptr;
+        }
+
+        while (true) {
+            auto expr = parseExpression();
+            if (!expr) {
+                return nullptr;
+            }
+            stmt->addGroupBy(std::move(expr));
+
+            if (currentToken().type != TokenType::COMMA) {
+                break;
+            }
+            nextToken(); // skip comma
+        }
+    }
+
+    // ORDER BY 子句
+    if (currentToken().type == TokenType::ORDER) {
+        nextToken();
+        if (!expectAndNext(TokenType::BY)) {
+            return nullptr;
+        }
+
+        while (true) {
+            auto expr = parseExpression();
+            if (!expr) {
+                return nullptr;
+            }
+
+            bool ascending = true;
+            if (currentToken().type == TokenType::ASC) {
+                nextToken();
+            } else if (currentToken().type == TokenType::DESC) {
+                ascending = false;
+                nextToken();
+            }
+            stmt->addOrderBy(std::move(expr), ascending);
+
+            if (currentToken().type != TokenType::COMMA) {
+                break;
+            }
+            nextToken(); // skip comma
+        }
+    }
+
+    // LIMIT 子句：LIMIT n | LIMIT n OFFSET m | LIMIT m, n
     if (currentToken().type == TokenType::LIMIT) {
         nextToken();
         if (currentToken().type != TokenType::NUMBER) {
@@ -104,6 +228,25 @@ std::unique_ptr<SelectStatement> Parser::parseSelectStatement() {
         }
         stmt->setLimit(std::stoi(currentToken().literal));
         nextToken();
+
+        if (currentToken().type == TokenType::OFFSET) {
+            nextToken();
+            if (currentToken().type != TokenType::NUMBER) {
+                addError("Expected number after OFFSET");
+                return nullptr;
+            }
+            stmt->setOffset(std::stoi(currentToken().literal));
+            nextToken();
+        } else if (currentToken().type == TokenType::COMMA) {
+            nextToken();
+            if (currentToken().type != TokenType::NUMBER) {
+                addError("Expected number after LIMIT offset");
+                return nullptr;
+            }
+            stmt->setOffset(stmt->getLimit());
+            stmt->setLimit(std::stoi(currentToken().literal));
+            nextToken();
+        }
     }
 
     return stmt;
@@ -116,6 +259,11 @@ std::unique_ptr<InsertStatement> Parser::parseInsertStatement() {
         return nullptr;
     }
 
+    if (currentToken().type == TokenType::IGNORE) {
+        stmt->setIgnore(true);
+        nextToken();
+    }
+
     if (!expectAndNext(TokenType::INTO)) {
         return nullptr;
     }
@@ -151,22 +299,35 @@ std::unique_ptr<InsertStatement> Parser::parseInsertStatement() {
         }
     }
 
-    // VALUES
+    // VALUES (...) [, (...) ...]
     if (!expectAndNext(TokenType::VALUES)) {
         return nullptr;
     }
 
-    if (!expectAndNext(TokenType::LPAREN)) {
-        return nullptr;
-    }
-
-    // 解析值
     while (true) {
-        auto expr = parseExpression();
-        if (!expr) {
+        if (!expectAndNext(TokenType::LPAREN)) {
+            return nullptr;
+        }
+
+        // 解析一行的值
+        std::vector<std::unique_ptr<Expression>> values;
+        while (true) {
+            auto expr = parseExpression();
+            if (!expr) {
+                return nullptr;
+            }
+            values.push_back(std::move(expr));
+
+            if (currentToken().type != TokenType::COMMA) {
+                break;
+            }
+            nextToken();
+        }
+
+        if (!expectAndNext(TokenType::RPAREN)) {
             return nullptr;
         }
-        stmt->addValue(std::move(expr));
+        stmt->addRow(std::move(values));
 
         if (currentToken().type != TokenType::COMMA) {
             break;
@@ -174,9 +335,94 @@ std::unique_ptr<InsertStatement> Parser::parseInsertStatement() {
         nextToken();
     }
 
-    if (!expectAndNext(TokenType::RPAREN)) {
+    // ON DUPLICATE KEY UPDATE col = expr [, ...]
+    if (currentToken().type == TokenType::ON) {
+        nextToken();
+        if (!expectAndNext(TokenType::DUPLICATE) || !expectAndNext(TokenType::KEY) ||
+            !expectAndNext(TokenType::UPDATE)) {
+            return nullptr;
+        }
+
+        std::vector<Assignment> assignments;
+        if (!parseAssignments(assignments)) {
+            return nullptr;
+        }
+        for (auto& assignment : assignments) {
+            stmt->addDuplicateAssignment(assignment.column, std::move(assignment.value));
+        }
+    }
+
+    return stmt;
+}
+
+std::unique_ptr<UpdateStatement> Parser::parseUpdateStatement() {
+    auto stmt = std::make_unique<UpdateStatement>();
+
+    if (!expectAndNext(TokenType::UPDATE)) {
+        return nullptr;
+    }
+
+    if (currentToken().type != TokenType::IDENTIFIER) {
+        addError("Expected table name after UPDATE");
+        return nullptr;
+    }
+
+    stmt->setTableName(currentToken().literal);
+    nextToken();
+
+    if (!expectAndNext(TokenType::SET)) {
+        return nullptr;
+    }
+
+    std::vector<Assignment> assignments;
+    if (!parseAssignments(assignments)) {
         return nullptr;
     }
+    for (auto& assignment : assignments) {
+        stmt->addAssignment(assignment.column, std::move(assignment.value));
+    }
+
+    // WHERE 子句
+    if (currentToken().type == TokenType::WHERE) {
+        nextToken();
+        auto where = parseExpression();
+        if (!where) {
+            return nullptr;
+        }
+        stmt->setWhereClause(std::move(where));
+    }
+
+    return stmt;
+}
+
+std::unique_ptr<DeleteStatement> Parser::parseDeleteStatement() {
+    auto stmt = std::make_unique<DeleteStatement>();
+
+    if (!expectAndNext(TokenType::DELETE)) {
+        return nullptr;
+    }
+
+    if (!expectAndNext(TokenType::FROM)) {
+        return nullptr;
+    }
+
+    if (currentToken().type != TokenType::IDENTIFIER) {
+        addError("Expected table name after FROM");
+        return nullptr;
+    }
+
+    stmt->setTableName(currentToken().literal);
+    nextToken();
+
+    // WHERE 子句
+    if (currentToken().type == TokenType::WHERE) {
+        nextToken();
+        auto where = parseExpression();
+        if (!where) {
+            return nullptr;
+        }
+        stmt->setWhereClause(std::move(where));
+    }
 
     return stmt;
 }
@@ -216,9 +462,21 @@ std::unique_ptr<CreateTableStatement> Parser::parseCreateTableStatement() {
         col.name = currentToken().literal;
         nextToken();
 
-        // 数据类型
+        // 数据类型，可带长度/精度：VARCHAR(20)、DECIMAL(10, 2)
         col.type = currentToken().literal;
         nextToken();
+        if (currentToken().type == TokenType::LPAREN) {
+            col.type += "(";
+            nextToken();
+            while (currentToken().type == TokenType::NUMBER || currentToken().type == TokenType::COMMA) {
+                col.type += currentToken().literal;
+                nextToken();
+            }
+            if (!expectAndNext(TokenType::RPAREN)) {
+                return nullptr;
+            }
+            col.type += ")";
+        }
 
         // 解析约束
         while (true) {
@@ -237,6 +495,12 @@ std::unique_ptr<CreateTableStatement> Parser::parseCreateTableStatement() {
             } else if (currentToken().type == TokenType::AUTO_INCREMENT) {
                 col.auto_increment = true;
                 nextToken();
+            } else if (currentToken().type == TokenType::UNIQUE) {
+                col.unique = true;
+                nextToken();
+                if (currentToken().type == TokenType::KEY) {
+                    nextToken();
+                }
             } else if (currentToken().type == TokenType::DEFAULT) {
                 nextToken();
                 col.default_value = currentToken().literal;
@@ -262,6 +526,93 @@ std::unique_ptr<CreateTableStatement> Parser::parseCreateTableStatement() {
     return stmt;
 }
 
+std::unique_ptr<CreateIndexStatement> Parser::parseCreateIndexStatement() {
+    if (!expectAndNext(TokenType::CREATE)) {
+        return nullptr;
+    }
+
+    if (!expectAndNext(TokenType::INDEX)) {
+        return nullptr;
+    }
+
+    if (currentToken().type != TokenType::IDENTIFIER) {
+        addError("Expected index name");
+        return nullptr;
+    }
+    std::string index_name = currentToken().literal;
+    nextToken();
+
+    if (!expectAndNext(TokenType::ON)) {
+        return nullptr;
+    }
+
+    if (currentToken().type != TokenType::IDENTIFIER) {
+        addError("Expected table name");
+        return nullptr;
+    }
+    std::string table_name = currentToken().literal;
+    nextToken();
+
+    if (!expectAndNext(TokenType::LPAREN)) {
+        return nullptr;
+    }
+
+    if (currentToken().type != TokenType::IDENTIFIER) {
+        addError("Expected column name");
+        return nullptr;
+    }
+    std::string column_name = currentToken().literal;
+    nextToken();
+
+    if (!expectAndNext(TokenType::RPAREN)) {
+        return nullptr;
+    }
+
+    return std::make_unique<CreateIndexStatement>(index_name, table_name, column_name);
+}
+
+std::unique_ptr<AnalyzeTableStatement> Parser::parseAnalyzeStatement() {
+    if (!expectAndNext(TokenType::ANALYZE)) {
+        return nullptr;
+    }
+
+    if (!expectAndNext(TokenType::TABLE)) {
+        return nullptr;
+    }
+
+    if (currentToken().type != TokenType::IDENTIFIER) {
+        addError("Expected table name");
+        return nullptr;
+    }
+
+    auto stmt = std::make_unique<AnalyzeTableStatement>(currentToken().literal);
+    nextToken();
+    return stmt;
+}
+
+std::unique_ptr<ExplainStatement> Parser::parseExplainStatement() {
+    if (!expectAndNext(TokenType::EXPLAIN)) {
+        return nullptr;
+    }
+
+    bool analyze = false;
+    if (currentToken().type == TokenType::ANALYZE) {
+        analyze = true;
+        nextToken();
+    }
+
+    if (currentToken().type != TokenType::SELECT) {
+        addError("EXPLAIN only supports SELECT statements");
+        return nullptr;
+    }
+
+    auto select = parseSelectStatement();
+    if (!select) {
+        return nullptr;
+    }
+    return std::make_unique<ExplainStatement>(analyze, std::move(select));
+}
+
 std::unique_ptr<DropTableStatement> Parser::parseDropTableStatement() {
     if (!expectAndNext(TokenType::DROP)) {
         return nullptr;
@@ -293,12 +644,87 @@ std::unique_ptr<Statement> Parser::parseShowStatement() {
     } else if (currentToken().type == TokenType::DATABASES) {
         nextToken();
         return std::make_unique<ShowDatabasesStatement>();
+    } else if (isContextualKeyword("GLOBAL") || isContextualKeyword("SESSION") ||
+               isContextualKeyword("STATUS")) {
+        auto stmt = std::make_unique<ShowStatusStatement>();
+        if (!isContextualKeyword("STATUS")) {
+            stmt->setGlobal(isContextualKeyword("GLOBAL"));
+            nextToken();
+        }
+        if (!isContextualKeyword("STATUS")) {
+            addError("Expected STATUS");
+            return nullptr;
+        }
+        nextToken();
+
+        if (currentToken().type == TokenType::LIKE) {
+            nextToken();
+            if (currentToken().type != TokenType::STRING) {
+                addError("Expected pattern string after LIKE");
+                return nullptr;
+            }
+            stmt->setLikePattern(currentToken().literal);
+            nextToken();
+        }
+        return stmt;
+    } else if (isContextualKeyword("FULL") || isContextualKeyword("PROCESSLIST")) {
+        auto stmt = std::make_unique<ShowProcesslistStatement>();
+        if (isContextualKeyword("FULL")) {
+            stmt->setFull(true);
+            nextToken();
+        }
+        if (!isContextualKeyword("PROCESSLIST")) {
+            addError("Expected PROCESSLIST");
+            return nullptr;
+        }
+        nextToken();
+        return stmt;
+    } else if (isContextualKeyword("QUERY")) {
+        nextToken();
+        if (!isContextualKeyword("DIGESTS")) {
+            addError("Expected DIGESTS");
+            return nullptr;
+        }
+        nextToken();
+
+        auto stmt = std::make_unique<ShowQueryDigestsStatement>();
+        if (currentToken().type == TokenType::LIMIT) {
+            nextToken();
+            if (currentToken().type != TokenType::NUMBER) {
+                addError("Expected number after LIMIT");
+                return nullptr;
+            }
+            stmt->setLimit(std::stoi(currentToken().literal));
+            nextToken();
+        }
+        return stmt;
     }
 
     addError("Unexpected token after SHOW");
     return nullptr;
 }
 
+std::unique_ptr<KillStatement> Parser::parseKillStatement() {
+    // KILL [QUERY | CONNECTION] processlist_id
+    nextToken();
+    bool query_only = false;
+    if (isContextualKeyword("QUERY")) {
+        query_only = true;
+        nextToken();
+    } else if (isContextualKeyword("CONNECTION")) {
+        nextToken();
+    }
+
+    if (currentToken().type != TokenType::NUMBER) {
+        addError("Expected connection id after KILL");
+        return nullptr;
+    }
+    auto stmt = std::make_unique<KillStatement>(
+        static_cast<uint32_t>(std::stoul(currentToken().literal)), query_only);
+    nextToken();
+    return stmt;
+}
+
 std::unique_ptr<UseDatabaseStatement> Parser::parseUseStatement() {
     if (!expectAndNext(TokenType::USE)) {
         return nullptr;
@@ -315,6 +741,90 @@ std::unique_ptr<UseDatabaseStatement> Parser::parseUseStatement() {
     return stmt;
 }
 
+std::unique_ptr<TransactionStatement> Parser::parseTransactionStatement() {
+    TransactionStatement::Kind kind;
+    switch (currentToken().type) {
+        case TokenType::BEGIN:
+            kind = TransactionStatement::Kind::BEGIN;
+            break;
+        case TokenType::START:
+            // START TRANSACTION
+            nextToken();
+            if (!expect(TokenType::TRANSACTION)) {
+                return nullptr;
+            }
+            kind = TransactionStatement::Kind::BEGIN;
+            break;
+        case TokenType::COMMIT:
+            kind = TransactionStatement::Kind::COMMIT;
+            break;
+        default:
+            kind = TransactionStatement::Kind::ROLLBACK;
+            break;
+    }
+    nextToken();
+
+    return std::make_unique<TransactionStatement>(kind);
+}
+
+bool Parser::parseAssignments(std::vector<Assignment>& assignments) {
+    while (true) {
+        if (currentToken().type != TokenType::IDENTIFIER) {
+            addError("Expected column name in assignment");
+            return false;
+        }
+        std::string column = currentToken().literal;
+        nextToken();
+
+        if (!expectAndNext(TokenType::EQ)) {
+            return false;
+        }
+
+        auto value = parseExpression();
+        if (!value) {
+            return false;
+        }
+        assignments.push_back({column, std::move(value)});
+
+        if (currentToken().type != TokenType::COMMA) {
+            return true;
+        }
+        nextToken();
+    }
+}
+
+bool Parser::isContextualKeyword(const char* word) {
+    if (currentToken().type != TokenType::IDENTIFIER) {
+        return false;
+    }
+    const std::string& literal = currentToken().literal;
+    size_t len = std::strlen(word);
+    if (literal.size() != len) {
+        return false;
+    }
+    for (size_t i = 0; i < len; ++i) {
+        if (std::toupper(static_cast<unsigned char>(literal[i])) != word[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Parser::parseTableAlias(std::string& alias) {
+    if (currentToken().type == TokenType::AS) {
+        nextToken();
+        if (currentToken().type != TokenType::IDENTIFIER) {
+            addError("Expected alias after AS");
+            return false;
+        }
+    }
+    if (currentToken().type == TokenType::IDENTIFIER) {
+        alias = currentToken().literal;
+        nextToken();
+    }
+    return true;
+}
+
 std::unique_ptr<Expression> Parser::parseExpression() {
     auto left = parsePrimaryExpression();
     if (!left) {
@@ -327,9 +837,21 @@ std::unique_ptr<Expression> Parser::parseExpression() {
 std::unique_ptr<Expression> Parser::parsePrimaryExpression() {
     switch (currentToken().type) {
         case TokenType::IDENTIFIER: {
-            auto expr = std::make_unique<Identifier>(currentToken().literal);
+            std::string name = currentToken().literal;
             nextToken();
-            return expr;
+
+            // 限定列名：table.column
+            if (currentToken().type == TokenType::DOT) {
+                nextToken();
+                if (currentToken().type != TokenType::IDENTIFIER) {
+                    addError("Expected column name after '" + name + ".'");
+                    return nullptr;
+                }
+                auto expr = std::make_unique<Identifier>(name, currentToken().literal);
+                nextToken();
+                return expr;
+            }
+            return std::make_unique<Identifier>(name);
         }
 
         case TokenType::NUMBER: {
@@ -350,6 +872,31 @@ std::unique_ptr<Expression> Parser::parsePrimaryExpression() {
             return expr;
         }
 
+        case TokenType::COUNT:
+        case TokenType::SUM:
+        case TokenType::AVG:
+        case TokenType::MIN:
+        case TokenType::MAX:
+            return parseFunctionCall();
+
+        case TokenType::VALUES: {
+            // VALUES(col)：ON DUPLICATE KEY UPDATE 中引用待插入的值，作为名为 "VALUES(col)" 的列
+            nextToken();
+            if (!expectAndNext(TokenType::LPAREN)) {
+                return nullptr;
+            }
+            if (currentToken().type != TokenType::IDENTIFIER) {
+                addError("Expected column name in VALUES()");
+                return nullptr;
+            }
+            auto expr = std::make_unique<Identifier>("VALUES(" + currentToken().literal + ")");
+            nextToken();
+            if (!expectAndNext(TokenType::RPAREN)) {
+                return nullptr;
+            }
+            return expr;
+        }
+
         case TokenType::LPAREN: {
             nextToken();
             auto expr = parseExpression();
@@ -365,10 +912,47 @@ std::unique_ptr<Expression> Parser::parsePrimaryExpression() {
     }
 }
 
+std::unique_ptr<Expression> Parser::parseFunctionCall() {
+    // 函数名统一为大写，便于执行器识别
+    std::string name = tokenTypeToString(currentToken().type);
+    nextToken();
+
+    if (!expectAndNext(TokenType::LPAREN)) {
+        return nullptr;
+    }
+
+    std::vector<std::unique_ptr<Expression>> args;
+    if (currentToken().type == TokenType::ASTERISK) {
+        // COUNT(*)
+        args.push_back(std::make_unique<Identifier>("*"));
+        nextToken();
+    } else if (currentToken().type != TokenType::RPAREN) {
+        while (true) {
+            auto arg = parseExpression();
+            if (!arg) {
+                return nullptr;
+            }
+            args.push_back(std::move(arg));
+
+            if (currentToken().type != TokenType::COMMA) {
+                break;
+            }
+            nextToken();
+        }
+    }
+
+    if (!expectAndNext(TokenType::RPAREN)) {
+        return nullptr;
+    }
+
+    return std::make_unique<FunctionCall>(name, std::move(args));
+}
+
 std::unique_ptr<Expression> Parser::parseBinaryExpression(int precedence, std::unique_ptr<Expression> left) {
     while (true) {
         int current_precedence = getPrecedence(currentToken().type);
-        if (current_precedence < precedence) {
+        // 优先级为0表示不是二元操作符（如逗号、右括号、EOF），表达式结束
+        if (current_precedence == 0 || current_precedence < precedence) {
             return left;
         }
 
@@ -376,6 +960,15 @@ std::unique_ptr<Expression> Parser::parseBinaryExpression(int precedence, std::u
         TokenType op_type = currentToken().type;
         nextToken();
 
+        // 统一操作符写法，求值器只识别规范形式
+        if (op_type == TokenType::AND) {
+            op = "AND";
+        } else if (op_type == TokenType::OR) {
+            op = "OR";
+        } else if (op_type == TokenType::NE) {
+            op = "!=";
+        }
+
         auto right = parsePrimaryExpression();
         if (!right) {
             return nullptr;
@@ -27,6 +27,25 @@ const char* tokenTypeToString(TokenType type) {
         case TokenType::SHOW: return "SHOW";
         case TokenType::TABLES: return "TABLES";
         case TokenType::DATABASES: return "DATABASES";
+        case TokenType::INDEX: return "INDEX";
+        case TokenType::ANALYZE: return "ANALYZE";
+        case TokenType::EXPLAIN: return "EXPLAIN";
+        case TokenType::SET: return "SET";
+        case TokenType::BEGIN: return "BEGIN";
+        case TokenType::START: return "START";
+        case TokenType::TRANSACTION: return "TRANSACTION";
+        case TokenType::COMMIT: return "COMMIT";
+        case TokenType::ROLLBACK: return "ROLLBACK";
+        case TokenType::IGNORE: return "IGNORE";
+        case TokenType::DUPLICATE: return "DUPLICATE";
+        case TokenType::ORDER: return "ORDER";
+        case TokenType::GROUP: return "GROUP";
+        case TokenType::BY: return "BY";
+        case TokenType::COUNT: return "COUNT";
+        case TokenType::SUM: return "SUM";
+        case TokenType::AVG: return "AVG";
+        case TokenType::MAX: return "MAX";
+        case TokenType::MIN: return "MIN";
         case TokenType::INT: return "INT";
         case TokenType::VARCHAR: return "VARCHAR";
         case TokenType::ASTERISK: return "*";
@@ -117,6 +136,16 @@ TokenType lookupKeyword(const std::string& identifier) {
         {"LIKE", TokenType::LIKE},
         {"IS", TokenType::IS},
         {"ASC", TokenType::ASC},
+        {"ANALYZE", TokenType::ANALYZE},
+        {"EXPLAIN", TokenType::EXPLAIN},
+        {"SET", TokenType::SET},
+        {"BEGIN", TokenType::BEGIN},
+        {"START", TokenType::START},
+        {"TRANSACTION", TokenType::TRANSACTION},
+        {"COMMIT", TokenType::COMMIT},
+        {"ROLLBACK", TokenType::ROLLBACK},
+        {"IGNORE", TokenType::IGNORE},
+        {"DUPLICATE", TokenType::DUPLICATE},
     };
 
     // 转换为大写进行查找
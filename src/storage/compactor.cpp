@@ -0,0 +1,98 @@
+#include "tiny_sql/storage/compactor.h"
+#include "tiny_sql/storage/storage_engine.h"
+#include "tiny_sql/storage/transaction.h"
+#include "tiny_sql/common/config.h"
+#include "tiny_sql/common/logger.h"
+#include <chrono>
+
+namespace tiny_sql {
+
+Compactor& Compactor::instance() {
+    static Compactor compactor;
+    return compactor;
+}
+
+Compactor::~Compactor() {
+    stop();
+}
+
+void Compactor::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&Compactor::run, this);
+}
+
+void Compactor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    cv_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void Compactor::notify() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = true;
+    }
+    cv_.notify_one();
+}
+
+size_t Compactor::compactAll() {
+    auto& storage = StorageEngine::instance();
+    const double threshold = Config::instance().compaction_dead_ratio;
+    // 只回收对所有活跃快照都不可见的版本
+    const uint64_t horizon = TransactionManager::instance().gcHorizon();
+    size_t total = 0;
+
+    for (const auto& db_name : storage.getDatabaseNames()) {
+        auto db = storage.getDatabase(db_name);
+        if (!db) {
+            continue;
+        }
+        for (const auto& table_name : db->getTableNames()) {
+            auto table = db->getTable(table_name);
+            if (!table) {
+                continue;
+            }
+
+            size_t reclaimed = table->compact(threshold, horizon);
+            if (reclaimed > 0) {
+                LOG_INFO("Compacted " << db_name << "." << table_name
+                         << ": reclaimed " << reclaimed << " dead row versions");
+                total += reclaimed;
+            }
+        }
+    }
+    return total;
+}
+
+void Compactor::run() {
+    // 周期唤醒由事件循环的时间轮负责（见 main.cpp），这里只等 notify
+    // The event loop's timer wheel provides the periodic wakeup; only wait for notify
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        cv_.wait(lock, [this] { return !running_ || pending_; });
+        if (!running_) {
+            break;
+        }
+        pending_ = false;
+
+        // 压缩期间不持有 mutex_，notify 不会被阻塞
+        // Don't hold mutex_ while compacting so notify never blocks
+        lock.unlock();
+        compactAll();
+        lock.lock();
+    }
+}
+
+} // namespace tiny_sql
@@ -54,6 +54,70 @@ bool ExpressionEvaluator::evaluate(const Expression* expr,
     }
 }
 
+// 辅助函数：算术运算
+// 任一侧为NULL或除数为0时结果为NULL；整数之间的 +, -, *, % 结果为BIGINT，其余为DOUBLE
+// Arithmetic: NULL on NULL operands or division by zero; integer +, -, *, % yield BIGINT, the rest DOUBLE
+static Value evaluateArithmetic(const std::string& op, const Value& left, const Value& right) {
+    if (left.isNull() || right.isNull()) {
+        return Value::Null();
+    }
+
+    auto is_integer = [](const Value& v) { return v.isInt() || v.isBigInt() || v.isBool(); };
+    auto is_number = [&](const Value& v) { return is_integer(v) || v.isFloat() || v.isDouble(); };
+    if (!is_number(left) || !is_number(right)) {
+        throw std::runtime_error("Arithmetic operator " + op + " requires numeric operands");
+    }
+
+    if (is_integer(left) && is_integer(right) && op != "/") {
+        auto as_int = [](const Value& v) -> int64_t {
+            if (v.isInt()) return v.asInt();
+            if (v.isBigInt()) return v.asBigInt();
+            return v.asBool() ? 1 : 0;
+        };
+        int64_t a = as_int(left);
+        int64_t b = as_int(right);
+        int64_t result = 0;
+        bool overflow = false;
+
+        if (op == "+") {
+            overflow = __builtin_add_overflow(a, b, &result);
+        } else if (op == "-") {
+            overflow = __builtin_sub_overflow(a, b, &result);
+        } else if (op == "*") {
+            overflow = __builtin_mul_overflow(a, b, &result);
+        } else {
+            if (b == 0) {
+                return Value::Null();
+            }
+            result = (b == -1) ? 0 : a % b;
+        }
+
+        if (overflow) {
+            throw std::runtime_error("BIGINT value is out of range in '" + left.toString() +
+                                     " " + op + " " + right.toString() + "'");
+        }
+        return Value(result);
+    }
+
+    auto as_double = [](const Value& v) -> double {
+        if (v.isInt()) return v.asInt();
+        if (v.isBigInt()) return static_cast<double>(v.asBigInt());
+        if (v.isFloat()) return v.asFloat();
+        if (v.isDouble()) return v.asDouble();
+        return v.asBool() ? 1.0 : 0.0;
+    };
+    double a = as_double(left);
+    double b = as_double(right);
+
+    if (op == "+") return Value(a + b);
+    if (op == "-") return Value(a - b);
+    if (op == "*") return Value(a * b);
+    if (b == 0.0) {
+        return Value::Null();
+    }
+    return Value(op == "/" ? a / b : std::fmod(a, b));
+}
+
 Value ExpressionEvaluator::evaluateValue(const Expression* expr,
                                          const Row& row,
                                          const std::vector<ColumnDef>& columns) {
@@ -95,8 +159,14 @@ Value ExpressionEvaluator::evaluateValue(const Expression* expr,
             return Value(result);
         }
 
-        // 未来可以扩展：算术运算符 +, -, *, /
-        // Future extension: arithmetic operators +, -, *, /
+        // 算术运算符：+, -, *, /, %
+        // Arithmetic operators: +, -, *, /, %
+        if (op == "+" || op == "-" || op == "*" || op == "/" || op == "%") {
+            return evaluateArithmetic(op,
+                                      evaluateValue(bin_expr->getLeft(), row, columns),
+                                      evaluateValue(bin_expr->getRight(), row, columns));
+        }
+
         throw std::runtime_error("Unsupported operator in expression: " + op);
     }
 
@@ -138,25 +208,80 @@ bool ExpressionEvaluator::evaluateBinaryExpression(const BinaryExpression* expr,
     return compareValues(left_value, op, right_value);
 }
 
-Value ExpressionEvaluator::evaluateIdentifier(const Identifier* id,
-                                              const Row& row,
-                                              const std::vector<ColumnDef>& columns) {
+// 辅助函数：列名是否等于 qualifier.name
+static bool matchesQualified(const std::string& column_name,
+                             const std::string& qualifier,
+                             const std::string& name) {
+    return column_name.size() == qualifier.size() + 1 + name.size() &&
+           column_name.compare(0, qualifier.size(), qualifier) == 0 &&
+           column_name[qualifier.size()] == '.' &&
+           column_name.compare(qualifier.size() + 1, name.size(), name) == 0;
+}
+
+// 辅助函数：列名是否以 .name 结尾
+static bool matchesSuffix(const std::string& column_name, const std::string& name) {
+    return column_name.size() > name.size() &&
+           column_name[column_name.size() - name.size() - 1] == '.' &&
+           column_name.compare(column_name.size() - name.size(), name.size(), name) == 0;
+}
+
+int ExpressionEvaluator::resolveColumn(const Identifier* id,
+                                       const std::vector<ColumnDef>& columns) {
     const std::string& col_name = id->getName();
+    int plain_match = -1;
+    int suffix_match = -1;
+    size_t suffix_count = 0;
 
-    // 查找列索引
-    // Find column index
     for (size_t i = 0; i < columns.size(); ++i) {
-        if (columns[i].name == col_name) {
-            // 检查行是否有足够的列
-            // Check if row has enough columns
-            if (i >= row.getColumnCount()) {
-                throw std::runtime_error("Row has insufficient columns for identifier: " + col_name);
+        const std::string& name = columns[i].name;
+
+        if (id->isQualified() && matchesQualified(name, id->getQualifier(), col_name)) {
+            return static_cast<int>(i);
+        }
+        if (name == col_name) {
+            if (plain_match < 0) {
+                plain_match = static_cast<int>(i);
+            }
+        } else if (matchesSuffix(name, col_name)) {
+            if (suffix_match < 0) {
+                suffix_match = static_cast<int>(i);
             }
-            return row.getValue(i);
+            suffix_count++;
         }
     }
 
-    throw std::runtime_error("Unknown column in expression: " + col_name);
+    // 单表查询的列名不带限定，限定名退化为按列名匹配
+    // Single-table columns are unqualified; fall back to the bare column name
+    if (plain_match >= 0) {
+        return plain_match;
+    }
+
+    if (id->isQualified()) {
+        return -1;
+    }
+
+    if (suffix_count > 1) {
+        throw std::runtime_error("Column '" + col_name + "' is ambiguous");
+    }
+    return suffix_match;
+}
+
+Value ExpressionEvaluator::evaluateIdentifier(const Identifier* id,
+                                              const Row& row,
+                                              const std::vector<ColumnDef>& columns) {
+    // 查找列索引
+    // Find column index
+    int index = resolveColumn(id, columns);
+    if (index < 0) {
+        throw std::runtime_error("Unknown column in expression: " + id->toString());
+    }
+
+    // 检查行是否有足够的列
+    // Check if row has enough columns
+    if (static_cast<size_t>(index) >= row.getColumnCount()) {
+        throw std::runtime_error("Row has insufficient columns for identifier: " + id->toString());
+    }
+    return row.getValue(index);
 }
 
 Value ExpressionEvaluator::evaluateLiteral(const Expression* expr) {
@@ -0,0 +1,64 @@
+#include "tiny_sql/storage/index.h"
+#include <cmath>
+
+namespace tiny_sql {
+
+void OrderedIndex::insert(const Value& key, size_t row_id) {
+    entries_.emplace(key, row_id);
+}
+
+std::vector<size_t> OrderedIndex::find(const Value& key) const {
+    std::vector<size_t> row_ids;
+    auto range = entries_.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        row_ids.push_back(it->second);
+    }
+    return row_ids;
+}
+
+bool OrderedIndex::castKey(const Value& key, DataType type, Value& out) {
+    int64_t i = 0;
+    double d = 0.0;
+    bool is_int = false;
+    bool is_float = false;
+
+    if (key.isInt()) { i = key.asInt(); is_int = true; }
+    else if (key.isBigInt()) { i = key.asBigInt(); is_int = true; }
+    else if (key.isFloat()) { d = key.asFloat(); is_float = true; }
+    else if (key.isDouble()) { d = key.asDouble(); is_float = true; }
+
+    // 整数值的浮点数可以查整数列
+    if (is_float && std::floor(d) == d && std::fabs(d) < 9.2e18) {
+        i = static_cast<int64_t>(d);
+        is_int = true;
+    }
+
+    switch (type) {
+        case DataType::INT:
+            if (!is_int || i < INT32_MIN || i > INT32_MAX) return false;
+            out = Value(static_cast<int32_t>(i));
+            return true;
+        case DataType::BIGINT:
+            if (!is_int) return false;
+            out = Value(static_cast<int64_t>(i));
+            return true;
+        case DataType::FLOAT:
+            if (!is_int && !is_float) return false;
+            out = Value(static_cast<float>(is_float ? d : static_cast<double>(i)));
+            return true;
+        case DataType::DOUBLE:
+            if (!is_int && !is_float) return false;
+            out = Value(is_float ? d : static_cast<double>(i));
+            return true;
+        case DataType::VARCHAR:
+        case DataType::TEXT:
+            if (!key.isString()) return false;
+            out = key;
+            return true;
+        default:
+            out = key;
+            return true;
+    }
+}
+
+} // namespace tiny_sql
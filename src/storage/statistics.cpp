@@ -0,0 +1,196 @@
+#include "tiny_sql/storage/statistics.h"
+#include "tiny_sql/storage/table.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace tiny_sql {
+
+// ==================== HyperLogLog ====================
+
+void HyperLogLog::add(uint64_t hash) {
+    size_t index = static_cast<size_t>(hash >> (64 - kPrecision));
+    // 剩余位前导零个数+1；低位补一个哨兵1，保证结果不超过 64-kPrecision+1
+    uint64_t rest = (hash << kPrecision) | (uint64_t{1} << (kPrecision - 1));
+    uint8_t rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    registers_[index] = std::max(registers_[index], rank);
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    for (size_t i = 0; i < kRegisters; ++i) {
+        registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+}
+
+uint64_t HyperLogLog::estimate() const {
+    const double m = static_cast<double>(kRegisters);
+    const double alpha = 0.7213 / (1.0 + 1.079 / m);
+
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (uint8_t r : registers_) {
+        sum += std::ldexp(1.0, -r);
+        if (r == 0) {
+            zeros++;
+        }
+    }
+
+    double estimate = alpha * m * m / sum;
+
+    // 小基数修正：线性计数
+    // Small-range correction: linear counting
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / static_cast<double>(zeros));
+    }
+    return static_cast<uint64_t>(std::llround(estimate));
+}
+
+// ==================== ColumnStatistics ====================
+
+// 辅助函数：数值类型转换为double（用于桶内线性插值）
+static bool toNumber(const Value& v, double& out) {
+    if (v.isInt()) { out = v.asInt(); return true; }
+    if (v.isBigInt()) { out = static_cast<double>(v.asBigInt()); return true; }
+    if (v.isFloat()) { out = v.asFloat(); return true; }
+    if (v.isDouble()) { out = v.asDouble(); return true; }
+    return false;
+}
+
+double ColumnStatistics::fractionBelow(const Value& value, bool inclusive) const {
+    if (histogram.empty()) {
+        return 0.5;
+    }
+
+    // 找到第一个上界 >= value（inclusive 时 > value）的桶
+    // Find the first bucket whose upper bound is >= value (> value when inclusive)
+    auto less = [](const Value& a, const Value& b) { return a.compare(b) < 0; };
+    auto it = inclusive
+        ? std::upper_bound(histogram.begin(), histogram.end(), value, less)
+        : std::lower_bound(histogram.begin(), histogram.end(), value, less);
+
+    const double buckets = static_cast<double>(histogram.size());
+    size_t bucket = static_cast<size_t>(it - histogram.begin());
+    if (bucket == histogram.size()) {
+        return 1.0;
+    }
+
+    // 桶内按数值线性插值，非数值取桶的一半
+    // Linear interpolation inside the bucket for numbers, half a bucket otherwise
+    const Value& lower = bucket == 0 ? min : histogram[bucket - 1];
+    const Value& upper = histogram[bucket];
+    double within = 0.5;
+    double lo, hi, v;
+    if (toNumber(lower, lo) && toNumber(upper, hi) && toNumber(value, v)) {
+        within = hi > lo ? std::clamp((v - lo) / (hi - lo), 0.0, 1.0) : 0.0;
+    }
+    return (static_cast<double>(bucket) + within) / buckets;
+}
+
+double ColumnStatistics::equalSelectivity(const Value& value, uint64_t row_count) const {
+    if (row_count == 0 || value.isNull()) {
+        return 0.0;
+    }
+
+    double non_null = 1.0 - static_cast<double>(null_count) / static_cast<double>(row_count);
+
+    // 超出 [min, max] 范围
+    // Outside [min, max]
+    if (!min.isNull() && (value.compare(min) < 0 || value.compare(max) > 0)) {
+        return 0.0;
+    }
+
+    // 频繁值会占据多个桶的上界
+    // A frequent value spans several bucket bounds
+    size_t bounds = 0;
+    for (const auto& bound : histogram) {
+        if (bound.compare(value) == 0) {
+            bounds++;
+        }
+    }
+    if (bounds >= 2) {
+        return non_null * static_cast<double>(bounds) / static_cast<double>(histogram.size());
+    }
+
+    return non_null / static_cast<double>(std::max<uint64_t>(ndv, 1));
+}
+
+// ==================== TableStatistics ====================
+
+// 辅助函数：64位混合（Value::hash 对整数是恒等映射，HyperLogLog需要均匀分布的高位）
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+void TableStatistics::analyze(const std::vector<Row>& rows, const std::vector<bool>& deleted,
+                              size_t column_count) {
+    row_count = rows.size() - static_cast<size_t>(std::count(deleted.begin(), deleted.end(), true));
+    columns.assign(column_count, ColumnStatistics());
+
+    std::mt19937_64 rng(0x5EED);
+
+    for (size_t col = 0; col < column_count; ++col) {
+        ColumnStatistics& stats = columns[col];
+        HyperLogLog sketch;
+        std::vector<Value> sample;
+        sample.reserve(std::min(rows.size(), kHistogramSampleRows));
+        uint64_t seen = 0;
+
+        for (size_t i = 0; i < rows.size(); ++i) {
+            if (deleted[i]) {
+                continue;
+            }
+            const Value& value = rows[i].getValue(col);
+            if (value.isNull()) {
+                stats.null_count++;
+                continue;
+            }
+
+            sketch.add(mix64(value.hash()));
+
+            if (stats.min.isNull() || value.compare(stats.min) < 0) {
+                stats.min = value;
+            }
+            if (stats.max.isNull() || value.compare(stats.max) > 0) {
+                stats.max = value;
+            }
+
+            // 蓄水池采样
+            // Reservoir sampling
+            seen++;
+            if (sample.size() < kHistogramSampleRows) {
+                sample.push_back(value);
+            } else {
+                uint64_t slot = rng() % seen;
+                if (slot < kHistogramSampleRows) {
+                    sample[slot] = value;
+                }
+            }
+        }
+
+        stats.ndv = std::min<uint64_t>(sketch.estimate(), seen);
+        if (seen > 0 && stats.ndv == 0) {
+            stats.ndv = 1;
+        }
+
+        // 等深直方图：排序样本后等间隔取上界
+        // Equi-depth histogram: sort the sample and take evenly spaced upper bounds
+        if (!sample.empty()) {
+            std::sort(sample.begin(), sample.end(),
+                      [](const Value& a, const Value& b) { return a.compare(b) < 0; });
+            size_t buckets = std::min(kHistogramBuckets, sample.size());
+            stats.histogram.reserve(buckets);
+            for (size_t b = 1; b <= buckets; ++b) {
+                stats.histogram.push_back(sample[b * sample.size() / buckets - 1]);
+            }
+        }
+    }
+
+    analyzed = true;
+}
+
+} // namespace tiny_sql
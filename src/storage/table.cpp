@@ -1,5 +1,7 @@
 #include "tiny_sql/storage/table.h"
 #include "tiny_sql/common/logger.h"
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 namespace tiny_sql {
@@ -16,6 +18,12 @@ std::string Row::toString() const {
 }
 
 void Table::addColumn(const ColumnDef& column) {
+    if (column.primary_key && primary_key_index_ < 0) {
+        primary_key_index_ = static_cast<int>(columns_.size());
+        unique_keys_.push_back({"PRIMARY", columns_.size(), HashIndex()});
+    } else if (column.unique) {
+        unique_keys_.push_back({column.name, columns_.size(), HashIndex()});
+    }
     column_index_map_[column.name] = columns_.size();
     columns_.push_back(column);
 }
@@ -28,7 +36,7 @@ int Table::getColumnIndex(const std::string& column_name) const {
     return -1;
 }
 
-bool Table::insertRow(const Row& row) {
+bool Table::insertRow(const Row& row, uint64_t begin_ts) {
     // 验证列数匹配
     if (row.getColumnCount() != columns_.size()) {
         LOG_ERROR("Column count mismatch: expected " << columns_.size()
@@ -48,10 +56,242 @@ bool Table::insertRow(const Row& row) {
         }
     }
 
+    if (primary_key_index_ >= 0) {
+        primary_index_.insert(row.getValue(primary_key_index_), rows_.size());
+    }
+    for (auto& secondary : secondary_indexes_) {
+        secondary.index.insert(row.getValue(secondary.column), rows_.size());
+    }
+    for (auto& unique_key : unique_keys_) {
+        unique_key.index.insert(row.getValue(unique_key.column), rows_.size());
+    }
     rows_.push_back(row);
+    versions_.push_back({begin_ts, mvcc::kInfinity});
+    if (mvcc::isUncommitted(begin_ts)) {
+        uncommitted_++;
+    } else {
+        last_commit_ts_ = std::max(last_commit_ts_, begin_ts);
+    }
+    version_++;
+    return true;
+}
+
+bool Table::deleteRow(size_t row_id, uint64_t end_ts) {
+    if (row_id >= rows_.size() || versions_[row_id].end_ts != mvcc::kInfinity) {
+        return false;
+    }
+
+    // 索引项保留，查找时按版本可见性过滤，压缩时随索引重建一并清除
+    versions_[row_id].end_ts = end_ts;
+    if (mvcc::isUncommitted(end_ts)) {
+        uncommitted_++;
+    } else {
+        dead_rows_++;
+    }
+    version_++;
     return true;
 }
 
+bool Table::updateRow(size_t row_id, const Row& row, uint64_t ts) {
+    if (row_id >= rows_.size() || versions_[row_id].end_ts != mvcc::kInfinity) {
+        return false;
+    }
+    if (!insertRow(row, ts)) {
+        return false;
+    }
+    return deleteRow(row_id, ts);
+}
+
+Table::UniqueConflict Table::findUniqueConflict(const Row& row, uint64_t marker,
+                                                int64_t exclude_row) const {
+    UniqueConflict conflict;
+    for (const auto& unique_key : unique_keys_) {
+        const Value& key = row.getValue(unique_key.column);
+        if (key.isNull()) {
+            continue;
+        }
+
+        unique_key.index.probe(key, [&](size_t row_id) {
+            if (static_cast<int64_t>(row_id) == exclude_row) {
+                return true;
+            }
+            uint64_t end_ts = versions_[row_id].end_ts;
+            // 已提交的删除或回滚的插入释放了该键；其他事务未提交的删除仍占用
+            if (end_ts == mvcc::kInfinity || (mvcc::isUncommitted(end_ts) && end_ts != marker)) {
+                conflict.row_id = static_cast<int64_t>(row_id);
+                return false;
+            }
+            return true;
+        });
+
+        if (conflict.row_id >= 0) {
+            conflict.column = unique_key.column;
+            conflict.key_name = unique_key.name;
+            return conflict;
+        }
+    }
+    return conflict;
+}
+
+void Table::commitRow(size_t row_id, uint64_t marker, uint64_t commit_ts) {
+    RowVersion& row_version = versions_[row_id];
+    if (row_version.begin_ts == marker) {
+        row_version.begin_ts = commit_ts;
+        last_commit_ts_ = std::max(last_commit_ts_, commit_ts);
+        uncommitted_--;
+    }
+    if (row_version.end_ts == marker) {
+        row_version.end_ts = commit_ts;
+        uncommitted_--;
+        dead_rows_++;
+    }
+    version_++;
+}
+
+void Table::abortRow(size_t row_id, uint64_t marker) {
+    RowVersion& row_version = versions_[row_id];
+    if (row_version.begin_ts == marker) {
+        // 事务插入的版本：对所有快照不可见，等待回收
+        if (row_version.end_ts == marker) {
+            uncommitted_--;
+        }
+        row_version.begin_ts = mvcc::kAborted;
+        row_version.end_ts = mvcc::kAborted;
+        uncommitted_--;
+        dead_rows_++;
+    } else if (row_version.end_ts == marker) {
+        row_version.end_ts = mvcc::kInfinity;
+        uncommitted_--;
+    }
+    version_++;
+}
+
+void Table::analyze(const ReadView& view) {
+    std::vector<bool> hidden(rows_.size());
+    for (size_t i = 0; i < rows_.size(); ++i) {
+        hidden[i] = !view.sees(versions_[i]);
+    }
+    statistics_.analyze(rows_, hidden, columns_.size());
+}
+
+size_t Table::compact(double min_dead_ratio, uint64_t horizon) {
+    std::vector<Row> kept_rows;
+    std::vector<RowVersion> kept_versions;
+    OrderedIndex primary_index;
+    std::vector<SecondaryIndex> secondary_indexes;
+    std::vector<UniqueKey> unique_keys;
+    uint64_t version;
+
+    // 1. 持共享锁复制仍可能被看到的版本并重建索引（查询不受影响）
+    {
+        std::shared_lock<std::shared_mutex> lock(lock_);
+        if (dead_rows_ == 0 || uncommitted_ > 0 ||
+            static_cast<double>(dead_rows_) < min_dead_ratio * static_cast<double>(rows_.size())) {
+            return 0;
+        }
+        version = version_;
+
+        kept_rows.reserve(rows_.size() - dead_rows_);
+        kept_versions.reserve(rows_.size() - dead_rows_);
+        for (size_t i = 0; i < rows_.size(); ++i) {
+            // 没有未提交写入时 end_ts 只能是无穷大或提交时间戳
+            if (versions_[i].end_ts > horizon) {
+                kept_rows.push_back(rows_[i]);
+                kept_versions.push_back(versions_[i]);
+            }
+        }
+        if (kept_rows.size() == rows_.size()) {
+            return 0;
+        }
+
+        for (const auto& secondary : secondary_indexes_) {
+            secondary_indexes.push_back({secondary.name, secondary.column, OrderedIndex()});
+        }
+        for (const auto& unique_key : unique_keys_) {
+            unique_keys.push_back({unique_key.name, unique_key.column, HashIndex()});
+        }
+        for (size_t i = 0; i < kept_rows.size(); ++i) {
+            if (primary_key_index_ >= 0) {
+                primary_index.insert(kept_rows[i].getValue(primary_key_index_), i);
+            }
+            for (auto& secondary : secondary_indexes) {
+                secondary.index.insert(kept_rows[i].getValue(secondary.column), i);
+            }
+            for (auto& unique_key : unique_keys) {
+                unique_key.index.insert(kept_rows[i].getValue(unique_key.column), i);
+            }
+        }
+    }
+
+    // 2. 持排他锁替换；复制期间有写入则放弃
+    std::unique_lock<std::shared_mutex> lock(lock_);
+    if (version_ != version) {
+        LOG_DEBUG("Compaction of " << name_ << " skipped: table modified during copy");
+        return 0;
+    }
+
+    size_t reclaimed = rows_.size() - kept_rows.size();
+    rows_.swap(kept_rows);
+    versions_.swap(kept_versions);
+    primary_index_ = std::move(primary_index);
+    secondary_indexes_ = std::move(secondary_indexes);
+    unique_keys_ = std::move(unique_keys);
+    dead_rows_ -= reclaimed;
+    version_++;
+    return reclaimed;
+}
+
+bool Table::createIndex(const std::string& index_name, size_t column) {
+    if (hasIndex(index_name) || column >= columns_.size()) {
+        return false;
+    }
+
+    // 所有版本都建索引项，旧快照仍可能通过索引读到已结束的版本
+    SecondaryIndex secondary{index_name, column, OrderedIndex()};
+    for (size_t i = 0; i < rows_.size(); ++i) {
+        secondary.index.insert(rows_[i].getValue(column), i);
+    }
+    secondary_indexes_.push_back(std::move(secondary));
+    version_++;
+    return true;
+}
+
+bool Table::hasIndex(const std::string& index_name) const {
+    if (index_name == "PRIMARY") {
+        return primary_key_index_ >= 0;
+    }
+    for (const auto& secondary : secondary_indexes_) {
+        if (secondary.name == index_name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const OrderedIndex* Table::getIndex(size_t column) const {
+    if (static_cast<int>(column) == primary_key_index_) {
+        return &primary_index_;
+    }
+    for (const auto& secondary : secondary_indexes_) {
+        if (secondary.column == column) {
+            return &secondary.index;
+        }
+    }
+    return nullptr;
+}
+
+std::string Table::getIndexName(size_t column) const {
+    if (static_cast<int>(column) == primary_key_index_) {
+        return "PRIMARY";
+    }
+    for (const auto& secondary : secondary_indexes_) {
+        if (secondary.column == column) {
+            return secondary.name;
+        }
+    }
+    return "";
+}
+
 int Table::getPrimaryKeyIndex() const {
     for (size_t i = 0; i < columns_.size(); ++i) {
         if (columns_[i].primary_key) {
@@ -70,8 +310,18 @@ int Table::getAutoIncrementIndex() const {
     return -1;
 }
 
-int64_t Table::getNextAutoIncrementValue() {
-    return next_auto_increment_++;
+int64_t Table::reserveAutoIncrement(size_t count) {
+    return next_auto_increment_.fetch_add(static_cast<int64_t>(count), std::memory_order_relaxed);
+}
+
+void Table::observeAutoIncrementValue(int64_t value) {
+    if (value == std::numeric_limits<int64_t>::max()) {
+        return;
+    }
+    int64_t next = next_auto_increment_.load(std::memory_order_relaxed);
+    while (next <= value &&
+           !next_auto_increment_.compare_exchange_weak(next, value + 1, std::memory_order_relaxed)) {
+    }
 }
 
 std::string Table::toString() const {
@@ -91,11 +341,12 @@ std::string Table::toString() const {
             default: oss << "UNKNOWN"; break;
         }
         if (col.primary_key) oss << " PRIMARY KEY";
+        if (col.unique) oss << " UNIQUE";
         if (col.auto_increment) oss << " AUTO_INCREMENT";
         if (col.not_null) oss << " NOT NULL";
         oss << "\n";
     }
-    oss << "Rows: " << rows_.size();
+    oss << "Rows: " << getRowCount();
     return oss.str();
 }
 
@@ -0,0 +1,99 @@
+#include "tiny_sql/storage/transaction.h"
+#include "tiny_sql/storage/table.h"
+#include "tiny_sql/common/logger.h"
+#include <algorithm>
+#include <shared_mutex>
+
+namespace tiny_sql {
+
+TransactionManager& TransactionManager::instance() {
+    static TransactionManager manager;
+    return manager;
+}
+
+std::shared_ptr<Transaction> TransactionManager::begin(bool explicit_txn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t id = next_txn_id_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t read_ts = clock_.load(std::memory_order_acquire);
+    active_.emplace(read_ts, id);
+    return std::make_shared<Transaction>(id, read_ts, explicit_txn);
+}
+
+void TransactionManager::commit(Transaction& txn) {
+    const auto& writes = txn.getWrites();
+    if (!writes.empty()) {
+        // 按地址顺序锁住涉及的所有表（避免死锁），分配时间戳并打戳后统一释放
+        // Lock every table involved in address order (no deadlock), allocate the
+        // timestamp and stamp the writes, then release them together
+        std::vector<Table*> tables;
+        for (const auto& write : writes) {
+            tables.push_back(write.table.get());
+        }
+        std::sort(tables.begin(), tables.end());
+        tables.erase(std::unique(tables.begin(), tables.end()), tables.end());
+
+        std::vector<std::unique_lock<std::shared_mutex>> table_locks;
+        table_locks.reserve(tables.size());
+        for (Table* table : tables) {
+            table_locks.emplace_back(table->getLock());
+        }
+
+        uint64_t commit_ts = allocateTimestamp();
+        for (const auto& write : writes) {
+            write.table->commitRow(write.row_id, txn.getMarker(), commit_ts);
+        }
+        LOG_DEBUG("Transaction " << txn.getId() << " committed at " << commit_ts
+                  << " (" << writes.size() << " writes)");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    finish(txn);
+}
+
+void TransactionManager::rollback(Transaction& txn) {
+    // 逆序撤销：同一事务先插入后删除的版本按写入顺序的反向恢复
+    // Undo in reverse order of the writes
+    const Table* locked = nullptr;
+    std::unique_lock<std::shared_mutex> table_lock;
+    const auto& writes = txn.getWrites();
+    for (auto it = writes.rbegin(); it != writes.rend(); ++it) {
+        if (it->table.get() != locked) {
+            table_lock = std::unique_lock<std::shared_mutex>(it->table->getLock());
+            locked = it->table.get();
+        }
+        it->table->abortRow(it->row_id, txn.getMarker());
+    }
+    if (table_lock.owns_lock()) {
+        table_lock.unlock();
+    }
+    LOG_DEBUG("Transaction " << txn.getId() << " rolled back ("
+              << writes.size() << " writes)");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    finish(txn);
+}
+
+void TransactionManager::finish(const Transaction& txn) {
+    auto range = active_.equal_range(txn.getReadView().read_ts);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == txn.getId()) {
+            active_.erase(it);
+            break;
+        }
+    }
+}
+
+uint64_t TransactionManager::gcHorizon() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (active_.empty()) {
+        return clock_.load(std::memory_order_acquire);
+    }
+    return active_.begin()->first;
+}
+
+size_t TransactionManager::getActiveCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return active_.size();
+}
+
+} // namespace tiny_sql
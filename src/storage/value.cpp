@@ -1,6 +1,7 @@
 #include "tiny_sql/storage/value.h"
 #include <sstream>
 #include <iomanip>
+#include <functional>
 
 namespace tiny_sql {
 
@@ -41,6 +42,20 @@ bool Value::operator==(const Value& other) const {
     return data_ == other.data_;
 }
 
+size_t Value::hash() const {
+    // 混入类型下标，保证不同类型的相同字面值落在不同桶中（与operator==语义一致）
+    size_t seed = data_.index() * 0x9E3779B97F4A7C15ULL;
+    size_t h = std::visit([](const auto& v) -> size_t {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::nullptr_t>) {
+            return 0;
+        } else {
+            return std::hash<T>{}(v);
+        }
+    }, data_);
+    return seed ^ (h + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2));
+}
+
 bool Value::operator<(const Value& other) const {
     if (data_.index() != other.data_.index()) {
         return data_.index() < other.data_.index();
@@ -56,6 +71,27 @@ bool Value::operator<(const Value& other) const {
     return false;
 }
 
+// 辅助函数：数值类型转换为double
+static bool toNumber(const Value& v, double& out) {
+    if (v.isInt()) { out = v.asInt(); return true; }
+    if (v.isBigInt()) { out = static_cast<double>(v.asBigInt()); return true; }
+    if (v.isFloat()) { out = v.asFloat(); return true; }
+    if (v.isDouble()) { out = v.asDouble(); return true; }
+    return false;
+}
+
+int Value::compare(const Value& other) const {
+    if (data_.index() != other.data_.index()) {
+        double x, y;
+        if (toNumber(*this, x) && toNumber(other, y)) {
+            return x < y ? -1 : (y < x ? 1 : 0);
+        }
+    }
+    if (*this < other) return -1;
+    if (other < *this) return 1;
+    return 0;
+}
+
 bool Value::operator<=(const Value& other) const {
     return *this < other || *this == other;
 }
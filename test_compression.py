@@ -0,0 +1,239 @@
+#!/usr/bin/env python3
+"""
+测试压缩协议（CLIENT_COMPRESS，zlib）：握手协商、压缩帧和原样帧的往返、
+压缩帧序号，以及大结果集确实被压缩且内容与普通连接一致
+
+服务器需在编译时找到 zlib
+
+先启动服务器：./tiny-sql 13306
+"""
+import socket
+import struct
+import sys
+import zlib
+
+CAPABILITIES = 0x0000a207 | 0x00080000     # PROTOCOL_41、SECURE_CONNECTION、PLUGIN_AUTH 等，不带初始数据库
+CLIENT_COMPRESS = 0x00000020
+COMPRESSED_HEADER_SIZE = 7
+MIN_COMPRESS_LENGTH = 50
+
+failures = 0
+
+def send_mysql_packet(sock, sequence_id, payload):
+    """发送MySQL包"""
+    length = len(payload)
+    header = struct.pack('<I', length)[0:3] + struct.pack('B', sequence_id)
+    sock.sendall(header + payload)
+
+def recv_exact(sock, n):
+    data = b''
+    while len(data) < n:
+        chunk = sock.recv(n - len(data))
+        if not chunk:
+            raise EOFError("connection closed by server")
+        data += chunk
+    return data
+
+def recv_mysql_packet(sock):
+    """接收MySQL包"""
+    header = recv_exact(sock, 4)
+    length = struct.unpack('<I', header[0:3] + b'\x00')[0]
+    return recv_exact(sock, length)
+
+def read_lenenc(data, pos):
+    first = data[pos]
+    if first < 0xfb:
+        return first, pos + 1
+    if first == 0xfb:
+        return None, pos + 1
+    size = {0xfc: 2, 0xfd: 3, 0xfe: 8}[first]
+    return int.from_bytes(data[pos + 1:pos + 1 + size], 'little'), pos + 1 + size
+
+class Connection:
+    """
+    一个已认证的连接，query 返回 ('OK', affected_rows) / ('ERR', code, msg) / 行列表
+    compress 为 True 时认证之后的收发都经过压缩帧
+    """
+
+    def __init__(self, port=13306, compress=False):
+        self.sock = socket.create_connection(('127.0.0.1', port))
+        self.compress = False
+        self.plain_input = b''
+        self.frame_sequence = 0
+        self.bytes_received = 0         # 从 socket 读到的字节数
+        self.frames = []                # 收到的帧：(压缩序号, 帧内容长度, 压缩前长度)
+
+        handshake = recv_mysql_packet(self.sock)
+        self.server_capabilities = self.parse_capabilities(handshake)
+
+        capabilities = CAPABILITIES | (CLIENT_COMPRESS if compress else 0)
+        auth_response = struct.pack('<IIB', capabilities, 16777216, 33)
+        auth_response += b'\x00' * 23
+        auth_response += b'root\x00'
+        auth_response += b'\x00'
+        auth_response += b'mysql_native_password\x00'
+        send_mysql_packet(self.sock, 1, auth_response)
+        result = recv_mysql_packet(self.sock)
+        if result[0] != 0x00:
+            raise RuntimeError("authentication failed")
+        # 认证结果的 OK 包不压缩，之后双方都改用压缩帧
+        self.compress = compress
+
+    @staticmethod
+    def parse_capabilities(handshake):
+        pos = handshake.index(b'\x00', 1) + 1 + 4 + 8 + 1     # 版本串、连接ID、auth-plugin-data 前8字节
+        lower = struct.unpack('<H', handshake[pos:pos + 2])[0]
+        upper = struct.unpack('<H', handshake[pos + 5:pos + 7])[0]
+        return lower | (upper << 16)
+
+    def send_packet(self, sequence_id, payload):
+        packet = struct.pack('<I', len(payload))[0:3] + struct.pack('B', sequence_id) + payload
+        if not self.compress:
+            self.sock.sendall(packet)
+            return
+        # 客户端每条命令的第一帧序号为 0，短包原样发送
+        if len(packet) >= MIN_COMPRESS_LENGTH:
+            body, raw_length = zlib.compress(packet), len(packet)
+        else:
+            body, raw_length = packet, 0
+        header = struct.pack('<I', len(body))[0:3] + b'\x00' + struct.pack('<I', raw_length)[0:3]
+        self.sock.sendall(header + body)
+        self.frame_sequence = 1
+
+    def recv_raw(self, n):
+        data = recv_exact(self.sock, n)
+        self.bytes_received += n
+        return data
+
+    def recv_plain(self, n):
+        if not self.compress:
+            return self.recv_raw(n)
+        while len(self.plain_input) < n:
+            header = self.recv_raw(COMPRESSED_HEADER_SIZE)
+            length = struct.unpack('<I', header[0:3] + b'\x00')[0]
+            sequence_id = header[3]
+            raw_length = struct.unpack('<I', header[4:7] + b'\x00')[0]
+            body = self.recv_raw(length)
+            if sequence_id != self.frame_sequence:
+                raise RuntimeError(f"compressed sequence id {sequence_id}, expected {self.frame_sequence}")
+            self.frame_sequence = (self.frame_sequence + 1) & 0xff
+            self.frames.append((sequence_id, length, raw_length))
+            if raw_length:
+                body = zlib.decompress(body)
+                if len(body) != raw_length:
+                    raise RuntimeError("uncompressed length mismatch")
+            self.plain_input += body
+        data, self.plain_input = self.plain_input[:n], self.plain_input[n:]
+        return data
+
+    def recv_packet(self):
+        header = self.recv_plain(4)
+        length = struct.unpack('<I', header[0:3] + b'\x00')[0]
+        return self.recv_plain(length)
+
+    def query(self, sql):
+        self.send_packet(0, b'\x03' + sql.encode('utf-8'))
+        packet = self.recv_packet()
+        if packet[0] == 0xff:
+            return ('ERR', struct.unpack('<H', packet[1:3])[0], packet[9:].decode('utf-8', 'ignore'))
+        if packet[0] == 0x00:
+            return ('OK', read_lenenc(packet, 1)[0])
+
+        column_count, _ = read_lenenc(packet, 0)
+        for _ in range(column_count):
+            self.recv_packet()
+        self.recv_packet()              # 列定义后的EOF
+
+        rows = []
+        while True:
+            packet = self.recv_packet()
+            if packet[0] == 0xfe and len(packet) < 9:
+                break
+            pos, row = 0, []
+            for _ in range(column_count):
+                length, pos = read_lenenc(packet, pos)
+                row.append(None if length is None else packet[pos:pos + length].decode('utf-8'))
+                if length is not None:
+                    pos += length
+            rows.append(tuple(row))
+        return rows
+
+    def close(self):
+        self.sock.close()
+
+def check(description, actual, expected):
+    global failures
+    if actual == expected:
+        print(f"✅ {description}")
+    else:
+        failures += 1
+        print(f"❌ {description}")
+        print(f"   expected: {expected}")
+        print(f"   actual:   {actual}")
+
+def test_compression():
+    """测试 zlib 压缩协议的往返"""
+    print("=" * 60)
+    print("Tiny-SQL Compressed Protocol Test")
+    print("=" * 60)
+
+    plain = Connection()
+    check("server advertises CLIENT_COMPRESS",
+          bool(plain.server_capabilities & CLIENT_COMPRESS), True)
+    conn = Connection(compress=True)
+    print("✅ Compressed connection authenticated")
+
+    print(f"\n{'-' * 60}\nSmall statements (stored frames)\n{'-' * 60}")
+    for name, c in (("plain", plain), ("compressed", conn)):
+        c.query("CREATE DATABASE IF NOT EXISTS compress_test")
+        check(f"USE on the {name} connection", c.query("USE compress_test")[0], 'OK')
+    conn.query("DROP TABLE IF EXISTS c")
+    check("CREATE TABLE", conn.query("CREATE TABLE c (id INT PRIMARY KEY, v VARCHAR(200))"), ('OK', 0))
+    check("short responses come back as stored frames",
+          all(raw_length == 0 for _, _, raw_length in conn.frames), True)
+
+    print(f"\n{'-' * 60}\nLarge statements (compressed frames)\n{'-' * 60}")
+    for start in range(0, 2000, 100):
+        values = ','.join(f"({i}, '{'abcdefgh' * 20}')" for i in range(start, start + 100))
+        result = conn.query("INSERT INTO c VALUES " + values)
+        if result != ('OK', 100):
+            check(f"compressed INSERT of rows {start}..{start + 99}", result, ('OK', 100))
+            break
+    check("compressed inserts applied", conn.query("SELECT COUNT(*) FROM c"), [('2000',)])
+
+    conn.bytes_received = 0
+    conn.frames = []
+    compressed_rows = conn.query("SELECT * FROM c")
+    compressed_bytes = conn.bytes_received
+
+    plain.bytes_received = 0
+    plain_rows = plain.query("SELECT * FROM c")
+    plain_bytes = plain.bytes_received
+
+    check("result set matches an uncompressed connection", compressed_rows, plain_rows)
+    check("result set has 2000 rows", len(compressed_rows), 2000)
+    check("large result arrives in compressed frames",
+          any(raw_length > 0 for _, _, raw_length in conn.frames), True)
+    check("compressed frame sequence ids start at 1 for each command",
+          [sequence_id for sequence_id, _, _ in conn.frames],
+          list(range(1, len(conn.frames) + 1)))
+    print(f"   {compressed_bytes} bytes on the wire vs {plain_bytes} uncompressed")
+    check("compressed result is smaller", compressed_bytes < plain_bytes // 4, True)
+
+    check("connection still usable", conn.query("DROP TABLE c"), ('OK', 0))
+    conn.close()
+    plain.close()
+
+    print(f"\n{'=' * 60}")
+    print("Test completed!" if failures == 0 else f"{failures} check(s) failed")
+    print(f"{'=' * 60}")
+
+if __name__ == "__main__":
+    try:
+        test_compression()
+    except Exception as e:
+        failures += 1
+        print(f"❌ Test failed: {e}")
+        import traceback
+        traceback.print_exc()
+    sys.exit(1 if failures else 0)
@@ -36,24 +36,51 @@ int main() {
     testSQL("SELECT id, name FROM users");
     testSQL("SELECT name FROM users WHERE id = 1");
     testSQL("SELECT * FROM users LIMIT 10");
+    testSQL("SELECT name, age FROM users ORDER BY age DESC, name LIMIT 5 OFFSET 10");
+    testSQL("SELECT u.name, o.amount FROM users u LEFT JOIN orders o ON u.id = o.user_id");
 
     // Test INSERT statements
     testSQL("INSERT INTO users (name, age) VALUES ('Alice', 25)");
     testSQL("INSERT INTO users VALUES ('Bob', 30)");
+    testSQL("INSERT IGNORE INTO users VALUES (1, 'Bob')");
+    testSQL("INSERT INTO users (name, age) VALUES ('Carol', 41), ('Dave', 19)");
+    testSQL("INSERT INTO users (id, hits) VALUES (1, 1) ON DUPLICATE KEY UPDATE hits = hits + VALUES(hits)");
+
+    // Test UPDATE / DELETE
+    testSQL("UPDATE users SET age = age + 1, name = 'Carol' WHERE id = 3");
+    testSQL("DELETE FROM users WHERE age < 18");
+
+    // Test transactions
+    testSQL("BEGIN");
+    testSQL("START TRANSACTION");
+    testSQL("COMMIT");
+    testSQL("ROLLBACK");
 
     // Test CREATE TABLE
     testSQL("CREATE TABLE users (id INT PRIMARY KEY, name VARCHAR(50))");
     testSQL("CREATE TABLE products (id INT AUTO_INCREMENT PRIMARY KEY, name TEXT NOT NULL, price FLOAT DEFAULT 0.0)");
+    testSQL("CREATE TABLE accounts (id INT PRIMARY KEY, email VARCHAR(100) UNIQUE NOT NULL)");
 
     // Test other statements
     testSQL("SHOW TABLES");
     testSQL("SHOW DATABASES");
+    testSQL("SHOW GLOBAL STATUS LIKE 'Bytes%'");
+    testSQL("SHOW QUERY DIGESTS LIMIT 5");
+    testSQL("SHOW FULL PROCESSLIST");
+    testSQL("KILL QUERY 5");
     testSQL("USE mydb");
+    testSQL("CREATE INDEX idx_age ON users (age)");
+    testSQL("ANALYZE TABLE users");
+    testSQL("EXPLAIN ANALYZE SELECT name FROM users WHERE age > 18 ORDER BY name LIMIT 10");
     testSQL("DROP TABLE users");
 
     // Test complex SELECT
     testSQL("SELECT name, age FROM users WHERE age > 18 AND name = 'Alice'");
 
+    // Test aggregates
+    testSQL("SELECT COUNT(*) FROM users");
+    testSQL("SELECT age, COUNT(*), AVG(score) FROM users WHERE active = 1 GROUP BY age");
+
     // Test error cases
     testSQL("SELCT * FROM users");  // typo
     testSQL("SELECT FROM users");    // missing columns
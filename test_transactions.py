@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+"""
+测试事务（MVCC）：两个连接之间的快照读、先更新者胜（1020）、回滚、提交，
+以及旧快照仍打开时后台压缩不会回收它还能看到的版本
+
+先启动服务器：./tiny-sql 13306
+"""
+import socket
+import struct
+import sys
+import time
+
+CAPABILITIES = 0x0000a207 | 0x00080000     # PROTOCOL_41、SECURE_CONNECTION、PLUGIN_AUTH 等，不带初始数据库
+ER_CHECKREAD = 1020
+
+failures = 0
+
+def send_mysql_packet(sock, sequence_id, payload):
+    """发送MySQL包"""
+    length = len(payload)
+    header = struct.pack('<I', length)[0:3] + struct.pack('B', sequence_id)
+    sock.sendall(header + payload)
+
+def recv_exact(sock, n):
+    data = b''
+    while len(data) < n:
+        chunk = sock.recv(n - len(data))
+        if not chunk:
+            raise EOFError("connection closed by server")
+        data += chunk
+    return data
+
+def recv_mysql_packet(sock):
+    """接收MySQL包"""
+    header = recv_exact(sock, 4)
+    length = struct.unpack('<I', header[0:3] + b'\x00')[0]
+    return recv_exact(sock, length)
+
+def read_lenenc(data, pos):
+    first = data[pos]
+    if first < 0xfb:
+        return first, pos + 1
+    if first == 0xfb:
+        return None, pos + 1
+    size = {0xfc: 2, 0xfd: 3, 0xfe: 8}[first]
+    return int.from_bytes(data[pos + 1:pos + 1 + size], 'little'), pos + 1 + size
+
+class Connection:
+    """一个已认证的连接，query 返回 ('OK', affected_rows) / ('ERR', code, msg) / 行列表"""
+
+    def __init__(self, port=13306):
+        self.sock = socket.create_connection(('127.0.0.1', port))
+        recv_mysql_packet(self.sock)    # 握手包
+
+        auth_response = struct.pack('<IIB', CAPABILITIES, 16777216, 33)
+        auth_response += b'\x00' * 23
+        auth_response += b'root\x00'
+        auth_response += b'\x00'
+        auth_response += b'mysql_native_password\x00'
+        send_mysql_packet(self.sock, 1, auth_response)
+        result = recv_mysql_packet(self.sock)
+        if result[0] != 0x00:
+            raise RuntimeError("authentication failed")
+
+    def query(self, sql):
+        send_mysql_packet(self.sock, 0, b'\x03' + sql.encode('utf-8'))
+        packet = recv_mysql_packet(self.sock)
+        if packet[0] == 0xff:
+            return ('ERR', struct.unpack('<H', packet[1:3])[0], packet[9:].decode('utf-8', 'ignore'))
+        if packet[0] == 0x00:
+            return ('OK', read_lenenc(packet, 1)[0])
+
+        column_count, _ = read_lenenc(packet, 0)
+        for _ in range(column_count):
+            recv_mysql_packet(self.sock)
+        recv_mysql_packet(self.sock)    # 列定义后的EOF
+
+        rows = []
+        while True:
+            packet = recv_mysql_packet(self.sock)
+            if packet[0] == 0xfe and len(packet) < 9:
+                break
+            pos, row = 0, []
+            for _ in range(column_count):
+                length, pos = read_lenenc(packet, pos)
+                row.append(None if length is None else packet[pos:pos + length].decode('utf-8'))
+                if length is not None:
+                    pos += length
+            rows.append(tuple(row))
+        return rows
+
+    def close(self):
+        self.sock.close()
+
+def check(description, actual, expected):
+    global failures
+    if actual == expected:
+        print(f"✅ {description}")
+    else:
+        failures += 1
+        print(f"❌ {description}")
+        print(f"   expected: {expected}")
+        print(f"   actual:   {actual}")
+
+def table_rows(conn, sql="SELECT id, v FROM t"):
+    return sorted((int(r[0]), int(r[1])) for r in conn.query(sql))
+
+def test_transactions():
+    """测试两个连接之间的事务可见性"""
+    print("=" * 60)
+    print("Tiny-SQL Transaction (MVCC) Test")
+    print("=" * 60)
+
+    a = Connection()
+    b = Connection()
+    for conn in (a, b):
+        conn.query("CREATE DATABASE IF NOT EXISTS txn_test")
+        conn.query("USE txn_test")
+    a.query("DROP TABLE IF EXISTS t")
+    a.query("CREATE TABLE t (id INT PRIMARY KEY, v INT)")
+    for i in range(1, 6):
+        a.query(f"INSERT INTO t VALUES ({i}, {i * 10})")
+    initial = [(i, i * 10) for i in range(1, 6)]
+
+    print(f"\n{'-' * 60}\nSnapshot reads\n{'-' * 60}")
+    check("BEGIN", b.query("BEGIN")[0], 'OK')
+    check("b takes its snapshot", table_rows(b), initial)
+
+    a.query("UPDATE t SET v = v + 1 WHERE id = 1")
+    a.query("DELETE FROM t WHERE id = 2")
+    a.query("INSERT INTO t VALUES (6, 60)")
+    latest = [(1, 11), (3, 30), (4, 40), (5, 50), (6, 60)]
+    check("a sees its autocommitted changes", table_rows(a), latest)
+    check("b still reads its snapshot", table_rows(b), initial)
+    check("b point read of a row a updated", b.query("SELECT v FROM t WHERE id = 1"), [('10',)])
+    check("b point read of a row a deleted", b.query("SELECT v FROM t WHERE id = 2"), [('20',)])
+
+    print(f"\n{'-' * 60}\nFirst updater wins\n{'-' * 60}")
+    check("b updating a row changed after its snapshot fails with 1020",
+          b.query("UPDATE t SET v = 0 WHERE id = 1")[:2], ('ERR', ER_CHECKREAD))
+    check("b updates an untouched row", b.query("UPDATE t SET v = 99 WHERE id = 3"), ('OK', 1))
+    check("b inserts a new row", b.query("INSERT INTO t VALUES (7, 70)"), ('OK', 1))
+    check("b sees its own writes", table_rows(b),
+          [(1, 10), (2, 20), (3, 99), (4, 40), (5, 50), (7, 70)])
+    check("a does not see b's uncommitted writes", table_rows(a), latest)
+    check("a writing a row b has written fails with 1020",
+          a.query("DELETE FROM t WHERE id = 3")[:2], ('ERR', ER_CHECKREAD))
+
+    print(f"\n{'-' * 60}\nRollback\n{'-' * 60}")
+    check("ROLLBACK", b.query("ROLLBACK")[0], 'OK')
+    check("a after rollback", table_rows(a), latest)
+    check("b after rollback sees the latest data", table_rows(b), latest)
+
+    print(f"\n{'-' * 60}\nCommit\n{'-' * 60}")
+    b.query("BEGIN")
+    b.query("UPDATE t SET v = 5 WHERE id = 4")
+    b.query("DELETE FROM t WHERE id = 5")
+    check("a before commit", table_rows(a), latest)
+    check("COMMIT", b.query("COMMIT")[0], 'OK')
+    latest = [(1, 11), (3, 30), (4, 5), (6, 60)]
+    check("a after commit", table_rows(a), latest)
+
+    print(f"\n{'-' * 60}\nCompaction with an open snapshot\n{'-' * 60}")
+    b.query("BEGIN")
+    check("b takes a new snapshot", table_rows(b), latest)
+    # 超过 compaction_dead_ratio 的已结束版本，等后台压缩至少跑过一轮
+    for i in range(100, 200):
+        a.query(f"INSERT INTO t VALUES ({i}, {i})")
+    a.query("DELETE FROM t WHERE id >= 100")
+    a.query("UPDATE t SET v = v + 1000 WHERE id < 100")
+    time.sleep(1.5)
+    check("b's snapshot survives compaction", table_rows(b), latest)
+    check("b's point reads survive compaction", b.query("SELECT v FROM t WHERE id = 4"), [('5',)])
+    check("COMMIT", b.query("COMMIT")[0], 'OK')
+    time.sleep(1.5)
+    latest = [(i, v + 1000) for i, v in latest]
+    check("a after compaction", table_rows(a), latest)
+    check("b after compaction", table_rows(b), latest)
+
+    a.query("DROP TABLE t")
+    a.close()
+    b.close()
+
+    print(f"\n{'=' * 60}")
+    print("Test completed!" if failures == 0 else f"{failures} check(s) failed")
+    print(f"{'=' * 60}")
+
+if __name__ == "__main__":
+    try:
+        test_transactions()
+    except Exception as e:
+        failures += 1
+        print(f"❌ Test failed: {e}")
+        import traceback
+        traceback.print_exc()
+    sys.exit(1 if failures else 0)
@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""
+测试 INSERT IGNORE 和 INSERT ... ON DUPLICATE KEY UPDATE 的影响行数和警告数
+（与 MySQL 一致：插入计 1，更新计 2，更新后没有变化计 0，忽略的行计 0 并产生警告）
+
+先启动服务器：./tiny-sql 13306
+"""
+import socket
+import struct
+import sys
+
+CAPABILITIES = 0x0000a207 | 0x00080000     # PROTOCOL_41、SECURE_CONNECTION、PLUGIN_AUTH 等，不带初始数据库
+ER_DUP_ENTRY = 1062
+
+failures = 0
+
+def send_mysql_packet(sock, sequence_id, payload):
+    """发送MySQL包"""
+    length = len(payload)
+    header = struct.pack('<I', length)[0:3] + struct.pack('B', sequence_id)
+    sock.sendall(header + payload)
+
+def recv_exact(sock, n):
+    data = b''
+    while len(data) < n:
+        chunk = sock.recv(n - len(data))
+        if not chunk:
+            raise EOFError("connection closed by server")
+        data += chunk
+    return data
+
+def recv_mysql_packet(sock):
+    """接收MySQL包"""
+    header = recv_exact(sock, 4)
+    length = struct.unpack('<I', header[0:3] + b'\x00')[0]
+    return recv_exact(sock, length)
+
+def read_lenenc(data, pos):
+    first = data[pos]
+    if first < 0xfb:
+        return first, pos + 1
+    if first == 0xfb:
+        return None, pos + 1
+    size = {0xfc: 2, 0xfd: 3, 0xfe: 8}[first]
+    return int.from_bytes(data[pos + 1:pos + 1 + size], 'little'), pos + 1 + size
+
+class Connection:
+    """一个已认证的连接，query 返回 ('OK', affected_rows, warnings) / ('ERR', code, msg) / 行列表"""
+
+    def __init__(self, port=13306):
+        self.sock = socket.create_connection(('127.0.0.1', port))
+        recv_mysql_packet(self.sock)    # 握手包
+
+        auth_response = struct.pack('<IIB', CAPABILITIES, 16777216, 33)
+        auth_response += b'\x00' * 23
+        auth_response += b'root\x00'
+        auth_response += b'\x00'
+        auth_response += b'mysql_native_password\x00'
+        send_mysql_packet(self.sock, 1, auth_response)
+        result = recv_mysql_packet(self.sock)
+        if result[0] != 0x00:
+            raise RuntimeError("authentication failed")
+
+    def query(self, sql):
+        send_mysql_packet(self.sock, 0, b'\x03' + sql.encode('utf-8'))
+        packet = recv_mysql_packet(self.sock)
+        if packet[0] == 0xff:
+            return ('ERR', struct.unpack('<H', packet[1:3])[0], packet[9:].decode('utf-8', 'ignore'))
+        if packet[0] == 0x00:
+            affected_rows, pos = read_lenenc(packet, 1)
+            _, pos = read_lenenc(packet, pos)       # last insert id
+            warnings = struct.unpack('<H', packet[pos + 2:pos + 4])[0]
+            return ('OK', affected_rows, warnings)
+
+        column_count, _ = read_lenenc(packet, 0)
+        for _ in range(column_count):
+            recv_mysql_packet(self.sock)
+        recv_mysql_packet(self.sock)    # 列定义后的EOF
+
+        rows = []
+        while True:
+            packet = recv_mysql_packet(self.sock)
+            if packet[0] == 0xfe and len(packet) < 9:
+                break
+            pos, row = 0, []
+            for _ in range(column_count):
+                length, pos = read_lenenc(packet, pos)
+                row.append(None if length is None else packet[pos:pos + length].decode('utf-8'))
+                if length is not None:
+                    pos += length
+            rows.append(tuple(row))
+        return rows
+
+    def close(self):
+        self.sock.close()
+
+def check(description, actual, expected):
+    global failures
+    if actual == expected:
+        print(f"✅ {description}")
+    else:
+        failures += 1
+        print(f"❌ {description}")
+        print(f"   expected: {expected}")
+        print(f"   actual:   {actual}")
+
+def test_upsert():
+    """测试 IGNORE / ON DUPLICATE KEY UPDATE"""
+    print("=" * 60)
+    print("Tiny-SQL INSERT IGNORE / ON DUPLICATE KEY UPDATE Test")
+    print("=" * 60)
+
+    conn = Connection()
+    conn.query("CREATE DATABASE IF NOT EXISTS upsert_test")
+    conn.query("USE upsert_test")
+    conn.query("DROP TABLE IF EXISTS u")
+    conn.query("CREATE TABLE u (id INT PRIMARY KEY, email VARCHAR(20) UNIQUE, hits INT)")
+    check("plain insert", conn.query("INSERT INTO u VALUES (1, 'a@x', 1)"), ('OK', 1, 0))
+
+    print(f"\n{'-' * 60}\nINSERT IGNORE\n{'-' * 60}")
+    check("duplicate primary key without IGNORE fails",
+          conn.query("INSERT INTO u VALUES (1, 'b@x', 1)")[:2], ('ERR', ER_DUP_ENTRY))
+    check("duplicate unique key without IGNORE fails",
+          conn.query("INSERT INTO u VALUES (2, 'a@x', 1)")[:2], ('ERR', ER_DUP_ENTRY))
+    check("IGNORE skips a duplicate primary key with a warning",
+          conn.query("INSERT IGNORE INTO u VALUES (1, 'c@x', 1)"), ('OK', 0, 1))
+    check("IGNORE skips a duplicate unique key with a warning",
+          conn.query("INSERT IGNORE INTO u VALUES (2, 'a@x', 1)"), ('OK', 0, 1))
+    check("IGNORE inserts the other rows of a multi-row insert",
+          conn.query("INSERT IGNORE INTO u VALUES (2, 'b@x', 1), (1, 'd@x', 1), (3, 'c@x', 1)"),
+          ('OK', 2, 1))
+    check("rows after IGNORE", conn.query("SELECT * FROM u ORDER BY id"),
+          [('1', 'a@x', '1'), ('2', 'b@x', '1'), ('3', 'c@x', '1')])
+
+    print(f"\n{'-' * 60}\nON DUPLICATE KEY UPDATE\n{'-' * 60}")
+    check("new row counts 1",
+          conn.query("INSERT INTO u VALUES (4, 'e@x', 1) ON DUPLICATE KEY UPDATE hits = hits + 1"),
+          ('OK', 1, 0))
+    check("updated row counts 2",
+          conn.query("INSERT INTO u VALUES (1, 'a@x', 5) ON DUPLICATE KEY UPDATE hits = hits + VALUES(hits)"),
+          ('OK', 2, 0))
+    check("unchanged row counts 0",
+          conn.query("INSERT INTO u VALUES (1, 'a@x', 5) ON DUPLICATE KEY UPDATE hits = hits"),
+          ('OK', 0, 0))
+    check("conflict on a unique key updates that row",
+          conn.query("INSERT INTO u VALUES (9, 'b@x', 1) ON DUPLICATE KEY UPDATE hits = 7"),
+          ('OK', 2, 0))
+    # id 3 的 hits 加 1，id 4 保持不变，id 5 是新行：1 + 2 + 0
+    check("multi-row: one insert, one update, one unchanged",
+          conn.query("INSERT INTO u VALUES (5, 'f@x', 1), (3, 'c@x', 1), (4, 'e@x', 1) "
+                     "ON DUPLICATE KEY UPDATE hits = hits + VALUES(hits) - 1 + (id = 3)"),
+          ('OK', 3, 0))
+    check("rows after ON DUPLICATE KEY UPDATE", conn.query("SELECT * FROM u ORDER BY id"),
+          [('1', 'a@x', '6'), ('2', 'b@x', '7'), ('3', 'c@x', '2'), ('4', 'e@x', '1'), ('5', 'f@x', '1')])
+
+    conn.query("DROP TABLE u")
+    conn.close()
+
+    print(f"\n{'=' * 60}")
+    print("Test completed!" if failures == 0 else f"{failures} check(s) failed")
+    print(f"{'=' * 60}")
+
+if __name__ == "__main__":
+    try:
+        test_upsert()
+    except Exception as e:
+        failures += 1
+        print(f"❌ Test failed: {e}")
+        import traceback
+        traceback.print_exc()
+    sys.exit(1 if failures else 0)